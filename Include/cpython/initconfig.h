@@ -181,6 +181,8 @@ typedef struct PyConfig {
     int int_max_str_digits;
 
     int cpu_count;
+    int sort_threads;
+    wchar_t *optimizer_profile;
 
     /* --- Path configuration inputs ------------ */
     int pathconfig_warnings;
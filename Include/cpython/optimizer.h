@@ -25,8 +25,11 @@ typedef struct {
     uint8_t oparg;
     uint8_t valid;
     uint8_t linked;
+    /* Dependencies only known through a bloom filter (see _Py_ExecutorInit) */
     _PyBloomFilter bloom;
     _PyExecutorLinkListNode links;
+    /* Exact dependencies (see _Py_Executor_DependsOn) */
+    struct _PyExecutorDependency *dependencies;
 } _PyVMData;
 
 typedef struct _PyExecutorObject {
@@ -13,6 +13,9 @@ The hash field of Unused slots is always zero.
 The hash field of Dummy slots are set to -1
 meaning that dummy entries can be detected by
 either entry->key==dummy or by entry->hash==-1.
+
+A compact table (see Objects/setobject.c) has no hash fields: its slots
+are bare key pointers, either NULL, dummy or an active key.
 */
 
 #define PySet_MINSIZE 8
@@ -49,6 +52,11 @@ typedef struct {
      * or to additional malloc'ed memory for bigger tables.
      * The table pointer is never NULL which saves us from repeated
      * runtime null-tests.
+     *
+     * A set of only str and small int keys may use a compact table
+     * instead, an array of bare key pointers.  Then table is really a
+     * PyObject **, and a bit of finger flags the layout; see
+     * Objects/setobject.c.
      */
     setentry *table;
     Py_hash_t hash;             /* Only used by frozenset objects */
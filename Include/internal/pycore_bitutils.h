@@ -180,6 +180,30 @@ _Py_bit_length(unsigned long x)
 }
 
 
+// Return the index of the least significant 1 bit in 'x' (count trailing
+// zeros). 'x' must be non-zero.
+static inline int
+_Py_ctz32(uint32_t x)
+{
+    assert(x != 0);
+#if (defined(__clang__) || defined(__GNUC__))
+    Py_BUILD_ASSERT(sizeof(x) <= sizeof(unsigned long));
+    return __builtin_ctzl(x);
+#elif defined(_MSC_VER)
+    unsigned long lsb;
+    _BitScanForward(&lsb, x);
+    return (int)lsb;
+#else
+    int lsb = 0;
+    while ((x & 1) == 0) {
+        lsb++;
+        x >>= 1;
+    }
+    return lsb;
+#endif
+}
+
+
 #ifdef __cplusplus
 }
 #endif
@@ -103,6 +103,10 @@ typedef struct {
                         unsigned int code_size, PyCodeObject* code);
     // Callback to free the trampoline state
     int (*free_state)(void* state);
+    // Callback to register any other code under the given symbol name
+    // (like the machine code of a tier 2 executor)
+    void (*write_named_state)(void* state, const void *code_addr,
+                              unsigned int code_size, const char *name);
 } _PyPerf_Callbacks;
 
 extern int _PyPerfTrampoline_SetCallbacks(_PyPerf_Callbacks *);
@@ -113,6 +117,7 @@ extern int _PyIsPerfTrampolineActive(void);
 extern PyStatus _PyPerfTrampoline_AfterFork_Child(void);
 #ifdef PY_HAVE_PERF_TRAMPOLINE
 extern _PyPerf_Callbacks _Py_perfmap_callbacks;
+extern _PyPerf_Callbacks _Py_perfmap_jit_callbacks;
 #endif
 
 static inline PyObject*
@@ -43,6 +43,8 @@ struct trampoline_api_st {
     void (*write_state)(void* state, const void *code_addr,
                         unsigned int code_size, PyCodeObject* code);
     int (*free_state)(void* state);
+    void (*write_named_state)(void* state, const void *code_addr,
+                              unsigned int code_size, const char *name);
     void *state;
 };
 #endif
@@ -53,6 +55,9 @@ struct _ceval_runtime_state {
         perf_status_t status;
         Py_ssize_t extra_code_index;
         struct code_arena_st *code_arena;
+        // Incremented whenever the code arenas are freed, so that executors
+        // can tell whether their trampoline still exists.
+        unsigned int code_arena_generation;
         struct trampoline_api_st trampoline_api;
         FILE *map_file;
 #else
@@ -8,6 +8,8 @@ extern "C" {
 #  error "this header requires Py_BUILD_CORE define"
 #endif
 
+#include "pycore_time.h"          // _PyTime_t
+
 /* GC information is stored BEFORE the object structure. */
 typedef struct {
     // Pointer to next object in the list.
@@ -64,14 +66,20 @@ static inline int _PyObject_GC_MAY_BE_TRACKED(PyObject *obj) {
 #define _PyGC_PREV_SHIFT           (2)
 #define _PyGC_PREV_MASK            (((uintptr_t) -1) << _PyGC_PREV_SHIFT)
 
-// Lowest bit of _gc_next is used for flags only in GC.
-// But it is always 0 for normal code.
+/* Bit flags for _gc_next */
+/* Bit 0 is used for flags only in GC.  It is always 0 for normal code. */
+/* Bit 1 records which half ("space") of the oldest generation the object
+   belongs to when that generation is collected incrementally.  It is kept
+   across list operations. */
+#define _PyGC_NEXT_MASK_OLD_SPACE_1 (2)
+
 static inline PyGC_Head* _PyGCHead_NEXT(PyGC_Head *gc) {
-    uintptr_t next = gc->_gc_next;
+    uintptr_t next = gc->_gc_next & ~_PyGC_NEXT_MASK_OLD_SPACE_1;
     return (PyGC_Head*)next;
 }
 static inline void _PyGCHead_SET_NEXT(PyGC_Head *gc, PyGC_Head *next) {
-    gc->_gc_next = (uintptr_t)next;
+    gc->_gc_next = ((gc->_gc_next & _PyGC_NEXT_MASK_OLD_SPACE_1)
+                    | (uintptr_t)next);
 }
 
 // Lowest two bits of _gc_prev is used for _PyGC_PREV_MASK_* flags.
@@ -156,6 +164,11 @@ struct gc_generation {
 };
 
 /* Running stats per generation */
+/* Number of buckets of the pause histograms.  Bucket i counts the
+   pauses that took less than 2**i microseconds (and at least 2**(i-1)),
+   the last bucket counts all the longer ones. */
+#define _PyGC_PAUSE_BUCKETS 24
+
 struct gc_generation_stats {
     /* total number of collections */
     Py_ssize_t collections;
@@ -163,6 +176,19 @@ struct gc_generation_stats {
     Py_ssize_t collected;
     /* total number of uncollectable objects (put into gc.garbage) */
     Py_ssize_t uncollectable;
+    /* total number of objects examined, and of those found reachable */
+    Py_ssize_t examined;
+    Py_ssize_t survived;
+    /* number of pauses, their total and longest duration.  A pause is a
+       whole collection, or an increment of an incremental collection of
+       the oldest generation. */
+    Py_ssize_t pauses;
+    _PyTime_t pause_total;
+    _PyTime_t pause_max;
+    /* time spent clearing weakrefs and calling finalizers */
+    _PyTime_t weakrefs_time;
+    _PyTime_t finalize_time;
+    Py_ssize_t pause_histogram[_PyGC_PAUSE_BUCKETS];
 };
 
 struct _gc_runtime_state {
@@ -198,6 +224,27 @@ struct _gc_runtime_state {
        collections, and are awaiting to undergo a full collection for
        the first time. */
     Py_ssize_t long_lived_pending;
+
+    /* Incremental collection of the oldest generation.  When
+       pause_budget is non-zero, full collections are replaced by a
+       cycle of increments, each run after a collection of the middle
+       generation.  The oldest generation's list holds the objects still
+       to be scanned in this cycle; objects found reachable from the roots
+       are kept in old_gray until their referents are marked, and objects
+       already scanned in old_visited until the cycle ends.  See
+       gc_collect_increment(). */
+    _PyTime_t pause_budget;
+    /* number of objects to scan in the next increment */
+    Py_ssize_t increment_size;
+    PyGC_Head old_gray;
+    PyGC_Head old_visited;
+    /* _PyGC_NEXT_MASK_OLD_SPACE_1 bit value of the objects in old_gray and
+       old_visited; the objects to be scanned have the other value */
+    int visited_space;
+    /* true while an incremental cycle is in progress */
+    int incremental_cycle;
+    /* true between gc.freeze() and gc.unfreeze() */
+    int frozen;
 };
 
 
@@ -462,6 +462,7 @@ struct _Py_global_strings {
         STRUCT_FOR_ID(ident)
         STRUCT_FOR_ID(ignore)
         STRUCT_FOR_ID(imag)
+        STRUCT_FOR_ID(immortal)
         STRUCT_FOR_ID(importlib)
         STRUCT_FOR_ID(in_fd)
         STRUCT_FOR_ID(incoming)
@@ -216,8 +216,14 @@ struct _is {
     struct callable_cache callable_cache;
     _PyOptimizerObject *optimizer;
     _PyExecutorObject *executor_list_head;
+    /* Maps objects to the executors that depend on them (see optimizer.c) */
+    struct _Py_hashtable_t *executor_dependents;
+    /* Number of linked executors with a non-empty bloom filter */
+    Py_ssize_t executor_bloom_count;
     uint16_t optimizer_resume_threshold;
     uint16_t optimizer_backedge_threshold;
+    /* Set with -X optprofile (main interpreter only) */
+    struct _PyOptimizerProfile *optimizer_profile;
     uint32_t next_func_version;
 
     _Py_GlobalMonitors monitors;
@@ -0,0 +1,33 @@
+#ifndef Py_INTERNAL_JIT_H
+#define Py_INTERNAL_JIT_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef Py_BUILD_CORE
+#  error "this header requires Py_BUILD_CORE define"
+#endif
+
+#include "pycore_uops.h"          // _PyUOpExecutorObject
+
+#ifdef _Py_JIT
+
+// Copy and patch the stencil of every uop in executor->trace into freshly
+// allocated executable memory.  On success, executor->base.execute is set to
+// _PyJIT_Execute.  Return 0 on success, or -1 with an exception set.
+extern int _PyJIT_Compile(_PyUOpExecutorObject *executor);
+
+// Release the machine code of an executor compiled by _PyJIT_Compile().
+extern void _PyJIT_Free(_PyUOpExecutorObject *executor);
+
+extern _PyInterpreterFrame *_PyJIT_Execute(
+    _PyExecutorObject *executor,
+    _PyInterpreterFrame *frame,
+    PyObject **stack_pointer);
+
+#endif  // _Py_JIT
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* !Py_INTERNAL_JIT_H */
@@ -10,6 +10,7 @@ extern "C" {
 
 
 extern PyObject* _PyList_Extend(PyListObject *, PyObject *);
+extern int _PyList_Contains(PyListObject *, PyObject *);
 extern void _PyList_DebugMallocStats(FILE *out);
 
 
@@ -308,6 +308,24 @@ _PyLong_SetDigitCount(PyLongObject *op, Py_ssize_t size)
 
 #define NON_SIZE_MASK ~((1 << NON_SIZE_BITS) - 1)
 
+/* Overwrite the value of the compact int `op` with `value`; nothing else may
+ * refer to `op`.  Return 0, leaving `op` alone, if `value` is a small int
+ * (those must stay singletons) or doesn't fit in a single digit. */
+static inline int
+_PyLong_SetCompactValueInPlace(PyLongObject *op, stwodigits value)
+{
+    assert(PyLong_CheckExact(op));
+    assert(_PyLong_IsCompact(op) && !_PyLong_IsZero(op));
+    if ((-_PY_NSMALLNEGINTS <= value && value < _PY_NSMALLPOSINTS) ||
+        value <= -(stwodigits)PyLong_BASE || value >= (stwodigits)PyLong_BASE)
+    {
+        return 0;
+    }
+    _PyLong_SetSignAndDigitCount(op, value < 0 ? -1 : 1, 1);
+    op->long_value.ob_digit[0] = (digit)(value < 0 ? -value : value);
+    return 1;
+}
+
 static inline void
 _PyLong_FlipSign(PyLongObject *op) {
     unsigned int flipped_sign = 2 - (op->long_value.lv_tag & SIGN_MASK);
@@ -288,6 +288,23 @@ struct arena_object {
     /* Singly-linked list of available pools. */
     struct pool_header* freepools;
 
+    /* The pools at the head of `freepools` whose memory may still be
+     * resident: first the `nfreshpools` pools freed since the last purge
+     * tick, then the `nstalepools` pools that were already free at that
+     * tick.  The stale pools are purged at the next tick (see
+     * purge_free_pools() in obmalloc.c), the pools after them are clean.
+     */
+    uint nfreshpools;
+    uint nstalepools;
+
+    /* Whether this arena_object is on the singly-linked `dirty_arenas`
+     * list, linked by `nextdirty`, of the arenas that may have fresh or
+     * stale pools.  The list may also hold arena_objects that no longer
+     * do, or that are unassociated: the next purge tick drops them.
+     */
+    uint isdirty;
+    struct arena_object* nextdirty;
+
     /* Whenever this arena_object is not associated with an allocated
      * arena, the nextarena member is used to link all unassociated
      * arena_objects in the singly-linked `unused_arena_objects` list.
@@ -501,6 +518,18 @@ struct _obmalloc_mgmt {
     /* High water mark (max value ever seen) for narenas_currently_allocated. */
     size_t narenas_highwater;
 
+    /* The arenas whose free pools the purge ticks look at. */
+    struct arena_object* dirty_arenas;
+    /* Number of pools freed since the last purge tick. */
+    uint npools_freed;
+    /* Total number of free pools whose memory was returned to the OS. */
+    size_t npools_purged;
+
+    /* Doubly-linked list of the free arenas of huge page chunks whose other
+     * arenas are not all free.
+     */
+    struct spare_arena* spare_arenas;
+
     Py_ssize_t raw_allocated_blocks;
 };
 
@@ -659,6 +688,8 @@ struct _obmalloc_usage {
 
 struct _obmalloc_global_state {
     int dump_debug_stats;
+    /* Allocate the arenas in huge page chunks, see alloc_arena() */
+    int use_hugepages;
     Py_ssize_t interpreter_leaks;
 };
 
@@ -680,6 +711,9 @@ void _PyObject_VirtualFree(void *, size_t size);
 
 /* This function returns the number of allocated memory blocks, regardless of size */
 extern Py_ssize_t _Py_GetGlobalAllocatedBlocks(void);
+/* Return the memory of the free pools to the OS, return the number of bytes
+   released */
+extern Py_ssize_t _PyObject_TrimFreePools(void);
 #define _Py_GetAllocatedBlocks() \
     _Py_GetGlobalAllocatedBlocks()
 extern Py_ssize_t _PyInterpreterState_GetAllocatedBlocks(PyInterpreterState *);
@@ -28,67 +28,80 @@
 #define _EXIT_TRACE 300
 #define _SET_IP 301
 #define _GUARD_BOTH_INT 302
-#define _BINARY_OP_MULTIPLY_INT 303
-#define _BINARY_OP_ADD_INT 304
-#define _BINARY_OP_SUBTRACT_INT 305
-#define _GUARD_BOTH_FLOAT 306
-#define _BINARY_OP_MULTIPLY_FLOAT 307
-#define _BINARY_OP_ADD_FLOAT 308
-#define _BINARY_OP_SUBTRACT_FLOAT 309
-#define _GUARD_BOTH_UNICODE 310
-#define _BINARY_OP_ADD_UNICODE 311
-#define _BINARY_OP_INPLACE_ADD_UNICODE 312
-#define _POP_FRAME 313
-#define _GUARD_GLOBALS_VERSION 314
-#define _GUARD_BUILTINS_VERSION 315
-#define _LOAD_GLOBAL_MODULE 316
-#define _LOAD_GLOBAL_BUILTINS 317
-#define _GUARD_TYPE_VERSION 318
-#define _CHECK_MANAGED_OBJECT_HAS_VALUES 319
-#define _LOAD_ATTR_INSTANCE_VALUE 320
-#define _CHECK_ATTR_MODULE 321
-#define _LOAD_ATTR_MODULE 322
-#define _CHECK_ATTR_WITH_HINT 323
-#define _LOAD_ATTR_WITH_HINT 324
-#define _LOAD_ATTR_SLOT 325
-#define _CHECK_ATTR_CLASS 326
-#define _LOAD_ATTR_CLASS 327
-#define _GUARD_DORV_VALUES 328
-#define _STORE_ATTR_INSTANCE_VALUE 329
-#define _STORE_ATTR_SLOT 330
-#define _IS_NONE 331
-#define _ITER_CHECK_LIST 332
-#define _ITER_JUMP_LIST 333
-#define _IS_ITER_EXHAUSTED_LIST 334
-#define _ITER_NEXT_LIST 335
-#define _ITER_CHECK_TUPLE 336
-#define _ITER_JUMP_TUPLE 337
-#define _IS_ITER_EXHAUSTED_TUPLE 338
-#define _ITER_NEXT_TUPLE 339
-#define _ITER_CHECK_RANGE 340
-#define _ITER_JUMP_RANGE 341
-#define _IS_ITER_EXHAUSTED_RANGE 342
-#define _ITER_NEXT_RANGE 343
-#define _GUARD_DORV_VALUES_INST_ATTR_FROM_DICT 344
-#define _GUARD_KEYS_VERSION 345
-#define _LOAD_ATTR_METHOD_WITH_VALUES 346
-#define _LOAD_ATTR_METHOD_NO_DICT 347
-#define _LOAD_ATTR_NONDESCRIPTOR_WITH_VALUES 348
-#define _LOAD_ATTR_NONDESCRIPTOR_NO_DICT 349
-#define _CHECK_ATTR_METHOD_LAZY_DICT 350
-#define _LOAD_ATTR_METHOD_LAZY_DICT 351
-#define _CHECK_CALL_BOUND_METHOD_EXACT_ARGS 352
-#define _INIT_CALL_BOUND_METHOD_EXACT_ARGS 353
-#define _CHECK_PEP_523 354
-#define _CHECK_FUNCTION_EXACT_ARGS 355
-#define _CHECK_STACK_SPACE 356
-#define _INIT_CALL_PY_EXACT_ARGS 357
-#define _PUSH_FRAME 358
-#define _POP_JUMP_IF_FALSE 359
-#define _POP_JUMP_IF_TRUE 360
-#define _JUMP_TO_TOP 361
-#define _SAVE_RETURN_OFFSET 362
-#define _INSERT 363
+#define _GUARD_NOS_INT 303
+#define _GUARD_TOS_INT 304
+#define _BINARY_OP_MULTIPLY_INT 305
+#define _BINARY_OP_ADD_INT 306
+#define _BINARY_OP_SUBTRACT_INT 307
+#define _BINARY_OP_INPLACE_ADD_INT 308
+#define _BINARY_OP_INPLACE_SUBTRACT_INT 309
+#define _GUARD_BOTH_FLOAT 310
+#define _GUARD_NOS_FLOAT 311
+#define _GUARD_TOS_FLOAT 312
+#define _BINARY_OP_MULTIPLY_FLOAT 313
+#define _BINARY_OP_ADD_FLOAT 314
+#define _BINARY_OP_SUBTRACT_FLOAT 315
+#define _BINARY_OP_INPLACE_MULTIPLY_FLOAT 316
+#define _BINARY_OP_INPLACE_ADD_FLOAT 317
+#define _BINARY_OP_INPLACE_SUBTRACT_FLOAT 318
+#define _GUARD_BOTH_UNICODE 319
+#define _BINARY_OP_ADD_UNICODE 320
+#define _BINARY_OP_INPLACE_ADD_UNICODE 321
+#define _POP_FRAME 322
+#define _GUARD_GLOBALS_VERSION 323
+#define _GUARD_BUILTINS_VERSION 324
+#define _LOAD_GLOBAL_MODULE 325
+#define _LOAD_GLOBAL_BUILTINS 326
+#define _GUARD_TYPE_VERSION 327
+#define _CHECK_MANAGED_OBJECT_HAS_VALUES 328
+#define _LOAD_ATTR_INSTANCE_VALUE 329
+#define _CHECK_ATTR_MODULE 330
+#define _LOAD_ATTR_MODULE 331
+#define _CHECK_ATTR_WITH_HINT 332
+#define _LOAD_ATTR_WITH_HINT 333
+#define _LOAD_ATTR_SLOT 334
+#define _CHECK_ATTR_CLASS 335
+#define _LOAD_ATTR_CLASS 336
+#define _GUARD_DORV_VALUES 337
+#define _STORE_ATTR_INSTANCE_VALUE 338
+#define _STORE_ATTR_SLOT 339
+#define _IS_NONE 340
+#define _ITER_CHECK_LIST 341
+#define _ITER_JUMP_LIST 342
+#define _IS_ITER_EXHAUSTED_LIST 343
+#define _ITER_NEXT_LIST 344
+#define _ITER_CHECK_TUPLE 345
+#define _ITER_JUMP_TUPLE 346
+#define _IS_ITER_EXHAUSTED_TUPLE 347
+#define _ITER_NEXT_TUPLE 348
+#define _ITER_CHECK_RANGE 349
+#define _ITER_JUMP_RANGE 350
+#define _IS_ITER_EXHAUSTED_RANGE 351
+#define _ITER_NEXT_RANGE 352
+#define _GUARD_DORV_VALUES_INST_ATTR_FROM_DICT 353
+#define _GUARD_KEYS_VERSION 354
+#define _LOAD_ATTR_METHOD_WITH_VALUES 355
+#define _LOAD_ATTR_METHOD_NO_DICT 356
+#define _LOAD_ATTR_NONDESCRIPTOR_WITH_VALUES 357
+#define _LOAD_ATTR_NONDESCRIPTOR_NO_DICT 358
+#define _CHECK_ATTR_METHOD_LAZY_DICT 359
+#define _LOAD_ATTR_METHOD_LAZY_DICT 360
+#define _CHECK_CALL_BOUND_METHOD_EXACT_ARGS 361
+#define _INIT_CALL_BOUND_METHOD_EXACT_ARGS 362
+#define _CHECK_PEP_523 363
+#define _CHECK_FUNCTION_EXACT_ARGS 364
+#define _CHECK_STACK_SPACE 365
+#define _INIT_CALL_PY_EXACT_ARGS 366
+#define _PUSH_FRAME 367
+#define _POP_JUMP_IF_FALSE 368
+#define _POP_JUMP_IF_TRUE 369
+#define _JUMP_TO_TOP 370
+#define _SAVE_RETURN_OFFSET 371
+#define _LOAD_CONST_INLINE_BORROW 372
+#define _POP_TWO_LOAD_CONST_INLINE_BORROW 373
+#define _POP_INLINED_CALL_UNDER_TOP 374
+#define _POP_INLINED_CALL_LOAD_CONST_INLINE 375
+#define _INSERT 376
 
 extern int _PyOpcode_num_popped(int opcode, int oparg, bool jump);
 #ifdef NEED_OPCODE_METADATA
@@ -156,6 +169,10 @@ int _PyOpcode_num_popped(int opcode, int oparg, bool jump)  {
             return 1;
         case _GUARD_BOTH_INT:
             return 2;
+        case _GUARD_NOS_INT:
+            return 2;
+        case _GUARD_TOS_INT:
+            return 1;
         case _BINARY_OP_MULTIPLY_INT:
             return 2;
         case _BINARY_OP_ADD_INT:
@@ -168,8 +185,16 @@ int _PyOpcode_num_popped(int opcode, int oparg, bool jump)  {
             return 2;
         case BINARY_OP_SUBTRACT_INT:
             return 2;
+        case _BINARY_OP_INPLACE_ADD_INT:
+            return 2;
+        case _BINARY_OP_INPLACE_SUBTRACT_INT:
+            return 2;
         case _GUARD_BOTH_FLOAT:
             return 2;
+        case _GUARD_NOS_FLOAT:
+            return 2;
+        case _GUARD_TOS_FLOAT:
+            return 1;
         case _BINARY_OP_MULTIPLY_FLOAT:
             return 2;
         case _BINARY_OP_ADD_FLOAT:
@@ -182,6 +207,12 @@ int _PyOpcode_num_popped(int opcode, int oparg, bool jump)  {
             return 2;
         case BINARY_OP_SUBTRACT_FLOAT:
             return 2;
+        case _BINARY_OP_INPLACE_MULTIPLY_FLOAT:
+            return 2;
+        case _BINARY_OP_INPLACE_ADD_FLOAT:
+            return 2;
+        case _BINARY_OP_INPLACE_SUBTRACT_FLOAT:
+            return 2;
         case _GUARD_BOTH_UNICODE:
             return 2;
         case _BINARY_OP_ADD_UNICODE:
@@ -420,6 +451,16 @@ int _PyOpcode_num_popped(int opcode, int oparg, bool jump)  {
             return 2;
         case CONTAINS_OP:
             return 2;
+        case CONTAINS_OP_DICT:
+            return 2;
+        case CONTAINS_OP_SET:
+            return 2;
+        case CONTAINS_OP_STR:
+            return 2;
+        case CONTAINS_OP_TUPLE:
+            return 2;
+        case CONTAINS_OP_LIST:
+            return 2;
         case CHECK_EG_MATCH:
             return 2;
         case CHECK_EXC_MATCH:
@@ -602,10 +643,14 @@ int _PyOpcode_num_popped(int opcode, int oparg, bool jump)  {
             return 0;
         case CALL_KW:
             return oparg + 3;
+        case CALL_KW_PY_EXACT_ARGS:
+            return oparg + 3;
         case INSTRUMENTED_CALL_FUNCTION_EX:
             return 0;
         case CALL_FUNCTION_EX:
             return ((oparg & 1) ? 1 : 0) + 3;
+        case CALL_FUNCTION_EX_PY:
+            return ((oparg & 1) ? 1 : 0) + 3;
         case MAKE_FUNCTION:
             return 1;
         case SET_FUNCTION_ATTRIBUTE:
@@ -658,6 +703,14 @@ int _PyOpcode_num_popped(int opcode, int oparg, bool jump)  {
             return 0;
         case _EXIT_TRACE:
             return 0;
+        case _LOAD_CONST_INLINE_BORROW:
+            return 0;
+        case _POP_TWO_LOAD_CONST_INLINE_BORROW:
+            return 2;
+        case _POP_INLINED_CALL_UNDER_TOP:
+            return oparg + 2;
+        case _POP_INLINED_CALL_LOAD_CONST_INLINE:
+            return oparg + 1;
         case _INSERT:
             return oparg + 1;
         default:
@@ -732,6 +785,10 @@ int _PyOpcode_num_pushed(int opcode, int oparg, bool jump)  {
             return 1;
         case _GUARD_BOTH_INT:
             return 2;
+        case _GUARD_NOS_INT:
+            return 2;
+        case _GUARD_TOS_INT:
+            return 1;
         case _BINARY_OP_MULTIPLY_INT:
             return 1;
         case _BINARY_OP_ADD_INT:
@@ -744,8 +801,16 @@ int _PyOpcode_num_pushed(int opcode, int oparg, bool jump)  {
             return 1;
         case BINARY_OP_SUBTRACT_INT:
             return 1;
+        case _BINARY_OP_INPLACE_ADD_INT:
+            return 0;
+        case _BINARY_OP_INPLACE_SUBTRACT_INT:
+            return 0;
         case _GUARD_BOTH_FLOAT:
             return 2;
+        case _GUARD_NOS_FLOAT:
+            return 2;
+        case _GUARD_TOS_FLOAT:
+            return 1;
         case _BINARY_OP_MULTIPLY_FLOAT:
             return 1;
         case _BINARY_OP_ADD_FLOAT:
@@ -758,6 +823,12 @@ int _PyOpcode_num_pushed(int opcode, int oparg, bool jump)  {
             return 1;
         case BINARY_OP_SUBTRACT_FLOAT:
             return 1;
+        case _BINARY_OP_INPLACE_MULTIPLY_FLOAT:
+            return 0;
+        case _BINARY_OP_INPLACE_ADD_FLOAT:
+            return 0;
+        case _BINARY_OP_INPLACE_SUBTRACT_FLOAT:
+            return 0;
         case _GUARD_BOTH_UNICODE:
             return 2;
         case _BINARY_OP_ADD_UNICODE:
@@ -996,6 +1067,16 @@ int _PyOpcode_num_pushed(int opcode, int oparg, bool jump)  {
             return 1;
         case CONTAINS_OP:
             return 1;
+        case CONTAINS_OP_DICT:
+            return 1;
+        case CONTAINS_OP_SET:
+            return 1;
+        case CONTAINS_OP_STR:
+            return 1;
+        case CONTAINS_OP_TUPLE:
+            return 1;
+        case CONTAINS_OP_LIST:
+            return 1;
         case CHECK_EG_MATCH:
             return 2;
         case CHECK_EXC_MATCH:
@@ -1178,10 +1259,14 @@ int _PyOpcode_num_pushed(int opcode, int oparg, bool jump)  {
             return 0;
         case CALL_KW:
             return 1;
+        case CALL_KW_PY_EXACT_ARGS:
+            return 1;
         case INSTRUMENTED_CALL_FUNCTION_EX:
             return 0;
         case CALL_FUNCTION_EX:
             return 1;
+        case CALL_FUNCTION_EX_PY:
+            return 1;
         case MAKE_FUNCTION:
             return 1;
         case SET_FUNCTION_ATTRIBUTE:
@@ -1234,6 +1319,14 @@ int _PyOpcode_num_pushed(int opcode, int oparg, bool jump)  {
             return 0;
         case _EXIT_TRACE:
             return 0;
+        case _LOAD_CONST_INLINE_BORROW:
+            return 1;
+        case _POP_TWO_LOAD_CONST_INLINE_BORROW:
+            return 1;
+        case _POP_INLINED_CALL_UNDER_TOP:
+            return 1;
+        case _POP_INLINED_CALL_LOAD_CONST_INLINE:
+            return 1;
         case _INSERT:
             return oparg + 1;
         default:
@@ -1340,19 +1433,28 @@ const struct opcode_metadata _PyOpcode_opcode_metadata[OPCODE_METADATA_SIZE] = {
     [TO_BOOL_ALWAYS_TRUE] = { true, INSTR_FMT_IXC00, HAS_DEOPT_FLAG },
     [UNARY_INVERT] = { true, INSTR_FMT_IX, HAS_ERROR_FLAG },
     [_GUARD_BOTH_INT] = { true, INSTR_FMT_IX, HAS_DEOPT_FLAG },
+    [_GUARD_NOS_INT] = { true, INSTR_FMT_IX, HAS_DEOPT_FLAG },
+    [_GUARD_TOS_INT] = { true, INSTR_FMT_IX, HAS_DEOPT_FLAG },
     [_BINARY_OP_MULTIPLY_INT] = { true, INSTR_FMT_IXC, HAS_ERROR_FLAG },
     [_BINARY_OP_ADD_INT] = { true, INSTR_FMT_IXC, HAS_ERROR_FLAG },
     [_BINARY_OP_SUBTRACT_INT] = { true, INSTR_FMT_IXC, HAS_ERROR_FLAG },
     [BINARY_OP_MULTIPLY_INT] = { true, INSTR_FMT_IXC, HAS_DEOPT_FLAG | HAS_ERROR_FLAG },
     [BINARY_OP_ADD_INT] = { true, INSTR_FMT_IXC, HAS_DEOPT_FLAG | HAS_ERROR_FLAG },
     [BINARY_OP_SUBTRACT_INT] = { true, INSTR_FMT_IXC, HAS_DEOPT_FLAG | HAS_ERROR_FLAG },
+    [_BINARY_OP_INPLACE_ADD_INT] = { true, INSTR_FMT_IBC, HAS_ARG_FLAG | HAS_LOCAL_FLAG | HAS_ERROR_FLAG },
+    [_BINARY_OP_INPLACE_SUBTRACT_INT] = { true, INSTR_FMT_IBC, HAS_ARG_FLAG | HAS_LOCAL_FLAG | HAS_ERROR_FLAG },
     [_GUARD_BOTH_FLOAT] = { true, INSTR_FMT_IX, HAS_DEOPT_FLAG },
+    [_GUARD_NOS_FLOAT] = { true, INSTR_FMT_IX, HAS_DEOPT_FLAG },
+    [_GUARD_TOS_FLOAT] = { true, INSTR_FMT_IX, HAS_DEOPT_FLAG },
     [_BINARY_OP_MULTIPLY_FLOAT] = { true, INSTR_FMT_IXC, 0 },
     [_BINARY_OP_ADD_FLOAT] = { true, INSTR_FMT_IXC, 0 },
     [_BINARY_OP_SUBTRACT_FLOAT] = { true, INSTR_FMT_IXC, 0 },
     [BINARY_OP_MULTIPLY_FLOAT] = { true, INSTR_FMT_IXC, HAS_DEOPT_FLAG },
     [BINARY_OP_ADD_FLOAT] = { true, INSTR_FMT_IXC, HAS_DEOPT_FLAG },
     [BINARY_OP_SUBTRACT_FLOAT] = { true, INSTR_FMT_IXC, HAS_DEOPT_FLAG },
+    [_BINARY_OP_INPLACE_MULTIPLY_FLOAT] = { true, INSTR_FMT_IBC, HAS_ARG_FLAG },
+    [_BINARY_OP_INPLACE_ADD_FLOAT] = { true, INSTR_FMT_IBC, HAS_ARG_FLAG },
+    [_BINARY_OP_INPLACE_SUBTRACT_FLOAT] = { true, INSTR_FMT_IBC, HAS_ARG_FLAG },
     [_GUARD_BOTH_UNICODE] = { true, INSTR_FMT_IX, HAS_DEOPT_FLAG },
     [_BINARY_OP_ADD_UNICODE] = { true, INSTR_FMT_IXC, HAS_ERROR_FLAG },
     [BINARY_OP_ADD_UNICODE] = { true, INSTR_FMT_IXC, HAS_DEOPT_FLAG | HAS_ERROR_FLAG },
@@ -1471,7 +1573,12 @@ const struct opcode_metadata _PyOpcode_opcode_metadata[OPCODE_METADATA_SIZE] = {
     [COMPARE_OP_INT] = { true, INSTR_FMT_IBC, HAS_ARG_FLAG | HAS_DEOPT_FLAG },
     [COMPARE_OP_STR] = { true, INSTR_FMT_IBC, HAS_ARG_FLAG | HAS_DEOPT_FLAG },
     [IS_OP] = { true, INSTR_FMT_IB, HAS_ARG_FLAG },
-    [CONTAINS_OP] = { true, INSTR_FMT_IB, HAS_ARG_FLAG | HAS_ERROR_FLAG },
+    [CONTAINS_OP] = { true, INSTR_FMT_IBC, HAS_ARG_FLAG | HAS_ERROR_FLAG },
+    [CONTAINS_OP_DICT] = { true, INSTR_FMT_IBC, HAS_ARG_FLAG | HAS_DEOPT_FLAG | HAS_ERROR_FLAG },
+    [CONTAINS_OP_SET] = { true, INSTR_FMT_IBC, HAS_ARG_FLAG | HAS_DEOPT_FLAG | HAS_ERROR_FLAG },
+    [CONTAINS_OP_STR] = { true, INSTR_FMT_IBC, HAS_ARG_FLAG | HAS_DEOPT_FLAG | HAS_ERROR_FLAG },
+    [CONTAINS_OP_TUPLE] = { true, INSTR_FMT_IBC, HAS_ARG_FLAG | HAS_DEOPT_FLAG | HAS_ERROR_FLAG },
+    [CONTAINS_OP_LIST] = { true, INSTR_FMT_IBC, HAS_ARG_FLAG | HAS_DEOPT_FLAG | HAS_ERROR_FLAG },
     [CHECK_EG_MATCH] = { true, INSTR_FMT_IX, HAS_ERROR_FLAG },
     [CHECK_EXC_MATCH] = { true, INSTR_FMT_IX, HAS_ERROR_FLAG },
     [IMPORT_NAME] = { true, INSTR_FMT_IB, HAS_ARG_FLAG | HAS_NAME_FLAG | HAS_ERROR_FLAG },
@@ -1562,9 +1669,11 @@ const struct opcode_metadata _PyOpcode_opcode_metadata[OPCODE_METADATA_SIZE] = {
     [CALL_METHOD_DESCRIPTOR_NOARGS] = { true, INSTR_FMT_IBC00, HAS_ARG_FLAG | HAS_EVAL_BREAK_FLAG | HAS_DEOPT_FLAG | HAS_ERROR_FLAG },
     [CALL_METHOD_DESCRIPTOR_FAST] = { true, INSTR_FMT_IBC00, HAS_ARG_FLAG | HAS_EVAL_BREAK_FLAG | HAS_DEOPT_FLAG | HAS_ERROR_FLAG },
     [INSTRUMENTED_CALL_KW] = { true, INSTR_FMT_IB, HAS_ARG_FLAG | HAS_ERROR_FLAG },
-    [CALL_KW] = { true, INSTR_FMT_IB, HAS_ARG_FLAG | HAS_EVAL_BREAK_FLAG | HAS_ERROR_FLAG },
+    [CALL_KW] = { true, INSTR_FMT_IBC00, HAS_ARG_FLAG | HAS_EVAL_BREAK_FLAG | HAS_ERROR_FLAG },
+    [CALL_KW_PY_EXACT_ARGS] = { true, INSTR_FMT_IBC00, HAS_ARG_FLAG | HAS_DEOPT_FLAG },
     [INSTRUMENTED_CALL_FUNCTION_EX] = { true, INSTR_FMT_IX, 0 },
-    [CALL_FUNCTION_EX] = { true, INSTR_FMT_IB, HAS_ARG_FLAG | HAS_EVAL_BREAK_FLAG | HAS_ERROR_FLAG },
+    [CALL_FUNCTION_EX] = { true, INSTR_FMT_IBC, HAS_ARG_FLAG | HAS_EVAL_BREAK_FLAG | HAS_ERROR_FLAG },
+    [CALL_FUNCTION_EX_PY] = { true, INSTR_FMT_IBC, HAS_ARG_FLAG | HAS_DEOPT_FLAG | HAS_ERROR_FLAG },
     [MAKE_FUNCTION] = { true, INSTR_FMT_IX, HAS_ERROR_FLAG },
     [SET_FUNCTION_ATTRIBUTE] = { true, INSTR_FMT_IB, HAS_ARG_FLAG },
     [RETURN_GENERATOR] = { true, INSTR_FMT_IX, HAS_ERROR_FLAG },
@@ -1591,6 +1700,10 @@ const struct opcode_metadata _PyOpcode_opcode_metadata[OPCODE_METADATA_SIZE] = {
     [_SET_IP] = { true, INSTR_FMT_IB, HAS_ARG_FLAG },
     [_SAVE_RETURN_OFFSET] = { true, INSTR_FMT_IB, HAS_ARG_FLAG },
     [_EXIT_TRACE] = { true, INSTR_FMT_IX, 0 },
+    [_LOAD_CONST_INLINE_BORROW] = { true, INSTR_FMT_IXC000, 0 },
+    [_POP_TWO_LOAD_CONST_INLINE_BORROW] = { true, INSTR_FMT_IXC000, 0 },
+    [_POP_INLINED_CALL_UNDER_TOP] = { true, INSTR_FMT_IB, HAS_ARG_FLAG },
+    [_POP_INLINED_CALL_LOAD_CONST_INLINE] = { true, INSTR_FMT_IBC000, HAS_ARG_FLAG },
     [_INSERT] = { true, INSTR_FMT_IB, HAS_ARG_FLAG },
 };
 #endif // NEED_OPCODE_METADATA
@@ -1703,6 +1816,11 @@ const struct opcode_macro_expansion _PyOpcode_macro_expansion[OPCODE_MACRO_EXPAN
     [COMPARE_OP_STR] = { .nuops = 1, .uops = { { COMPARE_OP_STR, 0, 0 } } },
     [IS_OP] = { .nuops = 1, .uops = { { IS_OP, 0, 0 } } },
     [CONTAINS_OP] = { .nuops = 1, .uops = { { CONTAINS_OP, 0, 0 } } },
+    [CONTAINS_OP_DICT] = { .nuops = 1, .uops = { { CONTAINS_OP_DICT, 0, 0 } } },
+    [CONTAINS_OP_SET] = { .nuops = 1, .uops = { { CONTAINS_OP_SET, 0, 0 } } },
+    [CONTAINS_OP_STR] = { .nuops = 1, .uops = { { CONTAINS_OP_STR, 0, 0 } } },
+    [CONTAINS_OP_TUPLE] = { .nuops = 1, .uops = { { CONTAINS_OP_TUPLE, 0, 0 } } },
+    [CONTAINS_OP_LIST] = { .nuops = 1, .uops = { { CONTAINS_OP_LIST, 0, 0 } } },
     [CHECK_EG_MATCH] = { .nuops = 1, .uops = { { CHECK_EG_MATCH, 0, 0 } } },
     [CHECK_EXC_MATCH] = { .nuops = 1, .uops = { { CHECK_EXC_MATCH, 0, 0 } } },
     [GET_LEN] = { .nuops = 1, .uops = { { GET_LEN, 0, 0 } } },
@@ -1753,13 +1871,22 @@ const char * const _PyOpcode_uop_name[OPCODE_UOP_NAME_SIZE] = {
     [_EXIT_TRACE] = "_EXIT_TRACE",
     [_SET_IP] = "_SET_IP",
     [_GUARD_BOTH_INT] = "_GUARD_BOTH_INT",
+    [_GUARD_NOS_INT] = "_GUARD_NOS_INT",
+    [_GUARD_TOS_INT] = "_GUARD_TOS_INT",
     [_BINARY_OP_MULTIPLY_INT] = "_BINARY_OP_MULTIPLY_INT",
     [_BINARY_OP_ADD_INT] = "_BINARY_OP_ADD_INT",
     [_BINARY_OP_SUBTRACT_INT] = "_BINARY_OP_SUBTRACT_INT",
+    [_BINARY_OP_INPLACE_ADD_INT] = "_BINARY_OP_INPLACE_ADD_INT",
+    [_BINARY_OP_INPLACE_SUBTRACT_INT] = "_BINARY_OP_INPLACE_SUBTRACT_INT",
     [_GUARD_BOTH_FLOAT] = "_GUARD_BOTH_FLOAT",
+    [_GUARD_NOS_FLOAT] = "_GUARD_NOS_FLOAT",
+    [_GUARD_TOS_FLOAT] = "_GUARD_TOS_FLOAT",
     [_BINARY_OP_MULTIPLY_FLOAT] = "_BINARY_OP_MULTIPLY_FLOAT",
     [_BINARY_OP_ADD_FLOAT] = "_BINARY_OP_ADD_FLOAT",
     [_BINARY_OP_SUBTRACT_FLOAT] = "_BINARY_OP_SUBTRACT_FLOAT",
+    [_BINARY_OP_INPLACE_MULTIPLY_FLOAT] = "_BINARY_OP_INPLACE_MULTIPLY_FLOAT",
+    [_BINARY_OP_INPLACE_ADD_FLOAT] = "_BINARY_OP_INPLACE_ADD_FLOAT",
+    [_BINARY_OP_INPLACE_SUBTRACT_FLOAT] = "_BINARY_OP_INPLACE_SUBTRACT_FLOAT",
     [_GUARD_BOTH_UNICODE] = "_GUARD_BOTH_UNICODE",
     [_BINARY_OP_ADD_UNICODE] = "_BINARY_OP_ADD_UNICODE",
     [_BINARY_OP_INPLACE_ADD_UNICODE] = "_BINARY_OP_INPLACE_ADD_UNICODE",
@@ -1813,6 +1940,10 @@ const char * const _PyOpcode_uop_name[OPCODE_UOP_NAME_SIZE] = {
     [_POP_JUMP_IF_TRUE] = "_POP_JUMP_IF_TRUE",
     [_JUMP_TO_TOP] = "_JUMP_TO_TOP",
     [_SAVE_RETURN_OFFSET] = "_SAVE_RETURN_OFFSET",
+    [_LOAD_CONST_INLINE_BORROW] = "_LOAD_CONST_INLINE_BORROW",
+    [_POP_TWO_LOAD_CONST_INLINE_BORROW] = "_POP_TWO_LOAD_CONST_INLINE_BORROW",
+    [_POP_INLINED_CALL_UNDER_TOP] = "_POP_INLINED_CALL_UNDER_TOP",
+    [_POP_INLINED_CALL_LOAD_CONST_INLINE] = "_POP_INLINED_CALL_LOAD_CONST_INLINE",
     [_INSERT] = "_INSERT",
 };
 #endif // NEED_OPCODE_METADATA
@@ -1958,7 +2089,9 @@ const char *const _PyOpcode_OpName[268] = {
     [CALL_BUILTIN_FAST] = "CALL_BUILTIN_FAST",
     [CALL_BUILTIN_FAST_WITH_KEYWORDS] = "CALL_BUILTIN_FAST_WITH_KEYWORDS",
     [CALL_BUILTIN_O] = "CALL_BUILTIN_O",
+    [CALL_FUNCTION_EX_PY] = "CALL_FUNCTION_EX_PY",
     [CALL_ISINSTANCE] = "CALL_ISINSTANCE",
+    [CALL_KW_PY_EXACT_ARGS] = "CALL_KW_PY_EXACT_ARGS",
     [CALL_LEN] = "CALL_LEN",
     [CALL_LIST_APPEND] = "CALL_LIST_APPEND",
     [CALL_METHOD_DESCRIPTOR_FAST] = "CALL_METHOD_DESCRIPTOR_FAST",
@@ -1973,6 +2106,11 @@ const char *const _PyOpcode_OpName[268] = {
     [COMPARE_OP_FLOAT] = "COMPARE_OP_FLOAT",
     [COMPARE_OP_INT] = "COMPARE_OP_INT",
     [COMPARE_OP_STR] = "COMPARE_OP_STR",
+    [CONTAINS_OP_DICT] = "CONTAINS_OP_DICT",
+    [CONTAINS_OP_LIST] = "CONTAINS_OP_LIST",
+    [CONTAINS_OP_SET] = "CONTAINS_OP_SET",
+    [CONTAINS_OP_STR] = "CONTAINS_OP_STR",
+    [CONTAINS_OP_TUPLE] = "CONTAINS_OP_TUPLE",
     [FOR_ITER_GEN] = "FOR_ITER_GEN",
     [FOR_ITER_LIST] = "FOR_ITER_LIST",
     [FOR_ITER_RANGE] = "FOR_ITER_RANGE",
@@ -2056,12 +2194,15 @@ const uint8_t _PyOpcode_Caches[256] = {
     [LOAD_SUPER_ATTR] = 1,
     [LOAD_ATTR] = 9,
     [COMPARE_OP] = 1,
+    [CONTAINS_OP] = 1,
     [POP_JUMP_IF_FALSE] = 1,
     [POP_JUMP_IF_TRUE] = 1,
     [POP_JUMP_IF_NONE] = 1,
     [POP_JUMP_IF_NOT_NONE] = 1,
     [FOR_ITER] = 1,
     [CALL] = 3,
+    [CALL_KW] = 3,
+    [CALL_FUNCTION_EX] = 1,
     [BINARY_OP] = 1,
     [JUMP_BACKWARD] = 1,
 };
@@ -2104,10 +2245,12 @@ const uint8_t _PyOpcode_Deopt[256] = {
     [CALL_BUILTIN_FAST_WITH_KEYWORDS] = CALL,
     [CALL_BUILTIN_O] = CALL,
     [CALL_FUNCTION_EX] = CALL_FUNCTION_EX,
+    [CALL_FUNCTION_EX_PY] = CALL_FUNCTION_EX,
     [CALL_INTRINSIC_1] = CALL_INTRINSIC_1,
     [CALL_INTRINSIC_2] = CALL_INTRINSIC_2,
     [CALL_ISINSTANCE] = CALL,
     [CALL_KW] = CALL_KW,
+    [CALL_KW_PY_EXACT_ARGS] = CALL_KW,
     [CALL_LEN] = CALL,
     [CALL_LIST_APPEND] = CALL,
     [CALL_METHOD_DESCRIPTOR_FAST] = CALL,
@@ -2127,6 +2270,11 @@ const uint8_t _PyOpcode_Deopt[256] = {
     [COMPARE_OP_INT] = COMPARE_OP,
     [COMPARE_OP_STR] = COMPARE_OP,
     [CONTAINS_OP] = CONTAINS_OP,
+    [CONTAINS_OP_DICT] = CONTAINS_OP,
+    [CONTAINS_OP_LIST] = CONTAINS_OP,
+    [CONTAINS_OP_SET] = CONTAINS_OP,
+    [CONTAINS_OP_STR] = CONTAINS_OP,
+    [CONTAINS_OP_TUPLE] = CONTAINS_OP,
     [CONVERT_VALUE] = CONVERT_VALUE,
     [COPY] = COPY,
     [COPY_FREE_VARS] = COPY_FREE_VARS,
@@ -2312,13 +2460,6 @@ const uint8_t _PyOpcode_Deopt[256] = {
     case 146: \
     case 147: \
     case 148: \
-    case 219: \
-    case 220: \
-    case 221: \
-    case 222: \
-    case 223: \
-    case 224: \
-    case 225: \
     case 226: \
     case 227: \
     case 228: \
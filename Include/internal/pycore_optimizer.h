@@ -13,6 +13,35 @@ extern "C" {
 int _Py_uop_analyze_and_optimize(PyCodeObject *code,
     _PyUOpInstruction *trace, int trace_len, int curr_stackentries);
 
+// Number of times a side exit must be taken before it gets its own executor.
+#define _Py_SIDE_EXIT_THRESHOLD 16
+
+// Called by an executor when it leaves the trace at uop `index`, after it has
+// saved the stack pointer in `frame`.  If the exit is hot, trace from
+// frame->instr_ptr and link the new executor to the exit.  Return 1 and set
+// *exit_ptr to a new reference to the executor to continue in, 0 to continue
+// in tier 1, or -1 with an exception set.
+extern int _PyOptimizer_SideExit(
+    _PyUOpExecutorObject *executor, int index,
+    _PyInterpreterFrame *frame, _PyExecutorObject **exit_ptr);
+
+// Give a new executor a symbol for the Linux perf profiler, if a perf
+// trampoline is active (see perf_trampoline.c).
+extern void _PyPerfTrampoline_RegisterExecutor(
+    _PyUOpExecutorObject *executor, PyCodeObject *code, _Py_CODEUNIT *instr);
+
+// Persistent optimizer profiles (-X optprofile=PATH), see optimizer_profile.c.
+// Init loads the profile at PATH, Fini saves it and frees it.
+extern int _PyOptimizer_InitProfile(PyInterpreterState *interp,
+                                    const wchar_t *path);
+extern void _PyOptimizer_FiniProfile(PyInterpreterState *interp);
+// Remember the hot loops, branches and specializations of `code`.
+extern void _PyOptimizer_RecordProfile(PyCodeObject *code);
+// Same, for a quickened code object that is being deallocated.
+extern void _PyOptimizer_ForgetCode(PyCodeObject *code);
+// Prime the counters of a newly quickened code object from the profile.
+extern void _PyOptimizer_ApplyProfile(PyCodeObject *code);
+
 
 #ifdef __cplusplus
 }
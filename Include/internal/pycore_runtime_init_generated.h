@@ -971,6 +971,7 @@ extern "C" {
     INIT_ID(ident), \
     INIT_ID(ignore), \
     INIT_ID(imag), \
+    INIT_ID(immortal), \
     INIT_ID(importlib), \
     INIT_ID(in_fd), \
     INIT_ID(incoming), \
@@ -18,6 +18,8 @@ PyAPI_FUNC(int) _PySet_NextEntry(
 // Export for '_pickle' shared extension
 PyAPI_FUNC(int) _PySet_Update(PyObject *set, PyObject *iterable);
 
+extern int _PySet_Contains(PySetObject *so, PyObject *key);
+
 // Export for the gdb plugin's (python-gdb.py) benefit
 PyAPI_DATA(PyObject *) _PySet_Dummy;
 
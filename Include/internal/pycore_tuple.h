@@ -9,6 +9,7 @@ extern "C" {
 #endif
 
 extern void _PyTuple_MaybeUntrack(PyObject *);
+extern int _PyTuple_Contains(PyTupleObject *, PyObject *);
 extern void _PyTuple_DebugMallocStats(FILE *out);
 
 /* runtime lifecycle */
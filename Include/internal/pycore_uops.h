@@ -18,8 +18,25 @@ typedef struct {
     uint64_t operand;  // A cache entry
 } _PyUOpInstruction;
 
+// Per-uop bookkeeping for the places where an executor exits to tier 1
+// (a failed DEOPT_IF or an _EXIT_TRACE).  See _PyOptimizer_SideExit().
+typedef struct {
+    uint16_t temperature;  // How often the exit was taken since last attempt
+    uint16_t backoff;      // Log2 of the threshold multiplier after failures
+    _PyExecutorObject *executor;  // The side exit executor, or NULL
+} _PyExitData;
+
 typedef struct {
     _PyExecutorObject base;
+    _PyExitData *exits;  // One per uop in trace, allocated on first exit
+#ifdef _Py_JIT
+    unsigned char *jit_code;  // Machine code, or NULL if not compiled
+    size_t jit_size;
+#endif
+#ifdef PY_HAVE_PERF_TRAMPOLINE
+    void *perf_trampoline;  // See _PyPerfTrampoline_RegisterExecutor()
+    unsigned int perf_generation;
+#endif
     _PyUOpInstruction trace[1];
 } _PyUOpExecutorObject;
 
@@ -149,57 +149,64 @@ extern "C" {
 #define CALL_BUILTIN_FAST                      165
 #define CALL_BUILTIN_FAST_WITH_KEYWORDS        166
 #define CALL_BUILTIN_O                         167
-#define CALL_ISINSTANCE                        168
-#define CALL_LEN                               169
-#define CALL_LIST_APPEND                       170
-#define CALL_METHOD_DESCRIPTOR_FAST            171
-#define CALL_METHOD_DESCRIPTOR_FAST_WITH_KEYWORDS 172
-#define CALL_METHOD_DESCRIPTOR_NOARGS          173
-#define CALL_METHOD_DESCRIPTOR_O               174
-#define CALL_PY_EXACT_ARGS                     175
-#define CALL_PY_WITH_DEFAULTS                  176
-#define CALL_STR_1                             177
-#define CALL_TUPLE_1                           178
-#define CALL_TYPE_1                            179
-#define COMPARE_OP_FLOAT                       180
-#define COMPARE_OP_INT                         181
-#define COMPARE_OP_STR                         182
-#define FOR_ITER_GEN                           183
-#define FOR_ITER_LIST                          184
-#define FOR_ITER_RANGE                         185
-#define FOR_ITER_TUPLE                         186
-#define LOAD_ATTR_CLASS                        187
-#define LOAD_ATTR_GETATTRIBUTE_OVERRIDDEN      188
-#define LOAD_ATTR_INSTANCE_VALUE               189
-#define LOAD_ATTR_METHOD_LAZY_DICT             190
-#define LOAD_ATTR_METHOD_NO_DICT               191
-#define LOAD_ATTR_METHOD_WITH_VALUES           192
-#define LOAD_ATTR_MODULE                       193
-#define LOAD_ATTR_NONDESCRIPTOR_NO_DICT        194
-#define LOAD_ATTR_NONDESCRIPTOR_WITH_VALUES    195
-#define LOAD_ATTR_PROPERTY                     196
-#define LOAD_ATTR_SLOT                         197
-#define LOAD_ATTR_WITH_HINT                    198
-#define LOAD_GLOBAL_BUILTIN                    199
-#define LOAD_GLOBAL_MODULE                     200
-#define LOAD_SUPER_ATTR_ATTR                   201
-#define LOAD_SUPER_ATTR_METHOD                 202
-#define RESUME_CHECK                           203
-#define SEND_GEN                               204
-#define STORE_ATTR_INSTANCE_VALUE              205
-#define STORE_ATTR_SLOT                        206
-#define STORE_ATTR_WITH_HINT                   207
-#define STORE_SUBSCR_DICT                      208
-#define STORE_SUBSCR_LIST_INT                  209
-#define TO_BOOL_ALWAYS_TRUE                    210
-#define TO_BOOL_BOOL                           211
-#define TO_BOOL_INT                            212
-#define TO_BOOL_LIST                           213
-#define TO_BOOL_NONE                           214
-#define TO_BOOL_STR                            215
-#define UNPACK_SEQUENCE_LIST                   216
-#define UNPACK_SEQUENCE_TUPLE                  217
-#define UNPACK_SEQUENCE_TWO_TUPLE              218
+#define CALL_FUNCTION_EX_PY                    168
+#define CALL_ISINSTANCE                        169
+#define CALL_KW_PY_EXACT_ARGS                  170
+#define CALL_LEN                               171
+#define CALL_LIST_APPEND                       172
+#define CALL_METHOD_DESCRIPTOR_FAST            173
+#define CALL_METHOD_DESCRIPTOR_FAST_WITH_KEYWORDS 174
+#define CALL_METHOD_DESCRIPTOR_NOARGS          175
+#define CALL_METHOD_DESCRIPTOR_O               176
+#define CALL_PY_EXACT_ARGS                     177
+#define CALL_PY_WITH_DEFAULTS                  178
+#define CALL_STR_1                             179
+#define CALL_TUPLE_1                           180
+#define CALL_TYPE_1                            181
+#define COMPARE_OP_FLOAT                       182
+#define COMPARE_OP_INT                         183
+#define COMPARE_OP_STR                         184
+#define CONTAINS_OP_DICT                       185
+#define CONTAINS_OP_LIST                       186
+#define CONTAINS_OP_SET                        187
+#define CONTAINS_OP_STR                        188
+#define CONTAINS_OP_TUPLE                      189
+#define FOR_ITER_GEN                           190
+#define FOR_ITER_LIST                          191
+#define FOR_ITER_RANGE                         192
+#define FOR_ITER_TUPLE                         193
+#define LOAD_ATTR_CLASS                        194
+#define LOAD_ATTR_GETATTRIBUTE_OVERRIDDEN      195
+#define LOAD_ATTR_INSTANCE_VALUE               196
+#define LOAD_ATTR_METHOD_LAZY_DICT             197
+#define LOAD_ATTR_METHOD_NO_DICT               198
+#define LOAD_ATTR_METHOD_WITH_VALUES           199
+#define LOAD_ATTR_MODULE                       200
+#define LOAD_ATTR_NONDESCRIPTOR_NO_DICT        201
+#define LOAD_ATTR_NONDESCRIPTOR_WITH_VALUES    202
+#define LOAD_ATTR_PROPERTY                     203
+#define LOAD_ATTR_SLOT                         204
+#define LOAD_ATTR_WITH_HINT                    205
+#define LOAD_GLOBAL_BUILTIN                    206
+#define LOAD_GLOBAL_MODULE                     207
+#define LOAD_SUPER_ATTR_ATTR                   208
+#define LOAD_SUPER_ATTR_METHOD                 209
+#define RESUME_CHECK                           210
+#define SEND_GEN                               211
+#define STORE_ATTR_INSTANCE_VALUE              212
+#define STORE_ATTR_SLOT                        213
+#define STORE_ATTR_WITH_HINT                   214
+#define STORE_SUBSCR_DICT                      215
+#define STORE_SUBSCR_LIST_INT                  216
+#define TO_BOOL_ALWAYS_TRUE                    217
+#define TO_BOOL_BOOL                           218
+#define TO_BOOL_INT                            219
+#define TO_BOOL_LIST                           220
+#define TO_BOOL_NONE                           221
+#define TO_BOOL_STR                            222
+#define UNPACK_SEQUENCE_LIST                   223
+#define UNPACK_SEQUENCE_TUPLE                  224
+#define UNPACK_SEQUENCE_TWO_TUPLE              225
 #define MIN_INSTRUMENTED_OPCODE                236
 #define INSTRUMENTED_RESUME                    236
 #define INSTRUMENTED_END_FOR                   237
@@ -75,6 +75,13 @@ _specializations = {
         "COMPARE_OP_INT",
         "COMPARE_OP_STR",
     ],
+    "CONTAINS_OP": [
+        "CONTAINS_OP_DICT",
+        "CONTAINS_OP_SET",
+        "CONTAINS_OP_STR",
+        "CONTAINS_OP_TUPLE",
+        "CONTAINS_OP_LIST",
+    ],
     "FOR_ITER": [
         "FOR_ITER_LIST",
         "FOR_ITER_TUPLE",
@@ -101,6 +108,12 @@ _specializations = {
         "CALL_METHOD_DESCRIPTOR_FAST",
         "CALL_ALLOC_AND_ENTER_INIT",
     ],
+    "CALL_KW": [
+        "CALL_KW_PY_EXACT_ARGS",
+    ],
+    "CALL_FUNCTION_EX": [
+        "CALL_FUNCTION_EX_PY",
+    ],
 }
 
 # An irregular case:
@@ -126,57 +139,64 @@ _specialized_opmap = {
     'CALL_BUILTIN_FAST': 165,
     'CALL_BUILTIN_FAST_WITH_KEYWORDS': 166,
     'CALL_BUILTIN_O': 167,
-    'CALL_ISINSTANCE': 168,
-    'CALL_LEN': 169,
-    'CALL_LIST_APPEND': 170,
-    'CALL_METHOD_DESCRIPTOR_FAST': 171,
-    'CALL_METHOD_DESCRIPTOR_FAST_WITH_KEYWORDS': 172,
-    'CALL_METHOD_DESCRIPTOR_NOARGS': 173,
-    'CALL_METHOD_DESCRIPTOR_O': 174,
-    'CALL_PY_EXACT_ARGS': 175,
-    'CALL_PY_WITH_DEFAULTS': 176,
-    'CALL_STR_1': 177,
-    'CALL_TUPLE_1': 178,
-    'CALL_TYPE_1': 179,
-    'COMPARE_OP_FLOAT': 180,
-    'COMPARE_OP_INT': 181,
-    'COMPARE_OP_STR': 182,
-    'FOR_ITER_GEN': 183,
-    'FOR_ITER_LIST': 184,
-    'FOR_ITER_RANGE': 185,
-    'FOR_ITER_TUPLE': 186,
-    'LOAD_ATTR_CLASS': 187,
-    'LOAD_ATTR_GETATTRIBUTE_OVERRIDDEN': 188,
-    'LOAD_ATTR_INSTANCE_VALUE': 189,
-    'LOAD_ATTR_METHOD_LAZY_DICT': 190,
-    'LOAD_ATTR_METHOD_NO_DICT': 191,
-    'LOAD_ATTR_METHOD_WITH_VALUES': 192,
-    'LOAD_ATTR_MODULE': 193,
-    'LOAD_ATTR_NONDESCRIPTOR_NO_DICT': 194,
-    'LOAD_ATTR_NONDESCRIPTOR_WITH_VALUES': 195,
-    'LOAD_ATTR_PROPERTY': 196,
-    'LOAD_ATTR_SLOT': 197,
-    'LOAD_ATTR_WITH_HINT': 198,
-    'LOAD_GLOBAL_BUILTIN': 199,
-    'LOAD_GLOBAL_MODULE': 200,
-    'LOAD_SUPER_ATTR_ATTR': 201,
-    'LOAD_SUPER_ATTR_METHOD': 202,
-    'RESUME_CHECK': 203,
-    'SEND_GEN': 204,
-    'STORE_ATTR_INSTANCE_VALUE': 205,
-    'STORE_ATTR_SLOT': 206,
-    'STORE_ATTR_WITH_HINT': 207,
-    'STORE_SUBSCR_DICT': 208,
-    'STORE_SUBSCR_LIST_INT': 209,
-    'TO_BOOL_ALWAYS_TRUE': 210,
-    'TO_BOOL_BOOL': 211,
-    'TO_BOOL_INT': 212,
-    'TO_BOOL_LIST': 213,
-    'TO_BOOL_NONE': 214,
-    'TO_BOOL_STR': 215,
-    'UNPACK_SEQUENCE_LIST': 216,
-    'UNPACK_SEQUENCE_TUPLE': 217,
-    'UNPACK_SEQUENCE_TWO_TUPLE': 218,
+    'CALL_FUNCTION_EX_PY': 168,
+    'CALL_ISINSTANCE': 169,
+    'CALL_KW_PY_EXACT_ARGS': 170,
+    'CALL_LEN': 171,
+    'CALL_LIST_APPEND': 172,
+    'CALL_METHOD_DESCRIPTOR_FAST': 173,
+    'CALL_METHOD_DESCRIPTOR_FAST_WITH_KEYWORDS': 174,
+    'CALL_METHOD_DESCRIPTOR_NOARGS': 175,
+    'CALL_METHOD_DESCRIPTOR_O': 176,
+    'CALL_PY_EXACT_ARGS': 177,
+    'CALL_PY_WITH_DEFAULTS': 178,
+    'CALL_STR_1': 179,
+    'CALL_TUPLE_1': 180,
+    'CALL_TYPE_1': 181,
+    'COMPARE_OP_FLOAT': 182,
+    'COMPARE_OP_INT': 183,
+    'COMPARE_OP_STR': 184,
+    'CONTAINS_OP_DICT': 185,
+    'CONTAINS_OP_LIST': 186,
+    'CONTAINS_OP_SET': 187,
+    'CONTAINS_OP_STR': 188,
+    'CONTAINS_OP_TUPLE': 189,
+    'FOR_ITER_GEN': 190,
+    'FOR_ITER_LIST': 191,
+    'FOR_ITER_RANGE': 192,
+    'FOR_ITER_TUPLE': 193,
+    'LOAD_ATTR_CLASS': 194,
+    'LOAD_ATTR_GETATTRIBUTE_OVERRIDDEN': 195,
+    'LOAD_ATTR_INSTANCE_VALUE': 196,
+    'LOAD_ATTR_METHOD_LAZY_DICT': 197,
+    'LOAD_ATTR_METHOD_NO_DICT': 198,
+    'LOAD_ATTR_METHOD_WITH_VALUES': 199,
+    'LOAD_ATTR_MODULE': 200,
+    'LOAD_ATTR_NONDESCRIPTOR_NO_DICT': 201,
+    'LOAD_ATTR_NONDESCRIPTOR_WITH_VALUES': 202,
+    'LOAD_ATTR_PROPERTY': 203,
+    'LOAD_ATTR_SLOT': 204,
+    'LOAD_ATTR_WITH_HINT': 205,
+    'LOAD_GLOBAL_BUILTIN': 206,
+    'LOAD_GLOBAL_MODULE': 207,
+    'LOAD_SUPER_ATTR_ATTR': 208,
+    'LOAD_SUPER_ATTR_METHOD': 209,
+    'RESUME_CHECK': 210,
+    'SEND_GEN': 211,
+    'STORE_ATTR_INSTANCE_VALUE': 212,
+    'STORE_ATTR_SLOT': 213,
+    'STORE_ATTR_WITH_HINT': 214,
+    'STORE_SUBSCR_DICT': 215,
+    'STORE_SUBSCR_LIST_INT': 216,
+    'TO_BOOL_ALWAYS_TRUE': 217,
+    'TO_BOOL_BOOL': 218,
+    'TO_BOOL_INT': 219,
+    'TO_BOOL_LIST': 220,
+    'TO_BOOL_NONE': 221,
+    'TO_BOOL_STR': 222,
+    'UNPACK_SEQUENCE_LIST': 223,
+    'UNPACK_SEQUENCE_TUPLE': 224,
+    'UNPACK_SEQUENCE_TWO_TUPLE': 225,
 }
 
 opmap = {
@@ -1,10 +1,8 @@
-"""Python implementations of some algorithms for use by longobject.c.
-The goal is to provide asymptotically faster algorithms that can be
-used for operations on integers with many digits.  In those cases, the
-performance overhead of the Python implementation is not significant
-since the asymptotic behavior is what dominates runtime. Functions
-provided by this module should be considered private and not part of any
-public API.
+"""Python implementations of some asymptotically faster algorithms for
+operations on integers with many digits.  longobject.c now has native
+versions of these; this module is kept as a readable reference for them and
+is used to test them.  Functions provided by this module should be
+considered private and not part of any public API.
 
 Note: for ease of maintainability, please prefer clear code and avoid
 "micro-optimizations".  This module will only be imported and used for
@@ -459,6 +459,8 @@ def _write_atomic(path, data, mode=0o666):
 #     Python 3.13a1 3561 (Add cache entry to branch instructions)
 #     Python 3.13a1 3562 (Assign opcode IDs for internal ops in separate range)
 #     Python 3.13a1 3563 (Add CALL_KW and remove KW_NAMES)
+#     Python 3.13a1 3564 (Add cache entries to CALL_KW and CALL_FUNCTION_EX)
+#     Python 3.13a1 3565 (Add cache entry to CONTAINS_OP)
 
 #     Python 3.14 will start with 3600
 
@@ -475,7 +477,7 @@ def _write_atomic(path, data, mode=0o666):
 # Whenever MAGIC_NUMBER is changed, the ranges in the magic_values array
 # in PC/launcher.c must also be updated.
 
-MAGIC_NUMBER = (3563).to_bytes(2, 'little') + b'\r\n'
+MAGIC_NUMBER = (3565).to_bytes(2, 'little') + b'\r\n'
 
 _RAW_MAGIC_NUMBER = int.from_bytes(MAGIC_NUMBER, 'little')  # For import.c
 
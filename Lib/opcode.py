@@ -56,6 +56,9 @@
     "COMPARE_OP": {
         "counter": 1,
     },
+    "CONTAINS_OP": {
+        "counter": 1,
+    },
     "BINARY_SUBSCR": {
         "counter": 1,
     },
@@ -80,6 +83,13 @@
         "counter": 1,
         "func_version": 2,
     },
+    "CALL_KW": {
+        "counter": 1,
+        "func_version": 2,
+    },
+    "CALL_FUNCTION_EX": {
+        "counter": 1,
+    },
     "STORE_SUBSCR": {
         "counter": 1,
     },
@@ -349,6 +349,47 @@ def check_pattern(rr):
         # Test that empty string always work:
         check_pattern(lambda *args: 0)
 
+    def test_find_short_needles(self):
+        # Cover the vectorized search for needles of 2 to 32 characters,
+        # with the candidates it rejects and the tail it leaves over.
+        self.check_short_needles('abc')
+        # Too many rejected candidates switch to the scalar algorithms.
+        for m in 3, 8, 32:
+            p = 'ab' + 'a' * (m - 2)
+            text = 'a' * 5000 + p + 'a' * 3000
+            self.checkequal(5000, text, 'find', p)
+            self.checkequal(2, text + p, 'count', p)
+            self.checkequal(['a' * 5000, 'a' * 3000, ''],
+                            text + p, 'split', p)
+
+    def check_short_needles(self, alphabet):
+        def reference_split(p, s):
+            parts = []
+            i = j = 0
+            while j <= len(s) - len(p):
+                if s.startswith(p, j):
+                    parts.append(s[i:j])
+                    i = j = j + len(p)
+                else:
+                    j += 1
+            parts.append(s[i:])
+            return parts
+
+        rr = random.randrange
+        for m in range(2, 35):
+            for _ in range(10):
+                text = ''.join(random.choices(alphabet, k=rr(m, 150)))
+                start = rr(len(text) - m + 1)
+                p = text[start:start + m]
+                parts = reference_split(p, text)
+                with self.subTest(p=p, text=text):
+                    self.checkequal(len(parts[0]), text, 'find', p)
+                    self.checkequal(len(parts) - 1, text, 'count', p)
+                    self.checkequal(True, text, '__contains__', p)
+                    self.checkequal(parts, text, 'split', p)
+                    self.checkequal('d'.join(parts), text, 'replace', p, 'd')
+                    self.checkequal(-1, text + 'd', 'find', p + 'd' + p)
+
     def test_find_many_lengths(self):
         haystack_repeats = [a * 10**e for e in range(6) for a in (1,2,5)]
         haystacks = [(n, self.fixtype("abcab"*n + "da")) for n in haystack_repeats]
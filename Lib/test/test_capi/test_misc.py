@@ -24,6 +24,8 @@
 from test import support
 from test.support import MISSING_C_DOCSTRINGS
 from test.support import import_helper
+from test.support import os_helper
+from test.support import script_helper
 from test.support import threading_helper
 from test.support import warnings_helper
 from test.support import requires_limited_api
@@ -2493,6 +2495,51 @@ def f{n}():
             for exe in executors[:i]:
                 self.assertTrue(exe.is_valid())
 
+    def test_invalidate_unrelated_objects(self):
+        ns = {}
+        exec(textwrap.dedent("""
+            def f():
+                for _ in range(1000):
+                    pass
+        """), ns, ns)
+        f = ns['f']
+        f()
+        exe = get_first_executor(f)
+        obj = object()
+        _testinternalcapi.add_executor_dependency(exe, obj)
+        # Dependencies are tracked exactly: there are no false positives.
+        others = [object() for _ in range(1000)]
+        for other in others:
+            _testinternalcapi.invalidate_executors(other)
+        self.assertTrue(exe.is_valid())
+        _testinternalcapi.invalidate_executors(obj)
+        self.assertFalse(exe.is_valid())
+
+    def test_invalidate_after_executor_freed(self):
+        ns = {}
+        exec(textwrap.dedent("""
+            def f():
+                for _ in range(1000):
+                    pass
+            def g():
+                for _ in range(1000):
+                    pass
+        """), ns, ns)
+        f, g = ns['f'], ns['g']
+        f()
+        g()
+        obj = object()
+        exe = get_first_executor(f)
+        _testinternalcapi.add_executor_dependency(exe, obj)
+        _testinternalcapi.add_executor_dependency(exe, obj)
+        _testinternalcapi.add_executor_dependency(get_first_executor(g), obj)
+        del exe, f, ns['f']
+        support.gc_collect()
+        exe = get_first_executor(g)
+        self.assertTrue(exe.is_valid())
+        _testinternalcapi.invalidate_executors(obj)
+        self.assertFalse(exe.is_valid())
+
     def test_uop_optimizer_invalidation(self):
         # Generate a new function at each call
         ns = {}
@@ -2693,7 +2740,7 @@ def testfunc(n):
         uops = {opname for opname, _, _ in ex}
         # Since there is no JUMP_FORWARD instruction,
         # look for indirect evidence: the += operator
-        self.assertIn("_BINARY_OP_ADD_INT", uops)
+        self.assertIn("_BINARY_OP_INPLACE_ADD_INT", uops)
 
     def test_for_iter_range(self):
         def testfunc(n):
@@ -2808,6 +2855,431 @@ def testfunc(n):
         uops = {opname for opname, _, _ in ex}
         self.assertIn("_POP_JUMP_IF_TRUE", uops)
 
+    def test_int_type_propagation(self):
+        def testfunc(n):
+            x = 0
+            for i in range(n):
+                y = i + i
+                x = y * y + 1
+            return x
+
+        opt = _testinternalcapi.get_uop_optimizer()
+        with temporary_optimizer(opt):
+            res = testfunc(20)
+            self.assertEqual(res, 38 * 38 + 1)
+
+        ex = get_first_executor(testfunc)
+        self.assertIsNotNone(ex)
+        uops = [opname for opname, _, _ in ex]
+        self.assertNotIn("_GUARD_BOTH_INT", uops)
+        self.assertEqual(uops.count("_BINARY_OP_ADD_INT"), 2)
+
+    def test_int_guard_one_side_known(self):
+        def testfunc(n):
+            i = 0
+            while i < n:
+                i += 1
+            return i
+
+        opt = _testinternalcapi.get_uop_optimizer()
+        with temporary_optimizer(opt):
+            self.assertEqual(testfunc(20), 20)
+
+        ex = get_first_executor(testfunc)
+        self.assertIsNotNone(ex)
+        uops = {opname for opname, _, _ in ex}
+        self.assertNotIn("_GUARD_BOTH_INT", uops)
+        self.assertIn("_GUARD_NOS_INT", uops)
+
+    def test_float_type_propagation(self):
+        def testfunc(n, a, b):
+            total = 0.0
+            for _ in range(n):
+                total = a * b + total
+            return total
+
+        opt = _testinternalcapi.get_uop_optimizer()
+        with temporary_optimizer(opt):
+            self.assertEqual(testfunc(20, 0.5, 2.0), 20.0)
+
+        ex = get_first_executor(testfunc)
+        self.assertIsNotNone(ex)
+        uops = [opname for opname, _, _ in ex]
+        self.assertEqual(uops.count("_GUARD_BOTH_FLOAT"), 1)
+        self.assertIn("_GUARD_TOS_FLOAT", uops)
+
+    def test_int_constant_folding(self):
+        def testfunc(n):
+            i = 0
+            while i < n:
+                a = 1
+                b = a + 2
+                i += 1
+            return b
+
+        opt = _testinternalcapi.get_uop_optimizer()
+        with temporary_optimizer(opt):
+            self.assertEqual(testfunc(20), 3)
+
+        ex = get_first_executor(testfunc)
+        self.assertIsNotNone(ex)
+        uops = [opname for opname, _, _ in ex]
+        self.assertIn("_LOAD_CONST_INLINE_BORROW", uops)
+        # Only `i += 1` is left:
+        self.assertNotIn("_BINARY_OP_ADD_INT", uops)
+        self.assertEqual(uops.count("_BINARY_OP_INPLACE_ADD_INT"), 1)
+
+    def test_type_version_guard_elimination(self):
+        class A:
+            def __init__(self):
+                self.a = 1
+                self.b = 2
+
+        def testfunc(n, o):
+            t = 0
+            for _ in range(n):
+                t = o.a + o.b
+            return t
+
+        opt = _testinternalcapi.get_uop_optimizer()
+        with temporary_optimizer(opt):
+            self.assertEqual(testfunc(20, A()), 3)
+
+        ex = get_first_executor(testfunc)
+        self.assertIsNotNone(ex)
+        uops = [opname for opname, _, _ in ex]
+        self.assertEqual(uops.count("_GUARD_TYPE_VERSION"), 1)
+        self.assertEqual(uops.count("_LOAD_ATTR_INSTANCE_VALUE"), 2)
+
+    def test_type_version_guard_kept_after_escape(self):
+        class A:
+            def __init__(self):
+                self.a = 1
+                self.b = 2
+
+        def testfunc(n, o, s):
+            t = 0
+            for _ in range(n):
+                t = o.a + len(s) + o.b
+            return t
+
+        opt = _testinternalcapi.get_uop_optimizer()
+        with temporary_optimizer(opt):
+            self.assertEqual(testfunc(20, A(), "abc"), 6)
+
+        ex = get_first_executor(testfunc)
+        self.assertIsNotNone(ex)
+        uops = [opname for opname, _, _ in ex]
+        self.assertEqual(uops.count("_GUARD_TYPE_VERSION"), 2)
+
+    def test_side_exit_for_unlikely_branch(self):
+        def testfunc(n):
+            total = 0
+            for i in range(n):
+                if i >= 20:
+                    total += 1
+                total += 1
+            return total
+
+        opt = _testinternalcapi.get_uop_optimizer()
+        with temporary_optimizer(opt):
+            self.assertEqual(testfunc(100), 100 + 80)
+
+        ex = get_first_executor(testfunc)
+        self.assertIsNotNone(ex)
+        exits = [(ex[i][0], ex.get_side_exit(i)) for i in range(len(ex))]
+        side = [(opname, exit) for opname, exit in exits if exit is not None]
+        self.assertEqual(len(side), 1)
+        opname, exit = side[0]
+        self.assertEqual(opname, "_EXIT_TRACE")
+        self.assertTrue(exit.is_valid())
+        uops = [opname for opname, _, _ in exit]
+        self.assertIn("_BINARY_OP_INPLACE_ADD_INT", uops)
+
+    def test_side_exit_for_failed_guard(self):
+        def testfunc(items):
+            total = 0
+            for x in items:
+                total = total + x
+            return total
+
+        opt = _testinternalcapi.get_uop_optimizer()
+        with temporary_optimizer(opt):
+            items = [1] * 20 + [0.5] * 80
+            self.assertEqual(testfunc(items), 20 + 40.0)
+
+        ex = get_first_executor(testfunc)
+        self.assertIsNotNone(ex)
+        exits = [(ex[i][0], ex.get_side_exit(i)) for i in range(len(ex))]
+        side = [(opname, exit) for opname, exit in exits if exit is not None]
+        self.assertEqual(len(side), 1)
+        opname, exit = side[0]
+        self.assertIn(opname, ("_GUARD_BOTH_INT", "_GUARD_TOS_INT",
+                               "_GUARD_NOS_INT"))
+        # The side exit executor starts with the unspecialized instruction:
+        uops = [opname for opname, _, _ in exit]
+        self.assertIn("BINARY_OP", uops)
+
+    def test_side_exit_threshold(self):
+        def testfunc(n):
+            total = 0
+            for i in range(n):
+                if i >= 20:
+                    total += 1
+                total += 1
+            return total
+
+        opt = _testinternalcapi.get_uop_optimizer()
+        with temporary_optimizer(opt):
+            testfunc(20 + 5)
+
+        ex = get_first_executor(testfunc)
+        self.assertIsNotNone(ex)
+        for i in range(len(ex)):
+            self.assertIsNone(ex.get_side_exit(i))
+
+    def test_inline_tiny_calls(self):
+        class Point:
+            def __init__(self, x):
+                self.x = x
+            def get_x(self):
+                return self.x
+
+        def one():
+            return 1
+        def first(a, b):
+            return a
+        def last(a, b):
+            return b
+
+        def testfunc(n):
+            p = Point(5)
+            total = 0
+            for i in range(n):
+                total += one() + first(i, 0) + last(0, i) + p.get_x()
+            return total
+
+        opt = _testinternalcapi.get_uop_optimizer()
+        with temporary_optimizer(opt):
+            self.assertEqual(testfunc(100), sum(1 + 2*i + 5 for i in range(100)))
+
+        ex = get_first_executor(testfunc)
+        self.assertIsNotNone(ex)
+        uops = [opname for opname, _, _ in ex]
+        self.assertNotIn("_PUSH_FRAME", uops)
+        self.assertNotIn("_POP_FRAME", uops)
+        self.assertEqual(uops.count("_CHECK_FUNCTION_EXACT_ARGS"), 4)
+        self.assertIn("_POP_INLINED_CALL_LOAD_CONST_INLINE", uops)
+        self.assertEqual(uops.count("_POP_INLINED_CALL_UNDER_TOP"), 3)
+
+    def test_inlined_getter_deopt(self):
+        class A:
+            def __init__(self, x):
+                self.x = x
+            def get_x(self):
+                return self.x
+        class B(A):
+            pass
+
+        def testfunc(objs):
+            total = 0
+            for obj in objs:
+                total += obj.get_x()
+            return total
+
+        opt = _testinternalcapi.get_uop_optimizer()
+        with temporary_optimizer(opt):
+            objs = [A(1)] * 50 + [B(2)] * 50
+            self.assertEqual(testfunc(objs), 150)
+            a = A(1)
+            del a.x
+            with self.assertRaises(AttributeError):
+                testfunc([A(1)] * 50 + [a])
+
+    def test_no_inline_observable_frame(self):
+        def add(a, b):
+            return a + b
+        def frame_name():
+            return sys._getframe().f_code.co_name
+
+        def testfunc(n):
+            total = 0
+            for i in range(n):
+                total = add(total, i)
+                name = frame_name()
+            return total, name
+
+        opt = _testinternalcapi.get_uop_optimizer()
+        with temporary_optimizer(opt):
+            self.assertEqual(testfunc(100), (sum(range(100)), "frame_name"))
+
+        ex = get_first_executor(testfunc)
+        self.assertIsNotNone(ex)
+        uops = [opname for opname, _, _ in ex]
+        self.assertIn("_PUSH_FRAME", uops)
+        self.assertNotIn("_POP_INLINED_CALL_UNDER_TOP", uops)
+        self.assertNotIn("_POP_INLINED_CALL_LOAD_CONST_INLINE", uops)
+
+
+    def test_float_accumulator_updated_in_place(self):
+        def testfunc(xs):
+            total = 0.0
+            rest = 100.0
+            for x in xs:
+                total += x
+                rest -= x
+                total *= 1.0
+            return total, rest
+
+        opt = _testinternalcapi.get_uop_optimizer()
+        with temporary_optimizer(opt):
+            self.assertEqual(testfunc([0.5] * 100), (50.0, 50.0))
+
+        ex = get_first_executor(testfunc)
+        self.assertIsNotNone(ex)
+        uops = [opname for opname, _, _ in ex]
+        self.assertIn("_BINARY_OP_INPLACE_ADD_FLOAT", uops)
+        self.assertIn("_BINARY_OP_INPLACE_SUBTRACT_FLOAT", uops)
+        self.assertIn("_BINARY_OP_INPLACE_MULTIPLY_FLOAT", uops)
+
+    def test_shared_accumulator_not_updated_in_place(self):
+        def testfunc(xs):
+            total = 0.0
+            seen = []
+            for x in xs:
+                total += x
+                seen.append(total)
+            return seen
+
+        opt = _testinternalcapi.get_uop_optimizer()
+        with temporary_optimizer(opt):
+            seen = testfunc([1.0] * 100)
+        self.assertEqual(seen, [float(i) for i in range(1, 101)])
+
+    def test_int_accumulator_updated_in_place(self):
+        def testfunc(start, n):
+            up = start
+            down = start
+            for _ in range(n):
+                up += 1
+                down -= 1
+            return up, down
+
+        opt = _testinternalcapi.get_uop_optimizer()
+        with temporary_optimizer(opt):
+            # Through the small ints, which must stay singletons:
+            up, down = testfunc(-400, 405)
+            self.assertIs(up, 5)
+            self.assertEqual(down, -805)
+            # Out of the compact range:
+            start = 2**30 - 200
+            self.assertEqual(testfunc(start, 400), (start + 400, start - 400))
+            self.assertEqual(testfunc(-start, 400), (-start + 400, -start - 400))
+
+        ex = get_first_executor(testfunc)
+        self.assertIsNotNone(ex)
+        uops = [opname for opname, _, _ in ex]
+        self.assertIn("_BINARY_OP_INPLACE_ADD_INT", uops)
+        self.assertIn("_BINARY_OP_INPLACE_SUBTRACT_INT", uops)
+
+@unittest.skipUnless(hasattr(_testinternalcapi, "get_executor"),
+                     "Requires the uop optimizer")
+class TestOptimizerProfile(unittest.TestCase):
+
+    script = textwrap.dedent("""
+        import opcode, sys, _testinternalcapi
+
+        def loop(n):
+            total = 0
+            for i in range(n):
+                total += i
+            return total
+
+        loop(int(sys.argv[1]))
+        code = loop.__code__
+        JUMP_BACKWARD = opcode.opmap["JUMP_BACKWARD"]
+        for i in range(0, len(code.co_code), 2):
+            if code.co_code[i] == JUMP_BACKWARD:
+                try:
+                    _testinternalcapi.get_executor(code, i)
+                except ValueError:
+                    continue
+                print("optimized")
+                break
+        else:
+            print("not optimized")
+    """)
+
+    specialize_script = textwrap.dedent("""
+        import dis, sys
+
+        def add(a, b):
+            return a + b
+
+        for _ in range(int(sys.argv[1])):
+            add(1, 2)
+        ops = {i.opname for i in dis.get_instructions(add, adaptive=True)}
+        print("specialized" if "BINARY_OP_ADD_INT" in ops else "not specialized")
+    """)
+
+    def run_loop(self, script, profile, n):
+        _, out, _ = assert_python_ok("-X", "uops", "-X", f"optprofile={profile}",
+                                     script, str(n))
+        return out.decode().strip()
+
+    def test_hot_loops_are_remembered(self):
+        with os_helper.temp_dir() as tmp:
+            script = script_helper.make_script(tmp, "hot", self.script)
+            profile = os.path.join(tmp, "profile")
+            self.assertEqual(self.run_loop(script, profile, 10), "not optimized")
+            self.assertEqual(self.run_loop(script, profile, 1000), "optimized")
+            self.assertTrue(os.path.exists(profile))
+            # The loop is optimized on its first back edge now:
+            self.assertEqual(self.run_loop(script, profile, 10), "optimized")
+            self.assertEqual(sorted(os.listdir(tmp)), ["hot.py", "profile"])
+
+    @support.requires_specialization
+    def test_specializations_are_remembered(self):
+        # Without -X uops: the tier 1 warm-up is recorded as well.
+        def run(script, profile, n):
+            _, out, _ = assert_python_ok("-X", f"optprofile={profile}",
+                                         script, str(n))
+            return out.decode().strip()
+
+        with os_helper.temp_dir() as tmp:
+            script = script_helper.make_script(tmp, "add",
+                                               self.specialize_script)
+            profile = os.path.join(tmp, "profile")
+            self.assertEqual(run(script, profile, 1), "not specialized")
+            self.assertEqual(run(script, profile, 100), "specialized")
+            # The instruction specializes on its first execution now:
+            self.assertEqual(run(script, profile, 1), "specialized")
+            # and it is still remembered after a run that didn't execute it:
+            self.assertEqual(run(script, profile, 0), "not specialized")
+            self.assertEqual(run(script, profile, 1), "specialized")
+
+    def test_bad_profile_is_ignored(self):
+        with os_helper.temp_dir() as tmp:
+            script = script_helper.make_script(tmp, "hot", self.script)
+            profile = os.path.join(tmp, "profile")
+            with open(profile, "w") as f:
+                f.write("garbage")
+            self.assertEqual(self.run_loop(script, profile, 10), "not optimized")
+            self.assertEqual(self.run_loop(script, profile, 1000), "optimized")
+            self.assertEqual(self.run_loop(script, profile, 10), "optimized")
+
+    def test_environment_variable(self):
+        with os_helper.temp_dir() as tmp:
+            script = script_helper.make_script(tmp, "hot", self.script)
+            profile = os.path.join(tmp, "profile")
+            # -E ignores PYTHONOPTPROFILE:
+            assert_python_ok("-E", "-X", "uops", script, "1000",
+                             PYTHONOPTPROFILE=profile)
+            self.assertFalse(os.path.exists(profile))
+            assert_python_ok("-X", "uops", script, "1000",
+                             PYTHONOPTPROFILE=profile)
+            self.assertTrue(os.path.exists(profile))
+
 
 if __name__ == "__main__":
     unittest.main()
@@ -826,6 +826,24 @@ def test_pythonmalloc(self):
             with self.subTest(env_var=env_var, name=name):
                 self.check_pythonmalloc(env_var, name)
 
+    @support.cpython_only
+    def test_pymalloc_hugepages(self):
+        # Test the PYTHON_PYMALLOC_HUGEPAGES environment variable
+        code = textwrap.dedent('''
+            import sys
+            x = [[i] for i in range(300000)]
+            keep = x[::5000]
+            del x
+            sys._trim_memory()
+            x = [(i, str(i)) for i in range(300000)]
+            print(sum(len(t) for t in x), len(keep))
+        ''')
+        for value in ('1', '0', ''):
+            with self.subTest(value=value):
+                rc, out, err = assert_python_ok(
+                    '-c', code, PYTHON_PYMALLOC_HUGEPAGES=value)
+                self.assertEqual(out.rstrip(), b'600000 60')
+
     def test_pythondevmode_env(self):
         # Test the PYTHONDEVMODE environment variable
         code = "import sys; print(sys.flags.dev_mode)"
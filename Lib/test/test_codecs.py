@@ -918,6 +918,57 @@ def test_incremental_errors(self):
                 dec = codecs.getincrementaldecoder(self.encoding)()
                 self.assertRaises(UnicodeDecodeError, dec.decode, data)
 
+    def test_long_strings(self):
+        # Long enough inputs go through the vectorized codecs where
+        # available: check them against the results one character at
+        # a time, at all alignments.  utf-8-sig only differs by the BOM.
+        chars = ['a', '\xe9', 'Ж', '中', '￿', '\U0001f600',
+                 '\U0010ffff']
+        for first in chars:
+            for second in chars:
+                for length in (31, 32, 33, 63, 64, 65, 100):
+                    s = ''.join((first, second, 'z')[i % 3 if i % 5 else 2]
+                                for i in range(length))
+                    with self.subTest(first=first, second=second,
+                                      length=length):
+                        data = s.encode('utf-8')
+                        self.assertEqual(
+                            data, b''.join(c.encode('utf-8') for c in s))
+                        self.assertEqual(data.decode('utf-8'), s)
+                        self.assertEqual(
+                            codecs.utf_8_decode(data[:-1])[0], s[:-1])
+
+    def test_long_strings_errors(self):
+        s = 'abc\xe9Ж中\U0001f600' * 10
+        data = s.encode('utf-8')
+        for i in range(len(data)):
+            # a byte that is never valid, and a truncated sequence
+            for bad in (b'\xff', b'\xe4\xb8'):
+                with self.subTest(i=i, bad=bad):
+                    invalid = data[:i] + bad + data[i:]
+                    with self.assertRaises(UnicodeDecodeError) as cm:
+                        invalid.decode('utf-8')
+                    # the error is at the first byte that can't be decoded
+                    self.assertLessEqual(cm.exception.start, i)
+                    if 0x80 <= data[i] < 0xC0:
+                        # inside a character, which is split
+                        continue
+                    self.assertEqual(
+                        invalid.decode('utf-8', 'surrogateescape'),
+                        data[:i].decode('utf-8', 'surrogateescape')
+                        + bad.decode('utf-8', 'surrogateescape')
+                        + data[i:].decode('utf-8', 'surrogateescape'))
+        for i in range(len(s)):
+            with self.subTest(i=i):
+                with self.assertRaises(UnicodeEncodeError) as cm:
+                    (s[:i] + '\udc80' + s[i:]).encode('utf-8')
+                self.assertEqual(cm.exception.start, i)
+                self.assertEqual(
+                    (s[:i] + '\udc80' + s[i:]).encode('utf-8',
+                                                      'surrogateescape'),
+                    data[:len(s[:i].encode())] + b'\x80'
+                    + data[len(s[:i].encode()):])
+
 
 class UTF7Test(ReadTest, unittest.TestCase):
     encoding = "utf-7"
@@ -856,6 +856,73 @@ def __eq__(self, other):
         resizing = True
         d[9] = 6
 
+    def test_large_str_keys(self):
+        # Large str-keyed dicts probe a group of slots at a time.
+        class StrSub(str):
+            pass
+
+        n = 5000
+        d = {f'key{i}': i for i in range(n)}
+        for i in range(0, n, 3):
+            del d[f'key{i}']
+        for i in range(n):
+            key = f'key{i}'
+            if i % 3:
+                self.assertEqual(d[key], i)
+                self.assertIn(StrSub(key), d)
+            else:
+                self.assertNotIn(key, d)
+                self.assertNotIn(StrSub(key), d)
+        # Deleted slots are reused without losing later keys.
+        for i in range(0, n, 3):
+            self.assertEqual(d.setdefault(f'key{i}', -i), -i)
+        self.assertEqual(len(d), n)
+        while len(d) > n // 2:
+            key, value = d.popitem()
+            self.assertNotIn(key, d)
+        e = d.copy()
+        self.assertEqual(e, d)
+        e[StrSub('key1')] = 'x'  # converts to a generic table
+        self.assertEqual(e['key1'], 'x')
+        self.assertEqual(len(e), len(d))
+
+    def test_large_str_keys_collisions(self):
+        # Mix inserts, deletes and lookups of str keys whose hashes all pick
+        # the same group of slots in tables of up to 8192 slots, so that
+        # probing goes through many full groups and dummy slots.
+        def group(key):
+            return (hash(key) >> 7) & 8191 & ~15
+
+        target = group('c0')
+        colliding = []
+        i = 0
+        while len(colliding) < 300:
+            key = f'c{i}'
+            if group(key) == target:
+                colliding.append(key)
+            i += 1
+        keys = colliding + [f'f{i}' for i in range(1500)]
+
+        rng = random.Random(12345)
+        d = {}
+        expected = {}  # bytes keys: a generic table
+        for step in range(30_000):
+            key = rng.choice(keys)
+            bkey = key.encode()
+            op = rng.random()
+            if op < 0.45:
+                d[key] = step
+                expected[bkey] = step
+            elif op < 0.7:
+                self.assertEqual(d.pop(key, None), expected.pop(bkey, None))
+            else:
+                self.assertEqual(d.get(key), expected.get(bkey))
+                self.assertEqual(key in d, bkey in expected)
+        self.assertEqual(len(d), len(expected))
+        self.assertEqual({k.encode(): v for k, v in d.items()}, expected)
+        for key in colliding:
+            self.assertEqual(d.get(key), expected.get(key.encode()))
+
     def test_empty_presized_dict_in_freelist(self):
         # Bug #3537: if an empty but presized dict with a size larger
         # than 7 was in the freelist, it triggered an assertion failure
@@ -446,6 +446,8 @@ class InitConfigTests(EmbeddingTestsMixin, unittest.TestCase):
         'hash_seed': 0,
         'int_max_str_digits': sys.int_info.default_max_str_digits,
         'cpu_count': -1,
+        'sort_threads': 1,
+        'optimizer_profile': None,
         'faulthandler': 0,
         'tracemalloc': 0,
         'perf_profiling': 0,
@@ -897,6 +899,7 @@ def test_init_from_config(self):
             'safe_path': 1,
             'int_max_str_digits': 31337,
             'cpu_count': 4321,
+            'sort_threads': 4,
 
             'check_hash_pycs_mode': 'always',
             'pathconfig_warnings': 0,
@@ -788,10 +788,22 @@ def test_get_stats(self):
         for st in stats:
             self.assertIsInstance(st, dict)
             self.assertEqual(set(st),
-                             {"collected", "collections", "uncollectable"})
+                             {"collected", "collections", "uncollectable",
+                              "examined", "survived", "pauses",
+                              "pause_total", "pause_max", "weakrefs_time",
+                              "finalize_time", "pause_histogram"})
             self.assertGreaterEqual(st["collected"], 0)
             self.assertGreaterEqual(st["collections"], 0)
             self.assertGreaterEqual(st["uncollectable"], 0)
+            self.assertGreaterEqual(st["examined"], st["survived"])
+            self.assertGreaterEqual(st["survived"], 0)
+            self.assertGreaterEqual(st["pause_total"], st["pause_max"])
+            self.assertGreaterEqual(st["pause_max"], 0.0)
+            self.assertGreaterEqual(st["weakrefs_time"], 0.0)
+            self.assertGreaterEqual(st["finalize_time"], 0.0)
+            self.assertIsInstance(st["pause_histogram"], tuple)
+            self.assertGreaterEqual(st["pauses"], st["collections"])
+            self.assertEqual(sum(st["pause_histogram"]), st["pauses"])
         # Check that collection counts are incremented correctly
         if gc.isenabled():
             self.addCleanup(gc.enable)
@@ -808,12 +820,122 @@ def test_get_stats(self):
         self.assertEqual(new[1]["collections"], old[1]["collections"])
         self.assertEqual(new[2]["collections"], old[2]["collections"] + 1)
 
+    def test_get_stats_examined(self):
+        if gc.isenabled():
+            self.addCleanup(gc.enable)
+            gc.disable()
+        gc.collect(0)
+        class A:
+            pass
+        a = A()
+        a.a = a
+        b = A()
+        b.b = b
+        del a
+        old = gc.get_stats()[0]
+        gc.collect(0)
+        new = gc.get_stats()[0]
+        self.assertGreaterEqual(new["examined"] - old["examined"], 2)
+        self.assertGreaterEqual(new["survived"] - old["survived"], 1)
+        self.assertEqual(new["collected"] - old["collected"], 1)
+        self.assertGreater(new["pause_total"], old["pause_total"])
+        self.assertEqual(new["pauses"] - old["pauses"], 1)
+        self.assertEqual(sum(new["pause_histogram"]) -
+                         sum(old["pause_histogram"]), 1)
+
     def test_freeze(self):
         gc.freeze()
         self.assertGreater(gc.get_freeze_count(), 0)
         gc.unfreeze()
         self.assertEqual(gc.get_freeze_count(), 0)
 
+    def test_freeze_immortal(self):
+        # Run in a subprocess, immortal objects are never freed
+        code = textwrap.dedent('''
+            import gc, sys
+            class A:
+                pass
+            a = A()
+            a.a = a
+            l = [a]
+            d = {}
+            gc.freeze(immortal=True)
+            assert gc.get_freeze_count() == 0
+            assert not gc.is_tracked(l)
+            assert not gc.is_tracked(a)
+            refcount = sys.getrefcount(l)
+            m = l
+            assert sys.getrefcount(l) == refcount
+            del m
+            assert not any(o is l for o in gc.get_objects())
+
+            # The containers still work, and a dict is tracked again when
+            # it holds an object that may be in a cycle
+            l.append([])
+            d['x'] = []
+            assert gc.is_tracked(d)
+            gc.collect()
+            assert gc.get_freeze_count() == 1
+            del a, l, d
+            gc.collect()
+            gc.freeze()
+            gc.unfreeze()
+        ''')
+        assert_python_ok("-c", code)
+
+    def test_pause_budget(self):
+        self.addCleanup(gc.set_pause_budget, gc.get_pause_budget())
+        gc.set_pause_budget(0.005)
+        self.assertEqual(gc.get_pause_budget(), 0.005)
+        gc.set_pause_budget(0)
+        self.assertEqual(gc.get_pause_budget(), 0.0)
+        self.assertRaises(ValueError, gc.set_pause_budget, -1)
+        self.assertRaises(ValueError, gc.set_pause_budget, float('nan'))
+        self.assertRaises(TypeError, gc.set_pause_budget, '1')
+
+    def test_incremental_collection(self):
+        # Cycles of garbage in the oldest generation are collected by the
+        # increments that replace full collections.
+        class A:
+            pass
+        if not gc.isenabled():
+            self.addCleanup(gc.disable)
+            gc.enable()
+        self.addCleanup(gc.set_threshold, *gc.get_threshold())
+        self.addCleanup(gc.set_pause_budget, gc.get_pause_budget())
+        gc.collect()
+        gc.set_threshold(100, 2, 2)
+        gc.set_pause_budget(0.001)
+        live = [A() for _ in range(100)]
+        refs = []
+        for i in range(10):
+            a = A()
+            a.a = a
+            a.live = live
+            refs.append(weakref.ref(a))
+            gc.collect(1)  # move the cycle to the oldest generation
+            del a
+        old = gc.get_stats()[2]
+        keep = []
+        for i in range(5000):
+            if all(r() is None for r in refs):
+                break
+            keep.extend(A() for _ in range(100))
+        self.assertTrue(all(r() is None for r in refs))
+        self.assertGreater(gc.get_stats()[2]["collected"], old["collected"])
+        objects = gc.get_objects(generation=2)
+        self.assertTrue(any(live is o for o in objects))
+        self.assertTrue(any(keep is o for o in objects))
+        del objects
+
+        # Frozen objects are ignored by increments
+        gc.freeze()
+        self.addCleanup(gc.unfreeze)
+        count = gc.get_freeze_count()
+        for i in range(100):
+            keep.extend(A() for _ in range(100))
+        self.assertEqual(gc.get_freeze_count(), count)
+
     def test_get_objects(self):
         gc.collect()
         l = []
@@ -153,7 +153,7 @@ def test_inst_one_pop(self):
         output = """
         TARGET(OP) {
             PyObject *value;
-            value = stack_pointer[-1];
+            value = TOS_CACHE();
             spam();
             STACK_SHRINK(1);
             DISPATCH();
@@ -173,7 +173,7 @@ def test_inst_one_push(self):
             spam();
             STACK_GROW(1);
             stack_pointer[-1] = res;
-            DISPATCH();
+            DISPATCH_TOS(res);
         }
     """
         self.run_cases_test(input, output)
@@ -188,10 +188,10 @@ def test_inst_one_push_one_pop(self):
         TARGET(OP) {
             PyObject *value;
             PyObject *res;
-            value = stack_pointer[-1];
+            value = TOS_CACHE();
             spam();
             stack_pointer[-1] = res;
-            DISPATCH();
+            DISPATCH_TOS(res);
         }
     """
         self.run_cases_test(input, output)
@@ -207,12 +207,12 @@ def test_binary_op(self):
             PyObject *right;
             PyObject *left;
             PyObject *res;
-            right = stack_pointer[-1];
+            right = TOS_CACHE();
             left = stack_pointer[-2];
             spam();
             STACK_SHRINK(1);
             stack_pointer[-1] = res;
-            DISPATCH();
+            DISPATCH_TOS(res);
         }
     """
         self.run_cases_test(input, output)
@@ -228,11 +228,11 @@ def test_overlap(self):
             PyObject *right;
             PyObject *left;
             PyObject *result;
-            right = stack_pointer[-1];
+            right = TOS_CACHE();
             left = stack_pointer[-2];
             spam();
             stack_pointer[-1] = result;
-            DISPATCH();
+            DISPATCH_TOS(result);
         }
     """
         self.run_cases_test(input, output)
@@ -253,19 +253,19 @@ def test_predictions_and_eval_breaker(self):
             static_assert(INLINE_CACHE_ENTRIES_OP1 == 0, "incorrect cache size");
             PyObject *arg;
             PyObject *rest;
-            arg = stack_pointer[-1];
+            arg = TOS_CACHE();
             stack_pointer[-1] = rest;
-            DISPATCH();
+            DISPATCH_TOS(rest);
         }
 
         TARGET(OP3) {
             PyObject *arg;
             PyObject *res;
-            arg = stack_pointer[-1];
+            arg = TOS_CACHE();
             DEOPT_IF(xxx, OP1);
             stack_pointer[-1] = res;
             CHECK_EVAL_BREAKER();
-            DISPATCH();
+            DISPATCH_TOS(res);
         }
     """
         self.run_cases_test(input, output)
@@ -309,12 +309,12 @@ def test_error_if_pop(self):
             PyObject *right;
             PyObject *left;
             PyObject *res;
-            right = stack_pointer[-1];
+            right = TOS_CACHE();
             left = stack_pointer[-2];
             if (cond) goto pop_2_label;
             STACK_SHRINK(1);
             stack_pointer[-1] = res;
-            DISPATCH();
+            DISPATCH_TOS(res);
         }
     """
         self.run_cases_test(input, output)
@@ -327,7 +327,7 @@ def test_cache_effect(self):
         output = """
         TARGET(OP) {
             PyObject *value;
-            value = stack_pointer[-1];
+            value = TOS_CACHE();
             uint16_t counter = read_u16(&next_instr[0].cache);
             uint32_t extra = read_u32(&next_instr[1].cache);
             STACK_SHRINK(1);
@@ -368,7 +368,7 @@ def test_macro_instruction(self):
         TARGET(OP1) {
             PyObject *right;
             PyObject *left;
-            right = stack_pointer[-1];
+            right = TOS_CACHE();
             left = stack_pointer[-2];
             uint16_t counter = read_u16(&next_instr[0].cache);
             op1(left, right);
@@ -384,7 +384,7 @@ def test_macro_instruction(self):
             PyObject *arg2;
             PyObject *res;
             // OP1
-            right = stack_pointer[-1];
+            right = TOS_CACHE();
             left = stack_pointer[-2];
             {
                 uint16_t counter = read_u16(&next_instr[0].cache);
@@ -399,7 +399,7 @@ def test_macro_instruction(self):
             STACK_SHRINK(2);
             stack_pointer[-1] = res;
             next_instr += 5;
-            DISPATCH();
+            DISPATCH_TOS(res);
         }
 
         TARGET(OP3) {
@@ -407,14 +407,14 @@ def test_macro_instruction(self):
             PyObject *left;
             PyObject *arg2;
             PyObject *res;
-            right = stack_pointer[-1];
+            right = TOS_CACHE();
             left = stack_pointer[-2];
             arg2 = stack_pointer[-3];
             res = op3(arg2, left, right);
             STACK_SHRINK(2);
             stack_pointer[-1] = res;
             next_instr += 5;
-            DISPATCH();
+            DISPATCH_TOS(res);
         }
     """
         self.run_cases_test(input, output)
@@ -430,7 +430,7 @@ def test_array_input(self):
             PyObject *above;
             PyObject **values;
             PyObject *below;
-            above = stack_pointer[-1];
+            above = TOS_CACHE();
             values = stack_pointer - 1 - oparg*2;
             below = stack_pointer[-2 - oparg*2];
             spam();
@@ -457,7 +457,7 @@ def test_array_output(self):
             STACK_GROW(oparg*3);
             stack_pointer[-2 - oparg*3] = below;
             stack_pointer[-1] = above;
-            DISPATCH();
+            DISPATCH_TOS(above);
         }
     """
         self.run_cases_test(input, output)
@@ -476,7 +476,7 @@ def test_array_input_output(self):
             spam(values, oparg);
             STACK_GROW(1);
             stack_pointer[-1] = above;
-            DISPATCH();
+            DISPATCH_TOS(above);
         }
     """
         self.run_cases_test(input, output)
@@ -515,7 +515,7 @@ def test_cond_effect(self):
             PyObject *xx;
             PyObject *output = NULL;
             PyObject *zz;
-            cc = stack_pointer[-1];
+            cc = TOS_CACHE();
             if ((oparg & 1) == 1) { input = stack_pointer[-1 - ((oparg & 1) == 1 ? 1 : 0)]; }
             aa = stack_pointer[-2 - ((oparg & 1) == 1 ? 1 : 0)];
             output = spam(oparg, input);
@@ -524,7 +524,7 @@ def test_cond_effect(self):
             stack_pointer[-2 - (oparg & 2 ? 1 : 0)] = xx;
             if (oparg & 2) { stack_pointer[-1 - (oparg & 2 ? 1 : 0)] = output; }
             stack_pointer[-1] = zz;
-            DISPATCH();
+            DISPATCH_TOS(zz);
         }
     """
         self.run_cases_test(input, output)
@@ -548,7 +548,7 @@ def test_macro_cond_effect(self):
             PyObject *extra = NULL;
             PyObject *res;
             // A
-            right = stack_pointer[-1];
+            right = TOS_CACHE();
             middle = stack_pointer[-2];
             left = stack_pointer[-3];
             {
@@ -563,7 +563,7 @@ def test_macro_cond_effect(self):
             stack_pointer[-2 - (oparg ? 1 : 0)] = deep;
             if (oparg) { stack_pointer[-1 - (oparg ? 1 : 0)] = extra; }
             stack_pointer[-1] = res;
-            DISPATCH();
+            DISPATCH_TOS(res);
         }
     """
         self.run_cases_test(input, output)
@@ -593,7 +593,7 @@ def test_macro_push_push(self):
             STACK_GROW(2);
             stack_pointer[-2] = val1;
             stack_pointer[-1] = val2;
-            DISPATCH();
+            DISPATCH_TOS(val2);
         }
         """
         self.run_cases_test(input, output)
@@ -2,7 +2,6 @@
 import time
 
 import unittest
-from unittest import mock
 from test import support
 from test.test_grammar import (VALID_UNDERSCORE_LITERALS,
                                INVALID_UNDERSCORE_LITERALS)
@@ -822,8 +821,9 @@ class IntSubclassStrDigitLimitsTests(IntStrDigitLimitsTests):
 
 
 class PyLongModuleTests(unittest.TestCase):
-    # Tests of the functions in _pylong.py.  Those get used when the
-    # number of digits in the input values are large enough.
+    # Tests of the subquadratic algorithms in longobject.c, which get used
+    # when the number of digits in the input values are large enough.  The
+    # results are checked against the functions in _pylong.py.
 
     def setUp(self):
         super().setUp()
@@ -867,38 +867,43 @@ def test_pylong_str_to_int(self):
         with self.assertRaises(ValueError) as err:
             int('_' + s)
 
-    @support.cpython_only  # tests implementation details of CPython.
     @unittest.skipUnless(_pylong, "_pylong module required")
-    @mock.patch.object(_pylong, "int_to_decimal_string")
-    def test_pylong_misbehavior_error_path_to_str(
-            self, mock_int_to_str):
-        with support.adjust_int_max_str_digits(20_000):
-            big_value = int('7'*19_999)
-            mock_int_to_str.return_value = None  # not a str
-            with self.assertRaises(TypeError) as ctx:
-                str(big_value)
-            self.assertIn('_pylong.int_to_decimal_string did not',
-                          str(ctx.exception))
-            mock_int_to_str.side_effect = RuntimeError("testABC")
-            with self.assertRaises(RuntimeError):
-                str(big_value)
-
-    @support.cpython_only  # tests implementation details of CPython.
+    def test_pylong_roundtrip(self):
+        from random import Random
+        rng = Random(42)
+        # Sizes around the switch to the divide-and-conquer algorithms and
+        # around powers of two, where the recursion splits unevenly.
+        for bits in (6_000, 7_000, 8_192, 8_193, 20_000, 65_536, 100_001):
+            n = rng.getrandbits(bits)
+            for v in (n, -n, n | 1, 10**(bits // 4), 10**(bits // 4) - 1):
+                s = str(v)
+                self.assertEqual(s, _pylong.int_to_decimal_string(v))
+                self.assertEqual(int(s), v)
+        s = '1_' + '0' * 10_000 + '_1' + '0' * 10_000
+        self.assertEqual(int(s), 10**20_001 + 10**10_000)
+        self.assertEqual(int('0' * 10_000 + '7'), 7)
+        self.assertEqual(int('-' + '0' * 10_000 + '7'), -7)
+
     @unittest.skipUnless(_pylong, "_pylong module required")
-    @mock.patch.object(_pylong, "int_from_string")
-    def test_pylong_misbehavior_error_path_from_str(
-            self, mock_int_from_str):
-        big_value = '7'*19_999
-        with support.adjust_int_max_str_digits(20_000):
-            mock_int_from_str.return_value = b'not an int'
-            with self.assertRaises(TypeError) as ctx:
-                int(big_value)
-            self.assertIn('_pylong.int_from_string did not',
-                          str(ctx.exception))
-
-            mock_int_from_str.side_effect = RuntimeError("test123")
-            with self.assertRaises(RuntimeError):
-                int(big_value)
+    def test_pylong_int_divmod_random(self):
+        from random import Random
+        rng = Random(42)
+        for abits, bbits in ((10_000, 4_000), (40_000, 20_000),
+                             (100_000, 60_000), (60_000, 3_001)):
+            a = rng.getrandbits(abits)
+            b = rng.getrandbits(bbits) | (1 << (bbits - 1))
+            for x, y in ((a, b), (-a, b), (a, -b), (-a, -b)):
+                self.assertEqual(divmod(x, y), _pylong.int_divmod(x, y))
+                self.assertEqual(x % y, _pylong.int_divmod(x, y)[1])
+        # The quotient estimate overflows when the top digits of the
+        # remainder and the divisor are equal.
+        for n in (3_000, 6_001, 12_000):
+            b = (1 << n) - 1
+            a = (1 << (3 * n)) - 1
+            self.assertEqual(divmod(a, b), _pylong.int_divmod(a, b))
+            b = (1 << (n - 1)) | 1
+            a = b * ((1 << (2 * n)) - 1) + b - 1
+            self.assertEqual(divmod(a, b), (((1 << (2 * n)) - 1), b - 1))
 
 
 if __name__ == "__main__":
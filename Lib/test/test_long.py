@@ -12,6 +12,8 @@
 BASE = 2 ** SHIFT
 MASK = BASE - 1
 KARATSUBA_CUTOFF = 70   # from longobject.c
+TOOM3_CUTOFF = 250      # from longobject.c
+NTT_CUTOFF = 4000       # from longobject.c
 
 # Max number of base BASE digits to use in test cases.  Doubling
 # this will more than double the runtime.
@@ -229,6 +231,46 @@ def test_karatsuba(self):
                          1)
                     self.assertEqual(x, y)
 
+    def test_toom3_and_ntt(self):
+        digits = [TOOM3_CUTOFF, TOOM3_CUTOFF * 2 + 1, TOOM3_CUTOFF * 10,
+                  NTT_CUTOFF, NTT_CUTOFF * 3 + 7]
+        # Products of long strings of 1 bits maximize every partial sum.
+        for adigits in digits:
+            a = (1 << (adigits * SHIFT)) - 1
+            for bdigits in digits:
+                if bdigits < adigits:
+                    continue
+                with self.subTest(adigits=adigits, bdigits=bdigits):
+                    b = (1 << (bdigits * SHIFT)) - 1
+                    x = a * b
+                    y = ((1 << ((adigits + bdigits) * SHIFT)) -
+                         (1 << (adigits * SHIFT)) -
+                         (1 << (bdigits * SHIFT)) +
+                         1)
+                    self.assertEqual(x, y)
+
+        # Random operands: check the products modulo a few primes, and
+        # squarings against multiplications by an equal, distinct int.
+        moduli = [2**61 - 1, 2**89 - 1, 10**30 + 57, 3**50 - 2]
+        for adigits, bdigits in [(TOOM3_CUTOFF, TOOM3_CUTOFF),
+                                 (TOOM3_CUTOFF * 3, TOOM3_CUTOFF * 4 + 5),
+                                 (NTT_CUTOFF, NTT_CUTOFF + 1),
+                                 (NTT_CUTOFF * 2 + 3, NTT_CUTOFF * 5)]:
+            with self.subTest(adigits=adigits, bdigits=bdigits):
+                a = random.getrandbits(adigits * SHIFT)
+                a |= 1 << (adigits * SHIFT - 1)
+                b = random.getrandbits(bdigits * SHIFT) | 1
+                x = a * b
+                for m in moduli:
+                    self.assertEqual(x % m, (a % m) * (b % m) % m)
+                self.assertEqual(-a * b, -x)
+                self.assertEqual(divmod(x, b), (a, 0))
+                a2 = a + 0
+                self.assertIsNot(a2, a)
+                self.assertEqual(a * a, a * a2)
+                for m in moduli:
+                    self.assertEqual(a * a % m, pow(a, 2, m))
+
     def check_bitop_identities_1(self, x):
         eq = self.assertEqual
         with self.subTest(x=x):
@@ -505,6 +505,236 @@ def f(x, y):
             f()
 
 
+def get_opnames(func):
+    return {
+        instruction.opname
+        for instruction in dis.get_instructions(func, adaptive=True)
+    }
+
+
+class TestCallKwCache(unittest.TestCase):
+    def test_exact_args(self):
+        def f(a, b, *, c):
+            return (a, b, c)
+
+        def g():
+            return f(1, b=2, c=3)
+
+        for _ in range(1025):
+            self.assertEqual(g(), (1, 2, 3))
+        self.assertIn("CALL_KW_PY_EXACT_ARGS", get_opnames(g))
+
+    def test_names_out_of_order(self):
+        def f(a, b, c):
+            return (a, b, c)
+
+        def g():
+            return f(1, c=3, b=2)
+
+        for _ in range(1025):
+            self.assertEqual(g(), (1, 2, 3))
+        self.assertNotIn("CALL_KW_PY_EXACT_ARGS", get_opnames(g))
+
+    def test_positional_only(self):
+        def f(a, /, b):
+            return (a, b)
+
+        def g():
+            return f(1, b=2)
+
+        for _ in range(1025):
+            self.assertEqual(g(), (1, 2))
+        self.assertIn("CALL_KW_PY_EXACT_ARGS", get_opnames(g))
+
+    def test_function_changed(self):
+        def f(a, b):
+            return (a, b)
+
+        def g(a, b=0):
+            return (b, a)
+
+        def h(a, *, b):
+            return ("h", a, b)
+
+        def call(func):
+            return func(1, b=2)
+
+        for _ in range(1025):
+            self.assertEqual(call(f), (1, 2))
+        for func, expected in [(g, (2, 1)), (h, ("h", 1, 2)), (f, (1, 2))]:
+            for _ in range(1025):
+                self.assertEqual(call(func), expected)
+
+    def test_bound_method(self):
+        class C:
+            def m(self, a, b):
+                return (self, a, b)
+
+        c = C()
+        bound = c.m
+
+        def g():
+            return c.m(1, b=2), bound(1, b=2)
+
+        for _ in range(1025):
+            self.assertEqual(g(), ((c, 1, 2), (c, 1, 2)))
+
+    def test_code_changed(self):
+        def f(a, b):
+            return (a, b)
+
+        def h():
+            return f(1, b=2)
+
+        for _ in range(1025):
+            self.assertEqual(h(), (1, 2))
+        f.__code__ = (lambda a, c: (a, c)).__code__
+        with self.assertRaises(TypeError):
+            h()
+
+
+class TestCallFunctionExCache(unittest.TestCase):
+    def test_forwarding(self):
+        def f(a, b):
+            return (a, b)
+
+        def wrapper(*args, **kwargs):
+            return f(*args, **kwargs)
+
+        for _ in range(1025):
+            self.assertEqual(wrapper(1, 2), (1, 2))
+            self.assertEqual(wrapper(1, b=2), (1, 2))
+        self.assertIn("CALL_FUNCTION_EX_PY", get_opnames(wrapper))
+        with self.assertRaises(TypeError):
+            wrapper(1, 2, 3)
+        with self.assertRaises(TypeError):
+            wrapper(1, c=2)
+
+    def test_signature_mismatch(self):
+        def defaults(a, b=2):
+            return (a, b)
+
+        def varargs(*args):
+            return args
+
+        def kwonly(a, *, b=2):
+            return (a, b)
+
+        def call(func, *args, **kwargs):
+            return func(*args, **kwargs)
+
+        for _ in range(1025):
+            self.assertEqual(call(defaults, 1), (1, 2))
+            self.assertEqual(call(varargs, 1, 2, 3), (1, 2, 3))
+            self.assertEqual(call(kwonly, 1), (1, 2))
+            self.assertEqual(call(kwonly, 1, b=3), (1, 3))
+
+    def test_not_a_function(self):
+        def f(a, b):
+            return (a, b)
+
+        def call(func, args):
+            return func(*args)
+
+        for _ in range(1025):
+            self.assertEqual(call(f, (1, 2)), (1, 2))
+            self.assertEqual(call(f, [1, 2]), (1, 2))
+            self.assertEqual(call(max, (1, 2)), 2)
+            self.assertEqual(call(f, iter((1, 2))), (1, 2))
+
+    def test_recursion(self):
+        def f(n):
+            return f(*(n,)) + 1
+
+        with self.assertRaises(RecursionError):
+            f(0)
+
+
+class TestContainsOpCache(unittest.TestCase):
+    def check(self, container, present, absent, opname):
+        def contains(x, c):
+            return x in c
+
+        def not_contains(x, c):
+            return x not in c
+
+        for _ in range(1025):
+            self.assertTrue(contains(present, container))
+            self.assertFalse(contains(absent, container))
+            self.assertFalse(not_contains(present, container))
+            self.assertTrue(not_contains(absent, container))
+        self.assertIn(opname, get_opnames(contains))
+        self.assertIn(opname, get_opnames(not_contains))
+
+    def test_dict(self):
+        self.check({"a": 1, 2: 3}, "a", "b", "CONTAINS_OP_DICT")
+        self.check({"a": 1, 2: 3}, 2, 3, "CONTAINS_OP_DICT")
+
+    def test_set(self):
+        self.check({"a", 2}, "a", "b", "CONTAINS_OP_SET")
+        self.check(frozenset({"a", 2}), 2, 3, "CONTAINS_OP_SET")
+        # A set key is looked up as a frozenset
+        self.check({frozenset({1})}, {1}, {2}, "CONTAINS_OP_SET")
+
+    def test_str(self):
+        self.check("spam", "pa", "ap", "CONTAINS_OP_STR")
+
+    def test_tuple(self):
+        self.check(("a", 2, 3.0), 3, 4, "CONTAINS_OP_TUPLE")
+
+    def test_list(self):
+        self.check(["a", 2, 3.0], "a", "b", "CONTAINS_OP_LIST")
+
+    def test_container_type_changes(self):
+        def contains(x, c):
+            return x in c
+
+        class Sub(dict):
+            def __contains__(self, key):
+                return key == "sub"
+
+        for _ in range(1025):
+            self.assertTrue(contains("a", {"a": 1}))
+        cases = [
+            ({"a"}, True),
+            ("abc", True),
+            (("a",), True),
+            (["a"], True),
+            (Sub(), False),
+            (range(3), False),
+        ]
+        for container, expected in cases:
+            for _ in range(1025):
+                self.assertEqual(contains("a", container), expected)
+        self.assertTrue(contains("sub", Sub()))
+        self.assertTrue(contains(1, range(3)))
+
+    def test_errors(self):
+        def contains(x, c):
+            return x in c
+
+        for _ in range(1025):
+            self.assertTrue(contains("a", {"a"}))
+            self.assertTrue(contains("a", "abc"))
+        with self.assertRaises(TypeError):
+            contains([], {"a"})
+        with self.assertRaises(TypeError):
+            contains([], {"a": 1})
+        with self.assertRaises(TypeError):
+            contains(1, "abc")
+
+        class BadEq:
+            def __eq__(self, other):
+                raise ZeroDivisionError
+
+        for _ in range(1025):
+            self.assertTrue(contains(1, (1, 2)))
+        with self.assertRaises(ZeroDivisionError):
+            contains(BadEq(), (1, 2))
+        with self.assertRaises(ZeroDivisionError):
+            contains(BadEq(), [1, 2])
+
+
 @threading_helper.requires_working_threading()
 class TestRacesDoNotCrash(unittest.TestCase):
     # Careful with these. Bigger numbers have a higher chance of catching bugs,
@@ -5,6 +5,7 @@
 import sysconfig
 import os
 import pathlib
+import struct
 from test import support
 from test.support.script_helper import (
     make_script,
@@ -34,16 +35,37 @@ def supports_trampoline_profiling():
     raise unittest.SkipTest("perf trampoline profiling not supported")
 
 
+def read_jitdump(path):
+    """Return the names of the JIT_CODE_LOAD records in a jitdump file."""
+    data = path.read_bytes()
+    magic, version, header_size = struct.unpack_from("<III", data)
+    if magic != 0x4A695444 or version != 1:
+        raise ValueError("not a jitdump file")
+    names = []
+    offset = header_size
+    while offset < len(data):
+        record_id, total_size = struct.unpack_from("<II", data, offset)
+        if record_id == 0:  # JIT_CODE_LOAD
+            # prefix (16) + pid, tid (8) + vma, code_addr, size, index (32)
+            name_start = offset + 56
+            name_end = data.index(b"\0", name_start)
+            names.append(data[name_start:name_end].decode())
+        offset += total_size
+    return names
+
+
 class TestPerfTrampoline(unittest.TestCase):
     def setUp(self):
         super().setUp()
         self.perf_files = set(pathlib.Path("/tmp/").glob("perf-*.map"))
+        self.perf_files |= set(pathlib.Path("/tmp/").glob("jit-*.dump"))
 
     def tearDown(self) -> None:
         super().tearDown()
         files_to_delete = (
-            set(pathlib.Path("/tmp/").glob("perf-*.map")) - self.perf_files
-        )
+            set(pathlib.Path("/tmp/").glob("perf-*.map"))
+            | set(pathlib.Path("/tmp/").glob("jit-*.dump"))
+        ) - self.perf_files
         for file in files_to_delete:
             file.unlink()
 
@@ -201,6 +223,128 @@ def test_sys_api_with_invalid_trampoline(self):
         rc, out, err = assert_python_failure("-c", code)
         self.assertIn("invalid backend: invalid", err.decode())
 
+    def test_trampoline_works_with_executors(self):
+        code = """if 1:
+                def foo():
+                    total = 0
+                    for i in range(1000):
+                        total += i
+                    return total
+
+                foo()
+                """
+        with temp_dir() as script_dir:
+            script = make_script(script_dir, "perftest", code)
+            with subprocess.Popen(
+                [sys.executable, "-Xperf", "-Xuops", script],
+                text=True,
+                stderr=subprocess.PIPE,
+                stdout=subprocess.PIPE,
+            ) as process:
+                stdout, stderr = process.communicate()
+
+        self.assertEqual(stderr, "")
+        self.assertEqual(stdout, "")
+
+        perf_file = pathlib.Path(f"/tmp/perf-{process.pid}.map")
+        self.assertTrue(perf_file.exists())
+        perf_file_contents = perf_file.read_text()
+        self.assertIn(f"py::foo:{script}", perf_file_contents)
+        # The loop in foo() starts on line 4:
+        self.assertIn(f"py::uop::foo:{script}:4", perf_file_contents)
+
+    def test_jitdump(self):
+        code = """if 1:
+                def foo():
+                    total = 0
+                    for i in range(1000):
+                        total += i
+                    return total
+
+                def bar():
+                    return foo()
+
+                bar()
+                """
+        with temp_dir() as script_dir:
+            script = make_script(script_dir, "perftest", code)
+            with subprocess.Popen(
+                [sys.executable, "-Xperf_jit", "-Xuops", script],
+                text=True,
+                stderr=subprocess.PIPE,
+                stdout=subprocess.PIPE,
+            ) as process:
+                stdout, stderr = process.communicate()
+
+        self.assertEqual(stderr, "")
+        self.assertEqual(stdout, "")
+
+        self.assertFalse(pathlib.Path(f"/tmp/perf-{process.pid}.map").exists())
+        jitdump_file = pathlib.Path(f"/tmp/jit-{process.pid}.dump")
+        self.assertTrue(jitdump_file.exists())
+        names = read_jitdump(jitdump_file)
+        self.assertIn(f"py::foo:{script}", names)
+        self.assertIn(f"py::bar:{script}", names)
+        self.assertIn(f"py::uop::foo:{script}:4", names)
+
+    def test_sys_api_jitdump(self):
+        code = """if 1:
+                import sys
+                def foo():
+                    pass
+
+                sys.activate_stack_trampoline("perf_jit")
+                foo()
+                """
+        with temp_dir() as script_dir:
+            script = make_script(script_dir, "perftest", code)
+            with subprocess.Popen(
+                [sys.executable, script],
+                text=True,
+                stderr=subprocess.PIPE,
+                stdout=subprocess.PIPE,
+            ) as process:
+                stdout, stderr = process.communicate()
+
+        self.assertEqual(stderr, "")
+        self.assertEqual(stdout, "")
+
+        jitdump_file = pathlib.Path(f"/tmp/jit-{process.pid}.dump")
+        self.assertTrue(jitdump_file.exists())
+        self.assertIn(f"py::foo:{script}", read_jitdump(jitdump_file))
+
+    def test_sys_api_switch_from_jitdump(self):
+        code = """if 1:
+                import sys
+                def foo():
+                    pass
+
+                sys.activate_stack_trampoline("perf_jit")
+                foo()
+                sys.activate_stack_trampoline("perf")
+                foo()
+                """
+        with temp_dir() as script_dir:
+            script = make_script(script_dir, "perftest", code)
+            with subprocess.Popen(
+                [sys.executable, script],
+                text=True,
+                stderr=subprocess.PIPE,
+                stdout=subprocess.PIPE,
+            ) as process:
+                stdout, stderr = process.communicate()
+
+        self.assertEqual(stderr, "")
+        self.assertEqual(stdout, "")
+
+        # The jitdump file was closed when switching to the perf map:
+        jitdump_file = pathlib.Path(f"/tmp/jit-{process.pid}.dump")
+        data = jitdump_file.read_bytes()
+        record_id, total_size = struct.unpack_from("<II", data, len(data) - 16)
+        self.assertEqual((record_id, total_size), (3, 16))  # JIT_CODE_CLOSE
+        perf_file = pathlib.Path(f"/tmp/perf-{process.pid}.map")
+        self.assertIn(f"py::foo:{script}", perf_file.read_text())
+
     def test_sys_api_get_status(self):
         code = """if 1:
                 import sys
@@ -355,6 +355,51 @@ class C(object):
     def test_free_after_iterating(self):
         support.check_free_after_iterating(self, iter, self.thetype)
 
+    def test_compact_keys(self):
+        # Sets of str and small int keys use a table without cached
+        # hashes; they must behave the same as sets of other keys.
+        keys = [0, 1, -1, -2, 2**29, -2**30, 2**62, 'a', 'xyz', '']
+        for n in (1, 5, 10, 100, 1000):
+            sample = [k for i in range(n) for k in (i, str(i))]
+            compact = self.thetype(sample + keys)
+            general = self.thetype(sample + keys + [0.5])
+            general = self.thetype(k for k in general if k != 0.5)
+            self.assertEqual(compact, general)
+            self.assertEqual(len(compact), len(general))
+            self.assertEqual(sorted(map(repr, compact)),
+                             sorted(map(repr, general)))
+            if self.thetype.__hash__ is not None:
+                self.assertEqual(hash(compact), hash(general))
+            for k in sample + keys:
+                self.assertIn(k, compact)
+            for k in (0.5, 'b', b'a', -3, 2**30, n + 10, str(n + 10)):
+                self.assertNotIn(k, compact)
+        s = self.thetype([-1, 1, 'a'])
+        self.assertNotIn(-2, s)
+        # equal keys of other types are found
+        self.assertIn(1.0, s)
+        self.assertIn(True, s)
+        self.assertIn(-1.0, s)
+        class Str(str):
+            pass
+        self.assertIn(Str('a'), s)
+
+    def test_compact_keys_order(self):
+        # A compact table has the same slots as a general one, so the
+        # iteration order doesn't depend on the layout.
+        self.assertEqual(list(self.thetype([8, 0])), [8, 0])
+        self.assertEqual(list(self.thetype([1, 9, 17])), [1, 9, 17])
+        class Str(str):
+            pass
+        class Int(int):
+            pass
+        for n in (3, 10, 50, 100, 1000):
+            keys = [str(i) for i in range(n)] + list(range(-n, 4*n, 3))
+            # Subclass instances hash the same but need the general layout
+            general = [Str(k) if isinstance(k, str) else Int(k) for k in keys]
+            self.assertEqual(list(self.thetype(keys)),
+                             list(self.thetype(general)))
+
 class TestSet(TestJointOps, unittest.TestCase):
     thetype = set
     basetype = set
@@ -591,6 +636,54 @@ def test_inplace_on_self(self):
         t ^= t
         self.assertEqual(t, self.thetype())
 
+    def test_compact_keys_mutation(self):
+        # Adding a key other than a str or small int switches the table
+        # layout, and clearing the set switches it back.
+        s = self.thetype(range(20))
+        s.add('a')
+        s.add((1, 2))
+        self.assertEqual(s, set(range(20)) | {'a', (1, 2)})
+        s.discard((1, 2))
+        s.add(2**100)
+        s -= set(range(10))
+        self.assertEqual(s, set(range(10, 20)) | {'a', 2**100})
+        s.clear()
+        s.update(['x', 'y', 1.5])
+        self.assertEqual(s, {'x', 'y', 1.5})
+        popped = {s.pop() for i in range(3)}
+        self.assertEqual(popped, {'x', 'y', 1.5})
+        self.assertEqual(s, set())
+
+        # A comparison of a key of another type that switches the
+        # layout of the set during a lookup
+        class Eq:
+            def __init__(self, target):
+                self.target = target
+            def __hash__(self):
+                return hash(5)
+            def __eq__(self, other):
+                self.target.add(0.5)
+                return other == 5
+        s = self.thetype(range(10))
+        self.assertIn(Eq(s), s)
+        self.assertIn(0.5, s)
+        s = self.thetype(range(10))
+        s.discard(Eq(s))
+        self.assertNotIn(5, s)
+        self.assertIn(0.5, s)
+        s = self.thetype(range(10))
+        s.add(Eq(s))
+        self.assertEqual(len(s), 11)
+
+        # Switching the layout keeps every key in its slot
+        for n in (3, 10, 50):
+            s = self.thetype(range(0, 8*n, 8))
+            s.discard(8)
+            order = list(s)
+            s.add(0.5)
+            s.discard(0.5)
+            self.assertEqual(list(s), order)
+
     def test_weakref(self):
         s = self.thetype('gallahad')
         p = weakref.proxy(s)
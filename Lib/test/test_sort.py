@@ -1,5 +1,7 @@
 from test import support
+from test.support.script_helper import assert_python_ok
 import random
+import textwrap
 import unittest
 from functools import cmp_to_key
 
@@ -362,6 +364,63 @@ def test_unsafe_float_compare(self):
         check_against_PyObject_RichCompareBool(self, [float(x) for
                                                       x in range(100)])
 
+    def test_radix_sort(self):
+        # Large lists of bounded ints, floats and latin strings are radix
+        # sorted.  The result must be identical, including stability.
+        n = 5000
+        rand = random.Random(42)
+        lists = [[rand.randrange(-2**30 + 1, 2**30) for _ in range(n)],
+                 [rand.randrange(10) for _ in range(n)],
+                 [rand.uniform(-1e6, 1e6) for _ in range(n)],
+                 [rand.choice([0.0, -0.0, 1.5, -1.5, float('inf'),
+                               float('-inf'), 5e-324]) for _ in range(n)],
+                 [rand.uniform(-1, 1) for _ in range(n)] + [float('nan')],
+                 [rand.choice(['', 'a', 'a\0', 'ab', 'abcdefgh', 'abcdefghi',
+                               'abcdefgh\xff', '\xff', '\x80'])
+                  for _ in range(n)],
+                 [str(rand.randrange(10**12)) for _ in range(n)]]
+        for L in lists:
+            check_against_PyObject_RichCompareBool(self, L)
+            for reverse in (False, True):
+                # Sorting positions by key checks stability, and key
+                # functions.
+                actual = sorted(range(len(L)), key=L.__getitem__,
+                                reverse=reverse)
+                expected = sorted(range(len(L)), key=lambda i: (0, L[i]),
+                                  reverse=reverse)
+                self.assertEqual(actual, expected)
+        L = list(range(n))
+        L.sort()
+        self.assertEqual(L, list(range(n)))
+        L.sort(reverse=True)
+        self.assertEqual(L, list(range(n - 1, -1, -1)))
+
+    @support.requires_resource('cpu')
+    def test_parallel_sort(self):
+        # Only lists of Latin-1 strings are sorted in parallel.  Sorting
+        # (0, s) tuples gives the serial result to compare with.
+        code = textwrap.dedent('''
+            import random
+            rand = random.Random(42)
+            n = 300_000
+            prefixes = ['abcdefgh', 'abcdefghi', 'a', '', '\\xe9t\\xe9']
+            for L in ([rand.choice(prefixes) + str(rand.randrange(1000))
+                       for _ in range(n)],
+                      [''.join(rand.choices('ab\\xff', k=rand.randrange(12)))
+                       for _ in range(n)],
+                      ['x' * 10 + str(i) for i in range(n)]):
+                for reverse in (False, True):
+                    actual = sorted(range(n), key=L.__getitem__,
+                                    reverse=reverse)
+                    expected = sorted(range(n), key=lambda i: (0, L[i]),
+                                      reverse=reverse)
+                    assert actual == expected
+                    actual = sorted(L, reverse=reverse)
+                    expected = [L[i] for i in expected]
+                    assert actual == expected
+        ''')
+        assert_python_ok('-X', 'sort_threads=4', '-c', code)
+
     def test_unsafe_tuple_compare(self):
         # This test was suggested by Tim Peters. It verifies that the tuple
         # comparison respects the current tuple compare semantics, which do not
@@ -286,6 +286,12 @@ def test_find(self):
         self.checkequal(-1, 'a' * 100, 'find', 'a\U00100304')
         self.checkequal(-1, '\u0102' * 100, 'find', '\u0102\U00100304')
 
+    def test_find_short_needles(self):
+        string_tests.StringLikeTest.test_find_short_needles(self)
+        # test the UCS2 and UCS4 variants
+        self.check_short_needles('ab\u0102')
+        self.check_short_needles('a\u0102\U00100304')
+
     def test_rfind(self):
         string_tests.StringLikeTest.test_rfind(self)
         # test implementation details of the memrchr fast path
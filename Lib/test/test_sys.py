@@ -778,6 +778,15 @@ def test_sys_getwindowsversion_no_instantiation(self):
     def test_clear_type_cache(self):
         sys._clear_type_cache()
 
+    def test_trim_memory(self):
+        x = [[i] for i in range(100000)]
+        del x
+        self.assertGreaterEqual(sys._trim_memory(), 0)
+        # The released pools can be reused
+        x = [[i] for i in range(100000)]
+        self.assertEqual(sum(a[0] for a in x), 4999950000)
+        self.assertRaises(TypeError, sys._trim_memory, True)
+
     @support.requires_subprocess()
     def test_ioencoding(self):
         env = dict(os.environ)
@@ -1596,23 +1605,20 @@ def delx(self): del self.__x
         # set
         # frozenset
         PySet_MINSIZE = 8
-        samples = [[], range(10), range(50)]
         s = size('3nP' + PySet_MINSIZE*'nP' + '2nP')
-        for sample in samples:
-            minused = len(sample)
-            if minused == 0: tmp = 1
-            # the computation of minused is actually a bit more complicated
-            # but this suffices for the sizeof test
-            minused = minused*2
-            newsize = PySet_MINSIZE
-            while newsize <= minused:
-                newsize = newsize << 1
-            if newsize <= 8:
-                check(set(sample), s)
-                check(frozenset(sample), s)
-            else:
-                check(set(sample), s + newsize*calcsize('nP'))
-                check(frozenset(sample), s + newsize*calcsize('nP'))
+        # Small ints and strings go in a compact table of bare key
+        # pointers, other keys in a table of (key, hash) entries.  Both
+        # have the same number of slots.
+        samples = [([], 0),
+                   (range(4), 0),
+                   (range(10), 32*calcsize('P')),
+                   (range(50), 128*calcsize('P')),
+                   ([0.5], 0),
+                   ([i + 0.5 for i in range(10)], 32*calcsize('nP')),
+                   ([i + 0.5 for i in range(50)], 128*calcsize('nP'))]
+        for sample, tablesize in samples:
+            check(set(sample), s + tablesize)
+            check(frozenset(sample), s + tablesize)
         # setiterator
         check(iter(set()), size('P3n'))
         # slice
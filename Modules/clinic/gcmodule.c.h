@@ -232,6 +232,74 @@ gc_get_threshold(PyObject *module, PyObject *Py_UNUSED(ignored))
     return gc_get_threshold_impl(module);
 }
 
+PyDoc_STRVAR(gc_set_pause_budget__doc__,
+"set_pause_budget($module, budget, /)\n"
+"--\n"
+"\n"
+"Set the pause budget of incremental collections, in seconds.\n"
+"\n"
+"If budget is positive, full automatic collections are replaced by\n"
+"increments interleaved with collections of the younger generations,\n"
+"each taking about budget seconds.  Zero disables incremental collection.");
+
+#define GC_SET_PAUSE_BUDGET_METHODDEF    \
+    {"set_pause_budget", (PyCFunction)gc_set_pause_budget, METH_O, gc_set_pause_budget__doc__},
+
+static PyObject *
+gc_set_pause_budget_impl(PyObject *module, double budget);
+
+static PyObject *
+gc_set_pause_budget(PyObject *module, PyObject *arg)
+{
+    PyObject *return_value = NULL;
+    double budget;
+
+    if (PyFloat_CheckExact(arg)) {
+        budget = PyFloat_AS_DOUBLE(arg);
+    }
+    else
+    {
+        budget = PyFloat_AsDouble(arg);
+        if (budget == -1.0 && PyErr_Occurred()) {
+            goto exit;
+        }
+    }
+    return_value = gc_set_pause_budget_impl(module, budget);
+
+exit:
+    return return_value;
+}
+
+PyDoc_STRVAR(gc_get_pause_budget__doc__,
+"get_pause_budget($module, /)\n"
+"--\n"
+"\n"
+"Return the pause budget of incremental collections, in seconds.\n"
+"\n"
+"Zero means that incremental collection is disabled.");
+
+#define GC_GET_PAUSE_BUDGET_METHODDEF    \
+    {"get_pause_budget", (PyCFunction)gc_get_pause_budget, METH_NOARGS, gc_get_pause_budget__doc__},
+
+static double
+gc_get_pause_budget_impl(PyObject *module);
+
+static PyObject *
+gc_get_pause_budget(PyObject *module, PyObject *Py_UNUSED(ignored))
+{
+    PyObject *return_value = NULL;
+    double _return_value;
+
+    _return_value = gc_get_pause_budget_impl(module);
+    if ((_return_value == -1.0) && PyErr_Occurred()) {
+        goto exit;
+    }
+    return_value = PyFloat_FromDouble(_return_value);
+
+exit:
+    return return_value;
+}
+
 PyDoc_STRVAR(gc_get_count__doc__,
 "get_count($module, /)\n"
 "--\n"
@@ -357,25 +425,74 @@ PyDoc_STRVAR(gc_is_finalized__doc__,
     {"is_finalized", (PyCFunction)gc_is_finalized, METH_O, gc_is_finalized__doc__},
 
 PyDoc_STRVAR(gc_freeze__doc__,
-"freeze($module, /)\n"
+"freeze($module, /, *, immortal=False)\n"
 "--\n"
 "\n"
 "Freeze all current tracked objects and ignore them for future collections.\n"
 "\n"
 "This can be used before a POSIX fork() call to make the gc copy-on-write friendly.\n"
 "Note: collection before a POSIX fork() call may free pages for future allocation\n"
-"which can cause copy-on-write.");
+"which can cause copy-on-write.\n"
+"\n"
+"If immortal is true, the frozen objects are also made immortal and\n"
+"untracked, so that their reference counts and GC headers are no longer\n"
+"written to.  They can\'t be unfrozen, and are never freed.");
 
 #define GC_FREEZE_METHODDEF    \
-    {"freeze", (PyCFunction)gc_freeze, METH_NOARGS, gc_freeze__doc__},
+    {"freeze", _PyCFunction_CAST(gc_freeze), METH_FASTCALL|METH_KEYWORDS, gc_freeze__doc__},
 
 static PyObject *
-gc_freeze_impl(PyObject *module);
+gc_freeze_impl(PyObject *module, int immortal);
 
 static PyObject *
-gc_freeze(PyObject *module, PyObject *Py_UNUSED(ignored))
+gc_freeze(PyObject *module, PyObject *const *args, Py_ssize_t nargs, PyObject *kwnames)
 {
-    return gc_freeze_impl(module);
+    PyObject *return_value = NULL;
+    #if defined(Py_BUILD_CORE) && !defined(Py_BUILD_CORE_MODULE)
+
+    #define NUM_KEYWORDS 1
+    static struct {
+        PyGC_Head _this_is_not_used;
+        PyObject_VAR_HEAD
+        PyObject *ob_item[NUM_KEYWORDS];
+    } _kwtuple = {
+        .ob_base = PyVarObject_HEAD_INIT(&PyTuple_Type, NUM_KEYWORDS)
+        .ob_item = { &_Py_ID(immortal), },
+    };
+    #undef NUM_KEYWORDS
+    #define KWTUPLE (&_kwtuple.ob_base.ob_base)
+
+    #else  // !Py_BUILD_CORE
+    #  define KWTUPLE NULL
+    #endif  // !Py_BUILD_CORE
+
+    static const char * const _keywords[] = {"immortal", NULL};
+    static _PyArg_Parser _parser = {
+        .keywords = _keywords,
+        .fname = "freeze",
+        .kwtuple = KWTUPLE,
+    };
+    #undef KWTUPLE
+    PyObject *argsbuf[1];
+    Py_ssize_t noptargs = nargs + (kwnames ? PyTuple_GET_SIZE(kwnames) : 0) - 0;
+    int immortal = 0;
+
+    args = _PyArg_UnpackKeywords(args, nargs, NULL, kwnames, &_parser, 0, 0, 0, argsbuf);
+    if (!args) {
+        goto exit;
+    }
+    if (!noptargs) {
+        goto skip_optional_kwonly;
+    }
+    immortal = PyObject_IsTrue(args[0]);
+    if (immortal < 0) {
+        goto exit;
+    }
+skip_optional_kwonly:
+    return_value = gc_freeze_impl(module, immortal);
+
+exit:
+    return return_value;
 }
 
 PyDoc_STRVAR(gc_unfreeze__doc__,
@@ -425,4 +542,4 @@ gc_get_freeze_count(PyObject *module, PyObject *Py_UNUSED(ignored))
 exit:
     return return_value;
 }
-/*[clinic end generated code: output=5c345e7b4ce6085a input=a9049054013a1b77]*/
+/*[clinic end generated code: output=429382199d54615c input=a9049054013a1b77]*/
@@ -27,6 +27,7 @@
 #include "pycore_ceval.h"         // _Py_set_eval_breaker_bit()
 #include "pycore_context.h"
 #include "pycore_dict.h"          // _PyDict_MaybeUntrack()
+#include "pycore_frame.h"         // _PyInterpreterFrame
 #include "pycore_initconfig.h"
 #include "pycore_interp.h"        // PyInterpreterState.gc
 #include "pycore_object.h"
@@ -71,6 +72,13 @@ module gc
 // most gc_list_* functions for it.
 #define NEXT_MASK_UNREACHABLE  (1)
 
+// Bit 1 of _gc_next records the space of an object in the oldest
+// generation, when it is collected incrementally (see gc_collect_increment).
+//
+// Unlike NEXT_MASK_UNREACHABLE, the gc_list_* functions keep this flag.
+// update_refs() clears it, so objects being collected never have it.
+#define NEXT_MASK_OLD_SPACE_1  _PyGC_NEXT_MASK_OLD_SPACE_1
+
 #define AS_GC(op) _Py_AS_GC(op)
 #define FROM_GC(gc) _Py_FROM_GC(gc)
 
@@ -87,6 +95,21 @@ gc_clear_collecting(PyGC_Head *g)
     g->_gc_prev &= ~PREV_MASK_COLLECTING;
 }
 
+static inline int
+gc_old_space(PyGC_Head *g)
+{
+    return (g->_gc_next & NEXT_MASK_OLD_SPACE_1) != 0;
+}
+
+static inline void
+gc_set_old_space(PyGC_Head *g, int space)
+{
+    g->_gc_next &= ~NEXT_MASK_OLD_SPACE_1;
+    if (space) {
+        g->_gc_next |= NEXT_MASK_OLD_SPACE_1;
+    }
+}
+
 static inline Py_ssize_t
 gc_get_refs(PyGC_Head *g)
 {
@@ -128,6 +151,11 @@ gc_decref(PyGC_Head *g)
 
 #define GEN_HEAD(gcstate, n) (&(gcstate)->generations[n].head)
 
+/* Initial and smallest number of objects scanned by an increment of the
+   oldest generation, see gc_collect_increment(). */
+#define INCREMENT_SIZE_INIT 10000
+#define INCREMENT_SIZE_MIN 1000
+
 
 static GCState *
 get_gc_state(void)
@@ -152,6 +180,11 @@ _PyGC_InitState(GCState *gcstate)
     };
     gcstate->generation0 = GEN_HEAD(gcstate, 0);
     INIT_HEAD(gcstate->permanent_generation);
+    gcstate->old_gray._gc_next = (uintptr_t)&gcstate->old_gray;
+    gcstate->old_gray._gc_prev = (uintptr_t)&gcstate->old_gray;
+    gcstate->old_visited._gc_next = (uintptr_t)&gcstate->old_visited;
+    gcstate->old_visited._gc_prev = (uintptr_t)&gcstate->old_visited;
+    gcstate->increment_size = INCREMENT_SIZE_INIT;
 
 #undef INIT_HEAD
 }
@@ -225,6 +258,11 @@ NEXT_MASK_UNREACHABLE
     The flag is unset and the object is moved back to "reachable" set.
 
     move_legacy_finalizers() will remove this flag from "unreachable" set.
+
+NEXT_MASK_OLD_SPACE_1
+    Set or cleared for objects in the oldest generation to tell the objects
+    already scanned by the current incremental cycle from the others.
+    It is meaningless outside of the oldest generation.
 */
 
 /*** list functions ***/
@@ -326,6 +364,19 @@ gc_list_size(PyGC_Head *list)
     return n;
 }
 
+/* Set the space of all objects in the list and return their number */
+static Py_ssize_t
+gc_list_set_space(PyGC_Head *list, int space)
+{
+    PyGC_Head *gc;
+    Py_ssize_t n = 0;
+    for (gc = GC_NEXT(list); gc != list; gc = GC_NEXT(gc)) {
+        gc_set_old_space(gc, space);
+        n++;
+    }
+    return n;
+}
+
 /* Walk the list and mark all objects as non-collecting */
 static inline void
 gc_list_clear_collecting(PyGC_Head *collectable)
@@ -368,7 +419,8 @@ enum flagstates {collecting_clear_unreachable_clear,
 // What's checked:
 // - The `head` pointers are not polluted.
 // - The objects' PREV_MASK_COLLECTING and NEXT_MASK_UNREACHABLE flags are all
-//   `set or clear, as specified by the 'flags' argument.
+//   `set or clear, as specified by the 'flags' argument.  NEXT_MASK_OLD_SPACE_1
+//   is ignored.
 // - The prev and next pointers are mutually consistent.
 static void
 validate_list(PyGC_Head *head, enum flagstates flags)
@@ -396,7 +448,8 @@ validate_list(PyGC_Head *head, enum flagstates flags)
     PyGC_Head *gc = GC_NEXT(head);
     while (gc != head) {
         PyGC_Head *trueprev = GC_PREV(gc);
-        PyGC_Head *truenext = (PyGC_Head *)(gc->_gc_next  & ~NEXT_MASK_UNREACHABLE);
+        PyGC_Head *truenext = (PyGC_Head *)(gc->_gc_next
+            & ~(NEXT_MASK_UNREACHABLE | NEXT_MASK_OLD_SPACE_1));
         assert(truenext != NULL);
         assert(trueprev == prev);
         assert((gc->_gc_prev & PREV_MASK_COLLECTING) == prev_value);
@@ -415,12 +468,16 @@ validate_list(PyGC_Head *head, enum flagstates flags)
 
 /* Set all gc_refs = ob_refcnt.  After this, gc_refs is > 0 and
  * PREV_MASK_COLLECTING bit is set for all objects in containers.
+ * NEXT_MASK_OLD_SPACE_1 is cleared, since the rest of the collection
+ * manipulates _gc_next directly.
+ * Return the number of objects left in containers.
  */
-static void
+static Py_ssize_t
 update_refs(PyGC_Head *containers)
 {
     PyGC_Head *next;
     PyGC_Head *gc = GC_NEXT(containers);
+    Py_ssize_t size = 0;
 
     while (gc != containers) {
         next = GC_NEXT(gc);
@@ -434,6 +491,7 @@ update_refs(PyGC_Head *containers)
            continue;
         }
         gc_reset_refs(gc, Py_REFCNT(FROM_GC(gc)));
+        gc->_gc_next &= ~NEXT_MASK_OLD_SPACE_1;
         /* Python's cyclic gc should never see an incoming refcount
          * of 0:  if something decref'ed to 0, it should have been
          * deallocated immediately at that time.
@@ -453,8 +511,10 @@ update_refs(PyGC_Head *containers)
          * check instead of an assert?
          */
         _PyObject_ASSERT(FROM_GC(gc), gc_get_refs(gc) != 0);
+        size++;
         gc = next;
     }
+    return size;
 }
 
 /* A traversal callback for subtract_refs. */
@@ -1070,9 +1130,12 @@ show_stats_each_generations(GCState *gcstate)
     size_t pos = 0;
 
     for (int i = 0; i < NUM_GENERATIONS && pos < sizeof(buf); i++) {
-        pos += PyOS_snprintf(buf+pos, sizeof(buf)-pos,
-                             " %zd",
-                             gc_list_size(GEN_HEAD(gcstate, i)));
+        Py_ssize_t size = gc_list_size(GEN_HEAD(gcstate, i));
+        if (i == NUM_GENERATIONS-1) {
+            size += gc_list_size(&gcstate->old_gray);
+            size += gc_list_size(&gcstate->old_visited);
+        }
+        pos += PyOS_snprintf(buf+pos, sizeof(buf)-pos, " %zd", size);
     }
 
     PySys_FormatStderr(
@@ -1107,8 +1170,10 @@ IMPORTANT: This function leaves 'unreachable' with the NEXT_MASK_UNREACHABLE
 flag set but it does not clear it to skip unnecessary iteration. Before the
 flag is cleared (for example, by using 'clear_unreachable_mask' function or
 by a call to 'move_legacy_finalizers'), the 'unreachable' list is not a normal
-list and we can not use most gc_list_* functions for it. */
-static inline void
+list and we can not use most gc_list_* functions for it.
+
+Return the number of objects examined. */
+static inline Py_ssize_t
 deduce_unreachable(PyGC_Head *base, PyGC_Head *unreachable) {
     validate_list(base, collecting_clear_unreachable_clear);
     /* Using ob_refcnt and gc_refs, calculate which objects in the
@@ -1116,7 +1181,7 @@ deduce_unreachable(PyGC_Head *base, PyGC_Head *unreachable) {
      * refcount greater than 0 when all the references within the
      * set are taken into account).
      */
-    update_refs(base);  // gc_prev is used for gc_refs
+    Py_ssize_t examined = update_refs(base);  // gc_prev is used for gc_refs
     subtract_refs(base);
 
     /* Leave everything reachable from outside base in base, and move
@@ -1158,6 +1223,7 @@ deduce_unreachable(PyGC_Head *base, PyGC_Head *unreachable) {
     move_unreachable(base, unreachable);  // gc_prev is pointer again
     validate_list(base, collecting_clear_unreachable_clear);
     validate_list(unreachable, collecting_set_unreachable_set);
+    return examined;
 }
 
 /* Handle objects that may have resurrected after a call to 'finalize_garbage', moving
@@ -1192,6 +1258,115 @@ handle_resurrected_objects(PyGC_Head *unreachable, PyGC_Head* still_unreachable,
     gc_list_merge(resurrected, old_generation);
 }
 
+/* Dispose of the objects found unreachable by deduce_unreachable(): clear
+ * weakrefs, call finalizers and break the reference cycles.  Objects that
+ * survive (legacy finalizers, resurrected objects, ...) are moved to `old`.
+ * `examined` objects were examined to find `unreachable`, they are
+ * accounted in `stats` with the time spent in handle_weakrefs() and
+ * finalize_garbage().
+ * Return the number of collected objects, and store the number of
+ * uncollectable ones in *n_uncollectable.
+ */
+static Py_ssize_t
+gc_collect_unreachable(PyThreadState *tstate, GCState *gcstate,
+                       PyGC_Head *unreachable, PyGC_Head *old,
+                       struct gc_generation_stats *stats, Py_ssize_t examined,
+                       Py_ssize_t *n_uncollectable)
+{
+    Py_ssize_t m = 0; /* # objects collected */
+    Py_ssize_t n = 0; /* # unreachable objects that couldn't be collected */
+    PyGC_Head finalizers;  /* objects with, & reachable from, __del__ */
+    PyGC_Head *gc;
+
+    /* All objects in unreachable are trash, but objects reachable from
+     * legacy finalizers (e.g. tp_del) can't safely be deleted.
+     */
+    gc_list_init(&finalizers);
+    // NEXT_MASK_UNREACHABLE is cleared here.
+    // After move_legacy_finalizers(), unreachable is normal list.
+    move_legacy_finalizers(unreachable, &finalizers);
+    /* finalizers contains the unreachable objects with a legacy finalizer;
+     * unreachable objects reachable *from* those are also uncollectable,
+     * and we move those into the finalizers list too.
+     */
+    move_legacy_finalizer_reachable(&finalizers);
+
+    validate_list(&finalizers, collecting_clear_unreachable_clear);
+    validate_list(unreachable, collecting_set_unreachable_clear);
+
+    /* Print debugging information. */
+    if (gcstate->debug & DEBUG_COLLECTABLE) {
+        for (gc = GC_NEXT(unreachable); gc != unreachable; gc = GC_NEXT(gc)) {
+            debug_cycle("collectable", FROM_GC(gc));
+        }
+    }
+
+    /* Clear weakrefs and invoke callbacks as necessary. */
+    _PyTime_t t1 = _PyTime_GetPerfCounter();
+    m += handle_weakrefs(unreachable, old);
+    _PyTime_t t2 = _PyTime_GetPerfCounter();
+    stats->weakrefs_time += t2 - t1;
+
+    validate_list(old, collecting_clear_unreachable_clear);
+    validate_list(unreachable, collecting_set_unreachable_clear);
+
+    /* Call tp_finalize on objects which have one. */
+    finalize_garbage(tstate, unreachable);
+    stats->finalize_time += _PyTime_GetPerfCounter() - t2;
+
+    /* Handle any objects that may have resurrected after the call
+     * to 'finalize_garbage' and continue the collection with the
+     * objects that are still unreachable */
+    PyGC_Head final_unreachable;
+    handle_resurrected_objects(unreachable, &final_unreachable, old);
+
+    /* Call tp_clear on objects in the final_unreachable set.  This will cause
+    * the reference cycles to be broken.  It may also cause some objects
+    * in finalizers to be freed.
+    */
+    Py_ssize_t n_final = gc_list_size(&final_unreachable);
+    m += n_final;
+    stats->examined += examined;
+    stats->survived += examined - n_final;
+    delete_garbage(tstate, gcstate, &final_unreachable, old);
+
+    /* Collect statistics on uncollectable objects found and print
+     * debugging information. */
+    for (gc = GC_NEXT(&finalizers); gc != &finalizers; gc = GC_NEXT(gc)) {
+        n++;
+        if (gcstate->debug & DEBUG_UNCOLLECTABLE)
+            debug_cycle("uncollectable", FROM_GC(gc));
+    }
+
+    /* Append instances in the uncollectable set to a Python
+     * reachable list of garbage.  The programmer has to deal with
+     * this if they insist on creating this type of structure.
+     */
+    handle_legacy_finalizers(tstate, gcstate, &finalizers, old);
+    validate_list(old, collecting_clear_unreachable_clear);
+
+    *n_uncollectable = n;
+    return m;
+}
+
+/* Account a pause of `duration` in stats. */
+static void
+gc_add_pause(struct gc_generation_stats *stats, _PyTime_t duration)
+{
+    stats->pauses++;
+    stats->pause_total += duration;
+    if (duration > stats->pause_max) {
+        stats->pause_max = duration;
+    }
+    _PyTime_t us = duration / 1000;
+    int i = 0;
+    while (us > 0 && i < _PyGC_PAUSE_BUCKETS - 1) {
+        us >>= 1;
+        i++;
+    }
+    stats->pause_histogram[i]++;
+}
+
 /* This is the main function.  Read this to understand how the
  * collection process works. */
 static Py_ssize_t
@@ -1206,15 +1381,15 @@ gc_collect_main(PyThreadState *tstate, int generation,
     }
 #endif
     int i;
-    Py_ssize_t m = 0; /* # objects collected */
-    Py_ssize_t n = 0; /* # unreachable objects that couldn't be collected */
+    Py_ssize_t m; /* # objects collected */
+    Py_ssize_t n; /* # unreachable objects that couldn't be collected */
     PyGC_Head *young; /* the generation we are examining */
     PyGC_Head *old; /* next older generation */
     PyGC_Head unreachable; /* non-problematic unreachable trash */
-    PyGC_Head finalizers;  /* objects with, & reachable from, __del__ */
-    PyGC_Head *gc;
-    _PyTime_t t1 = 0;   /* initialize to prevent a compiler warning */
+    Py_ssize_t examined; /* # objects examined */
+    _PyTime_t t1 = _PyTime_GetPerfCounter();
     GCState *gcstate = &tstate->interp->gc;
+    struct gc_generation_stats *stats = &gcstate->generation_stats[generation];
 
     // gc_collect_main() must not be called before _PyGC_Init
     // or after _PyGC_Fini()
@@ -1224,7 +1399,6 @@ gc_collect_main(PyThreadState *tstate, int generation,
     if (gcstate->debug & DEBUG_STATS) {
         PySys_WriteStderr("gc: collecting generation %d...\n", generation);
         show_stats_each_generations(gcstate);
-        t1 = _PyTime_GetPerfCounter();
     }
 
     if (PyDTrace_GC_START_ENABLED())
@@ -1240,6 +1414,16 @@ gc_collect_main(PyThreadState *tstate, int generation,
     for (i = 0; i < generation; i++) {
         gc_list_merge(GEN_HEAD(gcstate, i), GEN_HEAD(gcstate, generation));
     }
+    if (generation == NUM_GENERATIONS-1) {
+        /* A full collection also scans the objects marked or visited by
+           the current incremental cycle, if any, which ends the cycle.
+           The survivors have their space cleared by update_refs(), which
+           makes them pending for the next cycle. */
+        gc_list_merge(&gcstate->old_gray, GEN_HEAD(gcstate, generation));
+        gc_list_merge(&gcstate->old_visited, GEN_HEAD(gcstate, generation));
+        gcstate->incremental_cycle = 0;
+        gcstate->visited_space = 1;
+    }
 
     /* handy references */
     young = GEN_HEAD(gcstate, generation);
@@ -1249,13 +1433,21 @@ gc_collect_main(PyThreadState *tstate, int generation,
         old = young;
     validate_list(old, collecting_clear_unreachable_clear);
 
-    deduce_unreachable(young, &unreachable);
+    examined = deduce_unreachable(young, &unreachable);
 
     untrack_tuples(young);
     /* Move reachable objects to next generation. */
     if (young != old) {
         if (generation == NUM_GENERATIONS - 2) {
-            gcstate->long_lived_pending += gc_list_size(young);
+            if (gcstate->pause_budget) {
+                /* Scan the promoted objects in the current (or next)
+                   incremental cycle. */
+                gcstate->long_lived_pending +=
+                    gc_list_set_space(young, !gcstate->visited_space);
+            }
+            else {
+                gcstate->long_lived_pending += gc_list_size(young);
+            }
         }
         gc_list_merge(young, old);
     }
@@ -1267,58 +1459,8 @@ gc_collect_main(PyThreadState *tstate, int generation,
         gcstate->long_lived_total = gc_list_size(young);
     }
 
-    /* All objects in unreachable are trash, but objects reachable from
-     * legacy finalizers (e.g. tp_del) can't safely be deleted.
-     */
-    gc_list_init(&finalizers);
-    // NEXT_MASK_UNREACHABLE is cleared here.
-    // After move_legacy_finalizers(), unreachable is normal list.
-    move_legacy_finalizers(&unreachable, &finalizers);
-    /* finalizers contains the unreachable objects with a legacy finalizer;
-     * unreachable objects reachable *from* those are also uncollectable,
-     * and we move those into the finalizers list too.
-     */
-    move_legacy_finalizer_reachable(&finalizers);
-
-    validate_list(&finalizers, collecting_clear_unreachable_clear);
-    validate_list(&unreachable, collecting_set_unreachable_clear);
-
-    /* Print debugging information. */
-    if (gcstate->debug & DEBUG_COLLECTABLE) {
-        for (gc = GC_NEXT(&unreachable); gc != &unreachable; gc = GC_NEXT(gc)) {
-            debug_cycle("collectable", FROM_GC(gc));
-        }
-    }
-
-    /* Clear weakrefs and invoke callbacks as necessary. */
-    m += handle_weakrefs(&unreachable, old);
-
-    validate_list(old, collecting_clear_unreachable_clear);
-    validate_list(&unreachable, collecting_set_unreachable_clear);
-
-    /* Call tp_finalize on objects which have one. */
-    finalize_garbage(tstate, &unreachable);
-
-    /* Handle any objects that may have resurrected after the call
-     * to 'finalize_garbage' and continue the collection with the
-     * objects that are still unreachable */
-    PyGC_Head final_unreachable;
-    handle_resurrected_objects(&unreachable, &final_unreachable, old);
-
-    /* Call tp_clear on objects in the final_unreachable set.  This will cause
-    * the reference cycles to be broken.  It may also cause some objects
-    * in finalizers to be freed.
-    */
-    m += gc_list_size(&final_unreachable);
-    delete_garbage(tstate, gcstate, &final_unreachable, old);
-
-    /* Collect statistics on uncollectable objects found and print
-     * debugging information. */
-    for (gc = GC_NEXT(&finalizers); gc != &finalizers; gc = GC_NEXT(gc)) {
-        n++;
-        if (gcstate->debug & DEBUG_UNCOLLECTABLE)
-            debug_cycle("uncollectable", FROM_GC(gc));
-    }
+    m = gc_collect_unreachable(tstate, gcstate, &unreachable, old,
+                               stats, examined, &n);
     if (gcstate->debug & DEBUG_STATS) {
         double d = _PyTime_AsSecondsDouble(_PyTime_GetPerfCounter() - t1);
         PySys_WriteStderr(
@@ -1326,13 +1468,6 @@ gc_collect_main(PyThreadState *tstate, int generation,
             n+m, n, d);
     }
 
-    /* Append instances in the uncollectable set to a Python
-     * reachable list of garbage.  The programmer has to deal with
-     * this if they insist on creating this type of structure.
-     */
-    handle_legacy_finalizers(tstate, gcstate, &finalizers, old);
-    validate_list(old, collecting_clear_unreachable_clear);
-
     /* Clear free list only during the collection of the highest
      * generation */
     if (generation == NUM_GENERATIONS-1) {
@@ -1356,10 +1491,10 @@ gc_collect_main(PyThreadState *tstate, int generation,
         *n_uncollectable = n;
     }
 
-    struct gc_generation_stats *stats = &gcstate->generation_stats[generation];
     stats->collections++;
     stats->collected += m;
     stats->uncollectable += n;
+    gc_add_pause(stats, _PyTime_GetPerfCounter() - t1);
 
     GC_STAT_ADD(generation, objects_collected, m);
 #ifdef Py_STATS
@@ -1448,6 +1583,290 @@ gc_collect_with_callback(PyThreadState *tstate, int generation)
     return result;
 }
 
+/* Incremental collection of the oldest generation.
+
+   The pause of a full collection grows with the number of long-lived
+   objects, since all of them are scanned at once.  When a pause budget is
+   set with gc.set_pause_budget(), full collections are replaced by a cycle
+   of increments.  Each increment runs right after a collection of the
+   middle generation, when the younger generations are empty.
+
+   A cycle starts by marking the objects of the oldest generation that are
+   reachable from the roots (the sys and builtins dicts, sys.modules and
+   the frames of all threads).  They are moved to old_gray, and each
+   increment moves the pending objects referred to by up to increment_size
+   gray objects to old_gray, and those gray objects to old_visited.
+   Marked objects are known to be alive, so they are not examined further
+   in this cycle.
+
+   Once no gray objects are left, each increment:
+
+   1. Moves objects from the head of the oldest generation (the "pending"
+      objects) into an increment, together with all the pending objects
+      reachable from them, until increment_size objects have been taken.
+   2. Collects the increment as any other generation: references from
+      objects outside of it are treated as coming from roots, so only
+      garbage that is unreachable from the rest of the heap is freed.
+   3. Moves the survivors to old_visited.
+
+   Marking and increments run while the program mutates the heap, so some
+   live objects can escape marking and some garbage can be marked, but
+   neither is a problem: step 2 is safe for any set of objects, and
+   garbage that was marked is collected during the next cycle.
+
+   Pending objects are told apart from gray and visited ones by
+   NEXT_MASK_OLD_SPACE_1: gray and visited objects have visited_space, and
+   objects promoted into the oldest generation get the other value.  When
+   no pending objects are left, the cycle ends: flipping visited_space
+   makes all visited objects pending again without touching them.
+
+   As an increment contains every pending object reachable from it, a
+   cycle of garbage is collected by the first increment that takes any of
+   its members, unless some of them were already marked or visited in the
+   same cycle.  It is then collected during the next cycle.  Adding the
+   reachable objects can make an increment larger than increment_size,
+   which is adjusted after each increment so that it takes about
+   pause_budget.
+
+   Frozen objects are not told apart from the pending ones, so the oldest
+   generation is collected all at once while gc.freeze() is in effect.
+*/
+
+struct increment_state {
+    PyGC_Head *list;
+    int visited_space;
+    Py_ssize_t size;
+};
+
+/* A traversal callback for gc_collect_increment: move pending objects to
+ * state->list. */
+static int
+visit_add_to_increment(PyObject *op, struct increment_state *state)
+{
+    OBJECT_STAT_INC(object_visits);
+    if (op != NULL && _PyObject_IS_GC(op) && _PyObject_GC_IS_TRACKED(op)) {
+        PyGC_Head *gc = AS_GC(op);
+        if (gc_old_space(gc) != state->visited_space) {
+            gc_list_move(gc, state->list);
+            gc_set_old_space(gc, state->visited_space);
+            state->size++;
+        }
+    }
+    return 0;
+}
+
+/* Move the pending objects referred to by the roots to old_gray. */
+static void
+gc_mark_roots(PyInterpreterState *interp, struct increment_state *state)
+{
+    visitproc visit = (visitproc)visit_add_to_increment;
+    visit(interp->sysdict, state);
+    visit(interp->builtins, state);
+    visit(interp->imports.modules, state);
+    for (PyThreadState *p = PyInterpreterState_ThreadHead(interp);
+         p != NULL; p = PyThreadState_Next(p))
+    {
+        for (_PyInterpreterFrame *frame = p->current_frame; frame != NULL;
+             frame = frame->previous)
+        {
+            if (_PyFrame_IsIncomplete(frame)) {
+                continue;
+            }
+            visit(frame->f_funcobj, state);
+            visit(frame->f_globals, state);
+            visit(frame->f_locals, state);
+            visit((PyObject *)frame->frame_obj, state);
+            /* The value stack is only valid while the frame is suspended */
+            PyObject **locals = _PyFrame_GetLocalsArray(frame);
+            int nlocals = _PyFrame_GetCode(frame)->co_nlocalsplus;
+            for (int i = 0; i < nlocals; i++) {
+                visit(locals[i], state);
+            }
+        }
+    }
+}
+
+static inline int
+gc_use_increments(GCState *gcstate)
+{
+    return gcstate->pause_budget > 0 && !gcstate->frozen;
+}
+
+/* End the current incremental cycle, if any: all the objects of the oldest
+   generation are pending again. */
+static void
+gc_end_incremental_cycle(GCState *gcstate)
+{
+    PyGC_Head *pending = GEN_HEAD(gcstate, NUM_GENERATIONS-1);
+    gc_list_merge(&gcstate->old_gray, pending);
+    gc_list_merge(&gcstate->old_visited, pending);
+    gcstate->visited_space = !gcstate->visited_space;
+    gcstate->incremental_cycle = 0;
+}
+
+/* Mark the referents of up to `budget` gray objects. */
+static void
+gc_mark_increment(GCState *gcstate, Py_ssize_t budget)
+{
+    PyGC_Head *gray = &gcstate->old_gray;
+    struct increment_state state = {gray, gcstate->visited_space, 0};
+    for (Py_ssize_t i = 0; i < budget && !gc_list_is_empty(gray); i++) {
+        PyGC_Head *gc = GC_NEXT(gray);
+        PyObject *op = FROM_GC(gc);
+        gc_list_move(gc, &gcstate->old_visited);
+        (void) Py_TYPE(op)->tp_traverse(op,
+                (visitproc)visit_add_to_increment,
+                &state);
+    }
+}
+
+/* Collect an increment of the oldest generation. */
+static Py_ssize_t
+gc_collect_increment(PyThreadState *tstate,
+                     Py_ssize_t *n_collected, Py_ssize_t *n_uncollectable)
+{
+    Py_ssize_t m = 0; /* # objects collected */
+    Py_ssize_t n = 0; /* # unreachable objects that couldn't be collected */
+    PyGC_Head increment; /* the objects we are examining */
+    PyGC_Head unreachable; /* non-problematic unreachable trash */
+    GCState *gcstate = &tstate->interp->gc;
+    PyGC_Head *pending = GEN_HEAD(gcstate, NUM_GENERATIONS-1);
+    struct gc_generation_stats *stats =
+        &gcstate->generation_stats[NUM_GENERATIONS-1];
+    _PyTime_t t1 = _PyTime_GetPerfCounter();
+
+    assert(gcstate->garbage != NULL);
+    assert(!_PyErr_Occurred(tstate));
+
+    if (gcstate->debug & DEBUG_STATS) {
+        PySys_WriteStderr("gc: collecting an increment of generation %d...\n",
+                          NUM_GENERATIONS-1);
+        show_stats_each_generations(gcstate);
+    }
+    if (PyDTrace_GC_START_ENABLED())
+        PyDTrace_GC_START(NUM_GENERATIONS-1);
+
+    if (!gcstate->incremental_cycle) {
+        gcstate->incremental_cycle = 1;
+        /* Count the survivors of this cycle */
+        gcstate->long_lived_total = 0;
+        struct increment_state state = {
+            &gcstate->old_gray, gcstate->visited_space, 0};
+        gc_mark_roots(tstate->interp, &state);
+    }
+
+    if (!gc_list_is_empty(&gcstate->old_gray)) {
+        /* Marking an object costs less than collecting it */
+        gc_mark_increment(gcstate, 2 * gcstate->increment_size);
+        if (gcstate->debug & DEBUG_STATS) {
+            double d = _PyTime_AsSecondsDouble(_PyTime_GetPerfCounter() - t1);
+            PySys_WriteStderr("gc: done marking, %.4fs elapsed\n", d);
+        }
+        goto done;
+    }
+
+    gc_list_init(&increment);
+    struct increment_state state = {&increment, gcstate->visited_space, 0};
+    PyGC_Head *scanned = &increment;
+    while (state.size < gcstate->increment_size && !gc_list_is_empty(pending)) {
+        PyGC_Head *gc = GC_NEXT(pending);
+        gc_list_move(gc, &increment);
+        gc_set_old_space(gc, state.visited_space);
+        state.size++;
+        /* Add the pending objects reachable from it, and from the objects
+           that it adds. */
+        while ((gc = GC_NEXT(scanned)) != &increment) {
+            PyObject *op = FROM_GC(gc);
+            (void) Py_TYPE(op)->tp_traverse(op,
+                    (visitproc)visit_add_to_increment,
+                    &state);
+            scanned = gc;
+        }
+    }
+
+    Py_ssize_t examined = deduce_unreachable(&increment, &unreachable);
+    untrack_tuples(&increment);
+    untrack_dicts(&increment);
+    m = gc_collect_unreachable(tstate, gcstate, &unreachable, &increment,
+                               stats, examined, &n);
+
+    /* Finalizers may have called gc.freeze() or gc.set_pause_budget(), the
+       survivors are merged into old_visited anyway. */
+    gcstate->long_lived_total +=
+        gc_list_set_space(&increment, gcstate->visited_space);
+    gc_list_merge(&increment, &gcstate->old_visited);
+
+    _PyTime_t t2 = _PyTime_GetPerfCounter();
+    if (gcstate->debug & DEBUG_STATS) {
+        PySys_WriteStderr(
+            "gc: done, %zd scanned, %zd unreachable, %zd uncollectable, "
+            "%.4fs elapsed\n",
+            state.size, n+m, n, _PyTime_AsSecondsDouble(t2 - t1));
+    }
+
+    /* Size the next increment from the time taken by this one, at most
+       doubling it. */
+    if (state.size >= INCREMENT_SIZE_MIN && gcstate->pause_budget > 0) {
+        double target = 2.0 * gcstate->increment_size;
+        if (t2 > t1) {
+            target = Py_MIN(target, (double)state.size
+                                    * gcstate->pause_budget / (t2 - t1));
+        }
+        Py_ssize_t size = (gcstate->increment_size + (Py_ssize_t)target) / 2;
+        gcstate->increment_size = Py_MAX(size, INCREMENT_SIZE_MIN);
+    }
+
+    if (gc_list_is_empty(pending)) {
+        gc_end_incremental_cycle(gcstate);
+        gcstate->long_lived_pending = 0;
+        gcstate->generations[NUM_GENERATIONS-1].count = 0;
+        stats->collections++;
+        GC_STAT_ADD(NUM_GENERATIONS-1, collections, 1);
+        clear_freelists(tstate->interp);
+    }
+
+    if (_PyErr_Occurred(tstate)) {
+        _PyErr_WriteUnraisableMsg("in garbage collection", NULL);
+    }
+
+done:
+    if (!gc_use_increments(gcstate) && gcstate->incremental_cycle) {
+        gc_end_incremental_cycle(gcstate);
+    }
+
+    *n_collected = m;
+    *n_uncollectable = n;
+    stats->collected += m;
+    stats->uncollectable += n;
+    gc_add_pause(stats, _PyTime_GetPerfCounter() - t1);
+    GC_STAT_ADD(NUM_GENERATIONS-1, objects_collected, m);
+
+    if (PyDTrace_GC_DONE_ENABLED()) {
+        PyDTrace_GC_DONE(n + m);
+    }
+
+    assert(!_PyErr_Occurred(tstate));
+    return n + m;
+}
+
+/* Collect the middle generation and an increment of the oldest generation,
+ * and invoke progress callbacks.
+ */
+static Py_ssize_t
+gc_collect_increment_with_callback(PyThreadState *tstate)
+{
+    assert(!_PyErr_Occurred(tstate));
+    Py_ssize_t result, collected, uncollectable, collected2, uncollectable2;
+    invoke_gc_callback(tstate, "start", NUM_GENERATIONS - 1, 0, 0);
+    result = gc_collect_main(tstate, NUM_GENERATIONS - 2,
+                             &collected, &uncollectable, 0);
+    result += gc_collect_increment(tstate, &collected2, &uncollectable2);
+    invoke_gc_callback(tstate, "stop", NUM_GENERATIONS - 1,
+                       collected + collected2, uncollectable + uncollectable2);
+    assert(!_PyErr_Occurred(tstate));
+    return result;
+}
+
 static Py_ssize_t
 gc_collect_generations(PyThreadState *tstate)
 {
@@ -1497,6 +1916,14 @@ gc_collect_generations(PyThreadState *tstate)
             if (i == NUM_GENERATIONS - 1
                 && gcstate->long_lived_pending < gcstate->long_lived_total / 4)
                 continue;
+            /* In incremental mode, a full collection starts a cycle of
+               increments, which is continued by the following collections
+               of the middle generation. */
+            if (i >= NUM_GENERATIONS - 2 && gc_use_increments(gcstate)
+                && (i == NUM_GENERATIONS - 1 || gcstate->incremental_cycle)) {
+                n = gc_collect_increment_with_callback(tstate);
+                break;
+            }
             n = gc_collect_with_callback(tstate, i);
             break;
         }
@@ -1666,6 +2093,57 @@ gc_get_threshold_impl(PyObject *module)
                          gcstate->generations[2].threshold);
 }
 
+/*[clinic input]
+gc.set_pause_budget
+
+    budget: double
+    /
+
+Set the pause budget of incremental collections, in seconds.
+
+If budget is positive, full automatic collections are replaced by
+increments interleaved with collections of the younger generations,
+each taking about budget seconds.  Zero disables incremental collection.
+[clinic start generated code]*/
+
+static PyObject *
+gc_set_pause_budget_impl(PyObject *module, double budget)
+/*[clinic end generated code: output=6f7f7b925973a47a input=38c19f2076c9332b]*/
+{
+    if (!(budget >= 0 && budget <= 1e6)) {
+        PyErr_SetString(PyExc_ValueError,
+                        "pause budget must be a non-negative number "
+                        "of seconds");
+        return NULL;
+    }
+    GCState *gcstate = get_gc_state();
+    _PyTime_t ns = (_PyTime_t)(budget * 1e9);
+    if (budget > 0 && ns == 0) {
+        ns = 1;
+    }
+    gcstate->pause_budget = ns;
+    if (ns == 0 && gcstate->incremental_cycle && !gcstate->collecting) {
+        gc_end_incremental_cycle(gcstate);
+    }
+    Py_RETURN_NONE;
+}
+
+/*[clinic input]
+gc.get_pause_budget -> double
+
+Return the pause budget of incremental collections, in seconds.
+
+Zero means that incremental collection is disabled.
+[clinic start generated code]*/
+
+static double
+gc_get_pause_budget_impl(PyObject *module)
+/*[clinic end generated code: output=0ac6600c52706fdb input=b1712295ac96c9ab]*/
+{
+    GCState *gcstate = get_gc_state();
+    return _PyTime_AsSecondsDouble(gcstate->pause_budget);
+}
+
 /*[clinic input]
 gc.get_count
 
@@ -1735,6 +2213,12 @@ gc_get_referrers(PyObject *self, PyObject *args)
             return NULL;
         }
     }
+    if (!(gc_referrers_for(args, &gcstate->old_gray, result))
+        || !(gc_referrers_for(args, &gcstate->old_visited, result)))
+    {
+        Py_DECREF(result);
+        return NULL;
+    }
     return result;
 }
 
@@ -1826,6 +2310,11 @@ gc_get_objects_impl(PyObject *module, Py_ssize_t generation)
         if (append_objects(result, GEN_HEAD(gcstate, generation))) {
             goto error;
         }
+        if (generation == NUM_GENERATIONS-1
+            && (append_objects(result, &gcstate->old_gray)
+                || append_objects(result, &gcstate->old_visited))) {
+            goto error;
+        }
 
         return result;
     }
@@ -1836,6 +2325,10 @@ gc_get_objects_impl(PyObject *module, Py_ssize_t generation)
             goto error;
         }
     }
+    if (append_objects(result, &gcstate->old_gray)
+        || append_objects(result, &gcstate->old_visited)) {
+        goto error;
+    }
     return result;
 
 error:
@@ -1868,12 +2361,36 @@ gc_get_stats_impl(PyObject *module)
         return NULL;
 
     for (i = 0; i < NUM_GENERATIONS; i++) {
-        PyObject *dict;
+        PyObject *dict, *histogram;
         st = &stats[i];
-        dict = Py_BuildValue("{snsnsn}",
+        histogram = PyTuple_New(_PyGC_PAUSE_BUCKETS);
+        if (histogram == NULL)
+            goto error;
+        for (int j = 0; j < _PyGC_PAUSE_BUCKETS; j++) {
+            PyObject *count = PyLong_FromSsize_t(st->pause_histogram[j]);
+            if (count == NULL) {
+                Py_DECREF(histogram);
+                goto error;
+            }
+            PyTuple_SET_ITEM(histogram, j, count);
+        }
+        /* "N" steals the reference to histogram, even on failure */
+        dict = Py_BuildValue("{snsnsnsnsnsnsdsdsdsdsN}",
                              "collections", st->collections,
                              "collected", st->collected,
-                             "uncollectable", st->uncollectable
+                             "uncollectable", st->uncollectable,
+                             "examined", st->examined,
+                             "survived", st->survived,
+                             "pauses", st->pauses,
+                             "pause_total",
+                             _PyTime_AsSecondsDouble(st->pause_total),
+                             "pause_max",
+                             _PyTime_AsSecondsDouble(st->pause_max),
+                             "weakrefs_time",
+                             _PyTime_AsSecondsDouble(st->weakrefs_time),
+                             "finalize_time",
+                             _PyTime_AsSecondsDouble(st->finalize_time),
+                             "pause_histogram", histogram
                             );
         if (dict == NULL)
             goto error;
@@ -1934,25 +2451,70 @@ gc_is_finalized(PyObject *module, PyObject *obj)
     Py_RETURN_FALSE;
 }
 
+/* Make the objects in list immortal and untrack them, which leaves the list
+ * empty.  Their reference counts and GC headers are no longer written to,
+ * so the pages holding them stay shared after fork().  A container is
+ * only tracked again if it gets an item that the collector must see (see
+ * MAINTAIN_TRACKING in dictobject.c), update_refs() then moves it to the
+ * permanent generation.
+ */
+static void
+gc_immortalize_list(PyGC_Head *list)
+{
+#ifdef Py_REF_DEBUG
+    PyInterpreterState *interp = _PyInterpreterState_GET();
+#endif
+    PyGC_Head *gc, *next;
+    for (gc = GC_NEXT(list); gc != list; gc = next) {
+        PyObject *op = FROM_GC(gc);
+        next = GC_NEXT(gc);
+        if (!_Py_IsImmortal(op)) {
+#ifdef Py_REF_DEBUG
+            /* Decrefs of immortal objects are not counted */
+            _Py_AddRefTotal(interp, -Py_REFCNT(op));
+#endif
+            _Py_SetImmortal(op);
+        }
+        gc->_gc_next = 0;
+        gc->_gc_prev &= _PyGC_PREV_MASK_FINALIZED;
+    }
+    gc_list_init(list);
+}
+
 /*[clinic input]
 gc.freeze
 
+    *
+    immortal: bool = False
+
 Freeze all current tracked objects and ignore them for future collections.
 
 This can be used before a POSIX fork() call to make the gc copy-on-write friendly.
 Note: collection before a POSIX fork() call may free pages for future allocation
 which can cause copy-on-write.
+
+If immortal is true, the frozen objects are also made immortal and
+untracked, so that their reference counts and GC headers are no longer
+written to.  They can't be unfrozen, and are never freed.
 [clinic start generated code]*/
 
 static PyObject *
-gc_freeze_impl(PyObject *module)
-/*[clinic end generated code: output=502159d9cdc4c139 input=b602b16ac5febbe5]*/
+gc_freeze_impl(PyObject *module, int immortal)
+/*[clinic end generated code: output=42dc7e62f9e59ad3 input=cab04918e33b1633]*/
 {
     GCState *gcstate = get_gc_state();
+    gc_end_incremental_cycle(gcstate);
     for (int i = 0; i < NUM_GENERATIONS; ++i) {
         gc_list_merge(GEN_HEAD(gcstate, i), &gcstate->permanent_generation.head);
         gcstate->generations[i].count = 0;
     }
+    if (immortal) {
+        gc_immortalize_list(&gcstate->permanent_generation.head);
+        gcstate->frozen = 0;
+    }
+    else {
+        gcstate->frozen = 1;
+    }
     Py_RETURN_NONE;
 }
 
@@ -1971,6 +2533,7 @@ gc_unfreeze_impl(PyObject *module)
     GCState *gcstate = get_gc_state();
     gc_list_merge(&gcstate->permanent_generation.head,
                   GEN_HEAD(gcstate, NUM_GENERATIONS-1));
+    gcstate->frozen = 0;
     Py_RETURN_NONE;
 }
 
@@ -2002,6 +2565,8 @@ PyDoc_STRVAR(gc__doc__,
 "get_debug() -- Get debugging flags.\n"
 "set_threshold() -- Set the collection thresholds.\n"
 "get_threshold() -- Return the current the collection thresholds.\n"
+"set_pause_budget() -- Set the pause budget of incremental collections.\n"
+"get_pause_budget() -- Return the pause budget of incremental collections.\n"
 "get_objects() -- Return a list of all objects tracked by the collector.\n"
 "is_tracked() -- Returns true if a given object is tracked.\n"
 "is_finalized() -- Returns true if a given object has been already finalized.\n"
@@ -2020,6 +2585,8 @@ static PyMethodDef GcMethods[] = {
     GC_GET_COUNT_METHODDEF
     {"set_threshold",  gc_set_threshold, METH_VARARGS, gc_set_thresh__doc__},
     GC_GET_THRESHOLD_METHODDEF
+    GC_SET_PAUSE_BUDGET_METHODDEF
+    GC_GET_PAUSE_BUDGET_METHODDEF
     GC_COLLECT_METHODDEF
     GC_GET_OBJECTS_METHODDEF
     GC_GET_STATS_METHODDEF
@@ -2437,9 +3004,17 @@ PyUnstable_GC_VisitObjects(gcvisitobjects_t callback, void *arg)
     GCState *gcstate = get_gc_state();
     int origenstate = gcstate->enabled;
     gcstate->enabled = 0;
-    for (i = 0; i < NUM_GENERATIONS; i++) {
+    for (i = 0; i < NUM_GENERATIONS + 2; i++) {
         PyGC_Head *gc_list, *gc;
-        gc_list = GEN_HEAD(gcstate, i);
+        if (i < NUM_GENERATIONS) {
+            gc_list = GEN_HEAD(gcstate, i);
+        }
+        else if (i == NUM_GENERATIONS) {
+            gc_list = &gcstate->old_gray;
+        }
+        else {
+            gc_list = &gcstate->old_visited;
+        }
         for (gc = GC_NEXT(gc_list); gc != gc_list; gc = GC_NEXT(gc)) {
             PyObject *op = FROM_GC(gc);
             Py_INCREF(op);
@@ -30,6 +30,8 @@ As of Python 3.6, this is compact and ordered. Basic idea is described here:
 | dk_entries[]        |
 |                     |
 +---------------------+
+| dk_ctrl[]           |  (grouped tables only)
++---------------------+
 
 dk_indices is actual hashtable.  It holds index in entries, or DKIX_EMPTY(-1)
 or DKIX_DUMMY(-2).
@@ -43,6 +45,10 @@ Size of indices is dk_size.  Type of each index in indices is vary on dk_size:
 dk_entries is array of PyDictKeyEntry when dk_kind == DICT_KEYS_GENERAL or
 PyDictUnicodeEntry otherwise. Its length is USABLE_FRACTION(dk_size).
 
+dk_ctrl only exists for "grouped" tables: Unicode tables with at least
+DK_GROUPED_MINSIZE slots.  It holds one control byte per slot of dk_indices;
+see the comment above DK_GROUP_WIDTH.
+
 NOTE: Since negative value is used for DKIX_EMPTY and DKIX_DUMMY, type of
 dk_indices entry is signed integer and int16 is used for table which
 dk_size == 256.
@@ -411,6 +417,144 @@ dictkeys_set_index(PyDictKeysObject *keys, Py_ssize_t i, Py_ssize_t ix)
  */
 #define USABLE_FRACTION(n) (((n) << 1)/3)
 
+/* Grouped tables.
+
+Large Unicode tables (combined or split) trade the perturbation probe
+sequence for group probing.  Such a table keeps one control byte per slot
+(dk_ctrl, stored after the entries): DK_CTRL_EMPTY, DK_CTRL_DUMMY, or for a
+used slot the low 7 bits of the key's hash.  The slots are probed
+DK_GROUP_WIDTH at a time, starting with the group that contains slot
+(hash >> 7) & mask and then stepping over groups at triangular offsets,
+which visits every group of a power-of-2 table.  Within a group all control
+bytes are compared against the hash's tag at once, and only slots that match
+load dk_indices and the entry.  The probe ends at the first group holding an
+empty slot.
+
+This matters for big tables with many collisions: a miss, or a hit behind a
+long chain, is settled by one or two 16-byte loads instead of a dependent
+index load plus entry load per probe.  Small tables keep the plain probe
+sequence; they fit in a few cache lines anyway and the extra bytes are not
+worth it.
+*/
+#define DK_GROUPED_LOG2_MINSIZE 10
+#define DK_GROUPED_MINSIZE (1 << DK_GROUPED_LOG2_MINSIZE)
+#define DK_GROUP_WIDTH 16
+
+#define DK_CTRL_EMPTY ((uint8_t)0x80)
+#define DK_CTRL_DUMMY ((uint8_t)0xfe)
+#define DK_CTRL_TAG(hash) ((uint8_t)((size_t)(hash) & 0x7f))
+
+static inline int
+dictkeys_is_grouped(const PyDictKeysObject *dk)
+{
+    return (dk->dk_kind != DICT_KEYS_GENERAL
+            && dk->dk_log2_size >= DK_GROUPED_LOG2_MINSIZE);
+}
+
+static inline uint8_t *
+dictkeys_ctrl(PyDictKeysObject *dk)
+{
+    assert(dictkeys_is_grouped(dk));
+    return (uint8_t *)(DK_UNICODE_ENTRIES(dk) + USABLE_FRACTION(DK_SIZE(dk)));
+}
+
+/* Record the state of slot i in a grouped table; no-op otherwise. */
+static inline void
+dictkeys_set_ctrl(PyDictKeysObject *dk, size_t i, uint8_t ctrl)
+{
+    if (dictkeys_is_grouped(dk)) {
+        dictkeys_ctrl(dk)[i] = ctrl;
+    }
+}
+
+static inline size_t
+group_start(Py_hash_t hash, size_t mask)
+{
+    return ((size_t)hash >> 7) & mask & ~(size_t)(DK_GROUP_WIDTH - 1);
+}
+
+/* The group_match*() functions return a mask with bit k set for each slot k
+   of the group whose control byte is the tag / empty / empty or dummy.
+   group_match() may report false positives when SSE2 is not available. */
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+
+static inline uint32_t
+group_match(const uint8_t *group, uint8_t tag)
+{
+    __m128i ctrl = _mm_loadu_si128((const __m128i *)group);
+    __m128i eq = _mm_cmpeq_epi8(ctrl, _mm_set1_epi8((char)tag));
+    return (uint32_t)_mm_movemask_epi8(eq);
+}
+
+static inline uint32_t
+group_match_empty(const uint8_t *group)
+{
+    return group_match(group, DK_CTRL_EMPTY);
+}
+
+static inline uint32_t
+group_match_free(const uint8_t *group)
+{
+    __m128i ctrl = _mm_loadu_si128((const __m128i *)group);
+    return (uint32_t)_mm_movemask_epi8(ctrl);
+}
+
+#else
+/* SWAR (SIMD Within A Register) fallback: two 64-bit words per group. */
+#define GROUP_LSB UINT64_C(0x0101010101010101)
+#define GROUP_MSB UINT64_C(0x8080808080808080)
+
+static inline uint64_t
+group_load(const uint8_t *p)
+{
+    uint64_t word;
+    memcpy(&word, p, sizeof(word));
+#if PY_BIG_ENDIAN
+    word = _Py_bswap64(word);
+#endif
+    return word;
+}
+
+/* Gather the high bit of each byte of word into an 8-bit mask. */
+static inline uint32_t
+group_bits(uint64_t word)
+{
+    return (uint32_t)(((word & GROUP_MSB) * UINT64_C(0x0002040810204081)) >> 56);
+}
+
+static inline uint32_t
+group_word_match(uint64_t word, uint8_t tag)
+{
+    uint64_t x = word ^ (GROUP_LSB * tag);
+    return group_bits((x - GROUP_LSB) & ~x);
+}
+
+static inline uint32_t
+group_match(const uint8_t *group, uint8_t tag)
+{
+    return (group_word_match(group_load(group), tag)
+            | group_word_match(group_load(group + 8), tag) << 8);
+}
+
+static inline uint32_t
+group_match_empty(const uint8_t *group)
+{
+    /* Only DK_CTRL_EMPTY has the high bit set and bit 1 clear. */
+    uint64_t lo = group_load(group), hi = group_load(group + 8);
+    return group_bits(lo & ~(lo << 6)) | group_bits(hi & ~(hi << 6)) << 8;
+}
+
+static inline uint32_t
+group_match_free(const uint8_t *group)
+{
+    return group_bits(group_load(group)) | group_bits(group_load(group + 8)) << 8;
+}
+
+#undef GROUP_LSB
+#undef GROUP_MSB
+#endif
+
 /* Find the smallest dk_size >= minsize. */
 static inline uint8_t
 calculate_log2_keysize(Py_ssize_t minsize)
@@ -542,6 +686,19 @@ _PyDict_CheckConsistency(PyObject *op, int check_content)
         for (Py_ssize_t i=0; i < DK_SIZE(keys); i++) {
             Py_ssize_t ix = dictkeys_get_index(keys, i);
             CHECK(DKIX_DUMMY <= ix && ix <= usable);
+            if (dictkeys_is_grouped(keys)) {
+                uint8_t ctrl = dictkeys_ctrl(keys)[i];
+                if (ix == DKIX_EMPTY) {
+                    CHECK(ctrl == DK_CTRL_EMPTY);
+                }
+                else if (ix == DKIX_DUMMY) {
+                    CHECK(ctrl == DK_CTRL_DUMMY);
+                }
+                else {
+                    PyObject *key = DK_UNICODE_ENTRIES(keys)[ix].me_key;
+                    CHECK(ctrl == DK_CTRL_TAG(unicode_get_hash(key)));
+                }
+            }
         }
 
         if (keys->dk_kind == DICT_KEYS_GENERAL) {
@@ -608,6 +765,7 @@ new_keys_object(PyInterpreterState *interp, uint8_t log2_size, bool unicode)
     Py_ssize_t usable;
     int log2_bytes;
     size_t entry_size = unicode ? sizeof(PyDictUnicodeEntry) : sizeof(PyDictKeyEntry);
+    bool grouped = unicode && log2_size >= DK_GROUPED_LOG2_MINSIZE;
 
     assert(log2_size >= PyDict_LOG_MINSIZE);
 
@@ -642,7 +800,8 @@ new_keys_object(PyInterpreterState *interp, uint8_t log2_size, bool unicode)
     {
         dk = PyObject_Malloc(sizeof(PyDictKeysObject)
                              + ((size_t)1 << log2_bytes)
-                             + entry_size * usable);
+                             + entry_size * usable
+                             + (grouped ? ((size_t)1 << log2_size) : 0));
         if (dk == NULL) {
             PyErr_NoMemory();
             return NULL;
@@ -660,6 +819,9 @@ new_keys_object(PyInterpreterState *interp, uint8_t log2_size, bool unicode)
     dk->dk_version = 0;
     memset(&dk->dk_indices[0], 0xff, ((size_t)1 << log2_bytes));
     memset(&dk->dk_indices[(size_t)1 << log2_bytes], 0, entry_size * usable);
+    if (grouped) {
+        memset(dictkeys_ctrl(dk), DK_CTRL_EMPTY, (size_t)1 << log2_size);
+    }
     return dk;
 }
 
@@ -857,6 +1019,28 @@ PyDict_New(void)
 static Py_ssize_t
 lookdict_index(PyDictKeysObject *k, Py_hash_t hash, Py_ssize_t index)
 {
+    if (dictkeys_is_grouped(k)) {
+        const uint8_t *ctrl = dictkeys_ctrl(k);
+        uint8_t tag = DK_CTRL_TAG(hash);
+        size_t mask = DK_MASK(k);
+        size_t i = group_start(hash, mask);
+        for (size_t step = DK_GROUP_WIDTH;; step += DK_GROUP_WIDTH) {
+            for (uint32_t match = group_match(ctrl + i, tag); match;
+                 match &= match - 1)
+            {
+                size_t j = i + _Py_ctz32(match);
+                if (dictkeys_get_index(k, j) == index) {
+                    return j;
+                }
+            }
+            if (group_match_empty(ctrl + i)) {
+                return DKIX_EMPTY;
+            }
+            i = (i + step) & mask;
+        }
+        Py_UNREACHABLE();
+    }
+
     size_t mask = DK_MASK(k);
     size_t perturb = (size_t)hash;
     size_t i = (size_t)hash & mask;
@@ -875,10 +1059,76 @@ lookdict_index(PyDictKeysObject *k, Py_hash_t hash, Py_ssize_t index)
     Py_UNREACHABLE();
 }
 
+// Compare a non-Unicode key to the key of a Unicode entry: return 1 if
+// they are equal, 0 if not, or DKIX_ERROR / DKIX_KEY_CHANGED.
+static inline Py_ssize_t
+unicodekeys_compare_generic(PyDictObject *mp, PyDictKeysObject *dk,
+                            PyDictUnicodeEntry *ep, PyObject *key, Py_hash_t hash)
+{
+    assert(ep->me_key != NULL);
+    assert(PyUnicode_CheckExact(ep->me_key));
+    if (ep->me_key == key) {
+        return 1;
+    }
+    if (unicode_get_hash(ep->me_key) == hash) {
+        PyObject *startkey = ep->me_key;
+        Py_INCREF(startkey);
+        int cmp = PyObject_RichCompareBool(startkey, key, Py_EQ);
+        Py_DECREF(startkey);
+        if (cmp < 0) {
+            return DKIX_ERROR;
+        }
+        if (dk == mp->ma_keys && ep->me_key == startkey) {
+            return cmp;
+        }
+        else {
+            /* The dict was mutated, restart */
+            return DKIX_KEY_CHANGED;
+        }
+    }
+    return 0;
+}
+
+// Search non-Unicode key from grouped Unicode table
+static Py_ssize_t
+unicodekeys_lookup_generic_grouped(PyDictObject *mp, PyDictKeysObject* dk,
+                                   PyObject *key, Py_hash_t hash)
+{
+    PyDictUnicodeEntry *ep0 = DK_UNICODE_ENTRIES(dk);
+    const uint8_t *ctrl = dictkeys_ctrl(dk);
+    uint8_t tag = DK_CTRL_TAG(hash);
+    size_t mask = DK_MASK(dk);
+    size_t i = group_start(hash, mask);
+    for (size_t step = DK_GROUP_WIDTH;; step += DK_GROUP_WIDTH) {
+        for (uint32_t match = group_match(ctrl + i, tag); match;
+             match &= match - 1)
+        {
+            Py_ssize_t ix = dictkeys_get_index(dk, i + _Py_ctz32(match));
+            assert(ix >= 0);
+            Py_ssize_t cmp = unicodekeys_compare_generic(mp, dk, &ep0[ix],
+                                                         key, hash);
+            if (cmp > 0) {
+                return ix;
+            }
+            if (cmp < 0) {
+                return cmp;
+            }
+        }
+        if (group_match_empty(ctrl + i)) {
+            return DKIX_EMPTY;
+        }
+        i = (i + step) & mask;
+    }
+    Py_UNREACHABLE();
+}
+
 // Search non-Unicode key from Unicode table
 static Py_ssize_t
 unicodekeys_lookup_generic(PyDictObject *mp, PyDictKeysObject* dk, PyObject *key, Py_hash_t hash)
 {
+    if (dictkeys_is_grouped(dk)) {
+        return unicodekeys_lookup_generic_grouped(mp, dk, key, hash);
+    }
     PyDictUnicodeEntry *ep0 = DK_UNICODE_ENTRIES(dk);
     size_t mask = DK_MASK(dk);
     size_t perturb = hash;
@@ -887,29 +1137,13 @@ unicodekeys_lookup_generic(PyDictObject *mp, PyDictKeysObject* dk, PyObject *key
     for (;;) {
         ix = dictkeys_get_index(dk, i);
         if (ix >= 0) {
-            PyDictUnicodeEntry *ep = &ep0[ix];
-            assert(ep->me_key != NULL);
-            assert(PyUnicode_CheckExact(ep->me_key));
-            if (ep->me_key == key) {
+            Py_ssize_t cmp = unicodekeys_compare_generic(mp, dk, &ep0[ix],
+                                                         key, hash);
+            if (cmp > 0) {
                 return ix;
             }
-            if (unicode_get_hash(ep->me_key) == hash) {
-                PyObject *startkey = ep->me_key;
-                Py_INCREF(startkey);
-                int cmp = PyObject_RichCompareBool(startkey, key, Py_EQ);
-                Py_DECREF(startkey);
-                if (cmp < 0) {
-                    return DKIX_ERROR;
-                }
-                if (dk == mp->ma_keys && ep->me_key == startkey) {
-                    if (cmp > 0) {
-                        return ix;
-                    }
-                }
-                else {
-                    /* The dict was mutated, restart */
-                    return DKIX_KEY_CHANGED;
-                }
+            if (cmp < 0) {
+                return cmp;
             }
         }
         else if (ix == DKIX_EMPTY) {
@@ -921,10 +1155,44 @@ unicodekeys_lookup_generic(PyDictObject *mp, PyDictKeysObject* dk, PyObject *key
     Py_UNREACHABLE();
 }
 
+// Search Unicode key from grouped Unicode table.
+static Py_ssize_t
+unicodekeys_lookup_unicode_grouped(PyDictKeysObject* dk, PyObject *key, Py_hash_t hash)
+{
+    PyDictUnicodeEntry *ep0 = DK_UNICODE_ENTRIES(dk);
+    const uint8_t *ctrl = dictkeys_ctrl(dk);
+    uint8_t tag = DK_CTRL_TAG(hash);
+    size_t mask = DK_MASK(dk);
+    size_t i = group_start(hash, mask);
+    for (size_t step = DK_GROUP_WIDTH;; step += DK_GROUP_WIDTH) {
+        for (uint32_t match = group_match(ctrl + i, tag); match;
+             match &= match - 1)
+        {
+            Py_ssize_t ix = dictkeys_get_index(dk, i + _Py_ctz32(match));
+            assert(ix >= 0);
+            PyDictUnicodeEntry *ep = &ep0[ix];
+            assert(ep->me_key != NULL);
+            assert(PyUnicode_CheckExact(ep->me_key));
+            if (ep->me_key == key ||
+                    (unicode_get_hash(ep->me_key) == hash && unicode_eq(ep->me_key, key))) {
+                return ix;
+            }
+        }
+        if (group_match_empty(ctrl + i)) {
+            return DKIX_EMPTY;
+        }
+        i = (i + step) & mask;
+    }
+    Py_UNREACHABLE();
+}
+
 // Search Unicode key from Unicode table.
 static Py_ssize_t _Py_HOT_FUNCTION
 unicodekeys_lookup_unicode(PyDictKeysObject* dk, PyObject *key, Py_hash_t hash)
 {
+    if (dictkeys_is_grouped(dk)) {
+        return unicodekeys_lookup_unicode_grouped(dk, key, hash);
+    }
     PyDictUnicodeEntry *ep0 = DK_UNICODE_ENTRIES(dk);
     size_t mask = DK_MASK(dk);
     size_t perturb = hash;
@@ -1180,6 +1448,17 @@ find_empty_slot(PyDictKeysObject *keys, Py_hash_t hash)
     assert(keys != NULL);
 
     const size_t mask = DK_MASK(keys);
+    if (dictkeys_is_grouped(keys)) {
+        const uint8_t *ctrl = dictkeys_ctrl(keys);
+        size_t i = group_start(hash, mask);
+        for (size_t step = DK_GROUP_WIDTH;; step += DK_GROUP_WIDTH) {
+            uint32_t free = group_match_free(ctrl + i);
+            if (free) {
+                return i + _Py_ctz32(free);
+            }
+            i = (i + step) & mask;
+        }
+    }
     size_t i = hash & mask;
     Py_ssize_t ix = dictkeys_get_index(keys, i);
     for (size_t perturb = hash; ix >= 0;) {
@@ -1219,6 +1498,7 @@ insert_into_dictkeys(PyDictKeysObject *keys, PyObject *name)
         ix = keys->dk_nentries;
         PyDictUnicodeEntry *ep = &DK_UNICODE_ENTRIES(keys)[ix];
         dictkeys_set_index(keys, hashpos, ix);
+        dictkeys_set_ctrl(keys, hashpos, DK_CTRL_TAG(hash));
         assert(ep->me_key == NULL);
         ep->me_key = Py_NewRef(name);
         keys->dk_usable--;
@@ -1266,6 +1546,7 @@ insertdict(PyInterpreterState *interp, PyDictObject *mp,
 
         Py_ssize_t hashpos = find_empty_slot(mp->ma_keys, hash);
         dictkeys_set_index(mp->ma_keys, hashpos, mp->ma_keys->dk_nentries);
+        dictkeys_set_ctrl(mp->ma_keys, hashpos, DK_CTRL_TAG(hash));
 
         if (DK_IS_UNICODE(mp->ma_keys)) {
             PyDictUnicodeEntry *ep;
@@ -1395,6 +1676,17 @@ build_indices_generic(PyDictKeysObject *keys, PyDictKeyEntry *ep, Py_ssize_t n)
 static void
 build_indices_unicode(PyDictKeysObject *keys, PyDictUnicodeEntry *ep, Py_ssize_t n)
 {
+    if (dictkeys_is_grouped(keys)) {
+        uint8_t *ctrl = dictkeys_ctrl(keys);
+        for (Py_ssize_t ix = 0; ix != n; ix++, ep++) {
+            Py_hash_t hash = unicode_get_hash(ep->me_key);
+            assert(hash != -1);
+            Py_ssize_t i = find_empty_slot(keys, hash);
+            dictkeys_set_index(keys, i, ix);
+            ctrl[i] = DK_CTRL_TAG(hash);
+        }
+        return;
+    }
     size_t mask = DK_MASK(keys);
     for (Py_ssize_t ix = 0; ix != n; ix++, ep++) {
         Py_hash_t hash = unicode_get_hash(ep->me_key);
@@ -1970,6 +2262,7 @@ delitem_common(PyDictObject *mp, Py_hash_t hash, Py_ssize_t ix,
     else {
         mp->ma_keys->dk_version = 0;
         dictkeys_set_index(mp->ma_keys, hashpos, DKIX_DUMMY);
+        dictkeys_set_ctrl(mp->ma_keys, hashpos, DK_CTRL_DUMMY);
         if (DK_IS_UNICODE(mp->ma_keys)) {
             PyDictUnicodeEntry *ep = &DK_UNICODE_ENTRIES(mp->ma_keys)[ix];
             old_key = ep->me_key;
@@ -3359,6 +3652,7 @@ PyDict_SetDefault(PyObject *d, PyObject *key, PyObject *defaultobj)
         }
         Py_ssize_t hashpos = find_empty_slot(mp->ma_keys, hash);
         dictkeys_set_index(mp->ma_keys, hashpos, mp->ma_keys->dk_nentries);
+        dictkeys_set_ctrl(mp->ma_keys, hashpos, DK_CTRL_TAG(hash));
         if (DK_IS_UNICODE(mp->ma_keys)) {
             assert(PyUnicode_CheckExact(key));
             PyDictUnicodeEntry *ep = &DK_UNICODE_ENTRIES(mp->ma_keys)[mp->ma_keys->dk_nentries];
@@ -3539,6 +3833,7 @@ dict_popitem_impl(PyDictObject *self)
     assert(j >= 0);
     assert(dictkeys_get_index(self->ma_keys, j) == i);
     dictkeys_set_index(self->ma_keys, j, DKIX_DUMMY);
+    dictkeys_set_ctrl(self->ma_keys, j, DK_CTRL_DUMMY);
 
     PyTuple_SET_ITEM(res, 0, key);
     PyTuple_SET_ITEM(res, 1, value);
@@ -3615,6 +3910,9 @@ _PyDict_KeysSize(PyDictKeysObject *keys)
     size_t size = sizeof(PyDictKeysObject);
     size += (size_t)1 << keys->dk_log2_index_bytes;
     size += USABLE_FRACTION((size_t)DK_SIZE(keys)) * es;
+    if (dictkeys_is_grouped(keys)) {
+        size += (size_t)DK_SIZE(keys);
+    }
     return size;
 }
 
@@ -8,6 +8,7 @@
 #include "pycore_long.h"          // _PyLong_DigitCount
 #include "pycore_modsupport.h"    // _PyArg_NoKwnames()
 #include "pycore_object.h"        // _PyObject_GC_TRACK(), _PyDebugAllocatorStats()
+#include "pycore_pystate.h"       // _Py_GetConfig()
 #include "pycore_tuple.h"         // _PyTuple_FromArray()
 #include <stddef.h>
 
@@ -439,8 +440,8 @@ list_length(PyListObject *a)
     return Py_SIZE(a);
 }
 
-static int
-list_contains(PyListObject *a, PyObject *el)
+int
+_PyList_Contains(PyListObject *a, PyObject *el)
 {
     PyObject *item;
     Py_ssize_t i;
@@ -1220,6 +1221,11 @@ struct s_MergeState {
      * of tuples. It may be set to safe_object_compare, but the idea is that hopefully
      * we can assume more, and use one of the special-case compares. */
     int (*tuple_elem_compare)(PyObject *, PyObject *, MergeState *);
+
+    /* True in the threads of a parallel sort, which run without the GIL:
+     * the special-case compares must not check themselves against
+     * PyObject_RichCompareBool() there. */
+    int gil_released;
 };
 
 /* binarysort is the best method for sorting small arrays: it does
@@ -1556,6 +1562,7 @@ merge_init(MergeState *ms, Py_ssize_t list_size, int has_keyfunc,
     ms->min_gallop = MIN_GALLOP;
     ms->listlen = list_size;
     ms->basekeys = lo->keys;
+    ms->gil_released = 0;
 }
 
 /* Free all the temp memory owned by the MergeState.  This must be called
@@ -2140,7 +2147,7 @@ unsafe_latin_compare(PyObject *v, PyObject *w, MergeState *ms)
            res < 0 :
            PyUnicode_GET_LENGTH(v) < PyUnicode_GET_LENGTH(w));
 
-    assert(res == PyObject_RichCompareBool(v, w, Py_LT));;
+    assert(ms->gil_released || res == PyObject_RichCompareBool(v, w, Py_LT));
     return res;
 }
 
@@ -2165,7 +2172,7 @@ unsafe_long_compare(PyObject *v, PyObject *w, MergeState *ms)
     w0 = _PyLong_CompactValue(wl);
 
     res = v0 < w0;
-    assert(res == PyObject_RichCompareBool(v, w, Py_LT));
+    assert(ms->gil_released || res == PyObject_RichCompareBool(v, w, Py_LT));
     return res;
 }
 
@@ -2180,7 +2187,7 @@ unsafe_float_compare(PyObject *v, PyObject *w, MergeState *ms)
     assert(Py_IS_TYPE(w, &PyFloat_Type));
 
     res = PyFloat_AS_DOUBLE(v) < PyFloat_AS_DOUBLE(w);
-    assert(res == PyObject_RichCompareBool(v, w, Py_LT));
+    assert(ms->gil_released || res == PyObject_RichCompareBool(v, w, Py_LT));
     return res;
 }
 
@@ -2226,6 +2233,440 @@ unsafe_tuple_compare(PyObject *v, PyObject *w, MergeState *ms)
         return PyObject_RichCompareBool(vt->ob_item[i], wt->ob_item[i], Py_LT);
 }
 
+/* Sort the n entries of lo with the natural mergesort: march over them
+ * once, left to right, finding natural runs, extending short natural runs
+ * to minrun elements, and merging runs as we go.  ms must have been set up
+ * by merge_init() for lo.  Return 0 on success, -1 on error.
+ */
+static int
+merge_sort_slice(MergeState *ms, sortslice lo, Py_ssize_t nremaining)
+{
+    Py_ssize_t minrun = merge_compute_minrun(nremaining);
+    do {
+        int descending;
+        Py_ssize_t n;
+
+        /* Identify next run. */
+        n = count_run(ms, lo.keys, lo.keys + nremaining, &descending);
+        if (n < 0)
+            return -1;
+        if (descending)
+            reverse_sortslice(&lo, n);
+        /* If short, extend to min(minrun, nremaining). */
+        if (n < minrun) {
+            const Py_ssize_t force = nremaining <= minrun ?
+                              nremaining : minrun;
+            if (binarysort(ms, lo, lo.keys + force, lo.keys + n) < 0)
+                return -1;
+            n = force;
+        }
+        /* Maybe merge pending runs. */
+        assert(ms->n == 0 || ms->pending[ms->n -1].base.keys +
+                             ms->pending[ms->n-1].len == lo.keys);
+        if (found_new_run(ms, n) < 0)
+            return -1;
+        /* Push new run on stack. */
+        assert(ms->n < MAX_MERGE_PENDING);
+        ms->pending[ms->n].base = lo;
+        ms->pending[ms->n].len = n;
+        ++ms->n;
+        /* Advance to find next run. */
+        sortslice_advance(&lo, n);
+        nremaining -= n;
+    } while (nremaining);
+
+    if (merge_force_collapse(ms) < 0)
+        return -1;
+    assert(ms->n == 1);
+    assert(ms->pending[0].base.keys == ms->basekeys);
+    assert(ms->pending[0].len == ms->listlen);
+    return 0;
+}
+
+/* Parallel sort, enabled with -X sort_threads=n.  When the keys are latin
+ * strings, whose compares never call back into Python and define a total
+ * order, the list is cut into up to n chunks that are sorted by as many
+ * threads with the GIL released.  Adjacent sorted chunks are then merged
+ * pairwise, again in parallel, until one run is left.  The threads are
+ * started once and reused by every round.  A stable sort of totally ordered
+ * keys has only one possible result, so this is the same as the serial sort.
+ * Each task gets the part of a shared scratch array that lies under its own
+ * slice, which is always enough for its merges, so the threads never
+ * allocate memory and never fail.
+ */
+
+/* Don't bother with threads for chunks shorter than this. */
+#define PARALLEL_SORT_MIN_CHUNK (1 << 16)
+
+typedef struct {
+    MergeState ms;
+    sortslice lo;
+    /* If nb == 0, sort lo[:na].  Else merge the sorted runs lo[:na] and
+     * lo[na:na+nb]. */
+    Py_ssize_t na;
+    Py_ssize_t nb;
+    /* The worker thread of the task, if it could be started, waits for go,
+     * runs the task and releases done, until quit is set. */
+    int started;
+    int quit;
+    PyThread_type_lock go;
+    PyThread_type_lock done;
+} sort_task;
+
+static void
+sort_task_init(sort_task *task, MergeState *ms, sortslice lo, sortslice scratch,
+               Py_ssize_t start, Py_ssize_t na, Py_ssize_t nb)
+{
+    task->lo = lo;
+    sortslice_advance(&task->lo, start);
+    task->na = na;
+    task->nb = nb;
+
+    task->ms.key_compare = ms->key_compare;
+    task->ms.key_richcompare = ms->key_richcompare;
+    task->ms.tuple_elem_compare = ms->tuple_elem_compare;
+    task->ms.gil_released = 1;
+    task->ms.min_gallop = MIN_GALLOP;
+    task->ms.listlen = na + nb;
+    task->ms.basekeys = task->lo.keys;
+    task->ms.a = scratch;
+    sortslice_advance(&task->ms.a, start);
+    task->ms.alloced = na + nb;
+    task->ms.n = 0;
+}
+
+static void
+sort_task_run(sort_task *task)
+{
+    MergeState *ms = &task->ms;
+    int res;
+    if (task->nb == 0) {
+        res = merge_sort_slice(ms, task->lo, task->na);
+    }
+    else {
+        ms->pending[0].base = task->lo;
+        ms->pending[0].len = task->na;
+        ms->pending[1].base = task->lo;
+        sortslice_advance(&ms->pending[1].base, task->na);
+        ms->pending[1].len = task->nb;
+        ms->n = 2;
+        res = merge_at(ms, 0);
+    }
+    /* The compares can't fail and no memory is allocated. */
+    assert(res == 0);
+    (void)res;
+}
+
+static void
+sort_task_thread(void *arg)
+{
+    sort_task *task = (sort_task *)arg;
+    for (;;) {
+        PyThread_acquire_lock(task->go, WAIT_LOCK);
+        if (task->quit) {
+            break;
+        }
+        sort_task_run(task);
+        PyThread_release_lock(task->done);
+    }
+    PyThread_release_lock(task->done);
+}
+
+/* Start a worker thread for each task but the first, which is run by the
+ * calling thread, as are the tasks whose thread couldn't be started. */
+static void
+sort_workers_start(sort_task *tasks, Py_ssize_t ntasks)
+{
+    for (Py_ssize_t i = 0; i < ntasks; i++) {
+        tasks[i].started = 0;
+        tasks[i].quit = 0;
+    }
+    for (Py_ssize_t i = 1; i < ntasks; i++) {
+        PyThread_acquire_lock(tasks[i].go, WAIT_LOCK);
+        PyThread_acquire_lock(tasks[i].done, WAIT_LOCK);
+        if (PyThread_start_new_thread(sort_task_thread, &tasks[i])
+            != PYTHREAD_INVALID_THREAD_ID)
+        {
+            tasks[i].started = 1;
+        }
+        else {
+            PyThread_release_lock(tasks[i].go);
+            PyThread_release_lock(tasks[i].done);
+        }
+    }
+}
+
+/* Wait for the worker threads to exit. */
+static void
+sort_workers_stop(sort_task *tasks, Py_ssize_t ntasks)
+{
+    for (Py_ssize_t i = 1; i < ntasks; i++) {
+        if (tasks[i].started) {
+            tasks[i].quit = 1;
+            PyThread_release_lock(tasks[i].go);
+            PyThread_acquire_lock(tasks[i].done, WAIT_LOCK);
+            PyThread_release_lock(tasks[i].done);
+        }
+    }
+}
+
+/* Run the first ntasks tasks to completion, each in its worker thread if it
+ * has one.  Must be called without the GIL. */
+static void
+sort_tasks_run(sort_task *tasks, Py_ssize_t ntasks)
+{
+    for (Py_ssize_t i = 0; i < ntasks; i++) {
+        if (tasks[i].started) {
+            PyThread_release_lock(tasks[i].go);
+        }
+    }
+    for (Py_ssize_t i = 0; i < ntasks; i++) {
+        if (!tasks[i].started) {
+            sort_task_run(&tasks[i]);
+        }
+    }
+    for (Py_ssize_t i = 0; i < ntasks; i++) {
+        if (tasks[i].started) {
+            PyThread_acquire_lock(tasks[i].done, WAIT_LOCK);
+        }
+    }
+}
+
+/* Sort the n entries of lo with up to nthreads threads.  Return 1 if the
+ * slice was sorted, or 0 if it is too short to be worth it or memory is
+ * short, in which case it is left alone.  Never fails.
+ */
+static int
+parallel_sort(MergeState *ms, sortslice lo, Py_ssize_t n, int nthreads)
+{
+    Py_ssize_t nchunks = Py_MIN(nthreads, n / PARALLEL_SORT_MIN_CHUNK);
+    if (nchunks < 2) {
+        return 0;
+    }
+
+    int done = 0;
+    sortslice scratch = {NULL, NULL};
+    Py_ssize_t *bounds = PyMem_New(Py_ssize_t, nchunks + 1);
+    sort_task *tasks = PyMem_New(sort_task, nchunks);
+    if (bounds == NULL || tasks == NULL) {
+        goto exit;
+    }
+    for (Py_ssize_t i = 0; i < nchunks; i++) {
+        tasks[i].go = NULL;
+        tasks[i].done = NULL;
+    }
+    for (Py_ssize_t i = 0; i < nchunks; i++) {
+        tasks[i].go = PyThread_allocate_lock();
+        tasks[i].done = PyThread_allocate_lock();
+        if (tasks[i].go == NULL || tasks[i].done == NULL) {
+            goto exit;
+        }
+    }
+    int multiplier = lo.values != NULL ? 2 : 1;
+    scratch.keys = PyMem_New(PyObject *, multiplier * (size_t)n);
+    if (scratch.keys == NULL) {
+        goto exit;
+    }
+    if (lo.values != NULL) {
+        scratch.values = &scratch.keys[n];
+    }
+
+    for (Py_ssize_t i = 0; i <= nchunks; i++) {
+        bounds[i] = (n / nchunks) * i + Py_MIN(i, n % nchunks);
+    }
+
+    Py_BEGIN_ALLOW_THREADS
+    sort_workers_start(tasks, nchunks);
+    for (Py_ssize_t i = 0; i < nchunks; i++) {
+        sort_task_init(&tasks[i], ms, lo, scratch,
+                       bounds[i], bounds[i+1] - bounds[i], 0);
+    }
+    sort_tasks_run(tasks, nchunks);
+
+    /* Merge runs 2*j and 2*j+1 into run j until only one is left. */
+    Py_ssize_t nruns = nchunks;
+    while (nruns > 1) {
+        Py_ssize_t npairs = nruns / 2;
+        for (Py_ssize_t j = 0; j < npairs; j++) {
+            Py_ssize_t start = bounds[2*j];
+            Py_ssize_t mid = bounds[2*j + 1];
+            sort_task_init(&tasks[j], ms, lo, scratch,
+                           start, mid - start, bounds[2*j + 2] - mid);
+        }
+        sort_tasks_run(tasks, npairs);
+        for (Py_ssize_t j = 0; j <= npairs; j++) {
+            bounds[j] = bounds[2*j];
+        }
+        if (nruns & 1) {
+            bounds[npairs + 1] = n;
+        }
+        nruns -= npairs;
+    }
+    sort_workers_stop(tasks, nchunks);
+    Py_END_ALLOW_THREADS
+    done = 1;
+
+exit:
+    if (tasks != NULL) {
+        for (Py_ssize_t i = 0; i < nchunks; i++) {
+            if (tasks[i].go != NULL) {
+                PyThread_free_lock(tasks[i].go);
+            }
+            if (tasks[i].done != NULL) {
+                PyThread_free_lock(tasks[i].done);
+            }
+        }
+    }
+    PyMem_Free(scratch.keys);
+    PyMem_Free(tasks);
+    PyMem_Free(bounds);
+    return done;
+}
+
+/* LSD radix sort for large homogeneous lists of bounded ints, floats and
+ * latin strings; see "RADIX SORT" in listsort.txt.  Every key is mapped to a
+ * uint64_t whose unsigned order agrees with "<" on the keys, and the
+ * (uint64_t, position) pairs are sorted a byte at a time with counting
+ * passes, skipping bytes that are the same in every key.  Counting passes are
+ * stable, so equal keys keep their order, as timsort would.
+ */
+
+/* Lists shorter than this are left to timsort. */
+#define RADIX_SORT_MIN 1024
+
+typedef struct {
+    uint64_t key;
+    Py_ssize_t index;
+} radix_item;
+
+static inline uint64_t
+radix_long_key(PyObject *v)
+{
+    assert(_PyLong_IsCompact((PyLongObject *)v));
+    int64_t x = _PyLong_CompactValue((PyLongObject *)v);
+    return (uint64_t)x ^ ((uint64_t)1 << 63);
+}
+
+/* The caller must reject NaNs: they are unordered. */
+static inline uint64_t
+radix_float_key(PyObject *v)
+{
+    double x = PyFloat_AS_DOUBLE(v);
+    uint64_t bits;
+    assert(!Py_IS_NAN(x));
+    if (x == 0.0) {
+        /* -0.0 == 0.0: both must get the same key to stay stable. */
+        x = 0.0;
+    }
+    memcpy(&bits, &x, sizeof(bits));
+    if (bits >> 63) {
+        return ~bits;
+    }
+    return bits | ((uint64_t)1 << 63);
+}
+
+/* Only orders strings by their first 8 characters. */
+static inline uint64_t
+radix_latin_key(PyObject *v)
+{
+    assert(PyUnicode_KIND(v) == PyUnicode_1BYTE_KIND);
+    const Py_UCS1 *data = PyUnicode_1BYTE_DATA(v);
+    Py_ssize_t len = Py_MIN(PyUnicode_GET_LENGTH(v), 8);
+    uint64_t key = 0;
+    for (Py_ssize_t i = 0; i < 8; i++) {
+        key = (key << 8) | (i < len ? data[i] : 0);
+    }
+    return key;
+}
+
+/* Radix sort the n keys of lo, using ms->key_compare to tell their kind.
+ * Return 1 if the slice is sorted, or 0 if timsort must still run: latin
+ * strings only get sorted by their prefix, and floats are left alone if
+ * there is a NaN or if memory is short.  Never fails.
+ */
+static int
+radix_sort(MergeState *ms, sortslice *lo, Py_ssize_t n)
+{
+    int latin = ms->key_compare == unsafe_latin_compare;
+    assert(n >= RADIX_SORT_MIN);
+    assert(latin || ms->key_compare == unsafe_long_compare ||
+           ms->key_compare == unsafe_float_compare);
+
+    radix_item *src = PyMem_New(radix_item, 2 * (size_t)n);
+    if (src == NULL) {
+        return 0;
+    }
+    radix_item *dst = src + n;
+
+    size_t counts[8][256];
+    memset(counts, 0, sizeof(counts));
+    int presorted = 1;
+    uint64_t prev = 0;
+    for (Py_ssize_t i = 0; i < n; i++) {
+        PyObject *v = lo->keys[i];
+        uint64_t key;
+        if (ms->key_compare == unsafe_long_compare) {
+            key = radix_long_key(v);
+        }
+        else if (latin) {
+            key = radix_latin_key(v);
+        }
+        else {
+            if (Py_IS_NAN(PyFloat_AS_DOUBLE(v))) {
+                PyMem_Free(src);
+                return 0;
+            }
+            key = radix_float_key(v);
+        }
+        src[i].key = key;
+        src[i].index = i;
+        presorted &= prev <= key;
+        prev = key;
+        for (int b = 0; b < 8; b++) {
+            counts[b][(key >> (8 * b)) & 0xff]++;
+        }
+    }
+    if (presorted) {
+        PyMem_Free(src);
+        return !latin;
+    }
+
+    for (int b = 0; b < 8; b++) {
+        int shift = 8 * b;
+        size_t *count = counts[b];
+        if (count[(src[0].key >> shift) & 0xff] == (size_t)n) {
+            continue;
+        }
+        size_t offset = 0;
+        for (int d = 0; d < 256; d++) {
+            size_t c = count[d];
+            count[d] = offset;
+            offset += c;
+        }
+        for (Py_ssize_t i = 0; i < n; i++) {
+            dst[count[(src[i].key >> shift) & 0xff]++] = src[i];
+        }
+        radix_item *tmp = src;
+        src = dst;
+        dst = tmp;
+    }
+
+    /* Apply the permutation, using dst as scratch space. */
+    PyObject **scratch = (PyObject **)dst;
+    for (Py_ssize_t i = 0; i < n; i++) {
+        scratch[i] = lo->keys[src[i].index];
+    }
+    memcpy(lo->keys, scratch, n * sizeof(PyObject *));
+    if (lo->values != NULL) {
+        for (Py_ssize_t i = 0; i < n; i++) {
+            scratch[i] = lo->values[src[i].index];
+        }
+        memcpy(lo->values, scratch, n * sizeof(PyObject *));
+    }
+    PyMem_Free(src < dst ? src : dst);
+    return !latin;
+}
+
 /* An adaptive, stable, natural mergesort.  See listsort.txt.
  * Returns Py_None on success, NULL on error.  Even in case of error, the
  * list will be some permutation of its input state (nothing is lost or
@@ -2255,7 +2696,6 @@ list_sort_impl(PyListObject *self, PyObject *keyfunc, int reverse)
 {
     MergeState ms;
     Py_ssize_t nremaining;
-    Py_ssize_t minrun;
     sortslice lo;
     Py_ssize_t saved_ob_size, saved_allocated;
     PyObject **saved_ob_item;
@@ -2425,51 +2865,36 @@ list_sort_impl(PyListObject *self, PyObject *keyfunc, int reverse)
         reverse_slice(&saved_ob_item[0], &saved_ob_item[saved_ob_size]);
     }
 
-    /* March over the array once, left to right, finding natural runs,
-     * and extending short natural runs to minrun elements.
+    /* Large lists of keys that map to integers radix sort in linear time.
+     * Latin strings are only radix sorted by their first characters, which
+     * leaves timsort with long runs to find below.
      */
-    minrun = merge_compute_minrun(nremaining);
-    do {
-        int descending;
-        Py_ssize_t n;
+    if (nremaining >= RADIX_SORT_MIN &&
+        (ms.key_compare == unsafe_long_compare ||
+         ms.key_compare == unsafe_float_compare ||
+         ms.key_compare == unsafe_latin_compare))
+    {
+        if (radix_sort(&ms, &lo, nremaining)) {
+            goto succeed;
+        }
+    }
 
-        /* Identify next run. */
-        n = count_run(&ms, lo.keys, lo.keys + nremaining, &descending);
-        if (n < 0)
-            goto fail;
-        if (descending)
-            reverse_sortslice(&lo, n);
-        /* If short, extend to min(minrun, nremaining). */
-        if (n < minrun) {
-            const Py_ssize_t force = nremaining <= minrun ?
-                              nremaining : minrun;
-            if (binarysort(&ms, lo, lo.keys + force, lo.keys + n) < 0)
-                goto fail;
-            n = force;
+    /* Only latin strings are sorted in parallel: the radix sort above
+     * already sorted ints completely, and floats only get here if there is
+     * a NaN, and then the result depends on the order of the merges. */
+    int nthreads = _Py_GetConfig()->sort_threads;
+    if (nthreads > 1 && ms.key_compare == unsafe_latin_compare) {
+        if (parallel_sort(&ms, lo, nremaining, nthreads)) {
+            goto succeed;
         }
-        /* Maybe merge pending runs. */
-        assert(ms.n == 0 || ms.pending[ms.n -1].base.keys +
-                            ms.pending[ms.n-1].len == lo.keys);
-        if (found_new_run(&ms, n) < 0)
-            goto fail;
-        /* Push new run on stack. */
-        assert(ms.n < MAX_MERGE_PENDING);
-        ms.pending[ms.n].base = lo;
-        ms.pending[ms.n].len = n;
-        ++ms.n;
-        /* Advance to find next run. */
-        sortslice_advance(&lo, n);
-        nremaining -= n;
-    } while (nremaining);
+    }
 
-    if (merge_force_collapse(&ms) < 0)
+    if (merge_sort_slice(&ms, lo, nremaining) < 0)
         goto fail;
-    assert(ms.n == 1);
     assert(keys == NULL
            ? ms.pending[0].base.keys == saved_ob_item
            : ms.pending[0].base.keys == &keys[0]);
     assert(ms.pending[0].len == saved_ob_size);
-    lo = ms.pending[0].base;
 
 succeed:
     result = Py_None;
@@ -2872,7 +3297,7 @@ static PySequenceMethods list_as_sequence = {
     0,                                          /* sq_slice */
     (ssizeobjargproc)list_ass_item,             /* sq_ass_item */
     0,                                          /* sq_ass_slice */
-    (objobjproc)list_contains,                  /* sq_contains */
+    (objobjproc)_PyList_Contains,               /* sq_contains */
     (binaryfunc)list_inplace_concat,            /* sq_inplace_concat */
     (ssizeargfunc)list_inplace_repeat,          /* sq_inplace_repeat */
 };
@@ -27,9 +27,6 @@ class int "PyObject *" "&PyLong_Type"
 #define _MAX_STR_DIGITS_ERROR_FMT_TO_INT "Exceeds the limit (%d digits) for integer string conversion: value has %zd digits; use sys.set_int_max_str_digits() to increase the limit"
 #define _MAX_STR_DIGITS_ERROR_FMT_TO_STR "Exceeds the limit (%d digits) for integer string conversion; use sys.set_int_max_str_digits() to increase the limit"
 
-/* If defined, use algorithms from the _pylong.py module */
-#define WITH_PYLONG_MODULE 1
-
 static inline void
 _Py_DECREF_INT(PyLongObject *op)
 {
@@ -72,6 +69,21 @@ maybe_small_long(PyLongObject *v)
 #define KARATSUBA_CUTOFF 70
 #define KARATSUBA_SQUARE_CUTOFF (2 * KARATSUBA_CUTOFF)
 
+/* Above that, k_mul switches to Toom-Cook 3-way multiplication when the
+ * smaller operand has at least TOOM3_CUTOFF digits, and to multiplication
+ * by number-theoretic transform from NTT_CUTOFF digits.
+ */
+#define TOOM3_CUTOFF 250
+#define TOOM3_SQUARE_CUTOFF (2 * TOOM3_CUTOFF)
+#define NTT_CUTOFF 4000
+#define NTT_SQUARE_CUTOFF NTT_CUTOFF
+#define NTT_MAX_LOG2 24
+
+/* Division uses the recursive algorithm of x_divrem_bz() when both the
+ * divisor and the quotient have at least BURNIKEL_ZIEGLER_CUTOFF digits.
+ */
+#define BURNIKEL_ZIEGLER_CUTOFF 100
+
 /* For exponentiation, use the binary left-to-right algorithm unless the
  ^ exponent contains more than HUGE_EXP_CUTOFF bits.  In that case, do
  * (no more than) EXP_WINDOW_SIZE bits at a time.  The potential drawback is
@@ -1681,71 +1693,156 @@ rem1(PyLongObject *a, digit n)
     );
 }
 
-#ifdef WITH_PYLONG_MODULE
-/* asymptotically faster long_to_decimal_string, using _pylong.py */
-static int
-pylong_int_to_decimal_string(PyObject *aa,
-                             PyObject **p_output,
-                             _PyUnicodeWriter *writer,
-                             _PyBytesWriter *bytes_writer,
-                             char **bytes_str)
-{
-    PyObject *s = NULL;
-    PyObject *mod = PyImport_ImportModule("_pylong");
-    if (mod == NULL) {
-        return -1;
+/* forward */
+static int long_divrem(PyLongObject *, PyLongObject *,
+                       PyLongObject **, PyLongObject **);
+static Py_ssize_t long_compare(PyLongObject *, PyLongObject *);
+static PyObject *long_add(PyLongObject *, PyLongObject *);
+static PyObject *long_mul(PyLongObject *, PyLongObject *);
+static PyObject *long_abs(PyLongObject *);
+
+/* Divide-and-conquer conversions between int and decimal.
+
+   The schoolbook conversions below are quadratic in the number of digits.
+   For large ints both directions instead work with the powers
+
+       P[i] = _PyLong_DECIMAL_BASE ** (2 ** (DECIMAL_DC_LEAF_LOG2 + i)),
+
+   each obtained by squaring the previous one.  Converting to decimal splits
+   a into divmod(a, P[i]) and recurses on both halves, the low half padded
+   with zeros to exactly 2 ** (DECIMAL_DC_LEAF_LOG2 + i) digits in base
+   _PyLong_DECIMAL_BASE.  Converting from decimal goes the other way,
+   combining adjacent chunks of the string as hi * P[i] + lo, one level at
+   a time.  Pieces of at most 2 ** DECIMAL_DC_LEAF_LOG2 digits in base
+   _PyLong_DECIMAL_BASE are left to the schoolbook algorithms, which are
+   faster at that size.  With Karatsuba multiplication and the recursive
+   division of x_divrem_bz() both directions take O(n**1.58) time.
+
+   The divide-and-conquer algorithms are used for ints of more than
+   DECIMAL_DC_CUTOFF digits and for strings of more than DECIMAL_DC_MIN_DIGITS
+   decimal digits. */
+#define DECIMAL_DC_LEAF_LOG2 6
+#define DECIMAL_DC_CUTOFF 250
+#define DECIMAL_DC_MIN_DIGITS 6000
+
+/* Return (base ** _PyLong_DECIMAL_SHIFT) ** (2 ** DECIMAL_DC_LEAF_LOG2); this
+   is P[0] for base 10. */
+static PyLongObject *
+decimal_dc_base_power(long base)
+{
+    long b = 1;
+    for (int i = 0; i < _PyLong_DECIMAL_SHIFT; i++) {
+        b *= base;
     }
-    s = PyObject_CallMethod(mod, "int_to_decimal_string", "O", aa);
-    if (s == NULL) {
-        goto error;
+    PyLongObject *pow = (PyLongObject *)PyLong_FromLong(b);
+    for (int i = 0; i < DECIMAL_DC_LEAF_LOG2 && pow != NULL; i++) {
+        Py_SETREF(pow, (PyLongObject *)long_mul(pow, pow));
     }
-    if (!PyUnicode_Check(s)) {
-        PyErr_SetString(PyExc_TypeError,
-                        "_pylong.int_to_decimal_string did not return a str");
-        goto error;
-    }
-    if (writer) {
-        Py_ssize_t size = PyUnicode_GET_LENGTH(s);
-        if (_PyUnicodeWriter_Prepare(writer, size, '9') == -1) {
-            goto error;
+    return pow;
+}
+
+/* Convert |a| to base _PyLong_DECIMAL_BASE, following Knuth (TAOCP,
+   Volume 2 (3rd edn), section 4.4, Method 1b).  The digits are stored in
+   pout, least significant first.  Return the number of digits stored (0 if
+   a is zero), or -1 if interrupted. */
+static Py_ssize_t
+long_to_decimal_base(PyLongObject *a, digit *pout)
+{
+    digit *pin = a->long_value.ob_digit;
+    Py_ssize_t i, j, size = 0;
+
+    for (i = _PyLong_DigitCount(a); --i >= 0; ) {
+        digit hi = pin[i];
+        for (j = 0; j < size; j++) {
+            twodigits z = (twodigits)pout[j] << PyLong_SHIFT | hi;
+            hi = (digit)(z / _PyLong_DECIMAL_BASE);
+            pout[j] = (digit)(z - (twodigits)hi *
+                              _PyLong_DECIMAL_BASE);
         }
-        if (_PyUnicodeWriter_WriteStr(writer, s) < 0) {
-            goto error;
+        while (hi) {
+            pout[size++] = hi % _PyLong_DECIMAL_BASE;
+            hi /= _PyLong_DECIMAL_BASE;
         }
-        goto success;
+        /* check for keyboard interrupt */
+        SIGCHECK({
+                return -1;
+            });
     }
-    else if (bytes_writer) {
-        Py_ssize_t size = PyUnicode_GET_LENGTH(s);
-        const void *data = PyUnicode_DATA(s);
-        int kind = PyUnicode_KIND(s);
-        *bytes_str = _PyBytesWriter_Prepare(bytes_writer, *bytes_str, size);
-        if (*bytes_str == NULL) {
-            goto error;
-        }
-        char *p = *bytes_str;
-        for (Py_ssize_t i=0; i < size; i++) {
-            Py_UCS4 ch = PyUnicode_READ(kind, data, i);
-            *p++ = (char) ch;
+    return size;
+}
+
+/* Store 0 <= a < pow[i]**2 in base _PyLong_DECIMAL_BASE in pout, padded
+   with zeros to at least pad digits.  Return the number of digits stored,
+   or -1 on error. */
+static Py_ssize_t
+long_to_decimal_base_rec(PyLongObject *a, PyLongObject **pow, int i,
+                         digit *pout, Py_ssize_t pad)
+{
+    PyLongObject *q, *r;
+    Py_ssize_t w, size;
+
+    while (i >= 0 && long_compare(a, pow[i]) < 0) {
+        i--;
+    }
+    if (i < 0) {
+        size = long_to_decimal_base(a, pout);
+        while (0 <= size && size < pad) {
+            pout[size++] = 0;
         }
-        (*bytes_str) = p;
-        goto success;
+        return size;
     }
-    else {
-        *p_output = Py_NewRef(s);
-        goto success;
+    if (long_divrem(a, pow[i], &q, &r) < 0) {
+        return -1;
     }
+    w = (Py_ssize_t)1 << (DECIMAL_DC_LEAF_LOG2 + i);
+    size = long_to_decimal_base_rec(r, pow, i - 1, pout, w);
+    if (size >= 0) {
+        assert(size == w);
+        size = long_to_decimal_base_rec(q, pow, i - 1, pout + w,
+                                        pad > w ? pad - w : 0);
+        if (size >= 0) {
+            size += w;
+        }
+    }
+    Py_DECREF(q);
+    Py_DECREF(r);
+    return size;
+}
 
-error:
-        Py_DECREF(mod);
-        Py_XDECREF(s);
-        return -1;
+/* Same as long_to_decimal_base(), but subquadratic. */
+static Py_ssize_t
+long_to_decimal_base_dc(PyLongObject *a, digit *pout)
+{
+    PyLongObject *pow[64];
+    Py_ssize_t size_a = _PyLong_DigitCount(a), size = -1;
+    int n = 0;
 
-success:
-        Py_DECREF(mod);
-        Py_DECREF(s);
-        return 0;
+    a = (PyLongObject *)long_abs(a);
+    if (a == NULL) {
+        return -1;
+    }
+    pow[0] = decimal_dc_base_power(10);
+    if (pow[0] == NULL) {
+        goto done;
+    }
+    n = 1;
+    /* Square until a < pow[n-1]**2. */
+    while (2 * (_PyLong_DigitCount(pow[n-1]) - 1) < size_a) {
+        assert(n < (int)Py_ARRAY_LENGTH(pow));
+        pow[n] = (PyLongObject *)long_mul(pow[n-1], pow[n-1]);
+        if (pow[n] == NULL) {
+            goto done;
+        }
+        n++;
+    }
+    size = long_to_decimal_base_rec(a, pow, n - 1, pout, 0);
+done:
+    while (n > 0) {
+        Py_DECREF(pow[--n]);
+    }
+    Py_DECREF(a);
+    return size;
 }
-#endif /* WITH_PYLONG_MODULE */
 
 /* Convert an integer to a base 10 string.  Returns a new non-shared
    string.  (Return value is non-shared so that callers can modify the
@@ -1761,7 +1858,7 @@ long_to_decimal_string_internal(PyObject *aa,
     PyLongObject *scratch, *a;
     PyObject *str = NULL;
     Py_ssize_t size, strlen, size_a, i, j;
-    digit *pout, *pin, rem, tenpow;
+    digit *pout, rem, tenpow;
     int negative;
     int d;
     int kind;
@@ -1791,17 +1888,6 @@ long_to_decimal_string_internal(PyObject *aa,
         }
     }
 
-#if WITH_PYLONG_MODULE
-    if (size_a > 1000) {
-        /* Switch to _pylong.int_to_decimal_string(). */
-        return pylong_int_to_decimal_string(aa,
-                                         p_output,
-                                         writer,
-                                         bytes_writer,
-                                         bytes_str);
-    }
-#endif
-
     /* quick and dirty upper bound for the number of digits
        required to express a in base _PyLong_DECIMAL_BASE:
 
@@ -1824,29 +1910,18 @@ long_to_decimal_string_internal(PyObject *aa,
     if (scratch == NULL)
         return -1;
 
-    /* convert array of base _PyLong_BASE digits in pin to an array of
-       base _PyLong_DECIMAL_BASE digits in pout, following Knuth (TAOCP,
-       Volume 2 (3rd edn), section 4.4, Method 1b). */
-    pin = a->long_value.ob_digit;
+    /* convert array of base _PyLong_BASE digits to an array of
+       base _PyLong_DECIMAL_BASE digits in pout */
     pout = scratch->long_value.ob_digit;
-    size = 0;
-    for (i = size_a; --i >= 0; ) {
-        digit hi = pin[i];
-        for (j = 0; j < size; j++) {
-            twodigits z = (twodigits)pout[j] << PyLong_SHIFT | hi;
-            hi = (digit)(z / _PyLong_DECIMAL_BASE);
-            pout[j] = (digit)(z - (twodigits)hi *
-                              _PyLong_DECIMAL_BASE);
-        }
-        while (hi) {
-            pout[size++] = hi % _PyLong_DECIMAL_BASE;
-            hi /= _PyLong_DECIMAL_BASE;
-        }
-        /* check for keyboard interrupt */
-        SIGCHECK({
-                Py_DECREF(scratch);
-                return -1;
-            });
+    if (size_a > DECIMAL_DC_CUTOFF) {
+        size = long_to_decimal_base_dc(a, pout);
+    }
+    else {
+        size = long_to_decimal_base(a, pout);
+    }
+    if (size < 0) {
+        Py_DECREF(scratch);
+        return -1;
     }
     /* pout should have at least one digit, so that the case when a = 0
        works correctly */
@@ -2300,40 +2375,6 @@ long_from_binary_base(const char *start, const char *end, Py_ssize_t digits, int
 
 static PyObject *long_neg(PyLongObject *v);
 
-#ifdef WITH_PYLONG_MODULE
-/* asymptotically faster str-to-long conversion for base 10, using _pylong.py */
-static int
-pylong_int_from_string(const char *start, const char *end, PyLongObject **res)
-{
-    PyObject *mod = PyImport_ImportModule("_pylong");
-    if (mod == NULL) {
-        goto error;
-    }
-    PyObject *s = PyUnicode_FromStringAndSize(start, end-start);
-    if (s == NULL) {
-        Py_DECREF(mod);
-        goto error;
-    }
-    PyObject *result = PyObject_CallMethod(mod, "int_from_string", "O", s);
-    Py_DECREF(s);
-    Py_DECREF(mod);
-    if (result == NULL) {
-        goto error;
-    }
-    if (!PyLong_Check(result)) {
-        Py_DECREF(result);
-        PyErr_SetString(PyExc_TypeError,
-                        "_pylong.int_from_string did not return an int");
-        goto error;
-    }
-    *res = (PyLongObject *)result;
-    return 0;
-error:
-    *res = NULL;
-    return 0;  // See the long_from_string_base() API comment.
-}
-#endif /* WITH_PYLONG_MODULE */
-
 /***
 long_from_non_binary_base: parameters and return values are the same as
 long_from_binary_base.
@@ -2556,6 +2597,112 @@ long_from_non_binary_base(const char *start, const char *end, Py_ssize_t digits,
     return 0;
 }
 
+/* Same as long_from_non_binary_base() for base 10, but subquadratic: see
+   "Divide-and-conquer conversions between int and decimal" above. */
+static int
+long_from_decimal_base_dc(const char *start, const char *end,
+                          Py_ssize_t digits, PyLongObject **res)
+{
+    const Py_ssize_t leaf = _PyLong_DECIMAL_SHIFT << DECIMAL_DC_LEAF_LOG2;
+    PyLongObject **parts = NULL, *pow = NULL, *z;
+    Py_ssize_t nparts, count = 0, i, w;
+    char *buf, *p;
+
+    *res = NULL;
+    /* Strip the underscores, so that the string can be cut anywhere. */
+    buf = PyMem_Malloc(digits);
+    if (buf == NULL) {
+        PyErr_NoMemory();
+        return 0;
+    }
+    for (p = buf; start < end; start++) {
+        if (*start != '_') {
+            *p++ = *start;
+        }
+    }
+    assert(p - buf == digits);
+
+    /* Convert chunks of leaf digits, least significant first. */
+    nparts = (digits + leaf - 1) / leaf;
+    parts = PyMem_New(PyLongObject *, nparts);
+    if (parts == NULL) {
+        PyErr_NoMemory();
+        goto done;
+    }
+    for (count = 0; count < nparts; count++) {
+        Py_ssize_t hi = digits - count * leaf;
+        Py_ssize_t lo = Py_MAX(hi - leaf, 0);
+        long_from_non_binary_base(buf + lo, buf + hi, hi - lo, 10, &z);
+        if (z == NULL) {
+            goto done;
+        }
+        parts[count] = long_normalize(z);
+    }
+
+    /* Combine adjacent pairs as hi * 10**w + lo until one part is left,
+       computing hi * 10**w as (hi * 5**w) << w to keep the multiplications
+       smaller. */
+    pow = decimal_dc_base_power(5);
+    if (pow == NULL) {
+        goto done;
+    }
+    w = leaf;
+    while (nparts > 1) {
+        for (i = 0; 2 * i < nparts; i++) {
+            PyLongObject *lo = parts[2 * i];
+            parts[2 * i] = NULL;
+            if (2 * i + 1 < nparts) {
+                PyLongObject *hi = parts[2 * i + 1];
+                parts[2 * i + 1] = NULL;
+                z = (PyLongObject *)long_mul(hi, pow);
+                Py_DECREF(hi);
+                if (z != NULL) {
+                    Py_SETREF(z, (PyLongObject *)_PyLong_Lshift((PyObject *)z,
+                                                                (size_t)w));
+                }
+                if (z != NULL) {
+                    Py_SETREF(z, (PyLongObject *)long_add(z, lo));
+                }
+                Py_DECREF(lo);
+                if (z == NULL) {
+                    goto done;
+                }
+            }
+            else {
+                z = lo;
+            }
+            parts[i] = z;
+        }
+        nparts = (nparts + 1) / 2;
+        if (nparts > 1) {
+            Py_SETREF(pow, (PyLongObject *)long_mul(pow, pow));
+            if (pow == NULL) {
+                goto done;
+            }
+            w *= 2;
+        }
+    }
+    z = parts[0];
+    parts[0] = NULL;
+    /* The caller sets the sign in place, so don't return a small int. */
+    if (Py_REFCNT(z) != 1) {
+        Py_SETREF(z, _PyLong_FromDigits(0, _PyLong_DigitCount(z),
+                                        z->long_value.ob_digit));
+    }
+    *res = z;
+
+done:
+    if (parts != NULL) {
+        for (i = 0; i < count; i++) {
+            Py_XDECREF(parts[i]);
+        }
+        PyMem_Free(parts);
+    }
+    Py_XDECREF(pow);
+    PyMem_Free(buf);
+    return 0;
+}
+
 /* *str points to the first digit in a string of base `base` digits. base is an
  * integer from 2 to 36 inclusive. Here we don't need to worry about prefixes
  * like 0x or leading +- signs. The string should be null terminated consisting
@@ -2564,13 +2711,12 @@ long_from_non_binary_base(const char *start, const char *end, Py_ssize_t digits,
  *
  * If base is a power of 2 then the complexity is linear in the number of
  * characters in the string. Otherwise a quadratic algorithm is used for
- * non-binary bases.
+ * non-binary bases, except for long decimal strings.
  *
  * Return values:
  *
  *   - Returns -1 on syntax error (exception needs to be set, *res is untouched)
- *   - Returns 0 and sets *res to NULL for MemoryError, OverflowError, or
- *     _pylong.int_from_string() errors.
+ *   - Returns 0 and sets *res to NULL for MemoryError or OverflowError.
  *   - Returns 0 and sets *res to an unsigned, unnormalized PyLong (success!).
  *
  * Afterwards *str is set to point to the first non-digit (which may be *str!).
@@ -2649,12 +2795,9 @@ long_from_string_base(const char **str, int base, PyLongObject **res)
                 return 0;
             }
         }
-#if WITH_PYLONG_MODULE
-        if (digits > 6000 && base == 10) {
-            /* Switch to _pylong.int_from_string() */
-            return pylong_int_from_string(start, end, res);
+        if (base == 10 && digits > DECIMAL_DC_MIN_DIGITS) {
+            return long_from_decimal_base_dc(start, end, digits, res);
         }
-#endif
         /* Use the quadratic algorithm for non binary bases. */
         return long_from_non_binary_base(start, end, digits, base, res);
     }
@@ -2831,6 +2974,8 @@ PyLong_FromUnicodeObject(PyObject *u, int base)
 /* forward */
 static PyLongObject *x_divrem
     (PyLongObject *, PyLongObject *, PyLongObject **);
+static PyLongObject *x_divrem_bz
+    (PyLongObject *, PyLongObject *, PyLongObject **);
 static PyObject *long_long(PyObject *v);
 
 /* Int division with remainder, top-level routine */
@@ -2964,6 +3109,10 @@ x_divrem(PyLongObject *v1, PyLongObject *w1, PyLongObject **prem)
     size_v = _PyLong_DigitCount(v1);
     size_w = _PyLong_DigitCount(w1);
     assert(size_v >= size_w && size_w >= 2); /* Assert checks by div() */
+    if (size_w >= BURNIKEL_ZIEGLER_CUTOFF &&
+        size_v - size_w >= BURNIKEL_ZIEGLER_CUTOFF) {
+        return x_divrem_bz(v1, w1, prem);
+    }
     v = _PyLong_New(size_v+1);
     if (v == NULL) {
         *prem = NULL;
@@ -3648,6 +3797,10 @@ kmul_split(PyLongObject *n,
 }
 
 static PyLongObject *k_lopsided_mul(PyLongObject *a, PyLongObject *b);
+static PyLongObject *toom3_mul(PyLongObject *a, PyLongObject *b);
+#if PyLong_SHIFT == 30
+static PyLongObject *ntt_mul(PyLongObject *a, PyLongObject *b);
+#endif
 
 /* Karatsuba multiplication.  Ignores the input signs, and returns the
  * absolute value of the product (or NULL if error).
@@ -3697,6 +3850,16 @@ k_mul(PyLongObject *a, PyLongObject *b)
             return x_mul(a, b);
     }
 
+#if PyLong_SHIFT == 30
+    /* Use the number-theoretic transform for huge numbers.  Its cost
+     * depends on asize + bsize, so it doesn't mind lopsided inputs.
+     */
+    if (asize >= (a == b ? NTT_SQUARE_CUTOFF : NTT_CUTOFF) &&
+        asize + bsize <= ((Py_ssize_t)1 << NTT_MAX_LOG2)) {
+        return ntt_mul(a, b);
+    }
+#endif
+
     /* If a is small compared to b, splitting on b gives a degenerate
      * case with ah==0, and Karatsuba may be (even much) less efficient
      * than "grade school" then.  However, we can still win, by viewing
@@ -3706,6 +3869,9 @@ k_mul(PyLongObject *a, PyLongObject *b)
     if (2 * asize <= bsize)
         return k_lopsided_mul(a, b);
 
+    if (asize >= (a == b ? TOOM3_SQUARE_CUTOFF : TOOM3_CUTOFF))
+        return toom3_mul(a, b);
+
     /* Split a & b into hi & lo pieces. */
     shift = bsize >> 1;
     if (kmul_split(a, shift, &ah, &al) < 0) goto fail;
@@ -3926,6 +4092,425 @@ k_lopsided_mul(PyLongObject *a, PyLongObject *b)
     return NULL;
 }
 
+/* Toom-Cook 3-way multiplication.  Ignores the input signs, and returns the
+ * absolute value of the product (or NULL if error).
+ *
+ * Split a and b into three pieces of k digits, a = a2*X**2 + a1*X + a0 with
+ * X = PyLong_BASE**k, evaluate both polynomials at 0, 1, -1, -2 and
+ * infinity, multiply the five pairs of values recursively, and interpolate
+ * to get the five coefficients of the product.  That's 5 multiplications of
+ * a third the size instead of the 9 of grade school, or O(n**1.46).  The
+ * evaluation and interpolation sequence is Bodrato's ("Towards Optimal
+ * Toom-Cook Multiplication for Univariate and Multivariate Polynomials in
+ * Characteristic 2 and 0", 2007).
+ */
+static PyLongObject *
+toom3_mul(PyLongObject *a, PyLongObject *b)
+{
+    Py_ssize_t asize = _PyLong_DigitCount(a);
+    Py_ssize_t bsize = _PyLong_DigitCount(b);
+    Py_ssize_t k = (Py_MAX(asize, bsize) + 2) / 3;
+    PyLongObject *pa[3] = {NULL}, *pb[3] = {NULL};
+    /* values at 0, 1, -1, -2 and infinity, then the products */
+    PyLongObject *va[5] = {NULL}, *vb[5] = {NULL}, *r[5] = {NULL};
+    PyLongObject *t = NULL, *ret = NULL;
+    PyLongObject *two = NULL;
+    digit rem;
+    int i;
+
+#define TOOM3_SET(x, expr)                      \
+    do {                                        \
+        PyLongObject *_tmp = (PyLongObject *)(expr); \
+        if (_tmp == NULL) {                     \
+            goto done;                          \
+        }                                       \
+        Py_XSETREF(x, _tmp);                    \
+    } while (0)
+
+    /* Split into pieces: a == a2*X**2 + a1*X + a0. */
+    if (kmul_split(a, k, &t, &pa[0]) < 0) {
+        goto done;
+    }
+    i = kmul_split(t, k, &pa[2], &pa[1]);
+    Py_CLEAR(t);
+    if (i < 0) {
+        goto done;
+    }
+    if (a == b) {
+        for (i = 0; i < 3; i++) {
+            pb[i] = (PyLongObject *)Py_NewRef(pa[i]);
+        }
+    }
+    else {
+        if (kmul_split(b, k, &t, &pb[0]) < 0) {
+            goto done;
+        }
+        i = kmul_split(t, k, &pb[2], &pb[1]);
+        Py_CLEAR(t);
+        if (i < 0) {
+            goto done;
+        }
+    }
+    two = (PyLongObject *)PyLong_FromLong(2);
+    if (two == NULL) {
+        goto done;
+    }
+
+    /* Evaluate: v(0) = p0, v(1) = p0 + p1 + p2, v(-1) = p0 - p1 + p2,
+       v(-2) = 2*(v(-1) + p2) - p0, v(inf) = p2. */
+    for (i = 0; i < (a == b ? 1 : 2); i++) {
+        PyLongObject **p = i ? pb : pa, **v = i ? vb : va;
+        v[0] = (PyLongObject *)Py_NewRef(p[0]);
+        v[4] = (PyLongObject *)Py_NewRef(p[2]);
+        TOOM3_SET(v[1], _PyLong_Add(p[0], p[2]));
+        TOOM3_SET(v[2], _PyLong_Subtract(v[1], p[1]));
+        TOOM3_SET(v[1], _PyLong_Add(v[1], p[1]));
+        TOOM3_SET(v[3], _PyLong_Add(v[2], p[2]));
+        TOOM3_SET(v[3], _PyLong_Multiply(v[3], two));
+        TOOM3_SET(v[3], _PyLong_Subtract(v[3], p[0]));
+    }
+
+    /* Pointwise products; squarings stay squarings. */
+    for (i = 0; i < 5; i++) {
+        TOOM3_SET(r[i], _PyLong_Multiply(va[i], a == b ? va[i] : vb[i]));
+    }
+
+    /* Interpolate, in place:
+           r3 = (r(-2) - r(1)) / 3
+           r1 = (r(1) - r(-1)) / 2
+           r2 = r(-1) - r(0)
+           r3 = (r2 - r3) / 2 + 2*r(inf)
+           r2 = r2 + r1 - r(inf)
+           r1 = r1 - r3
+       The divisions are exact. */
+    TOOM3_SET(r[3], _PyLong_Subtract(r[3], r[1]));
+    t = divrem1(r[3], 3, &rem);
+    if (t == NULL) {
+        goto done;
+    }
+    assert(rem == 0);
+    if (_PyLong_IsNegative(r[3])) {
+        _PyLong_FlipSign(t);
+    }
+    Py_SETREF(r[3], t);
+    t = NULL;
+    TOOM3_SET(r[1], _PyLong_Subtract(r[1], r[2]));
+    TOOM3_SET(r[1], _PyLong_Rshift((PyObject *)r[1], 1));
+    TOOM3_SET(r[2], _PyLong_Subtract(r[2], r[0]));
+    TOOM3_SET(r[3], _PyLong_Subtract(r[2], r[3]));
+    TOOM3_SET(r[3], _PyLong_Rshift((PyObject *)r[3], 1));
+    TOOM3_SET(t, _PyLong_Lshift((PyObject *)r[4], 1));
+    TOOM3_SET(r[3], _PyLong_Add(r[3], t));
+    Py_CLEAR(t);
+    TOOM3_SET(r[2], _PyLong_Add(r[2], r[1]));
+    TOOM3_SET(r[2], _PyLong_Subtract(r[2], r[4]));
+    TOOM3_SET(r[1], _PyLong_Subtract(r[1], r[3]));
+
+    /* Recompose: ret = r4*X**4 + r3*X**3 + r2*X**2 + r1*X + r0.  All the
+       coefficients of the product of nonnegative polynomials are
+       nonnegative, and each fits in the digits left at its offset. */
+    ret = _PyLong_New(asize + bsize);
+    if (ret == NULL) {
+        goto done;
+    }
+    memset(ret->long_value.ob_digit, 0, (asize + bsize) * sizeof(digit));
+    for (i = 0; i < 5; i++) {
+        assert(!_PyLong_IsNegative(r[i]));
+        assert(i * k + _PyLong_DigitCount(r[i]) <= asize + bsize);
+        (void)v_iadd(ret->long_value.ob_digit + i * k,
+                     asize + bsize - i * k,
+                     r[i]->long_value.ob_digit, _PyLong_DigitCount(r[i]));
+    }
+    long_normalize(ret);
+
+#undef TOOM3_SET
+  done:
+    for (i = 0; i < 3; i++) {
+        Py_XDECREF(pa[i]);
+        Py_XDECREF(pb[i]);
+    }
+    for (i = 0; i < 5; i++) {
+        Py_XDECREF(va[i]);
+        Py_XDECREF(vb[i]);
+        Py_XDECREF(r[i]);
+    }
+    Py_XDECREF(two);
+    return ret;
+}
+
+#if PyLong_SHIFT == 30
+/* Number-theoretic transform multiplication.  Ignores the input signs, and
+ * returns the absolute value of the product (or NULL if error).
+ *
+ * The digits of a and b are the coefficients of two polynomials in
+ * PyLong_BASE, and the product of the polynomials is their convolution.
+ * That is computed modulo three primes p = c*2**m + 1 < 2**31 with
+ * transforms of length n = 2**j <= 2**NTT_MAX_LOG2, in O(n log n) time, and
+ * recovered exactly by the Chinese remainder theorem: each coefficient is
+ * less than n * PyLong_BASE**2 <= 2**84, and the product of the primes is
+ * more than 2**89.  Carrying the coefficients into digits gives the product.
+ *
+ * The arithmetic modulo p uses Montgomery multiplication with R = 2**32:
+ * ntt_redc(t) is t / R mod p.
+ */
+
+typedef struct {
+    uint32_t p;         /* the prime */
+    uint32_t g;         /* a primitive root modulo p */
+} ntt_prime;
+
+/* Ordered by size, which the reconstruction in ntt_mul() relies on. */
+static const ntt_prime ntt_primes[3] = {
+    {469762049, 3},     /* 7 * 2**26 + 1 */
+    {754974721, 11},    /* 45 * 2**24 + 1 */
+    {2013265921, 31},   /* 15 * 2**27 + 1 */
+};
+
+typedef struct {
+    uint32_t p;
+    uint32_t pinv;      /* -1/p mod R */
+    uint32_t r2;        /* R**2 mod p */
+} ntt_mod;
+
+static inline uint32_t
+ntt_redc(uint64_t t, const ntt_mod *m)
+{
+    uint32_t q = (uint32_t)t * m->pinv;
+    uint32_t r = (uint32_t)((t + (uint64_t)q * m->p) >> 32);
+    return r >= m->p ? r - m->p : r;
+}
+
+static inline uint32_t
+ntt_mulmod(uint32_t a, uint32_t b, const ntt_mod *m)
+{
+    return ntt_redc((uint64_t)a * b, m);
+}
+
+static inline uint32_t
+ntt_addmod(uint32_t a, uint32_t b, const ntt_mod *m)
+{
+    uint32_t s = a + b;
+    return s >= m->p ? s - m->p : s;
+}
+
+static inline uint32_t
+ntt_submod(uint32_t a, uint32_t b, const ntt_mod *m)
+{
+    return a >= b ? a - b : a + m->p - b;
+}
+
+/* Return (x * R) mod p, x's Montgomery form. */
+static inline uint32_t
+ntt_to_mont(uint32_t x, const ntt_mod *m)
+{
+    return ntt_mulmod(x, m->r2, m);
+}
+
+static void
+ntt_mod_init(ntt_mod *m, uint32_t p)
+{
+    uint32_t inv = p;
+    uint64_t r = ((uint64_t)1 << 32) % p;
+
+    /* Newton's iteration doubles the number of correct low bits. */
+    for (int i = 0; i < 4; i++) {
+        inv *= 2 - p * inv;
+    }
+    assert(p * inv == 1);
+    m->p = p;
+    m->pinv = (uint32_t)0 - inv;
+    m->r2 = (uint32_t)(r * r % p);
+}
+
+/* Return x**e mod p, in Montgomery form if x is. */
+static uint32_t
+ntt_powmod(uint32_t x, uint64_t e, const ntt_mod *m)
+{
+    uint32_t result = ntt_to_mont(1, m);
+    while (e) {
+        if (e & 1) {
+            result = ntt_mulmod(result, x, m);
+        }
+        x = ntt_mulmod(x, x, m);
+        e >>= 1;
+    }
+    return result;
+}
+
+/* Fill the twiddle factors for transforms of length n with the given root
+   of unity of order n: the butterflies of half-length len use
+   w[len:2*len], with w[len + j] = root**(j * n/(2*len)), in Montgomery form.
+   w[0] is unused. */
+static void
+ntt_roots(uint32_t *w, Py_ssize_t n, uint32_t root, const ntt_mod *m)
+{
+    Py_ssize_t len, j;
+
+    if (n < 2) {
+        return;
+    }
+    w[n/2] = ntt_to_mont(1, m);
+    for (j = 1; j < n/2; j++) {
+        w[n/2 + j] = ntt_mulmod(w[n/2 + j - 1], root, m);
+    }
+    for (len = n/4; len >= 1; len /= 2) {
+        for (j = 0; j < len; j++) {
+            w[len + j] = w[2*len + 2*j];
+        }
+    }
+}
+
+/* Forward transform of x[0:n], by decimation in frequency.  The output is
+   in bit-reversed order, which ntt_inverse() expects. */
+static void
+ntt_forward(uint32_t *x, Py_ssize_t n, const uint32_t *w, const ntt_mod *m)
+{
+    for (Py_ssize_t len = n/2; len >= 1; len /= 2) {
+        const uint32_t *wl = w + len;
+        for (Py_ssize_t s = 0; s < n; s += 2*len) {
+            uint32_t *x0 = x + s, *x1 = x + s + len;
+            for (Py_ssize_t j = 0; j < len; j++) {
+                uint32_t u = x0[j], v = x1[j];
+                x0[j] = ntt_addmod(u, v, m);
+                x1[j] = ntt_mulmod(ntt_submod(u, v, m), wl[j], m);
+            }
+        }
+    }
+}
+
+/* Inverse transform of x[0:n], by decimation in time, w being the twiddle
+   factors of the inverse root.  The result is n times too large. */
+static void
+ntt_inverse(uint32_t *x, Py_ssize_t n, const uint32_t *w, const ntt_mod *m)
+{
+    for (Py_ssize_t len = 1; len < n; len *= 2) {
+        const uint32_t *wl = w + len;
+        for (Py_ssize_t s = 0; s < n; s += 2*len) {
+            uint32_t *x0 = x + s, *x1 = x + s + len;
+            for (Py_ssize_t j = 0; j < len; j++) {
+                uint32_t u = x0[j], v = ntt_mulmod(x1[j], wl[j], m);
+                x0[j] = ntt_addmod(u, v, m);
+                x1[j] = ntt_submod(u, v, m);
+            }
+        }
+    }
+}
+
+static PyLongObject *
+ntt_mul(PyLongObject *a, PyLongObject *b)
+{
+    const Py_ssize_t asize = _PyLong_DigitCount(a);
+    const Py_ssize_t bsize = _PyLong_DigitCount(b);
+    const Py_ssize_t ncoeffs = asize + bsize - 1;
+    const int square = a == b;
+    ntt_mod mods[3];
+    uint32_t *buf, *res[3], *tb, *w, *winv;
+    uint32_t scale[3];
+    Py_ssize_t n, i;
+    PyLongObject *ret;
+    int k;
+
+    n = 1;
+    while (n < ncoeffs) {
+        n *= 2;
+    }
+    assert(n <= ((Py_ssize_t)1 << NTT_MAX_LOG2));
+    /* res[0..2], tb, w and winv: n words each */
+    buf = PyMem_New(uint32_t, 6 * n);
+    if (buf == NULL) {
+        PyErr_NoMemory();
+        return NULL;
+    }
+    tb = buf + 3 * n;
+    w = buf + 4 * n;
+    winv = buf + 5 * n;
+
+    for (k = 0; k < 3; k++) {
+        ntt_mod *m = &mods[k];
+        uint32_t p = ntt_primes[k].p, root;
+        uint32_t *x = res[k] = buf + k * n;
+
+        ntt_mod_init(m, p);
+        root = ntt_powmod(ntt_to_mont(ntt_primes[k].g, m), (p - 1) / n, m);
+        ntt_roots(w, n, root, m);
+        ntt_roots(winv, n, ntt_powmod(root, n - 1, m), m);
+        /* scale = R**2 / n, so that ntt_redc(x * scale) = x * R / n undoes
+           both the factor n of the inverse transform and the 1/R of the
+           pointwise products. */
+        scale[k] = ntt_mulmod(m->r2,
+                              ntt_powmod(ntt_to_mont((uint32_t)(n % p), m),
+                                         p - 2, m), m);
+        for (i = 0; i < asize; i++) {
+            x[i] = a->long_value.ob_digit[i] % p;
+        }
+        memset(x + asize, 0, (n - asize) * sizeof(uint32_t));
+        ntt_forward(x, n, w, m);
+        if (square) {
+            for (i = 0; i < n; i++) {
+                x[i] = ntt_mulmod(x[i], x[i], m);
+            }
+        }
+        else {
+            for (i = 0; i < bsize; i++) {
+                tb[i] = b->long_value.ob_digit[i] % p;
+            }
+            memset(tb + bsize, 0, (n - bsize) * sizeof(uint32_t));
+            ntt_forward(tb, n, w, m);
+            for (i = 0; i < n; i++) {
+                x[i] = ntt_mulmod(x[i], tb[i], m);
+            }
+        }
+        ntt_inverse(x, n, winv, m);
+    }
+
+    ret = _PyLong_New(asize + bsize);
+    if (ret == NULL) {
+        PyMem_Free(buf);
+        return NULL;
+    }
+    /* Recover each coefficient c from its residues r0, r1, r2 (Garner's
+       algorithm): c = x + p0*p1*t with x = r0 + p0*((r1 - r0)/p0 mod p1)
+       and t = (r2 - x)/(p0*p1) mod p2.  Then carry it into the digits,
+       splitting x and p0*p1 into 30-bit halves to stay within 64 bits. */
+    {
+        const ntt_mod *m1 = &mods[1], *m2 = &mods[2];
+        const uint64_t p0 = mods[0].p, p01 = p0 * mods[1].p;
+        /* 1/p0 mod p1 and 1/(p0*p1) mod p2, in Montgomery form */
+        const uint32_t inv0 = ntt_powmod(
+            ntt_to_mont((uint32_t)p0, m1), m1->p - 2, m1);
+        const uint32_t inv01 = ntt_powmod(
+            ntt_to_mont((uint32_t)(p01 % m2->p), m2), m2->p - 2, m2);
+        const uint32_t inv01r = ntt_to_mont(inv01, m2);
+        digit *pz = ret->long_value.ob_digit;
+        uint64_t carry = 0;
+
+        for (i = 0; i < ncoeffs; i++) {
+            uint32_t r0 = ntt_mulmod(res[0][i], scale[0], &mods[0]);
+            uint32_t r1 = ntt_mulmod(res[1][i], scale[1], m1);
+            uint32_t r2 = ntt_mulmod(res[2][i], scale[2], m2);
+            /* r0 < p0 < p1, so r1 - r0 needs no reduction first */
+            uint64_t x = r0 + p0 * ntt_mulmod(ntt_submod(r1, r0, m1), inv0, m1);
+            /* ntt_redc(x) = x / R mod p2, as x < p2 * R */
+            uint32_t t = ntt_submod(ntt_mulmod(r2, inv01, m2),
+                                    ntt_mulmod(ntt_redc(x, m2), inv01r, m2),
+                                    m2);
+            uint64_t lo = (x & PyLong_MASK) + (p01 & PyLong_MASK) * t;
+            uint64_t hi = (x >> PyLong_SHIFT) + (p01 >> PyLong_SHIFT) * t;
+            lo += carry;
+            pz[i] = (digit)(lo & PyLong_MASK);
+            carry = (lo >> PyLong_SHIFT) + hi;
+        }
+        for (; i < asize + bsize; i++) {
+            pz[i] = (digit)(carry & PyLong_MASK);
+            carry >>= PyLong_SHIFT;
+        }
+        assert(carry == 0);
+    }
+    PyMem_Free(buf);
+    return long_normalize(ret);
+}
+#endif /* PyLong_SHIFT == 30 */
+
 PyObject *
 _PyLong_Multiply(PyLongObject *a, PyLongObject *b)
 {
@@ -3998,45 +4583,299 @@ fast_floor_div(PyLongObject *a, PyLongObject *b)
     return PyLong_FromLong(div);
 }
 
-#ifdef WITH_PYLONG_MODULE
-/* asymptotically faster divmod, using _pylong.py */
+/* Fast recursive division, due to Burnikel and Ziegler ("Fast Recursive
+   Division", 1998).  Dividing a 2n-digit number by an n-digit one is done
+   as two 3n/2-by-n divisions, each costing one recursive n-by-n/2 division
+   plus an n/2-by-n/2 multiplication, so with Karatsuba multiplication the
+   whole division takes O(n**1.58) instead of the O(n**2) of the schoolbook
+   algorithm in x_divrem().  This is the algorithm of Lib/_pylong.py's
+   int_divmod(), but working in whole digits, so that all the splitting and
+   joining is simple copying.
+
+   x_divrem() switches to it when both the divisor and the quotient have at
+   least BURNIKEL_ZIEGLER_CUTOFF digits; pieces below that size are divided
+   with the schoolbook algorithm again. */
+
+/* Return the nonnegative int made of digits lo to hi-1 of a, that is
+   |a| // PyLong_BASE**lo % PyLong_BASE**(hi-lo).  hi may exceed the size
+   of a. */
+static PyLongObject *
+digits_slice(PyLongObject *a, Py_ssize_t lo, Py_ssize_t hi)
+{
+    PyLongObject *z;
+
+    hi = Py_MIN(hi, _PyLong_DigitCount(a));
+    while (hi > lo && a->long_value.ob_digit[hi-1] == 0) {
+        hi--;
+    }
+    if (hi <= lo) {
+        return (PyLongObject *)_PyLong_GetZero();
+    }
+    z = _PyLong_New(hi - lo);
+    if (z == NULL) {
+        return NULL;
+    }
+    memcpy(z->long_value.ob_digit, a->long_value.ob_digit + lo,
+           (hi - lo) * sizeof(digit));
+    return z;
+}
+
+/* Return hi * PyLong_BASE**k + lo, for nonnegative hi and lo where lo has
+   at most k digits. */
+static PyLongObject *
+digits_join(PyLongObject *hi, PyLongObject *lo, Py_ssize_t k)
+{
+    Py_ssize_t size_hi = _PyLong_DigitCount(hi);
+    Py_ssize_t size_lo = _PyLong_DigitCount(lo);
+    PyLongObject *z;
+    digit *pz;
+
+    assert(!_PyLong_IsNegative(hi) && !_PyLong_IsNegative(lo));
+    assert(size_lo <= k);
+    if (size_hi == 0) {
+        return (PyLongObject *)Py_NewRef(lo);
+    }
+    z = _PyLong_New(k + size_hi);
+    if (z == NULL) {
+        return NULL;
+    }
+    pz = z->long_value.ob_digit;
+    memcpy(pz, lo->long_value.ob_digit, size_lo * sizeof(digit));
+    memset(pz + size_lo, 0, (k - size_lo) * sizeof(digit));
+    memcpy(pz + k, hi->long_value.ob_digit, size_hi * sizeof(digit));
+    return z;
+}
+
+static int bz_div3n2n(PyLongObject *, PyLongObject *, PyLongObject *,
+                      PyLongObject *, PyLongObject *, Py_ssize_t,
+                      PyLongObject **, PyLongObject **);
+
+/* Divide 0 <= a < b * PyLong_BASE**n by b, where b has exactly n digits
+   and its top digit is at least PyLong_BASE/2. */
+static int
+bz_div2n1n(PyLongObject *a, PyLongObject *b, Py_ssize_t n,
+           PyLongObject **pq, PyLongObject **pr)
+{
+    PyLongObject *zero = (PyLongObject *)_PyLong_GetZero();
+    PyLongObject *b1 = NULL, *b2 = NULL, *a12 = NULL, *a3 = NULL, *a4 = NULL;
+    PyLongObject *q1 = NULL, *q2 = NULL, *r1 = NULL, *r2 = NULL;
+    Py_ssize_t half;
+    int pad, res = -1;
+
+    if (_PyLong_DigitCount(a) - n < BURNIKEL_ZIEGLER_CUTOFF) {
+        return long_divrem(a, b, pq, pr);
+    }
+    pad = n & 1;
+    if (pad) {
+        /* Make n even by multiplying both a and b by PyLong_BASE. */
+        a = digits_join(a, zero, 1);
+        if (a == NULL) {
+            return -1;
+        }
+        b = digits_join(b, zero, 1);
+        if (b == NULL) {
+            Py_DECREF(a);
+            return -1;
+        }
+        n++;
+    }
+    else {
+        Py_INCREF(a);
+        Py_INCREF(b);
+    }
+    half = n >> 1;
+    if ((b1 = digits_slice(b, half, n)) == NULL ||
+        (b2 = digits_slice(b, 0, half)) == NULL ||
+        (a12 = digits_slice(a, n, PY_SSIZE_T_MAX)) == NULL ||
+        (a3 = digits_slice(a, half, n)) == NULL ||
+        (a4 = digits_slice(a, 0, half)) == NULL ||
+        bz_div3n2n(a12, a3, b, b1, b2, half, &q1, &r1) < 0 ||
+        bz_div3n2n(r1, a4, b, b1, b2, half, &q2, &r2) < 0)
+    {
+        goto done;
+    }
+    if (pad) {
+        /* Undo the scaling: the remainder is a multiple of PyLong_BASE. */
+        Py_SETREF(r2, digits_slice(r2, 1, PY_SSIZE_T_MAX));
+        if (r2 == NULL) {
+            goto done;
+        }
+    }
+    *pq = digits_join(q1, q2, half);
+    if (*pq == NULL) {
+        goto done;
+    }
+    *pr = r2;
+    r2 = NULL;
+    res = 0;
+done:
+    Py_DECREF(a);
+    Py_DECREF(b);
+    Py_XDECREF(b1);
+    Py_XDECREF(b2);
+    Py_XDECREF(a12);
+    Py_XDECREF(a3);
+    Py_XDECREF(a4);
+    Py_XDECREF(q1);
+    Py_XDECREF(q2);
+    Py_XDECREF(r1);
+    Py_XDECREF(r2);
+    return res;
+}
+
+/* Divide a12 * PyLong_BASE**n + a3 by b = b1 * PyLong_BASE**n + b2, where
+   a3 has at most n digits, b1 has exactly n digits with its top digit at
+   least PyLong_BASE/2, and the quotient is less than PyLong_BASE**n. */
 static int
-pylong_int_divmod(PyLongObject *v, PyLongObject *w,
-                  PyLongObject **pdiv, PyLongObject **pmod)
+bz_div3n2n(PyLongObject *a12, PyLongObject *a3, PyLongObject *b,
+           PyLongObject *b1, PyLongObject *b2, Py_ssize_t n,
+           PyLongObject **pq, PyLongObject **pr)
 {
-    PyObject *mod = PyImport_ImportModule("_pylong");
-    if (mod == NULL) {
+    PyLongObject *q = NULL, *r = NULL, *t;
+    Py_ssize_t cmp, i;
+
+    t = digits_slice(a12, n, PY_SSIZE_T_MAX);
+    if (t == NULL) {
         return -1;
     }
-    PyObject *result = PyObject_CallMethod(mod, "int_divmod", "OO", v, w);
-    Py_DECREF(mod);
-    if (result == NULL) {
-        return -1;
+    cmp = long_compare(t, b1);
+    Py_DECREF(t);
+    if (cmp == 0) {
+        /* a12 // b1 doesn't fit in n digits; the estimate
+           q = PyLong_BASE**n - 1 is still at most 2 too large. */
+        q = _PyLong_New(n);
+        if (q == NULL) {
+            return -1;
+        }
+        for (i = 0; i < n; i++) {
+            q->long_value.ob_digit[i] = PyLong_MASK;
+        }
+        t = digits_join(b1, (PyLongObject *)_PyLong_GetZero(), n);
+        if (t == NULL) {
+            goto error;
+        }
+        r = (PyLongObject *)long_sub(a12, t);
+        Py_DECREF(t);
+        if (r == NULL) {
+            goto error;
+        }
+        Py_SETREF(r, (PyLongObject *)long_add(r, b1));
+        if (r == NULL) {
+            goto error;
+        }
     }
-    if (!PyTuple_Check(result)) {
-        Py_DECREF(result);
-        PyErr_SetString(PyExc_ValueError,
-                        "tuple is required from int_divmod()");
+    else if (bz_div2n1n(a12, b1, n, &q, &r) < 0) {
         return -1;
     }
-    PyObject *q = PyTuple_GET_ITEM(result, 0);
-    PyObject *r = PyTuple_GET_ITEM(result, 1);
-    if (!PyLong_Check(q) || !PyLong_Check(r)) {
-        Py_DECREF(result);
-        PyErr_SetString(PyExc_ValueError,
-                        "tuple of int is required from int_divmod()");
-        return -1;
+    Py_SETREF(r, digits_join(r, a3, n));
+    if (r == NULL) {
+        goto error;
     }
-    if (pdiv != NULL) {
-        *pdiv = (PyLongObject *)Py_NewRef(q);
+    t = (PyLongObject *)long_mul(q, b2);
+    if (t == NULL) {
+        goto error;
     }
-    if (pmod != NULL) {
-        *pmod = (PyLongObject *)Py_NewRef(r);
+    Py_SETREF(r, (PyLongObject *)long_sub(r, t));
+    Py_DECREF(t);
+    if (r == NULL) {
+        goto error;
     }
-    Py_DECREF(result);
+    while (_PyLong_IsNegative(r)) {
+        Py_SETREF(q, (PyLongObject *)long_sub(
+            q, (PyLongObject *)_PyLong_GetOne()));
+        if (q == NULL) {
+            goto error;
+        }
+        Py_SETREF(r, (PyLongObject *)long_add(r, b));
+        if (r == NULL) {
+            goto error;
+        }
+    }
+    *pq = q;
+    *pr = r;
     return 0;
+error:
+    Py_XDECREF(q);
+    Py_XDECREF(r);
+    return -1;
 }
-#endif /* WITH_PYLONG_MODULE */
+
+/* Unsigned int division with remainder using the recursive algorithm.
+   The arguments and result are as for x_divrem(). */
+static PyLongObject *
+x_divrem_bz(PyLongObject *v1, PyLongObject *w1, PyLongObject **prem)
+{
+    PyLongObject *a, *b, *q = NULL, *r = NULL, *t, *qd;
+    Py_ssize_t size_v, size_w, size_a, size_r, n, i;
+    int d;
+
+    *prem = NULL;
+    size_v = _PyLong_DigitCount(v1);
+    size_w = _PyLong_DigitCount(w1);
+    a = _PyLong_New(size_v + 1);
+    b = _PyLong_New(size_w);
+    if (a == NULL || b == NULL) {
+        goto done;
+    }
+
+    /* normalize, as in x_divrem() */
+    d = PyLong_SHIFT - bit_length_digit(w1->long_value.ob_digit[size_w-1]);
+    (void)v_lshift(b->long_value.ob_digit, w1->long_value.ob_digit,
+                   size_w, d);
+    a->long_value.ob_digit[size_v] = v_lshift(
+        a->long_value.ob_digit, v1->long_value.ob_digit, size_v, d);
+    long_normalize(a);
+    size_a = _PyLong_DigitCount(a);
+
+    /* Schoolbook division in base PyLong_BASE**n, using bz_div2n1n() to
+       divide each 2-digit prefix by the 1-digit divisor. */
+    n = size_w;
+    q = _PyLong_New(size_a);
+    if (q == NULL) {
+        goto done;
+    }
+    memset(q->long_value.ob_digit, 0, size_a * sizeof(digit));
+    r = (PyLongObject *)_PyLong_GetZero();
+    for (i = (size_a - 1) / n; i >= 0; i--) {
+        t = digits_slice(a, i * n, (i + 1) * n);
+        if (t == NULL) {
+            goto done;
+        }
+        Py_SETREF(t, digits_join(r, t, n));
+        Py_CLEAR(r);
+        if (t == NULL || bz_div2n1n(t, b, n, &qd, &r) < 0) {
+            Py_XDECREF(t);
+            goto done;
+        }
+        Py_DECREF(t);
+        assert(_PyLong_DigitCount(qd) <= n);
+        memcpy(q->long_value.ob_digit + i * n, qd->long_value.ob_digit,
+               _PyLong_DigitCount(qd) * sizeof(digit));
+        Py_DECREF(qd);
+    }
+    long_normalize(q);
+
+    /* unshift the remainder */
+    size_r = _PyLong_DigitCount(r);
+    *prem = _PyLong_New(size_r);
+    if (*prem == NULL) {
+        Py_CLEAR(q);
+        goto done;
+    }
+    (void)v_rshift((*prem)->long_value.ob_digit, r->long_value.ob_digit,
+                   size_r, d);
+    long_normalize(*prem);
+
+done:
+    if (*prem == NULL) {
+        Py_CLEAR(q);
+    }
+    Py_XDECREF(a);
+    Py_XDECREF(b);
+    Py_XDECREF(r);
+    return q;
+}
+
 
 /* The / and % operators are now defined in terms of divmod().
    The expression a mod b has the value a - b*floor(a/b).
@@ -4089,18 +4928,6 @@ l_divmod(PyLongObject *v, PyLongObject *w,
         }
         return 0;
     }
-#if WITH_PYLONG_MODULE
-    Py_ssize_t size_v = _PyLong_DigitCount(v); /* digits in numerator */
-    Py_ssize_t size_w = _PyLong_DigitCount(w); /* digits in denominator */
-    if (size_w > 300 && (size_v - size_w) > 150) {
-        /* Switch to _pylong.int_divmod().  If the quotient is small then
-          "schoolbook" division is linear-time so don't use in that case.
-          These limits are empirically determined and should be slightly
-          conservative so that _pylong is used in cases it is likely
-          to be faster. See Tools/scripts/divmod_threshold.py. */
-        return pylong_int_divmod(v, w, pdiv, pmod);
-    }
-#endif
     if (long_divrem(v, w, &div, &mod) < 0)
         return -1;
     if ((_PyLong_IsNegative(mod) && _PyLong_IsPositive(w)) ||
@@ -877,6 +877,7 @@ get_state(void)
 #define maxarenas (state->mgmt.maxarenas)
 #define unused_arena_objects (state->mgmt.unused_arena_objects)
 #define usable_arenas (state->mgmt.usable_arenas)
+#define dirty_arenas (state->mgmt.dirty_arenas)
 #define nfp2lasta (state->mgmt.nfp2lasta)
 #define narenas_currently_allocated (state->mgmt.narenas_currently_allocated)
 #define ntimes_arena_allocated (state->mgmt.ntimes_arena_allocated)
@@ -1135,6 +1136,177 @@ arena_map_is_used(OMState *state, pymem_block *p)
 #endif /* WITH_PYMALLOC_RADIX_TREE */
 
 
+#ifdef ARENAS_USE_MMAP
+/* Return the size of the pages, which is only known at run time, or 0 if it
+   is unknown. */
+static inline size_t
+runtime_page_size(void)
+{
+    static size_t page_size = (size_t)-1;
+    if (page_size == (size_t)-1) {
+        long size = sysconf(_SC_PAGESIZE);
+        page_size = size > 0 ? (size_t)size : 0;
+    }
+    return page_size;
+}
+#endif
+
+
+/*==========================================================================*/
+/* Arenas in huge pages.
+ *
+ * If PYTHON_PYMALLOC_HUGEPAGES is set, the arenas are allocated in chunks of
+ * HUGE_PAGE_SIZE bytes aligned on HUGE_PAGE_SIZE and advised with
+ * MADV_HUGEPAGE, so that the kernel can back them with transparent huge
+ * pages, and a single TLB entry covers ARENAS_IN_HUGE_PAGE arenas.  The free
+ * arenas of a chunk are put in the spare_arenas list, which is used before
+ * mapping a new chunk, and a chunk is unmapped once all its arenas are free.
+ * The radix tree tells which arenas of a chunk are in use.
+ */
+
+#if defined(ARENAS_USE_MMAP) && defined(MADV_HUGEPAGE) \
+    && WITH_PYMALLOC_RADIX_TREE
+#define ARENAS_USE_HUGE_PAGES
+#define HUGE_PAGE_SIZE          (2 * 1024 * 1024)
+#define ARENAS_IN_HUGE_PAGE     (HUGE_PAGE_SIZE / ARENA_SIZE)
+
+struct spare_arena {
+    struct spare_arena *next;
+    struct spare_arena *prev;
+};
+
+static int
+use_huge_pages(void)
+{
+    int use = _PyRuntime.obmalloc.use_hugepages;
+    if (use == -1) {
+        const char *opt = Py_GETENV("PYTHON_PYMALLOC_HUGEPAGES");
+        use = (opt != NULL && *opt != '\0' && strcmp(opt, "0") != 0);
+        _PyRuntime.obmalloc.use_hugepages = use;
+    }
+    /* A custom arena allocator is used as is */
+    return use && _PyObject_Arena.alloc == _PyMem_ArenaAlloc;
+}
+
+static void
+push_spare_arena(OMState *state, uintptr_t address)
+{
+    struct spare_arena *spare = (struct spare_arena *)address;
+    spare->prev = NULL;
+    spare->next = state->mgmt.spare_arenas;
+    if (spare->next != NULL) {
+        spare->next->prev = spare;
+    }
+    state->mgmt.spare_arenas = spare;
+}
+
+static void
+unlink_spare_arena(OMState *state, struct spare_arena *spare)
+{
+    if (spare->prev != NULL) {
+        spare->prev->next = spare->next;
+    }
+    else {
+        assert(state->mgmt.spare_arenas == spare);
+        state->mgmt.spare_arenas = spare->next;
+    }
+    if (spare->next != NULL) {
+        spare->next->prev = spare->prev;
+    }
+}
+
+static void *
+alloc_huge_arena(OMState *state)
+{
+    struct spare_arena *spare = state->mgmt.spare_arenas;
+    if (spare != NULL) {
+        unlink_spare_arena(state, spare);
+        return spare;
+    }
+
+    /* Map twice the size of a chunk, and unmap what is around the aligned
+       chunk. */
+    size_t size = 2 * HUGE_PAGE_SIZE;
+    void *ptr = mmap(NULL, size, PROT_READ|PROT_WRITE,
+                     MAP_PRIVATE|MAP_ANONYMOUS, -1, 0);
+    if (ptr == MAP_FAILED) {
+        return NULL;
+    }
+    uintptr_t start = (uintptr_t)ptr;
+    uintptr_t chunk = _Py_SIZE_ROUND_UP(start, HUGE_PAGE_SIZE);
+    if (chunk > start) {
+        munmap(ptr, chunk - start);
+    }
+    if (start + size > chunk + HUGE_PAGE_SIZE) {
+        munmap((void *)(chunk + HUGE_PAGE_SIZE),
+               start + size - chunk - HUGE_PAGE_SIZE);
+    }
+    (void)madvise((void *)chunk, HUGE_PAGE_SIZE, MADV_HUGEPAGE);
+
+    for (int i = ARENAS_IN_HUGE_PAGE - 1; i > 0; i--) {
+        push_spare_arena(state, chunk + (uintptr_t)i * ARENA_SIZE);
+    }
+    return (void *)chunk;
+}
+
+/* The arena must already be marked as unused in the radix tree. */
+static void
+free_huge_arena(OMState *state, void *ptr)
+{
+    uintptr_t address = (uintptr_t)ptr;
+    uintptr_t chunk = address & ~((uintptr_t)HUGE_PAGE_SIZE - 1);
+    uintptr_t end = chunk + HUGE_PAGE_SIZE;
+    for (uintptr_t a = chunk; a < end; a += ARENA_SIZE) {
+        if (a != address && arena_map_is_used(state, (pymem_block *)a)) {
+            /* Release the memory of the arena but for the page linking it
+               in spare_arenas, which splits the huge page.  Nothing can be
+               released if the pages are as large as an arena. */
+            size_t page_size = runtime_page_size();
+            if (page_size != 0 && page_size < ARENA_SIZE
+                && ARENA_SIZE % page_size == 0)
+            {
+                (void)madvise((void *)(address + page_size),
+                              ARENA_SIZE - page_size, MADV_DONTNEED);
+            }
+            push_spare_arena(state, address);
+            return;
+        }
+    }
+    for (uintptr_t a = chunk; a < end; a += ARENA_SIZE) {
+        if (a != address) {
+            unlink_spare_arena(state, (struct spare_arena *)a);
+        }
+    }
+    munmap((void *)chunk, HUGE_PAGE_SIZE);
+}
+#endif /* ARENAS_USE_HUGE_PAGES */
+
+/* Allocate the memory of an arena. */
+static void *
+alloc_arena(OMState *state)
+{
+#ifdef ARENAS_USE_HUGE_PAGES
+    if (use_huge_pages()) {
+        return alloc_huge_arena(state);
+    }
+#endif
+    return _PyObject_Arena.alloc(_PyObject_Arena.ctx, ARENA_SIZE);
+}
+
+/* Free the memory of an arena allocated by alloc_arena(). */
+static void
+free_arena(OMState *state, void *address)
+{
+#ifdef ARENAS_USE_HUGE_PAGES
+    if (use_huge_pages()) {
+        free_huge_arena(state, address);
+        return;
+    }
+#endif
+    _PyObject_Arena.free(_PyObject_Arena.ctx, address, ARENA_SIZE);
+}
+
+
 /* Allocate a new arena.  If we run out of memory, return NULL.  Else
  * allocate a new arena, and return the address of an arena_object
  * describing the new arena.  It's expected that the caller will set
@@ -1173,6 +1345,13 @@ new_arena(OMState *state)
             return NULL;                /* overflow */
 #endif
         nbytes = numarenas * sizeof(*allarenas);
+        /* All the arenas are full, so none of them has free pools left
+         * to purge: empty dirty_arenas, which points into the old array.
+         */
+        for (i = 0; i < maxarenas; ++i) {
+            allarenas[i].isdirty = 0;
+        }
+        dirty_arenas = NULL;
         arenaobj = (struct arena_object *)PyMem_RawRealloc(allarenas, nbytes);
         if (arenaobj == NULL)
             return NULL;
@@ -1190,6 +1369,7 @@ new_arena(OMState *state)
         /* Put the new arenas on the unused_arena_objects list. */
         for (i = maxarenas; i < numarenas; ++i) {
             allarenas[i].address = 0;              /* mark as unassociated */
+            allarenas[i].isdirty = 0;
             allarenas[i].nextarena = i < numarenas - 1 ?
                                         &allarenas[i+1] : NULL;
         }
@@ -1204,12 +1384,12 @@ new_arena(OMState *state)
     arenaobj = unused_arena_objects;
     unused_arena_objects = arenaobj->nextarena;
     assert(arenaobj->address == 0);
-    address = _PyObject_Arena.alloc(_PyObject_Arena.ctx, ARENA_SIZE);
+    address = alloc_arena(state);
 #if WITH_PYMALLOC_RADIX_TREE
     if (address != NULL) {
         if (!arena_map_mark_used(state, (uintptr_t)address, 1)) {
             /* marking arena in radix tree failed, abort */
-            _PyObject_Arena.free(_PyObject_Arena.ctx, address, ARENA_SIZE);
+            free_arena(state, address);
             address = NULL;
         }
     }
@@ -1229,6 +1409,7 @@ new_arena(OMState *state)
     if (narenas_currently_allocated > narenas_highwater)
         narenas_highwater = narenas_currently_allocated;
     arenaobj->freepools = NULL;
+    arenaobj->nfreshpools = arenaobj->nstalepools = 0;
     /* pool_address <- first pool-aligned address in the arena
        nfreepools <- number of whole pools that fit after alignment */
     arenaobj->pool_address = (pymem_block*)arenaobj->address;
@@ -1371,6 +1552,146 @@ pymalloc_pool_extend(poolp pool, uint size)
     pool->nextpool = next;
 }
 
+/*==========================================================================*/
+/* Returning the memory of free pools to the OS.
+ *
+ * An arena is freed only when all of its pools are free, and the free pools
+ * of the other arenas would otherwise stay resident forever.  Free pools are
+ * "purged" with madvise(): the pages of the pool are released, but the first
+ * one, which holds the pool header linking it in its arena's freepools.
+ *
+ * To keep the pools that the program keeps reusing resident, a pool is only
+ * purged after staying free for a whole purge interval: every PURGE_INTERVAL
+ * freed pools, a tick purges the stale pools of each arena, which were
+ * already free at the previous tick, and the fresh pools become stale.
+ * Since freepools is a LIFO list, the fresh pools are at its head, followed
+ * by the stale pools, followed by the purged pools.  The ticks only look at
+ * the arenas in dirty_arenas, those that had pools freed since the previous
+ * tick or still have stale pools.
+ *
+ * The first page of a pool must stay resident, so pools are only purged
+ * when the pages, whose size is only known at run time, are smaller than
+ * the pools: not with the 16 KiB or 64 KiB pages of some aarch64 systems.
+ */
+
+#if defined(ARENAS_USE_MMAP) && POOL_SIZE > SYSTEM_PAGE_SIZE
+#  if defined(__linux__) && defined(MADV_DONTNEED)
+     /* Linux only releases MADV_FREE pages under memory pressure */
+#    define PURGE_ADVICE MADV_DONTNEED
+#  elif defined(MADV_FREE)
+#    define PURGE_ADVICE MADV_FREE
+#  elif defined(MADV_DONTNEED)
+#    define PURGE_ADVICE MADV_DONTNEED
+#  endif
+#endif
+
+/* Number of freed pools between two purge ticks: 4 MiB with 16 KiB pools */
+#define PURGE_INTERVAL 256
+
+#ifdef PURGE_ADVICE
+/* Return the size of the pages, or 0 if it is not smaller than POOL_SIZE. */
+static size_t
+purge_page_size(void)
+{
+    size_t page_size = runtime_page_size();
+    if (page_size == 0 || page_size >= POOL_SIZE
+        || POOL_SIZE % page_size != 0)
+    {
+        return 0;
+    }
+    return page_size;
+}
+#endif
+
+/* Purge the n pools of freepools following the pool, and return the number
+ * of bytes released.
+ */
+static size_t
+purge_pools(OMState *state, poolp pool, uint n)
+{
+    size_t nbytes = 0;
+#ifdef PURGE_ADVICE
+    /* The memory of arenas from a custom allocator may not be anonymous */
+    if (_PyObject_Arena.alloc != _PyMem_ArenaAlloc) {
+        return 0;
+    }
+    size_t page_size = purge_page_size();
+    if (page_size == 0) {
+        return 0;
+    }
+    for (; n > 0; n--) {
+        assert(pool != NULL);
+        /* The free list of the pool is in the released pages */
+        pool->szidx = DUMMY_SIZE_IDX;
+        if (madvise((pymem_block *)pool + page_size,
+                    POOL_SIZE - page_size, PURGE_ADVICE) == 0) {
+            nbytes += POOL_SIZE - page_size;
+            state->mgmt.npools_purged++;
+        }
+        pool = pool->nextpool;
+    }
+#endif
+    return nbytes;
+}
+
+/* Purge the stale pools of the arenas in dirty_arenas, and drop the arenas
+ * left without fresh pools from the list.
+ */
+static void
+purge_free_pools(OMState *state)
+{
+    state->mgmt.npools_freed = 0;
+#ifdef ARENAS_USE_HUGE_PAGES
+    /* Purging pools would split the huge pages, only an explicit
+       _PyObject_TrimFreePools() does. */
+    if (use_huge_pages()) {
+        return;
+    }
+#endif
+    struct arena_object **link = &dirty_arenas;
+    struct arena_object *ao;
+    while ((ao = *link) != NULL) {
+        /* An unassociated arena_object has no pools */
+        if (ao->address != 0) {
+            if (ao->nstalepools > 0) {
+                poolp pool = ao->freepools;
+                for (uint i = 0; i < ao->nfreshpools; i++) {
+                    pool = pool->nextpool;
+                }
+                (void)purge_pools(state, pool, ao->nstalepools);
+            }
+            ao->nstalepools = ao->nfreshpools;
+            ao->nfreshpools = 0;
+        }
+        if (ao->address == 0 || ao->nstalepools == 0) {
+            *link = ao->nextdirty;
+            ao->isdirty = 0;
+        }
+        else {
+            link = &ao->nextdirty;
+        }
+    }
+}
+
+Py_ssize_t
+_PyObject_TrimFreePools(void)
+{
+    OMState *state = get_state();
+    size_t nbytes = 0;
+    struct arena_object *ao = dirty_arenas;
+    dirty_arenas = NULL;
+    while (ao != NULL) {
+        if (ao->address != 0) {
+            nbytes += purge_pools(state, ao->freepools,
+                                  ao->nfreshpools + ao->nstalepools);
+            ao->nfreshpools = ao->nstalepools = 0;
+        }
+        ao->isdirty = 0;
+        ao = ao->nextdirty;
+    }
+    return (Py_ssize_t)nbytes;
+}
+
 /* called when pymalloc_alloc can not allocate a block from usedpool.
  * This function takes new pool and allocate a block from it.
  */
@@ -1419,6 +1740,12 @@ allocate_from_new_pool(OMState *state, uint size)
         /* Unlink from cached pools. */
         usable_arenas->freepools = pool->nextpool;
         usable_arenas->nfreepools--;
+        if (usable_arenas->nfreshpools > 0) {
+            usable_arenas->nfreshpools--;
+        }
+        else if (usable_arenas->nstalepools > 0) {
+            usable_arenas->nstalepools--;
+        }
         if (UNLIKELY(usable_arenas->nfreepools == 0)) {
             /* Wholly allocated:  remove. */
             assert(usable_arenas->freepools == NULL);
@@ -1626,6 +1953,12 @@ insert_to_freepool(OMState *state, poolp pool)
     struct arena_object *ao = &allarenas[pool->arenaindex];
     pool->nextpool = ao->freepools;
     ao->freepools = pool;
+    ao->nfreshpools++;
+    if (!ao->isdirty) {
+        ao->isdirty = 1;
+        ao->nextdirty = dirty_arenas;
+        dirty_arenas = ao;
+    }
     uint nf = ao->nfreepools;
     /* If this is the rightmost arena with this number of free pools,
      * nfp2lasta[nf] needs to change.  Caution:  if nf is 0, there
@@ -1700,8 +2033,7 @@ insert_to_freepool(OMState *state, poolp pool)
 #endif
 
         /* Free the entire arena. */
-        _PyObject_Arena.free(_PyObject_Arena.ctx,
-                             (void *)ao->address, ARENA_SIZE);
+        free_arena(state, (void *)ao->address);
         ao->address = 0;                        /* mark unassociated */
         --narenas_currently_allocated;
 
@@ -1836,6 +2168,9 @@ pymalloc_free(OMState *state, void *Py_UNUSED(ctx), void *p)
      * (being not referenced, they are perhaps paged out).
      */
     insert_to_freepool(state, pool);
+    if (UNLIKELY(++state->mgmt.npools_freed >= PURGE_INTERVAL)) {
+        purge_free_pools(state);
+    }
     return 1;
 }
 
@@ -1975,6 +2310,12 @@ _Py_FinalizeAllocatedBlocks(_PyRuntimeState *Py_UNUSED(runtime))
     return;
 }
 
+Py_ssize_t
+_PyObject_TrimFreePools(void)
+{
+    return 0;
+}
+
 #endif /* WITH_PYMALLOC */
 
 
@@ -2662,6 +3003,7 @@ _PyObject_DebugMallocStats(FILE *out)
     (void)printone(out, "# arenas reclaimed", ntimes_arena_allocated - narenas);
     (void)printone(out, "# arenas highwater mark", narenas_highwater);
     (void)printone(out, "# arenas allocated current", narenas);
+    (void)printone(out, "# pools purged", state->mgmt.npools_purged);
 
     PyOS_snprintf(buf, sizeof(buf),
                   "%zu arenas * %d bytes/arena",
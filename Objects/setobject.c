@@ -34,6 +34,7 @@
 #include "Python.h"
 #include "pycore_ceval.h"         // _PyEval_GetBuiltin()
 #include "pycore_dict.h"          // _PyDict_Contains_KnownHash()
+#include "pycore_long.h"          // _PyLong_IsCompact()
 #include "pycore_modsupport.h"    // _PyArg_NoKwnames()
 #include "pycore_object.h"        // _PyObject_GC_UNTRACK()
 #include "pycore_pyerrors.h"      // _PyErr_SetKeyError()
@@ -57,8 +58,99 @@ static PyObject _dummy_struct;
 /* This must be >= 1 */
 #define PERTURB_SHIFT 5
 
-static setentry *
-set_lookkey(PySetObject *so, PyObject *key, Py_hash_t hash)
+/* Compact tables.
+
+   Most sets hold strings or small ints, and neither needs its hash cached
+   in the table:  an exact str caches its own hash, and an exact int small
+   enough to be compact (see pycore_long.h) is its own hash, but for -1.
+   So a set starts out with a compact table, whose slots are bare key
+   pointers:  so->table really is a PyObject **.  That takes half the
+   memory of the general table.
+
+   A compact table has the same number of slots as the general table would
+   have, the same probe sequence and the same resize policy, so a key lands
+   in the same slot in either layout and the iteration order of a set
+   doesn't depend on its layout.  Switching to the general layout copies
+   every key and dummy to the same slot (set_table_make_general()).  The
+   smalltable holds the 8 slots of the smallest compact table in its first
+   half, so only sets that need a malloc'ed table save memory.
+
+   Probing a compact table has to load the hash of each key it compares
+   from the key itself, which only pays off while the table is small.  The
+   set switches to the general table for good when a key of any other type
+   is added, or when the table would grow past SET_COMPACT_MAXSIZE slots.
+   Clearing the set makes it compact again.
+
+   PySetObject has no room for a flag telling the layouts apart, so a
+   compact table is flagged by the SET_COMPACT_FLAG bit of so->finger.
+   set_pop() only uses the finger masked with so->mask, which a compact
+   table keeps far below that bit, and a general table never sets it.
+*/
+
+#define SET_COMPACT_MAXSIZE 128
+#define SET_COMPACT_FLAG (PY_SSIZE_T_MAX / 2 + 1)
+
+#define SET_IS_COMPACT(so) (((so)->finger & SET_COMPACT_FLAG) != 0)
+#define COMPACT_KEYS(so) ((PyObject **)(so)->table)
+
+static inline void
+set_mark_compact(PySetObject *so, int compact)
+{
+    if (compact)
+        so->finger |= SET_COMPACT_FLAG;
+    else
+        so->finger &= ~SET_COMPACT_FLAG;
+}
+
+/* Can key go in a compact table? */
+static inline int
+compact_key_check(PyObject *key)
+{
+    if (PyUnicode_CheckExact(key)) {
+        return _PyASCIIObject_CAST(key)->hash != -1;
+    }
+    return PyLong_CheckExact(key) && _PyLong_IsCompact((PyLongObject *)key);
+}
+
+/* The hash of a key of a compact table */
+static inline Py_hash_t
+compact_key_hash(PyObject *key)
+{
+    Py_hash_t hash;
+
+    if (PyUnicode_CheckExact(key)) {
+        hash = _PyASCIIObject_CAST(key)->hash;
+        assert(hash != -1);
+        return hash;
+    }
+    assert(PyLong_CheckExact(key) && _PyLong_IsCompact((PyLongObject *)key));
+    hash = _PyLong_CompactValue((PyLongObject *)key);
+    return hash == -1 ? -2 : hash;
+}
+
+/* Compare startkey, a key of a compact table, with key, an exact str or
+   int: no Python code can run. */
+static inline int
+compact_key_equal(PyObject *startkey, PyObject *key)
+{
+    if (PyUnicode_CheckExact(startkey)) {
+        return PyUnicode_CheckExact(key) && _PyUnicode_EQ(startkey, key);
+    }
+    return (PyLong_CheckExact(key)
+            && _PyLong_IsCompact((PyLongObject *)key)
+            && _PyLong_CompactValue((PyLongObject *)startkey)
+               == _PyLong_CompactValue((PyLongObject *)key));
+}
+
+static Py_ssize_t set_lookkey(PySetObject *so, PyObject *key, Py_hash_t hash);
+
+/* The lookkey functions return the index of the slot of key if it is in
+   the set, or else of the unused slot that ends the search, or -1 if the
+   comparison raised an exception.  The slot is in the table of the layout
+   the set has on return, since a comparison may have changed it. */
+
+static Py_ssize_t
+set_lookkey_general(PySetObject *so, PyObject *key, Py_hash_t hash)
 {
     setentry *table;
     setentry *entry;
@@ -73,26 +165,26 @@ set_lookkey(PySetObject *so, PyObject *key, Py_hash_t hash)
         probes = (i + LINEAR_PROBES <= mask) ? LINEAR_PROBES: 0;
         do {
             if (entry->hash == 0 && entry->key == NULL)
-                return entry;
+                return entry - so->table;
             if (entry->hash == hash) {
                 PyObject *startkey = entry->key;
                 assert(startkey != dummy);
                 if (startkey == key)
-                    return entry;
+                    return entry - so->table;
                 if (PyUnicode_CheckExact(startkey)
                     && PyUnicode_CheckExact(key)
                     && _PyUnicode_EQ(startkey, key))
-                    return entry;
+                    return entry - so->table;
                 table = so->table;
                 Py_INCREF(startkey);
                 cmp = PyObject_RichCompareBool(startkey, key, Py_EQ);
                 Py_DECREF(startkey);
                 if (cmp < 0)
-                    return NULL;
-                if (table != so->table || entry->key != startkey)
+                    return -1;
+                if (SET_IS_COMPACT(so) || table != so->table || entry->key != startkey)
                     return set_lookkey(so, key, hash);
                 if (cmp > 0)
-                    return entry;
+                    return entry - so->table;
                 mask = so->mask;
             }
             entry++;
@@ -102,10 +194,67 @@ set_lookkey(PySetObject *so, PyObject *key, Py_hash_t hash)
     }
 }
 
+static Py_ssize_t
+set_lookkey_compact(PySetObject *so, PyObject *key, Py_hash_t hash)
+{
+    PyObject **table;
+    PyObject **slot;
+    size_t perturb = hash;
+    size_t mask = so->mask;
+    size_t i = (size_t)hash & mask; /* Unsigned for defined overflow behavior */
+    int probes;
+    int cmp;
+
+    while (1) {
+        slot = &COMPACT_KEYS(so)[i];
+        probes = (i + LINEAR_PROBES <= mask) ? LINEAR_PROBES: 0;
+        do {
+            PyObject *startkey = *slot;
+            if (startkey == NULL || startkey == key)
+                return slot - COMPACT_KEYS(so);
+            if (startkey != dummy && compact_key_hash(startkey) == hash) {
+                if (PyUnicode_CheckExact(key) || PyLong_CheckExact(key)) {
+                    if (compact_key_equal(startkey, key))
+                        return slot - COMPACT_KEYS(so);
+                }
+                else {
+                    table = COMPACT_KEYS(so);
+                    Py_INCREF(startkey);
+                    cmp = PyObject_RichCompareBool(startkey, key, Py_EQ);
+                    Py_DECREF(startkey);
+                    if (cmp < 0)
+                        return -1;
+                    if (!SET_IS_COMPACT(so) || table != COMPACT_KEYS(so)
+                        || *slot != startkey)
+                        return set_lookkey(so, key, hash);
+                    if (cmp > 0)
+                        return slot - table;
+                    mask = so->mask;
+                }
+            }
+            slot++;
+        } while (probes--);
+        perturb >>= PERTURB_SHIFT;
+        i = (i * 5 + 1 + perturb) & mask;
+    }
+}
+
+static Py_ssize_t
+set_lookkey(PySetObject *so, PyObject *key, Py_hash_t hash)
+{
+    if (SET_IS_COMPACT(so))
+        return set_lookkey_compact(so, key, hash);
+    return set_lookkey_general(so, key, hash);
+}
+
 static int set_table_resize(PySetObject *, Py_ssize_t);
+static int set_table_make_general(PySetObject *);
+static int set_insert_key(PySetObject *, PyObject *, Py_hash_t);
+
+/* The insert functions steal a reference to key. */
 
 static int
-set_add_entry(PySetObject *so, PyObject *key, Py_hash_t hash)
+set_insert_general(PySetObject *so, PyObject *key, Py_hash_t hash)
 {
     setentry *table;
     setentry *freeslot;
@@ -116,12 +265,10 @@ set_add_entry(PySetObject *so, PyObject *key, Py_hash_t hash)
     int probes;
     int cmp;
 
-    /* Pre-increment is necessary to prevent arbitrary code in the rich
-       comparison from deallocating the key just before the insertion. */
-    Py_INCREF(key);
-
   restart:
 
+    if (SET_IS_COMPACT(so))
+        return set_insert_key(so, key, hash);
     mask = so->mask;
     i = (size_t)hash & mask;
     freeslot = NULL;
@@ -150,7 +297,7 @@ set_add_entry(PySetObject *so, PyObject *key, Py_hash_t hash)
                     goto found_active;
                 if (cmp < 0)
                     goto comparison_error;
-                if (table != so->table || entry->key != startkey)
+                if (SET_IS_COMPACT(so) || table != so->table || entry->key != startkey)
                     goto restart;
                 mask = so->mask;
             }
@@ -190,8 +337,85 @@ set_add_entry(PySetObject *so, PyObject *key, Py_hash_t hash)
     return -1;
 }
 
+/* The key must pass compact_key_check(), so no comparison can call
+   Python code. */
+static int
+set_insert_compact(PySetObject *so, PyObject *key, Py_hash_t hash)
+{
+    PyObject **table = COMPACT_KEYS(so);
+    PyObject **freeslot = NULL;
+    PyObject **slot;
+    size_t perturb = hash;
+    size_t mask = so->mask;
+    size_t i = (size_t)hash & mask; /* Unsigned for defined overflow behavior */
+    int probes;
+
+    assert(SET_IS_COMPACT(so));
+    assert(compact_key_check(key) && compact_key_hash(key) == hash);
+    while (1) {
+        slot = &table[i];
+        probes = (i + LINEAR_PROBES <= mask) ? LINEAR_PROBES: 0;
+        do {
+            PyObject *startkey = *slot;
+            if (startkey == NULL)
+                goto found_unused_or_dummy;
+            if (startkey == dummy)
+                freeslot = slot;
+            else if (startkey == key
+                     || (compact_key_hash(startkey) == hash
+                         && compact_key_equal(startkey, key)))
+                goto found_active;
+            slot++;
+        } while (probes--);
+        perturb >>= PERTURB_SHIFT;
+        i = (i * 5 + 1 + perturb) & mask;
+    }
+
+  found_unused_or_dummy:
+    if (freeslot == NULL)
+        goto found_unused;
+    so->used++;
+    *freeslot = key;
+    return 0;
+
+  found_unused:
+    so->fill++;
+    so->used++;
+    *slot = key;
+    if ((size_t)so->fill*5 < mask*3)
+        return 0;
+    return set_table_resize(so, so->used*4);
+
+  found_active:
+    Py_DECREF(key);
+    return 0;
+}
+
+static int
+set_insert_key(PySetObject *so, PyObject *key, Py_hash_t hash)
+{
+    if (SET_IS_COMPACT(so)) {
+        if (compact_key_check(key))
+            return set_insert_compact(so, key, hash);
+        if (set_table_make_general(so) != 0) {
+            Py_DECREF(key);
+            return -1;
+        }
+    }
+    return set_insert_general(so, key, hash);
+}
+
+static int
+set_add_entry(PySetObject *so, PyObject *key, Py_hash_t hash)
+{
+    /* Pre-increment is necessary to prevent arbitrary code in the rich
+       comparison from deallocating the key just before the insertion. */
+    Py_INCREF(key);
+    return set_insert_key(so, key, hash);
+}
+
 /*
-Internal routine used by set_table_resize() to insert an item which is
+Internal routines used by set_table_resize() to insert an item which is
 known to be absent from the set.  Besides the performance benefit,
 there is also safety benefit since using set_add_entry() risks making
 a callback in the middle of a set_table_resize(), see issue 1456209.
@@ -225,6 +449,33 @@ set_insert_clean(setentry *table, size_t mask, PyObject *key, Py_hash_t hash)
     entry->hash = hash;
 }
 
+static void
+set_insert_clean_compact(PyObject **table, size_t mask, PyObject *key)
+{
+    PyObject **slot;
+    Py_hash_t hash = compact_key_hash(key);
+    size_t perturb = hash;
+    size_t i = (size_t)hash & mask;
+    size_t j;
+
+    while (1) {
+        slot = &table[i];
+        if (*slot == NULL)
+            goto found_null;
+        if (i + LINEAR_PROBES <= mask) {
+            for (j = 0; j < LINEAR_PROBES; j++) {
+                slot++;
+                if (*slot == NULL)
+                    goto found_null;
+            }
+        }
+        perturb >>= PERTURB_SHIFT;
+        i = (i * 5 + 1 + perturb) & mask;
+    }
+  found_null:
+    *slot = key;
+}
+
 /* ======== End logic for probing the hash table ========================== */
 /* ======================================================================== */
 
@@ -232,13 +483,18 @@ set_insert_clean(setentry *table, size_t mask, PyObject *key, Py_hash_t hash)
 Restructure the table by allocating a new table and reinserting all
 keys again.  When entries have been deleted, the new table may
 actually be smaller than the old one.
+
+A compact table that would grow past SET_COMPACT_MAXSIZE slots becomes
+a general one.
 */
 static int
 set_table_resize(PySetObject *so, Py_ssize_t minused)
 {
     setentry *oldtable, *newtable, *entry;
     Py_ssize_t oldmask = so->mask;
-    size_t newmask;
+    int oldcompact = SET_IS_COMPACT(so);
+    int compact;
+    size_t newmask, entrysize;
     int is_oldtable_malloced;
     setentry small_copy[PySet_MINSIZE];
 
@@ -250,6 +506,8 @@ set_table_resize(PySetObject *so, Py_ssize_t minused)
     while (newsize <= (size_t)minused) {
         newsize <<= 1; // The largest possible value is PY_SSIZE_T_MAX + 1.
     }
+    compact = oldcompact && newsize <= SET_COMPACT_MAXSIZE;
+    entrysize = compact ? sizeof(PyObject *) : sizeof(setentry);
 
     /* Get space for a new table. */
     oldtable = so->table;
@@ -276,7 +534,10 @@ set_table_resize(PySetObject *so, Py_ssize_t minused)
         }
     }
     else {
-        newtable = PyMem_NEW(setentry, newsize);
+        if (compact)
+            newtable = (setentry *)PyMem_NEW(PyObject *, newsize);
+        else
+            newtable = PyMem_NEW(setentry, newsize);
         if (newtable == NULL) {
             PyErr_NoMemory();
             return -1;
@@ -285,14 +546,28 @@ set_table_resize(PySetObject *so, Py_ssize_t minused)
 
     /* Make the set empty, using the new table. */
     assert(newtable != oldtable);
-    memset(newtable, 0, sizeof(setentry) * newsize);
+    memset(newtable, 0, entrysize * newsize);
     so->mask = newsize - 1;
     so->table = newtable;
+    set_mark_compact(so, compact);
 
     /* Copy the data over; this is refcount-neutral for active entries;
        dummy entries aren't copied over, of course */
     newmask = (size_t)so->mask;
-    if (so->fill == so->used) {
+    if (oldcompact) {
+        PyObject **oldkeys = (PyObject **)oldtable;
+        so->fill = so->used;
+        for (Py_ssize_t i = 0; i <= oldmask; i++) {
+            PyObject *key = oldkeys[i];
+            if (key == NULL || key == dummy)
+                continue;
+            if (compact)
+                set_insert_clean_compact((PyObject **)newtable, newmask, key);
+            else
+                set_insert_clean(newtable, newmask, key, compact_key_hash(key));
+        }
+    }
+    else if (so->fill == so->used) {
         for (entry = oldtable; entry <= oldtable + oldmask; entry++) {
             if (entry->key != NULL) {
                 set_insert_clean(newtable, newmask, entry->key, entry->hash);
@@ -312,15 +587,60 @@ set_table_resize(PySetObject *so, Py_ssize_t minused)
     return 0;
 }
 
+/* Switch a compact table to the general layout.  Every key and dummy
+   keeps its slot, so the iteration order doesn't change. */
+static int
+set_table_make_general(PySetObject *so)
+{
+    PyObject **oldkeys = COMPACT_KEYS(so);
+    size_t size = (size_t)so->mask + 1;
+    setentry *newtable;
+    PyObject *small_copy[PySet_MINSIZE];
+
+    assert(SET_IS_COMPACT(so));
+    if (so->table == so->smalltable) {
+        assert(size == PySet_MINSIZE);
+        memcpy(small_copy, oldkeys, sizeof(small_copy));
+        oldkeys = small_copy;
+        newtable = so->smalltable;
+    }
+    else {
+        newtable = PyMem_NEW(setentry, size);
+        if (newtable == NULL) {
+            PyErr_NoMemory();
+            return -1;
+        }
+    }
+
+    for (size_t i = 0; i < size; i++) {
+        PyObject *key = oldkeys[i];
+        newtable[i].key = key;
+        if (key == NULL)
+            newtable[i].hash = 0;
+        else if (key == dummy)
+            newtable[i].hash = -1;
+        else
+            newtable[i].hash = compact_key_hash(key);
+    }
+
+    if (oldkeys != small_copy)
+        PyMem_Free(oldkeys);
+    so->table = newtable;
+    set_mark_compact(so, 0);
+    return 0;
+}
+
 static int
 set_contains_entry(PySetObject *so, PyObject *key, Py_hash_t hash)
 {
-    setentry *entry;
+    Py_ssize_t i;
 
-    entry = set_lookkey(so, key, hash);
-    if (entry != NULL)
-        return entry->key != NULL;
-    return -1;
+    i = set_lookkey(so, key, hash);
+    if (i < 0)
+        return -1;
+    if (SET_IS_COMPACT(so))
+        return COMPACT_KEYS(so)[i] != NULL;
+    return so->table[i].key != NULL;
 }
 
 #define DISCARD_NOTFOUND 0
@@ -329,17 +649,27 @@ set_contains_entry(PySetObject *so, PyObject *key, Py_hash_t hash)
 static int
 set_discard_entry(PySetObject *so, PyObject *key, Py_hash_t hash)
 {
-    setentry *entry;
+    Py_ssize_t i;
     PyObject *old_key;
 
-    entry = set_lookkey(so, key, hash);
-    if (entry == NULL)
+    i = set_lookkey(so, key, hash);
+    if (i < 0)
         return -1;
-    if (entry->key == NULL)
-        return DISCARD_NOTFOUND;
-    old_key = entry->key;
-    entry->key = dummy;
-    entry->hash = -1;
+    if (SET_IS_COMPACT(so)) {
+        PyObject **slot = &COMPACT_KEYS(so)[i];
+        if (*slot == NULL)
+            return DISCARD_NOTFOUND;
+        old_key = *slot;
+        *slot = dummy;
+    }
+    else {
+        setentry *entry = &so->table[i];
+        if (entry->key == NULL)
+            return DISCARD_NOTFOUND;
+        old_key = entry->key;
+        entry->key = dummy;
+        entry->hash = -1;
+    }
     so->used--;
     Py_DECREF(old_key);
     return DISCARD_FOUND;
@@ -395,16 +725,17 @@ set_empty_to_minsize(PySetObject *so)
     so->used = 0;
     so->mask = PySet_MINSIZE - 1;
     so->table = so->smalltable;
+    set_mark_compact(so, 1);
     so->hash = -1;
 }
 
 static int
 set_clear_internal(PySetObject *so)
 {
-    setentry *entry;
     setentry *table = so->table;
     Py_ssize_t fill = so->fill;
     Py_ssize_t used = so->used;
+    int compact = SET_IS_COMPACT(so);
     int table_is_malloced = table != so->smalltable;
     setentry small_copy[PySet_MINSIZE];
 
@@ -429,16 +760,31 @@ set_clear_internal(PySetObject *so)
         table = small_copy;
         set_empty_to_minsize(so);
     }
-    /* else it's a small table that's already empty */
+    else if (!compact) {
+        /* It's a small table that's already empty */
+        set_empty_to_minsize(so);
+    }
 
     /* Now we can finally clear things.  If C had refcounts, we could
      * assert that the refcount on table is 1 now, i.e. that this function
      * has unique access to it, so decref side-effects can't alter it.
      */
-    for (entry = table; used > 0; entry++) {
-        if (entry->key && entry->key != dummy) {
-            used--;
-            Py_DECREF(entry->key);
+    if (compact) {
+        PyObject **slot;
+        for (slot = (PyObject **)table; used > 0; slot++) {
+            if (*slot && *slot != dummy) {
+                used--;
+                Py_DECREF(*slot);
+            }
+        }
+    }
+    else {
+        setentry *entry;
+        for (entry = table; used > 0; entry++) {
+            if (entry->key && entry->key != dummy) {
+                used--;
+                Py_DECREF(entry->key);
+            }
         }
     }
 
@@ -451,27 +797,41 @@ set_clear_internal(PySetObject *so)
  * Iterate over a set table.  Use like so:
  *
  *     Py_ssize_t pos;
- *     setentry *entry;
+ *     PyObject *key;
+ *     Py_hash_t hash;
  *     pos = 0;   # important!  pos should not otherwise be changed by you
- *     while (set_next(yourset, &pos, &entry)) {
- *              Refer to borrowed reference in entry->key.
+ *     while (set_next(yourset, &pos, &key, &hash)) {
+ *              Refer to borrowed reference in key.
  *     }
  *
  * CAUTION:  In general, it isn't safe to use set_next in a loop that
  * mutates the table.
  */
 static int
-set_next(PySetObject *so, Py_ssize_t *pos_ptr, setentry **entry_ptr)
+set_next(PySetObject *so, Py_ssize_t *pos_ptr, PyObject **key_ptr,
+         Py_hash_t *hash_ptr)
 {
     Py_ssize_t i;
     Py_ssize_t mask;
-    setentry *entry;
 
     assert (PyAnySet_Check(so));
     i = *pos_ptr;
     assert(i >= 0);
     mask = so->mask;
-    entry = &so->table[i];
+    if (SET_IS_COMPACT(so)) {
+        PyObject **slot = &COMPACT_KEYS(so)[i];
+        while (i <= mask && (*slot == NULL || *slot == dummy)) {
+            i++;
+            slot++;
+        }
+        *pos_ptr = i+1;
+        if (i > mask)
+            return 0;
+        *key_ptr = *slot;
+        *hash_ptr = compact_key_hash(*slot);
+        return 1;
+    }
+    setentry *entry = &so->table[i];
     while (i <= mask && (entry->key == NULL || entry->key == dummy)) {
         i++;
         entry++;
@@ -479,15 +839,14 @@ set_next(PySetObject *so, Py_ssize_t *pos_ptr, setentry **entry_ptr)
     *pos_ptr = i+1;
     if (i > mask)
         return 0;
-    assert(entry != NULL);
-    *entry_ptr = entry;
+    *key_ptr = entry->key;
+    *hash_ptr = entry->hash;
     return 1;
 }
 
 static void
 set_dealloc(PySetObject *so)
 {
-    setentry *entry;
     Py_ssize_t used = so->used;
 
     /* bpo-31095: UnTrack is needed before calling any callbacks */
@@ -496,10 +855,22 @@ set_dealloc(PySetObject *so)
     if (so->weakreflist != NULL)
         PyObject_ClearWeakRefs((PyObject *) so);
 
-    for (entry = so->table; used > 0; entry++) {
-        if (entry->key && entry->key != dummy) {
+    if (SET_IS_COMPACT(so)) {
+        PyObject **slot;
+        for (slot = COMPACT_KEYS(so); used > 0; slot++) {
+            if (*slot && *slot != dummy) {
+                used--;
+                Py_DECREF(*slot);
+            }
+        }
+    }
+    else {
+        setentry *entry;
+        for (entry = so->table; used > 0; entry++) {
+            if (entry->key && entry->key != dummy) {
                 used--;
                 Py_DECREF(entry->key);
+            }
         }
     }
     if (so->table != so->smalltable)
@@ -559,14 +930,34 @@ set_len(PyObject *so)
     return ((PySetObject *)so)->used;
 }
 
+/* Return the key in slot i of the table of so, either layout, and store
+   its hash in *hash_ptr.  Unused and dummy slots get their usual hash. */
+static inline PyObject *
+set_slot(PySetObject *so, Py_ssize_t i, Py_hash_t *hash_ptr)
+{
+    PyObject *key;
+
+    if (SET_IS_COMPACT(so)) {
+        key = COMPACT_KEYS(so)[i];
+        if (key == NULL)
+            *hash_ptr = 0;
+        else if (key == dummy)
+            *hash_ptr = -1;
+        else
+            *hash_ptr = compact_key_hash(key);
+        return key;
+    }
+    *hash_ptr = so->table[i].hash;
+    return so->table[i].key;
+}
+
 static int
 set_merge(PySetObject *so, PyObject *otherset)
 {
     PySetObject *other;
     PyObject *key;
+    Py_hash_t hash;
     Py_ssize_t i;
-    setentry *so_entry;
-    setentry *other_entry;
 
     assert (PyAnySet_Check(so));
     assert (PyAnySet_Check(otherset));
@@ -575,6 +966,11 @@ set_merge(PySetObject *so, PyObject *otherset)
     if (other == so || other->used == 0)
         /* a.update(a) or a.update(set()); nothing to do */
         return 0;
+    /* Expect the keys of a general table not to fit in a compact one. */
+    if (SET_IS_COMPACT(so) && !SET_IS_COMPACT(other)) {
+        if (set_table_make_general(so) != 0)
+            return -1;
+    }
     /* Do one big resize at the start, rather than
      * incrementally resizing as we insert new keys.  Expect
      * that there will be no (or few) overlapping keys.
@@ -583,49 +979,84 @@ set_merge(PySetObject *so, PyObject *otherset)
         if (set_table_resize(so, (so->used + other->used)*2) != 0)
             return -1;
     }
-    so_entry = so->table;
-    other_entry = other->table;
-
-    /* If our table is empty, and both tables have the same size, and
-       there are no dummies to eliminate, then just copy the pointers. */
-    if (so->fill == 0 && so->mask == other->mask && other->fill == other->used) {
-        for (i = 0; i <= other->mask; i++, so_entry++, other_entry++) {
-            key = other_entry->key;
-            if (key != NULL) {
-                assert(so_entry->key == NULL);
-                so_entry->key = Py_NewRef(key);
-                so_entry->hash = other_entry->hash;
+
+    if (SET_IS_COMPACT(so)) {
+        PyObject **so_keys = COMPACT_KEYS(so);
+        PyObject **other_keys = COMPACT_KEYS(other);
+
+        assert(SET_IS_COMPACT(other));
+        /* If our table is empty, and both tables have the same size, and
+           there are no dummies to eliminate, then just copy the pointers. */
+        if (so->fill == 0 && so->mask == other->mask
+            && other->fill == other->used) {
+            for (i = 0; i <= other->mask; i++) {
+                key = other_keys[i];
+                if (key != NULL) {
+                    assert(so_keys[i] == NULL);
+                    so_keys[i] = Py_NewRef(key);
+                }
             }
+            so->fill = other->fill;
+            so->used = other->used;
+            return 0;
+        }
+
+        /* If our table is empty, we can use set_insert_clean_compact() */
+        if (so->fill == 0) {
+            size_t newmask = (size_t)so->mask;
+            so->fill = other->used;
+            so->used = other->used;
+            for (i = 0; i <= other->mask; i++) {
+                key = other_keys[i];
+                if (key != NULL && key != dummy) {
+                    set_insert_clean_compact(so_keys, newmask,
+                                             Py_NewRef(key));
+                }
+            }
+            return 0;
         }
-        so->fill = other->fill;
-        so->used = other->used;
-        return 0;
     }
+    else {
+        setentry *so_entry = so->table;
+
+        /* If our table is empty, and both tables have the same size, and
+           there are no dummies to eliminate, then just copy the pointers. */
+        if (so->fill == 0 && so->mask == other->mask
+            && other->fill == other->used) {
+            for (i = 0; i <= other->mask; i++, so_entry++) {
+                key = set_slot(other, i, &hash);
+                if (key != NULL) {
+                    assert(so_entry->key == NULL);
+                    so_entry->key = Py_NewRef(key);
+                    so_entry->hash = hash;
+                }
+            }
+            so->fill = other->fill;
+            so->used = other->used;
+            return 0;
+        }
 
-    /* If our table is empty, we can use set_insert_clean() */
-    if (so->fill == 0) {
-        setentry *newtable = so->table;
-        size_t newmask = (size_t)so->mask;
-        so->fill = other->used;
-        so->used = other->used;
-        for (i = other->mask + 1; i > 0 ; i--, other_entry++) {
-            key = other_entry->key;
-            if (key != NULL && key != dummy) {
-                set_insert_clean(newtable, newmask, Py_NewRef(key),
-                                 other_entry->hash);
+        /* If our table is empty, we can use set_insert_clean() */
+        if (so->fill == 0) {
+            setentry *newtable = so->table;
+            size_t newmask = (size_t)so->mask;
+            so->fill = other->used;
+            so->used = other->used;
+            for (i = 0; i <= other->mask; i++) {
+                key = set_slot(other, i, &hash);
+                if (key != NULL && key != dummy) {
+                    set_insert_clean(newtable, newmask, Py_NewRef(key), hash);
+                }
             }
+            return 0;
         }
-        return 0;
     }
 
     /* We can't assure there are no duplicates, so do normal insertions */
-    for (i = 0; i <= other->mask; i++) {
-        other_entry = &other->table[i];
-        key = other_entry->key;
-        if (key != NULL && key != dummy) {
-            if (set_add_entry(so, key, other_entry->hash))
-                return -1;
-        }
+    i = 0;
+    while (set_next(other, &i, &key, &hash)) {
+        if (set_add_entry(so, key, hash))
+            return -1;
     }
     return 0;
 }
@@ -633,15 +1064,34 @@ set_merge(PySetObject *so, PyObject *otherset)
 static PyObject *
 set_pop(PySetObject *so, PyObject *Py_UNUSED(ignored))
 {
-    /* Make sure the search finger is in bounds */
-    setentry *entry = so->table + (so->finger & so->mask);
-    setentry *limit = so->table + so->mask;
     PyObject *key;
 
     if (so->used == 0) {
         PyErr_SetString(PyExc_KeyError, "pop from an empty set");
         return NULL;
     }
+    if (SET_IS_COMPACT(so)) {
+        /* Make sure the search finger is in bounds */
+        PyObject **slot = COMPACT_KEYS(so) + (so->finger & so->mask);
+        PyObject **limit = COMPACT_KEYS(so) + so->mask;
+
+        while (*slot == NULL || *slot == dummy) {
+            slot++;
+            if (slot > limit)
+                slot = COMPACT_KEYS(so);
+        }
+        key = *slot;
+        *slot = dummy;
+        so->used--;
+        /* next place to start */
+        so->finger = (slot - COMPACT_KEYS(so) + 1) | SET_COMPACT_FLAG;
+        return key;
+    }
+
+    /* Make sure the search finger is in bounds */
+    setentry *entry = so->table + (so->finger & so->mask);
+    setentry *limit = so->table + so->mask;
+
     while (entry->key == NULL || entry->key==dummy) {
         entry++;
         if (entry > limit)
@@ -662,10 +1112,11 @@ static int
 set_traverse(PySetObject *so, visitproc visit, void *arg)
 {
     Py_ssize_t pos = 0;
-    setentry *entry;
+    PyObject *key;
+    Py_hash_t hash;
 
-    while (set_next(so, &pos, &entry))
-        Py_VISIT(entry->key);
+    while (set_next(so, &pos, &key, &hash))
+        Py_VISIT(key);
     return 0;
 }
 
@@ -704,18 +1155,29 @@ frozenset_hash(PyObject *self)
        depends only on active entries.  This allows the code to be
        vectorized by the compiler and it saves the unpredictable
        branches that would arise when trying to exclude null and dummy
-       entries on every iteration. */
-
-    for (entry = so->table; entry <= &so->table[so->mask]; entry++)
-        hash ^= _shuffle_bits(entry->hash);
+       entries on every iteration.  A compact table has no hash fields
+       to include, and its keys have to be skipped. */
+
+    if (SET_IS_COMPACT(so)) {
+        PyObject **slot;
+        for (slot = COMPACT_KEYS(so); slot <= &COMPACT_KEYS(so)[so->mask];
+             slot++) {
+            if (*slot != NULL && *slot != dummy)
+                hash ^= _shuffle_bits(compact_key_hash(*slot));
+        }
+    }
+    else {
+        for (entry = so->table; entry <= &so->table[so->mask]; entry++)
+            hash ^= _shuffle_bits(entry->hash);
 
-    /* Remove the effect of an odd number of NULL entries */
-    if ((so->mask + 1 - so->fill) & 1)
-        hash ^= _shuffle_bits(0);
+        /* Remove the effect of an odd number of NULL entries */
+        if ((so->mask + 1 - so->fill) & 1)
+            hash ^= _shuffle_bits(0);
 
-    /* Remove the effect of an odd number of dummy entries */
-    if ((so->fill - so->used) & 1)
-        hash ^= _shuffle_bits(-1);
+        /* Remove the effect of an odd number of dummy entries */
+        if ((so->fill - so->used) & 1)
+            hash ^= _shuffle_bits(-1);
+    }
 
     /* Factor in the number of active entries */
     hash ^= ((Py_uhash_t)PySet_GET_SIZE(self) + 1) * 1927868237UL;
@@ -815,8 +1277,18 @@ static PyObject *setiter_iternext(setiterobject *si)
 
     i = si->si_pos;
     assert(i>=0);
-    entry = so->table;
     mask = so->mask;
+    if (SET_IS_COMPACT(so)) {
+        PyObject **keys = COMPACT_KEYS(so);
+        while (i <= mask && (keys[i] == NULL || keys[i] == dummy))
+            i++;
+        si->si_pos = i+1;
+        if (i > mask)
+            goto fail;
+        si->len--;
+        return Py_NewRef(keys[i]);
+    }
+    entry = so->table;
     while (i <= mask && (entry[i].key == NULL || entry[i].key == dummy))
         i++;
     si->si_pos = i+1;
@@ -965,7 +1437,7 @@ make_new_set(PyTypeObject *type, PyObject *iterable)
     so->mask = PySet_MINSIZE - 1;
     so->table = so->smalltable;
     so->hash = -1;
-    so->finger = 0;
+    so->finger = SET_COMPACT_FLAG;
     so->weakreflist = NULL;
 
     if (iterable != NULL) {
@@ -1060,6 +1532,7 @@ static void
 set_swap_bodies(PySetObject *a, PySetObject *b)
 {
     Py_ssize_t t;
+    int c;
     setentry *u;
     setentry tab[PySet_MINSIZE];
     Py_hash_t h;
@@ -1067,6 +1540,9 @@ set_swap_bodies(PySetObject *a, PySetObject *b)
     t = a->fill;     a->fill   = b->fill;        b->fill  = t;
     t = a->used;     a->used   = b->used;        b->used  = t;
     t = a->mask;     a->mask   = b->mask;        b->mask  = t;
+    c = SET_IS_COMPACT(a);
+    set_mark_compact(a, SET_IS_COMPACT(b));
+    set_mark_compact(b, c);
 
     u = a->table;
     if (a->table == a->smalltable)
@@ -1193,7 +1669,6 @@ set_intersection(PySetObject *so, PyObject *other)
 
     if (PyAnySet_Check(other)) {
         Py_ssize_t pos = 0;
-        setentry *entry;
 
         if (PySet_GET_SIZE(other) > PySet_GET_SIZE(so)) {
             tmp = (PyObject *)so;
@@ -1201,9 +1676,7 @@ set_intersection(PySetObject *so, PyObject *other)
             other = tmp;
         }
 
-        while (set_next((PySetObject *)other, &pos, &entry)) {
-            key = entry->key;
-            hash = entry->hash;
+        while (set_next((PySetObject *)other, &pos, &key, &hash)) {
             Py_INCREF(key);
             rv = set_contains_entry(so, key, hash);
             if (rv < 0) {
@@ -1351,17 +1824,16 @@ set_isdisjoint(PySetObject *so, PyObject *other)
 
     if (PyAnySet_CheckExact(other)) {
         Py_ssize_t pos = 0;
-        setentry *entry;
+        Py_hash_t hash;
 
         if (PySet_GET_SIZE(other) > PySet_GET_SIZE(so)) {
             tmp = (PyObject *)so;
             so = (PySetObject *)other;
             other = tmp;
         }
-        while (set_next((PySetObject *)other, &pos, &entry)) {
-            PyObject *key = entry->key;
+        while (set_next((PySetObject *)other, &pos, &key, &hash)) {
             Py_INCREF(key);
-            rv = set_contains_entry(so, key, entry->hash);
+            rv = set_contains_entry(so, key, hash);
             Py_DECREF(key);
             if (rv < 0) {
                 return NULL;
@@ -1405,7 +1877,8 @@ set_difference_update_internal(PySetObject *so, PyObject *other)
         return set_clear_internal(so);
 
     if (PyAnySet_Check(other)) {
-        setentry *entry;
+        PyObject *key;
+        Py_hash_t hash;
         Py_ssize_t pos = 0;
 
         /* Optimization:  When the other set is more than 8 times
@@ -1420,10 +1893,9 @@ set_difference_update_internal(PySetObject *so, PyObject *other)
             Py_INCREF(other);
         }
 
-        while (set_next((PySetObject *)other, &pos, &entry)) {
-            PyObject *key = entry->key;
+        while (set_next((PySetObject *)other, &pos, &key, &hash)) {
             Py_INCREF(key);
-            if (set_discard_entry(so, key, entry->hash) < 0) {
+            if (set_discard_entry(so, key, hash) < 0) {
                 Py_DECREF(other);
                 Py_DECREF(key);
                 return -1;
@@ -1492,7 +1964,6 @@ set_difference(PySetObject *so, PyObject *other)
     PyObject *result;
     PyObject *key;
     Py_hash_t hash;
-    setentry *entry;
     Py_ssize_t pos = 0, other_size;
     int rv;
 
@@ -1517,9 +1988,7 @@ set_difference(PySetObject *so, PyObject *other)
         return NULL;
 
     if (PyDict_CheckExact(other)) {
-        while (set_next(so, &pos, &entry)) {
-            key = entry->key;
-            hash = entry->hash;
+        while (set_next(so, &pos, &key, &hash)) {
             Py_INCREF(key);
             rv = _PyDict_Contains_KnownHash(other, key, hash);
             if (rv < 0) {
@@ -1540,9 +2009,7 @@ set_difference(PySetObject *so, PyObject *other)
     }
 
     /* Iterate over so, checking for common elements in other. */
-    while (set_next(so, &pos, &entry)) {
-        key = entry->key;
-        hash = entry->hash;
+    while (set_next(so, &pos, &key, &hash)) {
         Py_INCREF(key);
         rv = set_contains_entry((PySetObject *)other, key, hash);
         if (rv < 0) {
@@ -1615,7 +2082,6 @@ set_symmetric_difference_update(PySetObject *so, PyObject *other)
     PyObject *key;
     Py_ssize_t pos = 0;
     Py_hash_t hash;
-    setentry *entry;
     int rv;
 
     if ((PyObject *)so == other)
@@ -1649,9 +2115,7 @@ set_symmetric_difference_update(PySetObject *so, PyObject *other)
             return NULL;
     }
 
-    while (set_next(otherset, &pos, &entry)) {
-        key = entry->key;
-        hash = entry->hash;
+    while (set_next(otherset, &pos, &key, &hash)) {
         Py_INCREF(key);
         rv = set_discard_entry(so, key, hash);
         if (rv < 0) {
@@ -1723,7 +2187,8 @@ set_ixor(PySetObject *so, PyObject *other)
 static PyObject *
 set_issubset(PySetObject *so, PyObject *other)
 {
-    setentry *entry;
+    PyObject *key;
+    Py_hash_t hash;
     Py_ssize_t pos = 0;
     int rv;
 
@@ -1739,10 +2204,9 @@ set_issubset(PySetObject *so, PyObject *other)
     if (PySet_GET_SIZE(so) > PySet_GET_SIZE(other))
         Py_RETURN_FALSE;
 
-    while (set_next(so, &pos, &entry)) {
-        PyObject *key = entry->key;
+    while (set_next(so, &pos, &key, &hash)) {
         Py_INCREF(key);
-        rv = set_contains_entry((PySetObject *)other, key, entry->hash);
+        rv = set_contains_entry((PySetObject *)other, key, hash);
         Py_DECREF(key);
         if (rv < 0) {
             return NULL;
@@ -1844,8 +2308,8 @@ PyDoc_STRVAR(add_doc,
 \n\
 This has no effect if the element is already present.");
 
-static int
-set_contains(PySetObject *so, PyObject *key)
+int
+_PySet_Contains(PySetObject *so, PyObject *key)
 {
     PyObject *tmpkey;
     int rv;
@@ -1869,7 +2333,7 @@ set_direct_contains(PySetObject *so, PyObject *key)
 {
     long result;
 
-    result = set_contains(so, key);
+    result = _PySet_Contains(so, key);
     if (result < 0)
         return NULL;
     return PyBool_FromLong(result);
@@ -1964,7 +2428,8 @@ set_sizeof(PySetObject *so, PyObject *Py_UNUSED(ignored))
 {
     size_t res = _PyObject_SIZE(Py_TYPE(so));
     if (so->table != so->smalltable) {
-        res += ((size_t)so->mask + 1) * sizeof(setentry);
+        res += ((size_t)so->mask + 1) *
+               (SET_IS_COMPACT(so) ? sizeof(PyObject *) : sizeof(setentry));
     }
     return PyLong_FromSize_t(res);
 }
@@ -2017,7 +2482,7 @@ static PySequenceMethods set_as_sequence = {
     0,                                  /* sq_slice */
     0,                                  /* sq_ass_item */
     0,                                  /* sq_ass_slice */
-    (objobjproc)set_contains,           /* sq_contains */
+    (objobjproc)_PySet_Contains,        /* sq_contains */
 };
 
 /* set object ********************************************************/
@@ -2321,17 +2786,11 @@ PySet_Add(PyObject *anyset, PyObject *key)
 int
 _PySet_NextEntry(PyObject *set, Py_ssize_t *pos, PyObject **key, Py_hash_t *hash)
 {
-    setentry *entry;
-
     if (!PyAnySet_Check(set)) {
         PyErr_BadInternalCall();
         return -1;
     }
-    if (set_next((PySetObject *)set, pos, &entry) == 0)
-        return 0;
-    *key = entry->key;
-    *hash = entry->hash;
-    return 1;
+    return set_next((PySetObject *)set, pos, key, hash);
 }
 
 PyObject *
@@ -253,6 +253,320 @@ STRINGLIB(utf8_decode)(const char **inptr, const char *end,
 
 #undef ASCII_CHAR_MASK
 
+#if defined(HAVE_UTF8_AVX2) && STRINGLIB_MAX_CHAR > 0x7F
+/* Decode [s, end), valid UTF-8 whose characters all fit STRINGLIB_CHAR,
+   into [p, pend), which must be exactly the size of the result.
+
+   Sixteen bytes from a character boundary are decoded at a time: the code
+   point that would start at each of them, if it isn't a continuation byte,
+   is computed from it and the next two bytes in 16-bit lanes, and the
+   lanes of the actual characters are then packed four at a time with a
+   shuffle.  Blocks with 4 byte sequences are left to
+   utf8_decode_valid_char(). */
+UTF8_AVX2_TARGET static void
+STRINGLIB(utf8_decode_valid_avx2)(const char *s, const char *end,
+                                  STRINGLIB_CHAR *p, STRINGLIB_CHAR *pend)
+{
+    /* pack_table[mask] moves the 16-bit lanes selected by the 4 bits of
+       mask to the bottom of the vector */
+    static const int8_t pack_table[16][8] = {
+        {-1, -1, -1, -1, -1, -1, -1, -1},
+        { 0,  1, -1, -1, -1, -1, -1, -1},
+        { 2,  3, -1, -1, -1, -1, -1, -1},
+        { 0,  1,  2,  3, -1, -1, -1, -1},
+        { 4,  5, -1, -1, -1, -1, -1, -1},
+        { 0,  1,  4,  5, -1, -1, -1, -1},
+        { 2,  3,  4,  5, -1, -1, -1, -1},
+        { 0,  1,  2,  3,  4,  5, -1, -1},
+        { 6,  7, -1, -1, -1, -1, -1, -1},
+        { 0,  1,  6,  7, -1, -1, -1, -1},
+        { 2,  3,  6,  7, -1, -1, -1, -1},
+        { 0,  1,  2,  3,  6,  7, -1, -1},
+        { 4,  5,  6,  7, -1, -1, -1, -1},
+        { 0,  1,  4,  5,  6,  7, -1, -1},
+        { 2,  3,  4,  5,  6,  7, -1, -1},
+        { 0,  1,  2,  3,  4,  5,  6,  7},
+    };
+    const __m256i mask3f = _mm256_set1_epi16(0x3F);
+    const __m128i cont_limit = _mm_set1_epi8(-0x40);
+
+    /* The loop reads up to 18 bytes, and writes up to 16 characters. */
+    while (end - s >= 32 && pend - p >= 16) {
+        __m128i input = _mm_loadu_si128((const __m128i *)s);
+        uint32_t high = (uint32_t)_mm_movemask_epi8(input);
+
+        if (high == 0) {
+            /* 16 ASCII characters */
+#if STRINGLIB_SIZEOF_CHAR == 1
+            _mm_storeu_si128((__m128i *)p, input);
+#elif STRINGLIB_SIZEOF_CHAR == 2
+            _mm256_storeu_si256((__m256i *)p, _mm256_cvtepu8_epi16(input));
+#else
+            _mm256_storeu_si256((__m256i *)p, _mm256_cvtepu8_epi32(input));
+            _mm256_storeu_si256((__m256i *)(p + 8),
+                _mm256_cvtepu8_epi32(_mm_srli_si128(input, 8)));
+#endif
+            s += 16;
+            p += 16;
+            continue;
+        }
+#if STRINGLIB_MAX_CHAR > 0xFFFF
+        uint32_t four = (uint32_t)_mm_movemask_epi8(
+            _mm_cmpgt_epi8(input, _mm_set1_epi8((char)(0xF0 - 1)))) & high;
+        if (four) {
+            /* decode up to the end of the first 4 byte sequence */
+            const char *stop = s + _Py_ctz32(four) + 4;
+            while (s < stop) {
+                *p++ = utf8_decode_valid_char(&s);
+            }
+            continue;
+        }
+#endif
+        __m128i input2 = _mm_loadu_si128((const __m128i *)(s + 2));
+        __m256i b0 = _mm256_cvtepu8_epi16(input);
+        __m256i b1 = _mm256_cvtepu8_epi16(
+            _mm_loadu_si128((const __m128i *)(s + 1)));
+        __m256i b2 = _mm256_cvtepu8_epi16(input2);
+        /* 110xxxxx 10yyyyyy -> 00000xxx xxyyyyyy */
+        __m256i ch2 = _mm256_or_si256(
+            _mm256_slli_epi16(_mm256_and_si256(b0, _mm256_set1_epi16(0x1F)), 6),
+            _mm256_and_si256(b1, mask3f));
+        /* 1110xxxx 10yyyyyy 10zzzzzz -> xxxxyyyy yyzzzzzz */
+        __m256i ch3 = _mm256_or_si256(
+            _mm256_or_si256(_mm256_slli_epi16(b0, 12),
+                            _mm256_slli_epi16(_mm256_and_si256(b1, mask3f), 6)),
+            _mm256_and_si256(b2, mask3f));
+        __m256i ch = _mm256_blendv_epi8(
+            ch2, b0, _mm256_cmpgt_epi16(_mm256_set1_epi16(0x80), b0));
+        ch = _mm256_blendv_epi8(
+            ch, ch3, _mm256_cmpgt_epi16(b0, _mm256_set1_epi16(0xDF)));
+
+        /* the bytes that start a character, and the continuation bytes at
+           s + 16 and s + 17, which belong to the last of them */
+        uint32_t starts = ~(uint32_t)_mm_movemask_epi8(
+            _mm_cmplt_epi8(input, cont_limit)) & 0xFFFF;
+        uint32_t conts = (uint32_t)_mm_movemask_epi8(
+            _mm_cmplt_epi8(input2, cont_limit)) >> 14;
+        __m128i half[2] = {_mm256_castsi256_si128(ch),
+                           _mm256_extracti128_si256(ch, 1)};
+        for (int i = 0; i < 4; i++) {
+            uint32_t mask = (starts >> (4 * i)) & 0xF;
+            __m128i lanes = half[i >> 1];
+            if (i & 1) {
+                lanes = _mm_srli_si128(lanes, 8);
+            }
+            lanes = _mm_shuffle_epi8(
+                lanes, _mm_loadl_epi64((const __m128i *)pack_table[mask]));
+#if STRINGLIB_SIZEOF_CHAR == 1
+            uint32_t packed = (uint32_t)_mm_cvtsi128_si32(
+                _mm_packus_epi16(lanes, lanes));
+            memcpy(p, &packed, 4);
+#elif STRINGLIB_SIZEOF_CHAR == 2
+            _mm_storel_epi64((__m128i *)p, lanes);
+#else
+            _mm_storeu_si128((__m128i *)p, _mm_cvtepu16_epi32(lanes));
+#endif
+            p += _Py_popcount32(mask);
+        }
+        /* skip the 0 to 2 continuation bytes after the block */
+        s += 16 + (conts & 1) + (conts >> 1 & conts & 1);
+    }
+    while (s < end) {
+        *p++ = (STRINGLIB_CHAR)utf8_decode_valid_char(&s);
+    }
+    assert(p == pend);
+}
+#endif  /* HAVE_UTF8_AVX2 && STRINGLIB_MAX_CHAR > 0x7F */
+
+
+#if defined(HAVE_UTF8_AVX2) && STRINGLIB_MAX_CHAR > 0x7F
+/* Encode data[i:size] to UTF-8 at *pp, eight characters at a time, up to
+   the first block with a surrogate.  There must be room for max_char_size
+   bytes per character.  Advance *pp, and return the index of the first
+   character left to the caller.
+
+   Blocks of ASCII, of characters below U+0800, and of 3 byte characters
+   have their own paths; other blocks get the encoding of each character
+   computed in a 32-bit lane, and then copied one lane at a time. */
+UTF8_AVX2_TARGET static Py_ssize_t
+STRINGLIB(utf8_encode_avx2)(const STRINGLIB_CHAR *data, Py_ssize_t i,
+                            Py_ssize_t size, char **pp)
+{
+    /* pack_table[mask] packs four 16-bit lanes of one or two bytes, mask
+       having a bit set for each lane of two bytes */
+    static const int8_t pack_table[16][8] = {
+        {0, 2, 4, 6, -1, -1, -1, -1},
+        {0, 1, 2, 4, 6, -1, -1, -1},
+        {0, 2, 3, 4, 6, -1, -1, -1},
+        {0, 1, 2, 3, 4, 6, -1, -1},
+        {0, 2, 4, 5, 6, -1, -1, -1},
+        {0, 1, 2, 4, 5, 6, -1, -1},
+        {0, 2, 3, 4, 5, 6, -1, -1},
+        {0, 1, 2, 3, 4, 5, 6, -1},
+        {0, 2, 4, 6, 7, -1, -1, -1},
+        {0, 1, 2, 4, 6, 7, -1, -1},
+        {0, 2, 3, 4, 6, 7, -1, -1},
+        {0, 1, 2, 3, 4, 6, 7, -1},
+        {0, 2, 4, 5, 6, 7, -1, -1},
+        {0, 1, 2, 4, 5, 6, 7, -1},
+        {0, 2, 3, 4, 5, 6, 7, -1},
+        {0, 1, 2, 3, 4, 5, 6, 7},
+    };
+    const __m128i mask3f = _mm_set1_epi16(0x3F);
+    char *p = *pp;
+
+    /* A block may write 4 bytes past the encoding of its last character:
+       the room for a ninth character covers that. */
+    while (size - i > 8) {
+        __m128i ch;
+#if STRINGLIB_SIZEOF_CHAR == 1
+        ch = _mm_cvtepu8_epi16(_mm_loadl_epi64((const __m128i *)(data + i)));
+#elif STRINGLIB_SIZEOF_CHAR == 2
+        ch = _mm_loadu_si128((const __m128i *)(data + i));
+#else
+        __m256i wide = _mm256_loadu_si256((const __m256i *)(data + i));
+        if (!_mm256_testz_si256(wide, _mm256_set1_epi32((int)0xFFFF0000))) {
+            goto general;
+        }
+        ch = _mm_packus_epi32(_mm256_castsi256_si128(wide),
+                              _mm256_extracti128_si256(wide, 1));
+#endif
+
+        if (_mm_testz_si128(ch, _mm_set1_epi16((short)0xFF80))) {
+            /* ASCII */
+            _mm_storel_epi64((__m128i *)p, _mm_packus_epi16(ch, ch));
+            p += 8;
+        }
+        else if (_mm_testz_si128(ch, _mm_set1_epi16((short)0xF800))) {
+            /* 1 or 2 bytes: 110xxxxx 10yyyyyy, first byte low */
+            __m128i two = _mm_or_si128(
+                _mm_or_si128(_mm_srli_epi16(ch, 6), _mm_set1_epi16(0x80C0)),
+                _mm_slli_epi16(_mm_and_si128(ch, mask3f), 8));
+            __m128i is_two = _mm_cmpgt_epi16(ch, _mm_set1_epi16(0x7F));
+            __m128i bytes = _mm_blendv_epi8(ch, two, is_two);
+            /* one bit per lane */
+            uint32_t mask = (uint32_t)_mm_movemask_epi8(
+                _mm_packs_epi16(is_two, is_two)) & 0xFF;
+            __m128i packed = _mm_shuffle_epi8(bytes,
+                _mm_loadl_epi64((const __m128i *)pack_table[mask & 0xF]));
+            _mm_storel_epi64((__m128i *)p, packed);
+            p += 4 + _Py_popcount32(mask & 0xF);
+            packed = _mm_shuffle_epi8(_mm_srli_si128(bytes, 8),
+                _mm_loadl_epi64((const __m128i *)pack_table[mask >> 4]));
+            _mm_storel_epi64((__m128i *)p, packed);
+            p += 4 + _Py_popcount32(mask >> 4);
+        }
+#if STRINGLIB_SIZEOF_CHAR > 1
+        else if (_mm_testz_si128(
+                     _mm_or_si128(
+                         /* below U+0800 */
+                         _mm_cmplt_epi16(
+                             _mm_xor_si128(ch, _mm_set1_epi16((short)0x8000)),
+                             _mm_set1_epi16((short)(0x0800 ^ 0x8000))),
+                         /* surrogates */
+                         _mm_cmpeq_epi16(
+                             _mm_and_si128(ch, _mm_set1_epi16((short)0xF800)),
+                             _mm_set1_epi16((short)0xD800))),
+                     _mm_set1_epi8(-1)))
+        {
+            /* 3 bytes: 1110xxxx 10yyyyyy 10zzzzzz */
+            __m128i b0 = _mm_or_si128(_mm_srli_epi16(ch, 12),
+                                      _mm_set1_epi16(0xE0));
+            __m128i b1 = _mm_or_si128(
+                _mm_and_si128(_mm_srli_epi16(ch, 6), mask3f),
+                _mm_set1_epi16(0x80));
+            __m128i b2 = _mm_or_si128(_mm_and_si128(ch, mask3f),
+                                      _mm_set1_epi16(0x80));
+            /* b0 and b1 in bytes 0-7 and 8-15, and b2 in bytes 0-7 */
+            __m128i b01 = _mm_packus_epi16(b0, b1);
+            b2 = _mm_packus_epi16(b2, b2);
+            __m128i out0 = _mm_or_si128(
+                _mm_shuffle_epi8(b01, _mm_setr_epi8(
+                    0, 8, -1, 1, 9, -1, 2, 10, -1, 3, 11, -1, 4, 12, -1, 5)),
+                _mm_shuffle_epi8(b2, _mm_setr_epi8(
+                    -1, -1, 0, -1, -1, 1, -1, -1, 2, -1, -1, 3, -1, -1, 4, -1)));
+            __m128i out1 = _mm_or_si128(
+                _mm_shuffle_epi8(b01, _mm_setr_epi8(
+                    13, -1, 6, 14, -1, 7, 15, -1,
+                    -1, -1, -1, -1, -1, -1, -1, -1)),
+                _mm_shuffle_epi8(b2, _mm_setr_epi8(
+                    -1, 5, -1, -1, 6, -1, -1, 7,
+                    -1, -1, -1, -1, -1, -1, -1, -1)));
+            _mm_storeu_si128((__m128i *)p, out0);
+            _mm_storel_epi64((__m128i *)(p + 16), out1);
+            p += 24;
+        }
+        else {
+#if STRINGLIB_SIZEOF_CHAR == 2
+            __m256i wide = _mm256_cvtepu16_epi32(ch);
+#else
+          general:
+#endif
+            /* any mix of lengths */
+            __m256i c = wide;
+            __m256i cont = _mm256_set1_epi32(0x80);
+            __m256i m3f = _mm256_set1_epi32(0x3F);
+            if (!_mm256_testz_si256(
+                    _mm256_cmpeq_epi32(
+                        _mm256_and_si256(c, _mm256_set1_epi32(~0x7FF)),
+                        _mm256_set1_epi32(0xD800)),
+                    _mm256_set1_epi8(-1)))
+            {
+                /* a surrogate */
+                break;
+            }
+            /* the continuation bytes for bits 0-5, 6-11 and 12-17 */
+            __m256i c0 = _mm256_or_si256(_mm256_and_si256(c, m3f), cont);
+            __m256i c1 = _mm256_or_si256(
+                _mm256_and_si256(_mm256_srli_epi32(c, 6), m3f), cont);
+            __m256i c2 = _mm256_or_si256(
+                _mm256_and_si256(_mm256_srli_epi32(c, 12), m3f), cont);
+            __m256i e2 = _mm256_or_si256(
+                _mm256_or_si256(_mm256_srli_epi32(c, 6),
+                                _mm256_set1_epi32(0xC0)),
+                _mm256_slli_epi32(c0, 8));
+            __m256i e3 = _mm256_or_si256(
+                _mm256_or_si256(_mm256_srli_epi32(c, 12),
+                                _mm256_set1_epi32(0xE0)),
+                _mm256_or_si256(_mm256_slli_epi32(c1, 8),
+                                _mm256_slli_epi32(c0, 16)));
+            __m256i over7f = _mm256_cmpgt_epi32(c, _mm256_set1_epi32(0x7F));
+            __m256i over7ff = _mm256_cmpgt_epi32(c, _mm256_set1_epi32(0x7FF));
+            __m256i enc = _mm256_blendv_epi8(c, e2, over7f);
+            enc = _mm256_blendv_epi8(enc, e3, over7ff);
+            /* lengths minus one, as the masks are -1 */
+            __m256i len = _mm256_sub_epi32(_mm256_setzero_si256(),
+                _mm256_add_epi32(over7f, over7ff));
+#if STRINGLIB_SIZEOF_CHAR == 4
+            __m256i overffff = _mm256_cmpgt_epi32(c, _mm256_set1_epi32(0xFFFF));
+            __m256i e4 = _mm256_or_si256(
+                _mm256_or_si256(_mm256_srli_epi32(c, 18),
+                                _mm256_set1_epi32(0xF0)),
+                _mm256_or_si256(
+                    _mm256_or_si256(_mm256_slli_epi32(c2, 8),
+                                    _mm256_slli_epi32(c1, 16)),
+                    _mm256_slli_epi32(c0, 24)));
+            enc = _mm256_blendv_epi8(enc, e4, overffff);
+            len = _mm256_sub_epi32(len, overffff);
+#else
+            (void)c2;
+#endif
+            uint32_t encs[8], lens[8];
+            _mm256_storeu_si256((__m256i *)encs, enc);
+            _mm256_storeu_si256((__m256i *)lens, len);
+            for (int k = 0; k < 8; k++) {
+                /* little endian: the first byte is the lowest */
+                memcpy(p, &encs[k], 4);
+                p += lens[k] + 1;
+            }
+        }
+#endif  /* STRINGLIB_SIZEOF_CHAR > 1 */
+        i += 8;
+    }
+    *pp = p;
+    return i;
+}
+#endif  /* HAVE_UTF8_AVX2 && STRINGLIB_MAX_CHAR > 0x7F */
 
 /* UTF-8 encoder specialized for a Unicode kind to avoid the slow
    PyUnicode_READ() macro. Delete some parts of the code depending on the kind:
@@ -292,7 +606,22 @@ STRINGLIB(utf8_encoder)(_PyBytesWriter *writer,
     if (p == NULL)
         return NULL;
 
+#if defined(HAVE_UTF8_AVX2) && STRINGLIB_MAX_CHAR > 0x7F
+    /* index of the next character to try the vectorized encoder at */
+    Py_ssize_t avx2_pos = size >= UTF8_AVX2_MIN_SIZE && utf8_avx2_supported()
+                          ? 0 : size;
+#endif
     for (i = 0; i < size;) {
+#if defined(HAVE_UTF8_AVX2) && STRINGLIB_MAX_CHAR > 0x7F
+        if (i >= avx2_pos) {
+            i = STRINGLIB(utf8_encode_avx2)(data, i, size, &p);
+            if (i == size) {
+                break;
+            }
+            /* encode the block it stopped at one character at a time */
+            avx2_pos = i + 8;
+        }
+#endif
         Py_UCS4 ch = data[i++];
 
         if (ch < 0x80) {
@@ -21,10 +21,26 @@
    deduce. See stringlib_find_two_way_notes.txt in this folder for a
    detailed explanation. */
 
+/* Needles of 2 to STRINGLIB_SIMD_MAX_NEEDLE characters are searched for
+   with SIMD instructions when they are available: SSE2 (always there on
+   x86-64), or AVX2 when the compiler targets it. */
+
+#include "pycore_bitutils.h"      // _Py_ctz32()
+
 #define FAST_COUNT 0
 #define FAST_SEARCH 1
 #define FAST_RSEARCH 2
 
+#if defined(__AVX2__)
+#  include <immintrin.h>
+#  define STRINGLIB_SIMD_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) \
+      || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  include <emmintrin.h>
+#  define STRINGLIB_SIMD_SSE2
+#endif
+#define STRINGLIB_SIMD_MAX_NEEDLE 32
+
 #if LONG_BIT >= 128
 #define STRINGLIB_BLOOM_WIDTH 128
 #elif LONG_BIT >= 64
@@ -729,6 +745,131 @@ STRINGLIB(default_rfind)(const STRINGLIB_CHAR* s, Py_ssize_t n,
 }
 
 
+#if defined(STRINGLIB_SIMD_AVX2) || defined(STRINGLIB_SIMD_SSE2)
+
+#ifdef STRINGLIB_SIMD_AVX2
+#  define SIMD_VEC __m256i
+#  define SIMD_LOAD(p) _mm256_loadu_si256((const __m256i *)(p))
+#  define SIMD_AND _mm256_and_si256
+#  define SIMD_MOVEMASK(v) ((uint32_t)_mm256_movemask_epi8(v))
+#  if STRINGLIB_SIZEOF_CHAR == 1
+#    define SIMD_SET1(c) _mm256_set1_epi8((char)(c))
+#    define SIMD_CMPEQ _mm256_cmpeq_epi8
+#  elif STRINGLIB_SIZEOF_CHAR == 2
+#    define SIMD_SET1(c) _mm256_set1_epi16((short)(c))
+#    define SIMD_CMPEQ _mm256_cmpeq_epi16
+#  else
+#    define SIMD_SET1(c) _mm256_set1_epi32((int)(c))
+#    define SIMD_CMPEQ _mm256_cmpeq_epi32
+#  endif
+#else
+#  define SIMD_VEC __m128i
+#  define SIMD_LOAD(p) _mm_loadu_si128((const __m128i *)(p))
+#  define SIMD_AND _mm_and_si128
+#  define SIMD_MOVEMASK(v) ((uint32_t)_mm_movemask_epi8(v))
+#  if STRINGLIB_SIZEOF_CHAR == 1
+#    define SIMD_SET1(c) _mm_set1_epi8((char)(c))
+#    define SIMD_CMPEQ _mm_cmpeq_epi8
+#  elif STRINGLIB_SIZEOF_CHAR == 2
+#    define SIMD_SET1(c) _mm_set1_epi16((short)(c))
+#    define SIMD_CMPEQ _mm_cmpeq_epi16
+#  else
+#    define SIMD_SET1(c) _mm_set1_epi32((int)(c))
+#    define SIMD_CMPEQ _mm_cmpeq_epi32
+#  endif
+#endif
+/* Characters per vector, and the movemask bits that stand for them (one
+   per character: movemask gives one bit per byte). */
+#define SIMD_LANES ((Py_ssize_t)(sizeof(SIMD_VEC) / STRINGLIB_SIZEOF_CHAR))
+#if STRINGLIB_SIZEOF_CHAR == 1
+#  define SIMD_LANE_BITS 0xFFFFFFFFu
+#elif STRINGLIB_SIZEOF_CHAR == 2
+#  define SIMD_LANE_BITS 0x55555555u
+#else
+#  define SIMD_LANE_BITS 0x11111111u
+#endif
+
+/* Search for a needle of 2 to STRINGLIB_SIMD_MAX_NEEDLE characters, after
+   Mula's "SIMD-friendly algorithms for substring searching": compare a
+   vector of haystack characters with the first character of the needle and
+   the vector m-1 characters further with its last one, and only compare
+   the rest of the needle where both match.  The last few positions, which
+   don't fill a vector, are left to default_find().
+
+   Haystacks where the first and last characters match without the rest
+   (say, searching for "aba" in "aaa...") make that slower than the scalar
+   algorithms, so give up on the vectors if it happens too often. */
+static Py_ssize_t
+STRINGLIB(simd_find)(const STRINGLIB_CHAR* s, Py_ssize_t n,
+                     const STRINGLIB_CHAR* p, Py_ssize_t m,
+                     Py_ssize_t maxcount, int mode)
+{
+    const Py_ssize_t mlast = m - 1;
+    const size_t middle = (size_t)(m - 2) * STRINGLIB_SIZEOF_CHAR;
+    const SIMD_VEC first = SIMD_SET1(p[0]);
+    const SIMD_VEC last = SIMD_SET1(p[mlast]);
+    /* counted matches don't overlap: the next one starts at next or later */
+    Py_ssize_t i, next = 0, count = 0, misses = 0, res;
+
+    assert(2 <= m && m <= STRINGLIB_SIMD_MAX_NEEDLE);
+    for (i = 0; i + mlast + SIMD_LANES <= n; i += SIMD_LANES) {
+        SIMD_VEC eq = SIMD_AND(SIMD_CMPEQ(first, SIMD_LOAD(s + i)),
+                               SIMD_CMPEQ(last, SIMD_LOAD(s + i + mlast)));
+        uint32_t mask = SIMD_MOVEMASK(eq) & SIMD_LANE_BITS;
+        while (mask) {
+            Py_ssize_t j = i + _Py_ctz32(mask) / STRINGLIB_SIZEOF_CHAR;
+            mask &= mask - 1;
+            if (j >= next && memcmp(s + j + 1, p + 1, middle) == 0) {
+                /* got a match! */
+                if (mode != FAST_COUNT) {
+                    return j;
+                }
+                count++;
+                if (count == maxcount) {
+                    return maxcount;
+                }
+                next = j + m;
+            }
+            else if (j >= next) {
+                misses++;
+            }
+        }
+        if (misses > (i >> 3) + 64) {
+            i += SIMD_LANES;
+            break;
+        }
+    }
+
+    i = Py_MAX(i, next);
+    if (n - i < m) {
+        return mode == FAST_COUNT ? count : -1;
+    }
+    if (m >= 6 && n - i > 2000) {
+        if (mode == FAST_SEARCH) {
+            res = STRINGLIB(_two_way_find)(s + i, n - i, p, m);
+            return res == -1 ? -1 : res + i;
+        }
+        res = STRINGLIB(_two_way_count)(s + i, n - i, p, m, maxcount - count);
+        return count + res;
+    }
+    res = STRINGLIB(default_find)(s + i, n - i, p, m, maxcount - count, mode);
+    if (mode == FAST_COUNT) {
+        return count + res;
+    }
+    return res == -1 ? -1 : res + i;
+}
+
+#undef SIMD_VEC
+#undef SIMD_LOAD
+#undef SIMD_AND
+#undef SIMD_MOVEMASK
+#undef SIMD_SET1
+#undef SIMD_CMPEQ
+#undef SIMD_LANES
+#undef SIMD_LANE_BITS
+#endif  /* STRINGLIB_SIMD_AVX2 || STRINGLIB_SIMD_SSE2 */
+
+
 static inline Py_ssize_t
 STRINGLIB(count_char)(const STRINGLIB_CHAR *s, Py_ssize_t n,
                       const STRINGLIB_CHAR p0, Py_ssize_t maxcount)
@@ -771,6 +912,11 @@ FASTSEARCH(const STRINGLIB_CHAR* s, Py_ssize_t n,
     }
 
     if (mode != FAST_RSEARCH) {
+#if defined(STRINGLIB_SIMD_AVX2) || defined(STRINGLIB_SIMD_SSE2)
+        if (m <= STRINGLIB_SIMD_MAX_NEEDLE) {
+            return STRINGLIB(simd_find)(s, n, p, m, maxcount, mode);
+        }
+#endif
         if (n < 2500 || (m < 100 && n < 30000) || m < 6) {
             return STRINGLIB(default_find)(s, n, p, m, maxcount, mode);
         }
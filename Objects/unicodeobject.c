@@ -40,6 +40,7 @@ OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
 
 #include "Python.h"
 #include "pycore_abstract.h"      // _PyIndex_Check()
+#include "pycore_bitutils.h"      // _Py_popcount32()
 #include "pycore_bytes_methods.h" // _Py_bytes_lower()
 #include "pycore_bytesobject.h"   // _PyBytes_Repeat()
 #include "pycore_ceval.h"         // _PyEval_GetBuiltin()
@@ -4589,6 +4590,223 @@ PyUnicode_DecodeUTF8(const char *s,
     return PyUnicode_DecodeUTF8Stateful(s, size, errors, NULL);
 }
 
+/* Vectorized UTF-8 decoding, used on x86 when the CPU supports AVX2, which
+   is checked at runtime.  Non-ASCII input is first validated and measured
+   by utf8_validate_avx2() (the algorithm of Keiser and Lemire, "Validating
+   UTF-8 In Less Than One Instruction Per Byte", 2021), and then transcoded
+   into a string of the right kind by STRINGLIB(utf8_decode_valid_avx2)()
+   from stringlib/codecs.h, without any further checks.  Invalid input, and
+   everything on other platforms, goes through STRINGLIB(utf8_decode)(). */
+#if (defined(__x86_64__) || defined(__i386__)) \
+    && (defined(__clang__) || (defined(__GNUC__) && __GNUC__ >= 5))
+#  include <immintrin.h>
+#  define HAVE_UTF8_AVX2
+#  define UTF8_AVX2_TARGET __attribute__((target("avx2,popcnt")))
+/* Don't bother with less non-ASCII input than that. */
+#  define UTF8_AVX2_MIN_SIZE 32
+
+static inline int
+utf8_avx2_supported(void)
+{
+    return __builtin_cpu_supports("avx2");
+}
+
+/* Error classes of the validation: each depends on the first 4 bits of a
+   byte, the last 4 bits of that byte, and the first 4 bits of the next
+   byte, and the input is invalid where all three lookups have a common
+   bit (but see TWO_CONTS). */
+#define UTF8_TOO_SHORT      (1 << 0)  /* 11______ 0_______, 11______ 11______ */
+#define UTF8_TOO_LONG       (1 << 1)  /* 0_______ 10______ */
+#define UTF8_OVERLONG_3     (1 << 2)  /* 11100000 100_____ */
+#define UTF8_TOO_LARGE      (1 << 3)  /* 11110100 1001____, 11110100 101_____,
+                                         11110101-11111111 10______ */
+#define UTF8_SURROGATE      (1 << 4)  /* 11101101 101_____ */
+#define UTF8_OVERLONG_2     (1 << 5)  /* 1100000_ 10______ */
+#define UTF8_TOO_LARGE_1000 (1 << 6)  /* 11110101-11111111 1000____ */
+#define UTF8_OVERLONG_4     (1 << 6)  /* 11110000 1000____ */
+/* Two continuation bytes in a row, which is only valid after a 3 or 4 byte
+   lead, so the bit is flipped there. */
+#define UTF8_TWO_CONTS      (1 << 7)  /* 10______ 10______ */
+#define UTF8_CARRY (UTF8_TOO_SHORT | UTF8_TOO_LONG | UTF8_TWO_CONTS)
+
+/* Duplicate a 16-byte lookup table into both lanes of a vector. */
+#define UTF8_TABLE(a, b, c, d, e, f, g, h, i, j, k, l, m, n, o, p)         \
+    _mm256_setr_epi8(a, b, c, d, e, f, g, h, i, j, k, l, m, n, o, p,        \
+                     a, b, c, d, e, f, g, h, i, j, k, l, m, n, o, p)
+
+/* Validate the UTF-8 data in [s, end).  If it is valid, set *nchars to the
+   number of code points it encodes and *maxchar to a maximum character for
+   them, 0xFF, 0xFFFF or 0x10FFFF, and return 1.  Return 0 otherwise. */
+UTF8_AVX2_TARGET static int
+utf8_validate_avx2(const char *s, const char *end,
+                   Py_ssize_t *nchars, Py_UCS4 *maxchar)
+{
+    const __m256i byte_1_high_table = UTF8_TABLE(
+        /* 0_______ ________: ASCII lead */
+        UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG,
+        UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG,
+        /* 10______ ________: continuation */
+        UTF8_TWO_CONTS, UTF8_TWO_CONTS, UTF8_TWO_CONTS, UTF8_TWO_CONTS,
+        /* 1100____ ________: 2 byte lead */
+        UTF8_TOO_SHORT | UTF8_OVERLONG_2,
+        /* 1101____ ________: 2 byte lead */
+        UTF8_TOO_SHORT,
+        /* 1110____ ________: 3 byte lead */
+        UTF8_TOO_SHORT | UTF8_OVERLONG_3 | UTF8_SURROGATE,
+        /* 1111____ ________: 4 byte lead */
+        UTF8_TOO_SHORT | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000
+            | UTF8_OVERLONG_4);
+    const __m256i byte_1_low_table = UTF8_TABLE(
+        /* ____0000 ________ */
+        UTF8_CARRY | UTF8_OVERLONG_3 | UTF8_OVERLONG_2 | UTF8_OVERLONG_4,
+        /* ____0001 ________ */
+        UTF8_CARRY | UTF8_OVERLONG_2,
+        /* ____001_ ________ */
+        UTF8_CARRY,
+        UTF8_CARRY,
+        /* ____0100 ________ */
+        UTF8_CARRY | UTF8_TOO_LARGE,
+        /* ____0101-____1100 ________ */
+        UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+        UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+        UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+        UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+        UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+        UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+        UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+        UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+        /* ____1101 ________ */
+        UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000 | UTF8_SURROGATE,
+        /* ____111_ ________ */
+        UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+        UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000);
+    const __m256i byte_2_high_table = UTF8_TABLE(
+        /* ________ 0_______: ASCII */
+        UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT,
+        UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT,
+        /* ________ 1000____ */
+        UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_OVERLONG_3
+            | UTF8_TOO_LARGE_1000 | UTF8_OVERLONG_4,
+        /* ________ 1001____ */
+        UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_OVERLONG_3
+            | UTF8_TOO_LARGE,
+        /* ________ 101_____ */
+        UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_SURROGATE
+            | UTF8_TOO_LARGE,
+        UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_SURROGATE
+            | UTF8_TOO_LARGE,
+        /* ________ 11______: lead */
+        UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT);
+    const __m256i low_nibble = _mm256_set1_epi8(0x0F);
+    __m256i prev = _mm256_setzero_si256();
+    __m256i error = _mm256_setzero_si256();
+    /* the sign bit of each byte is set if a byte >= 0xC4 / 0xF0 was seen */
+    __m256i seen_c4 = _mm256_setzero_si256();
+    __m256i seen_f0 = _mm256_setzero_si256();
+    char tail[32];
+    Py_ssize_t count = 0;
+
+    for (;;) {
+        Py_ssize_t len = Py_MIN(end - s, 32);
+        const char *block = s;
+        if (len < 32) {
+            /* Pad the last block with zeros, which also makes a sequence
+               truncated by the end of the data TOO_SHORT. */
+            memset(tail, 0, sizeof(tail));
+            memcpy(tail, s, len);
+            block = tail;
+        }
+        __m256i input = _mm256_loadu_si256((const __m256i *)block);
+        __m256i shifted = _mm256_permute2x128_si256(prev, input, 0x21);
+        __m256i prev1 = _mm256_alignr_epi8(input, shifted, 15);
+        __m256i prev2 = _mm256_alignr_epi8(input, shifted, 14);
+        __m256i prev3 = _mm256_alignr_epi8(input, shifted, 13);
+        __m256i byte_1_high = _mm256_shuffle_epi8(byte_1_high_table,
+            _mm256_and_si256(_mm256_srli_epi16(prev1, 4), low_nibble));
+        __m256i byte_1_low = _mm256_shuffle_epi8(byte_1_low_table,
+            _mm256_and_si256(prev1, low_nibble));
+        __m256i byte_2_high = _mm256_shuffle_epi8(byte_2_high_table,
+            _mm256_and_si256(_mm256_srli_epi16(input, 4), low_nibble));
+        __m256i special = _mm256_and_si256(
+            _mm256_and_si256(byte_1_high, byte_1_low), byte_2_high);
+        /* the bytes that must be the 2nd or 3rd continuation byte */
+        __m256i must23 = _mm256_or_si256(
+            _mm256_subs_epu8(prev2, _mm256_set1_epi8((char)(0xE0 - 0x80))),
+            _mm256_subs_epu8(prev3, _mm256_set1_epi8((char)(0xF0 - 0x80))));
+        must23 = _mm256_and_si256(must23, _mm256_set1_epi8((char)0x80));
+        error = _mm256_or_si256(error, _mm256_xor_si256(must23, special));
+
+        /* count the bytes that aren't continuation bytes (0x80-0xBF) */
+        uint32_t conts = (uint32_t)_mm256_movemask_epi8(
+            _mm256_cmpgt_epi8(_mm256_set1_epi8(-0x40), input));
+        count += len - _Py_popcount32(conts);
+        seen_c4 = _mm256_or_si256(seen_c4, _mm256_and_si256(input,
+            _mm256_cmpgt_epi8(input, _mm256_set1_epi8((char)(0xC4 - 1)))));
+        seen_f0 = _mm256_or_si256(seen_f0, _mm256_and_si256(input,
+            _mm256_cmpgt_epi8(input, _mm256_set1_epi8((char)(0xF0 - 1)))));
+
+        if (len < 32) {
+            break;
+        }
+        prev = input;
+        s += 32;
+    }
+
+    if (!_mm256_testz_si256(error, error)) {
+        return 0;
+    }
+    *nchars = count;
+    if (_mm256_movemask_epi8(seen_f0)) {
+        *maxchar = MAX_UNICODE;
+    }
+    else if (_mm256_movemask_epi8(seen_c4)) {
+        *maxchar = 0xFFFF;
+    }
+    else {
+        *maxchar = 0xFF;
+    }
+    return 1;
+}
+
+#undef UTF8_TOO_SHORT
+#undef UTF8_TOO_LONG
+#undef UTF8_OVERLONG_3
+#undef UTF8_TOO_LARGE
+#undef UTF8_SURROGATE
+#undef UTF8_OVERLONG_2
+#undef UTF8_TOO_LARGE_1000
+#undef UTF8_OVERLONG_4
+#undef UTF8_TWO_CONTS
+#undef UTF8_CARRY
+#undef UTF8_TABLE
+
+/* Decode the character at *ps, which must be valid UTF-8, and skip it. */
+static inline Py_UCS4
+utf8_decode_valid_char(const char **ps)
+{
+    const unsigned char *s = (const unsigned char *)*ps;
+    Py_UCS4 ch = s[0];
+
+    if (ch < 0x80) {
+        *ps += 1;
+    }
+    else if (ch < 0xE0) {
+        ch = ((ch & 0x1F) << 6) | (s[1] & 0x3F);
+        *ps += 2;
+    }
+    else if (ch < 0xF0) {
+        ch = ((ch & 0x0F) << 12) | ((s[1] & 0x3F) << 6) | (s[2] & 0x3F);
+        *ps += 3;
+    }
+    else {
+        ch = (((ch & 0x07) << 18) | ((s[1] & 0x3F) << 12)
+              | ((s[2] & 0x3F) << 6) | (s[3] & 0x3F));
+        *ps += 4;
+    }
+    return ch;
+}
+#endif  /* x86 with GCC or clang */
+
 #include "stringlib/asciilib.h"
 #include "stringlib/codecs.h"
 #include "stringlib/undef.h"
@@ -4669,6 +4887,80 @@ ascii_decode(const char *start, const char *end, Py_UCS1 *dest)
     return p - start;
 }
 
+#ifdef HAVE_UTF8_AVX2
+/* Decode starts[0:end-starts], whose ASCII prefix up to s was already
+   decoded into the ASCII string u, if it's valid UTF-8.  If consumed is not
+   NULL, an incomplete sequence at the end is left over.  Return Py_None,
+   a borrowed reference, if the data should go through the error handling
+   decoder instead. */
+static PyObject *
+utf8_decode_avx2(const char *starts, const char *s, const char *end,
+                 PyObject *u, Py_ssize_t *consumed)
+{
+    Py_ssize_t prefix = s - starts, nchars;
+    Py_UCS4 maxchar;
+    PyObject *res;
+
+    if (consumed) {
+        /* leave out a trailing incomplete sequence, if it is valid so far */
+        const char *last = end - 1;
+        while (last > s && end - last < 4
+               && ((unsigned char)*last & 0xC0) == 0x80)
+        {
+            last--;
+        }
+        unsigned char lead = (unsigned char)*last;
+        if (end - last < (lead >= 0xF0 ? 4 : lead >= 0xE0 ? 3 :
+                          lead >= 0xC0 ? 2 : 1))
+        {
+            Py_UCS4 tmp[4];
+            Py_ssize_t pos = 0;
+            const char *t = last;
+            if (ucs4lib_utf8_decode(&t, end, tmp, &pos) != 0 || t != last) {
+                return Py_None;
+            }
+            end = last;
+        }
+    }
+    if (!utf8_validate_avx2(s, end, &nchars, &maxchar)) {
+        return Py_None;
+    }
+    res = PyUnicode_New(prefix + nchars, maxchar);
+    if (res == NULL) {
+        return NULL;
+    }
+    switch (PyUnicode_KIND(res)) {
+    case PyUnicode_1BYTE_KIND:
+        memcpy(PyUnicode_1BYTE_DATA(res), PyUnicode_1BYTE_DATA(u), prefix);
+        ucs1lib_utf8_decode_valid_avx2(
+            s, end, PyUnicode_1BYTE_DATA(res) + prefix,
+            PyUnicode_1BYTE_DATA(res) + prefix + nchars);
+        break;
+    case PyUnicode_2BYTE_KIND:
+        _PyUnicode_CONVERT_BYTES(Py_UCS1, Py_UCS2, PyUnicode_1BYTE_DATA(u),
+                                 PyUnicode_1BYTE_DATA(u) + prefix,
+                                 PyUnicode_2BYTE_DATA(res));
+        ucs2lib_utf8_decode_valid_avx2(
+            s, end, PyUnicode_2BYTE_DATA(res) + prefix,
+            PyUnicode_2BYTE_DATA(res) + prefix + nchars);
+        break;
+    default:
+        _PyUnicode_CONVERT_BYTES(Py_UCS1, Py_UCS4, PyUnicode_1BYTE_DATA(u),
+                                 PyUnicode_1BYTE_DATA(u) + prefix,
+                                 PyUnicode_4BYTE_DATA(res));
+        ucs4lib_utf8_decode_valid_avx2(
+            s, end, PyUnicode_4BYTE_DATA(res) + prefix,
+            PyUnicode_4BYTE_DATA(res) + prefix + nchars);
+        break;
+    }
+    if (consumed) {
+        *consumed = end - starts;
+    }
+    assert(_PyUnicode_CheckConsistency(res, 1));
+    return res;
+}
+#endif
+
 static PyObject *
 unicode_decode_utf8(const char *s, Py_ssize_t size,
                     _Py_error_handler error_handler, const char *errors,
@@ -4704,6 +4996,16 @@ unicode_decode_utf8(const char *s, Py_ssize_t size,
         return u;
     }
 
+#ifdef HAVE_UTF8_AVX2
+    if (end - s >= UTF8_AVX2_MIN_SIZE && utf8_avx2_supported()) {
+        PyObject *res = utf8_decode_avx2(starts, s, end, u, consumed);
+        if (res != Py_None) {
+            Py_DECREF(u);
+            return res;
+        }
+    }
+#endif
+
     // Use _PyUnicodeWriter after fast path is failed.
     _PyUnicodeWriter writer;
     _PyUnicodeWriter_InitWithBuffer(&writer, u);
@@ -11,35 +11,30 @@
             break;
         }
 
-        case POP_TOP: {
-            STACK_SHRINK(1);
-            break;
-        }
-
         case PUSH_NULL: {
             STACK_GROW(1);
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-1)), true);
+            stack_pointer[-1] = sym_new_unknown(ctx);
             break;
         }
 
         case END_SEND: {
             STACK_SHRINK(1);
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-1)), true);
+            stack_pointer[-1] = sym_new_unknown(ctx);
             break;
         }
 
         case UNARY_NEGATIVE: {
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-1)), true);
+            stack_pointer[-1] = sym_new_unknown(ctx);
             break;
         }
 
         case UNARY_NOT: {
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-1)), true);
+            stack_pointer[-1] = sym_new_unknown(ctx);
             break;
         }
 
         case TO_BOOL: {
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-1)), true);
+            stack_pointer[-1] = sym_new_unknown(ctx);
             break;
         }
 
@@ -48,80 +43,69 @@
         }
 
         case TO_BOOL_INT: {
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-1)), true);
+            stack_pointer[-1] = sym_new_unknown(ctx);
             break;
         }
 
         case TO_BOOL_LIST: {
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-1)), true);
+            stack_pointer[-1] = sym_new_unknown(ctx);
             break;
         }
 
         case TO_BOOL_NONE: {
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-1)), true);
+            stack_pointer[-1] = sym_new_unknown(ctx);
             break;
         }
 
         case TO_BOOL_STR: {
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-1)), true);
+            stack_pointer[-1] = sym_new_unknown(ctx);
             break;
         }
 
         case TO_BOOL_ALWAYS_TRUE: {
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-1)), true);
+            stack_pointer[-1] = sym_new_unknown(ctx);
             break;
         }
 
         case UNARY_INVERT: {
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-1)), true);
+            stack_pointer[-1] = sym_new_unknown(ctx);
             break;
         }
 
-        case _GUARD_BOTH_INT: {
-            break;
-        }
-
-        case _GUARD_BOTH_FLOAT: {
-            break;
-        }
-
-        case _BINARY_OP_MULTIPLY_FLOAT: {
-            STACK_SHRINK(1);
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-1)), true);
+        case _BINARY_OP_INPLACE_ADD_INT: {
+            STACK_SHRINK(2);
             break;
         }
 
-        case _BINARY_OP_ADD_FLOAT: {
-            STACK_SHRINK(1);
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-1)), true);
+        case _BINARY_OP_INPLACE_SUBTRACT_INT: {
+            STACK_SHRINK(2);
             break;
         }
 
-        case _BINARY_OP_SUBTRACT_FLOAT: {
-            STACK_SHRINK(1);
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-1)), true);
+        case _BINARY_OP_INPLACE_MULTIPLY_FLOAT: {
+            STACK_SHRINK(2);
             break;
         }
 
-        case _GUARD_BOTH_UNICODE: {
+        case _BINARY_OP_INPLACE_ADD_FLOAT: {
+            STACK_SHRINK(2);
             break;
         }
 
-        case _BINARY_OP_ADD_UNICODE: {
-            STACK_SHRINK(1);
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-1)), true);
+        case _BINARY_OP_INPLACE_SUBTRACT_FLOAT: {
+            STACK_SHRINK(2);
             break;
         }
 
         case BINARY_SUBSCR: {
             STACK_SHRINK(1);
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-1)), true);
+            stack_pointer[-1] = sym_new_unknown(ctx);
             break;
         }
 
         case BINARY_SLICE: {
             STACK_SHRINK(2);
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-1)), true);
+            stack_pointer[-1] = sym_new_unknown(ctx);
             break;
         }
 
@@ -132,25 +116,25 @@
 
         case BINARY_SUBSCR_LIST_INT: {
             STACK_SHRINK(1);
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-1)), true);
+            stack_pointer[-1] = sym_new_unknown(ctx);
             break;
         }
 
         case BINARY_SUBSCR_STR_INT: {
             STACK_SHRINK(1);
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-1)), true);
+            stack_pointer[-1] = sym_new_unknown(ctx);
             break;
         }
 
         case BINARY_SUBSCR_TUPLE_INT: {
             STACK_SHRINK(1);
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-1)), true);
+            stack_pointer[-1] = sym_new_unknown(ctx);
             break;
         }
 
         case BINARY_SUBSCR_DICT: {
             STACK_SHRINK(1);
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-1)), true);
+            stack_pointer[-1] = sym_new_unknown(ctx);
             break;
         }
 
@@ -185,34 +169,29 @@
         }
 
         case CALL_INTRINSIC_1: {
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-1)), true);
+            stack_pointer[-1] = sym_new_unknown(ctx);
             break;
         }
 
         case CALL_INTRINSIC_2: {
             STACK_SHRINK(1);
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-1)), true);
-            break;
-        }
-
-        case _POP_FRAME: {
-            STACK_SHRINK(1);
+            stack_pointer[-1] = sym_new_unknown(ctx);
             break;
         }
 
         case GET_AITER: {
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-1)), true);
+            stack_pointer[-1] = sym_new_unknown(ctx);
             break;
         }
 
         case GET_ANEXT: {
             STACK_GROW(1);
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-1)), true);
+            stack_pointer[-1] = sym_new_unknown(ctx);
             break;
         }
 
         case GET_AWAITABLE: {
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-1)), true);
+            stack_pointer[-1] = sym_new_unknown(ctx);
             break;
         }
 
@@ -223,13 +202,13 @@
 
         case LOAD_ASSERTION_ERROR: {
             STACK_GROW(1);
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-1)), true);
+            stack_pointer[-1] = sym_new_unknown(ctx);
             break;
         }
 
         case LOAD_BUILD_CLASS: {
             STACK_GROW(1);
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-1)), true);
+            stack_pointer[-1] = sym_new_unknown(ctx);
             break;
         }
 
@@ -245,30 +224,48 @@
         case UNPACK_SEQUENCE: {
             STACK_SHRINK(1);
             STACK_GROW(oparg);
+            for (int _i = oparg; --_i >= 0;) {
+                (stack_pointer - oparg)[_i] = sym_new_unknown(ctx);
+            }
             break;
         }
 
         case UNPACK_SEQUENCE_TWO_TUPLE: {
             STACK_SHRINK(1);
             STACK_GROW(oparg);
+            for (int _i = oparg; --_i >= 0;) {
+                (stack_pointer - oparg)[_i] = sym_new_unknown(ctx);
+            }
             break;
         }
 
         case UNPACK_SEQUENCE_TUPLE: {
             STACK_SHRINK(1);
             STACK_GROW(oparg);
+            for (int _i = oparg; --_i >= 0;) {
+                (stack_pointer - oparg)[_i] = sym_new_unknown(ctx);
+            }
             break;
         }
 
         case UNPACK_SEQUENCE_LIST: {
             STACK_SHRINK(1);
             STACK_GROW(oparg);
+            for (int _i = oparg; --_i >= 0;) {
+                (stack_pointer - oparg)[_i] = sym_new_unknown(ctx);
+            }
             break;
         }
 
         case UNPACK_EX: {
             STACK_GROW((oparg & 0xFF) + (oparg >> 8));
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-1 - (oparg >> 8))), true);
+            for (int _i = oparg & 0xFF; --_i >= 0;) {
+                (stack_pointer - 1 - (oparg & 0xFF) - (oparg >> 8))[_i] = sym_new_unknown(ctx);
+            }
+            stack_pointer[-1 - (oparg >> 8)] = sym_new_unknown(ctx);
+            for (int _i = oparg >> 8; --_i >= 0;) {
+                (stack_pointer - (oparg >> 8))[_i] = sym_new_unknown(ctx);
+            }
             break;
         }
 
@@ -293,26 +290,26 @@
 
         case LOAD_LOCALS: {
             STACK_GROW(1);
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-1)), true);
+            stack_pointer[-1] = sym_new_unknown(ctx);
             break;
         }
 
         case LOAD_FROM_DICT_OR_GLOBALS: {
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-1)), true);
+            stack_pointer[-1] = sym_new_unknown(ctx);
             break;
         }
 
         case LOAD_NAME: {
             STACK_GROW(1);
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-1)), true);
+            stack_pointer[-1] = sym_new_unknown(ctx);
             break;
         }
 
         case LOAD_GLOBAL: {
             STACK_GROW(1);
             STACK_GROW(((oparg & 1) ? 1 : 0));
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-1 - (oparg & 1 ? 1 : 0))), true);
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-(oparg & 1 ? 1 : 0))), true);
+            stack_pointer[-1 - (oparg & 1 ? 1 : 0)] = sym_new_unknown(ctx);
+            if (oparg & 1) { stack_pointer[-(oparg & 1 ? 1 : 0)] = sym_new_unknown(ctx); }
             break;
         }
 
@@ -327,20 +324,16 @@
         case _LOAD_GLOBAL_MODULE: {
             STACK_GROW(1);
             STACK_GROW(((oparg & 1) ? 1 : 0));
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-1 - (oparg & 1 ? 1 : 0))), true);
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-(oparg & 1 ? 1 : 0))), true);
+            stack_pointer[-1 - (oparg & 1 ? 1 : 0)] = sym_new_unknown(ctx);
+            if (oparg & 1) { stack_pointer[-(oparg & 1 ? 1 : 0)] = sym_new_unknown(ctx); }
             break;
         }
 
         case _LOAD_GLOBAL_BUILTINS: {
             STACK_GROW(1);
             STACK_GROW(((oparg & 1) ? 1 : 0));
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-1 - (oparg & 1 ? 1 : 0))), true);
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-(oparg & 1 ? 1 : 0))), true);
-            break;
-        }
-
-        case DELETE_FAST: {
+            stack_pointer[-1 - (oparg & 1 ? 1 : 0)] = sym_new_unknown(ctx);
+            if (oparg & 1) { stack_pointer[-(oparg & 1 ? 1 : 0)] = sym_new_unknown(ctx); }
             break;
         }
 
@@ -349,13 +342,13 @@
         }
 
         case LOAD_FROM_DICT_OR_DEREF: {
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-1)), true);
+            stack_pointer[-1] = sym_new_unknown(ctx);
             break;
         }
 
         case LOAD_DEREF: {
             STACK_GROW(1);
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-1)), true);
+            stack_pointer[-1] = sym_new_unknown(ctx);
             break;
         }
 
@@ -371,21 +364,21 @@
         case BUILD_STRING: {
             STACK_SHRINK(oparg);
             STACK_GROW(1);
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-1)), true);
+            stack_pointer[-1] = sym_new_unknown(ctx);
             break;
         }
 
         case BUILD_TUPLE: {
             STACK_SHRINK(oparg);
             STACK_GROW(1);
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-1)), true);
+            stack_pointer[-1] = sym_new_unknown(ctx);
             break;
         }
 
         case BUILD_LIST: {
             STACK_SHRINK(oparg);
             STACK_GROW(1);
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-1)), true);
+            stack_pointer[-1] = sym_new_unknown(ctx);
             break;
         }
 
@@ -402,14 +395,14 @@
         case BUILD_SET: {
             STACK_SHRINK(oparg);
             STACK_GROW(1);
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-1)), true);
+            stack_pointer[-1] = sym_new_unknown(ctx);
             break;
         }
 
         case BUILD_MAP: {
             STACK_SHRINK(oparg*2);
             STACK_GROW(1);
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-1)), true);
+            stack_pointer[-1] = sym_new_unknown(ctx);
             break;
         }
 
@@ -419,7 +412,7 @@
 
         case BUILD_CONST_KEY_MAP: {
             STACK_SHRINK(oparg);
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-1)), true);
+            stack_pointer[-1] = sym_new_unknown(ctx);
             break;
         }
 
@@ -440,37 +433,21 @@
 
         case LOAD_SUPER_ATTR_ATTR: {
             STACK_SHRINK(2);
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-1)), true);
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(0)), true);
+            stack_pointer[-1] = sym_new_unknown(ctx);
             break;
         }
 
         case LOAD_SUPER_ATTR_METHOD: {
             STACK_SHRINK(1);
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-2)), true);
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-1)), true);
+            stack_pointer[-2] = sym_new_unknown(ctx);
+            stack_pointer[-1] = sym_new_unknown(ctx);
             break;
         }
 
         case LOAD_ATTR: {
             STACK_GROW(((oparg & 1) ? 1 : 0));
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-1 - (oparg & 1 ? 1 : 0))), true);
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-(oparg & 1 ? 1 : 0))), true);
-            break;
-        }
-
-        case _GUARD_TYPE_VERSION: {
-            break;
-        }
-
-        case _CHECK_MANAGED_OBJECT_HAS_VALUES: {
-            break;
-        }
-
-        case _LOAD_ATTR_INSTANCE_VALUE: {
-            STACK_GROW(((oparg & 1) ? 1 : 0));
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-1 - (oparg & 1 ? 1 : 0))), true);
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-(oparg & 1 ? 1 : 0))), true);
+            stack_pointer[-1 - (oparg & 1 ? 1 : 0)] = sym_new_unknown(ctx);
+            if (oparg & 1) { stack_pointer[-(oparg & 1 ? 1 : 0)] = sym_new_unknown(ctx); }
             break;
         }
 
@@ -480,8 +457,8 @@
 
         case _LOAD_ATTR_MODULE: {
             STACK_GROW(((oparg & 1) ? 1 : 0));
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-1 - (oparg & 1 ? 1 : 0))), true);
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-(oparg & 1 ? 1 : 0))), true);
+            stack_pointer[-1 - (oparg & 1 ? 1 : 0)] = sym_new_unknown(ctx);
+            if (oparg & 1) { stack_pointer[-(oparg & 1 ? 1 : 0)] = sym_new_unknown(ctx); }
             break;
         }
 
@@ -491,15 +468,15 @@
 
         case _LOAD_ATTR_WITH_HINT: {
             STACK_GROW(((oparg & 1) ? 1 : 0));
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-1 - (oparg & 1 ? 1 : 0))), true);
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-(oparg & 1 ? 1 : 0))), true);
+            stack_pointer[-1 - (oparg & 1 ? 1 : 0)] = sym_new_unknown(ctx);
+            if (oparg & 1) { stack_pointer[-(oparg & 1 ? 1 : 0)] = sym_new_unknown(ctx); }
             break;
         }
 
         case _LOAD_ATTR_SLOT: {
             STACK_GROW(((oparg & 1) ? 1 : 0));
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-1 - (oparg & 1 ? 1 : 0))), true);
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-(oparg & 1 ? 1 : 0))), true);
+            stack_pointer[-1 - (oparg & 1 ? 1 : 0)] = sym_new_unknown(ctx);
+            if (oparg & 1) { stack_pointer[-(oparg & 1 ? 1 : 0)] = sym_new_unknown(ctx); }
             break;
         }
 
@@ -509,8 +486,8 @@
 
         case _LOAD_ATTR_CLASS: {
             STACK_GROW(((oparg & 1) ? 1 : 0));
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-1 - (oparg & 1 ? 1 : 0))), true);
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-(oparg & 1 ? 1 : 0))), true);
+            stack_pointer[-1 - (oparg & 1 ? 1 : 0)] = sym_new_unknown(ctx);
+            if (oparg & 1) { stack_pointer[-(oparg & 1 ? 1 : 0)] = sym_new_unknown(ctx); }
             break;
         }
 
@@ -530,93 +507,123 @@
 
         case COMPARE_OP: {
             STACK_SHRINK(1);
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-1)), true);
+            stack_pointer[-1] = sym_new_unknown(ctx);
             break;
         }
 
         case COMPARE_OP_FLOAT: {
             STACK_SHRINK(1);
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-1)), true);
+            stack_pointer[-1] = sym_new_unknown(ctx);
             break;
         }
 
         case COMPARE_OP_INT: {
             STACK_SHRINK(1);
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-1)), true);
+            stack_pointer[-1] = sym_new_unknown(ctx);
             break;
         }
 
         case COMPARE_OP_STR: {
             STACK_SHRINK(1);
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-1)), true);
+            stack_pointer[-1] = sym_new_unknown(ctx);
             break;
         }
 
         case IS_OP: {
             STACK_SHRINK(1);
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-1)), true);
+            stack_pointer[-1] = sym_new_unknown(ctx);
             break;
         }
 
         case CONTAINS_OP: {
             STACK_SHRINK(1);
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-1)), true);
+            stack_pointer[-1] = sym_new_unknown(ctx);
+            break;
+        }
+
+        case CONTAINS_OP_DICT: {
+            STACK_SHRINK(1);
+            stack_pointer[-1] = sym_new_unknown(ctx);
+            break;
+        }
+
+        case CONTAINS_OP_SET: {
+            STACK_SHRINK(1);
+            stack_pointer[-1] = sym_new_unknown(ctx);
+            break;
+        }
+
+        case CONTAINS_OP_STR: {
+            STACK_SHRINK(1);
+            stack_pointer[-1] = sym_new_unknown(ctx);
+            break;
+        }
+
+        case CONTAINS_OP_TUPLE: {
+            STACK_SHRINK(1);
+            stack_pointer[-1] = sym_new_unknown(ctx);
+            break;
+        }
+
+        case CONTAINS_OP_LIST: {
+            STACK_SHRINK(1);
+            stack_pointer[-1] = sym_new_unknown(ctx);
             break;
         }
 
         case CHECK_EG_MATCH: {
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-2)), true);
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-1)), true);
+            stack_pointer[-2] = sym_new_unknown(ctx);
+            stack_pointer[-1] = sym_new_unknown(ctx);
             break;
         }
 
         case CHECK_EXC_MATCH: {
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-1)), true);
+            stack_pointer[-1] = sym_new_unknown(ctx);
             break;
         }
 
         case _IS_NONE: {
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-1)), true);
+            stack_pointer[-1] = sym_new_unknown(ctx);
             break;
         }
 
         case GET_LEN: {
             STACK_GROW(1);
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-1)), true);
+            stack_pointer[-1] = sym_new_unknown(ctx);
             break;
         }
 
         case MATCH_CLASS: {
             STACK_SHRINK(2);
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-1)), true);
+            stack_pointer[-1] = sym_new_unknown(ctx);
             break;
         }
 
         case MATCH_MAPPING: {
             STACK_GROW(1);
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-1)), true);
+            stack_pointer[-1] = sym_new_unknown(ctx);
             break;
         }
 
         case MATCH_SEQUENCE: {
             STACK_GROW(1);
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-1)), true);
+            stack_pointer[-1] = sym_new_unknown(ctx);
             break;
         }
 
         case MATCH_KEYS: {
             STACK_GROW(1);
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-1)), true);
+            stack_pointer[-1] = sym_new_unknown(ctx);
             break;
         }
 
         case GET_ITER: {
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-1)), true);
+            stack_pointer[-1] = sym_new_unknown(ctx);
             break;
         }
 
         case GET_YIELD_FROM_ITER: {
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-1)), true);
+            stack_pointer[-1] = sym_new_unknown(ctx);
             break;
         }
 
@@ -626,13 +633,13 @@
 
         case _IS_ITER_EXHAUSTED_LIST: {
             STACK_GROW(1);
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-1)), true);
+            stack_pointer[-1] = sym_new_unknown(ctx);
             break;
         }
 
         case _ITER_NEXT_LIST: {
             STACK_GROW(1);
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-1)), true);
+            stack_pointer[-1] = sym_new_unknown(ctx);
             break;
         }
 
@@ -642,13 +649,13 @@
 
         case _IS_ITER_EXHAUSTED_TUPLE: {
             STACK_GROW(1);
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-1)), true);
+            stack_pointer[-1] = sym_new_unknown(ctx);
             break;
         }
 
         case _ITER_NEXT_TUPLE: {
             STACK_GROW(1);
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-1)), true);
+            stack_pointer[-1] = sym_new_unknown(ctx);
             break;
         }
 
@@ -658,26 +665,20 @@
 
         case _IS_ITER_EXHAUSTED_RANGE: {
             STACK_GROW(1);
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-1)), true);
-            break;
-        }
-
-        case _ITER_NEXT_RANGE: {
-            STACK_GROW(1);
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-1)), true);
+            stack_pointer[-1] = sym_new_unknown(ctx);
             break;
         }
 
         case WITH_EXCEPT_START: {
             STACK_GROW(1);
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-1)), true);
+            stack_pointer[-1] = sym_new_unknown(ctx);
             break;
         }
 
         case PUSH_EXC_INFO: {
             STACK_GROW(1);
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-2)), true);
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-1)), true);
+            stack_pointer[-2] = sym_new_unknown(ctx);
+            stack_pointer[-1] = sym_new_unknown(ctx);
             break;
         }
 
@@ -691,27 +692,25 @@
 
         case _LOAD_ATTR_METHOD_WITH_VALUES: {
             STACK_GROW(1);
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-2)), true);
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-1)), true);
+            stack_pointer[-2] = sym_new_unknown(ctx);
+            stack_pointer[-1] = sym_new_unknown(ctx);
             break;
         }
 
         case _LOAD_ATTR_METHOD_NO_DICT: {
             STACK_GROW(1);
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-2)), true);
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-1)), true);
+            stack_pointer[-2] = sym_new_unknown(ctx);
+            stack_pointer[-1] = sym_new_unknown(ctx);
             break;
         }
 
         case _LOAD_ATTR_NONDESCRIPTOR_WITH_VALUES: {
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-1)), true);
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(0)), true);
+            stack_pointer[-1] = sym_new_unknown(ctx);
             break;
         }
 
         case _LOAD_ATTR_NONDESCRIPTOR_NO_DICT: {
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-1)), true);
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(0)), true);
+            stack_pointer[-1] = sym_new_unknown(ctx);
             break;
         }
 
@@ -721,8 +720,8 @@
 
         case _LOAD_ATTR_METHOD_LAZY_DICT: {
             STACK_GROW(1);
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-2)), true);
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-1)), true);
+            stack_pointer[-2] = sym_new_unknown(ctx);
+            stack_pointer[-1] = sym_new_unknown(ctx);
             break;
         }
 
@@ -731,8 +730,11 @@
         }
 
         case _INIT_CALL_BOUND_METHOD_EXACT_ARGS: {
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-2 - oparg)), true);
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-1 - oparg)), true);
+            stack_pointer[-2 - oparg] = sym_new_unknown(ctx);
+            stack_pointer[-1 - oparg] = sym_new_unknown(ctx);
+            for (int _i = oparg; --_i >= 0;) {
+                (stack_pointer - oparg)[_i] = sym_new_unknown(ctx);
+            }
             break;
         }
 
@@ -751,33 +753,28 @@
         case _INIT_CALL_PY_EXACT_ARGS: {
             STACK_SHRINK(oparg);
             STACK_SHRINK(1);
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-1)), true);
-            break;
-        }
-
-        case _PUSH_FRAME: {
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-1)), true);
+            stack_pointer[-1] = sym_new_unknown(ctx);
             break;
         }
 
         case CALL_TYPE_1: {
             STACK_SHRINK(oparg);
             STACK_SHRINK(1);
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-1)), true);
+            stack_pointer[-1] = sym_new_unknown(ctx);
             break;
         }
 
         case CALL_STR_1: {
             STACK_SHRINK(oparg);
             STACK_SHRINK(1);
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-1)), true);
+            stack_pointer[-1] = sym_new_unknown(ctx);
             break;
         }
 
         case CALL_TUPLE_1: {
             STACK_SHRINK(oparg);
             STACK_SHRINK(1);
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-1)), true);
+            stack_pointer[-1] = sym_new_unknown(ctx);
             break;
         }
 
@@ -789,116 +786,110 @@
         case CALL_BUILTIN_CLASS: {
             STACK_SHRINK(oparg);
             STACK_SHRINK(1);
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-1)), true);
+            stack_pointer[-1] = sym_new_unknown(ctx);
             break;
         }
 
         case CALL_BUILTIN_O: {
             STACK_SHRINK(oparg);
             STACK_SHRINK(1);
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-1)), true);
+            stack_pointer[-1] = sym_new_unknown(ctx);
             break;
         }
 
         case CALL_BUILTIN_FAST: {
             STACK_SHRINK(oparg);
             STACK_SHRINK(1);
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-1)), true);
+            stack_pointer[-1] = sym_new_unknown(ctx);
             break;
         }
 
         case CALL_BUILTIN_FAST_WITH_KEYWORDS: {
             STACK_SHRINK(oparg);
             STACK_SHRINK(1);
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-1)), true);
+            stack_pointer[-1] = sym_new_unknown(ctx);
             break;
         }
 
         case CALL_LEN: {
             STACK_SHRINK(oparg);
             STACK_SHRINK(1);
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-1)), true);
+            stack_pointer[-1] = sym_new_unknown(ctx);
             break;
         }
 
         case CALL_ISINSTANCE: {
             STACK_SHRINK(oparg);
             STACK_SHRINK(1);
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-1)), true);
+            stack_pointer[-1] = sym_new_unknown(ctx);
             break;
         }
 
         case CALL_METHOD_DESCRIPTOR_O: {
             STACK_SHRINK(oparg);
             STACK_SHRINK(1);
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-1)), true);
+            stack_pointer[-1] = sym_new_unknown(ctx);
             break;
         }
 
         case CALL_METHOD_DESCRIPTOR_FAST_WITH_KEYWORDS: {
             STACK_SHRINK(oparg);
             STACK_SHRINK(1);
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-1)), true);
+            stack_pointer[-1] = sym_new_unknown(ctx);
             break;
         }
 
         case CALL_METHOD_DESCRIPTOR_NOARGS: {
             STACK_SHRINK(oparg);
             STACK_SHRINK(1);
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-1)), true);
+            stack_pointer[-1] = sym_new_unknown(ctx);
             break;
         }
 
         case CALL_METHOD_DESCRIPTOR_FAST: {
             STACK_SHRINK(oparg);
             STACK_SHRINK(1);
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-1)), true);
+            stack_pointer[-1] = sym_new_unknown(ctx);
             break;
         }
 
         case MAKE_FUNCTION: {
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-1)), true);
+            stack_pointer[-1] = sym_new_unknown(ctx);
             break;
         }
 
         case SET_FUNCTION_ATTRIBUTE: {
             STACK_SHRINK(1);
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-1)), true);
+            stack_pointer[-1] = sym_new_unknown(ctx);
             break;
         }
 
         case BUILD_SLICE: {
             STACK_SHRINK(((oparg == 3) ? 1 : 0));
             STACK_SHRINK(1);
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-1)), true);
+            stack_pointer[-1] = sym_new_unknown(ctx);
             break;
         }
 
         case CONVERT_VALUE: {
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-1)), true);
+            stack_pointer[-1] = sym_new_unknown(ctx);
             break;
         }
 
         case FORMAT_SIMPLE: {
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-1)), true);
+            stack_pointer[-1] = sym_new_unknown(ctx);
             break;
         }
 
         case FORMAT_WITH_SPEC: {
             STACK_SHRINK(1);
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-1)), true);
+            stack_pointer[-1] = sym_new_unknown(ctx);
             break;
         }
 
         case BINARY_OP: {
             STACK_SHRINK(1);
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-1)), true);
-            break;
-        }
-
-        case SWAP: {
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-2 - (oparg-2))), true);
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-1)), true);
+            stack_pointer[-1] = sym_new_unknown(ctx);
             break;
         }
 
@@ -929,6 +920,9 @@
         }
 
         case _INSERT: {
-            PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)PARTITIONNODE_NULLROOT, PEEK(-(-1 - oparg)), true);
+            stack_pointer[-1 - oparg] = sym_new_unknown(ctx);
+            for (int _i = oparg; --_i >= 0;) {
+                (stack_pointer - oparg)[_i] = sym_new_unknown(ctx);
+            }
             break;
         }
@@ -402,6 +402,14 @@ dummy_func(
             DEOPT_IF(!PyLong_CheckExact(right));
         }
 
+        op(_GUARD_NOS_INT, (left, unused -- left, unused)) {
+            DEOPT_IF(!PyLong_CheckExact(left));
+        }
+
+        op(_GUARD_TOS_INT, (value -- value)) {
+            DEOPT_IF(!PyLong_CheckExact(value));
+        }
+
         op(_BINARY_OP_MULTIPLY_INT, (unused/1, left, right -- res)) {
             STAT_INC(BINARY_OP, hit);
             res = _PyLong_Multiply((PyLongObject *)left, (PyLongObject *)right);
@@ -433,11 +441,66 @@ dummy_func(
         macro(BINARY_OP_SUBTRACT_INT) =
             _GUARD_BOTH_INT + _BINARY_OP_SUBTRACT_INT;
 
+        // Like _BINARY_OP_INPLACE_ADD_FLOAT, for compact ints.
+        op(_BINARY_OP_INPLACE_ADD_INT, (unused/1, left, right --)) {
+            TIER_TWO_ONLY
+            STAT_INC(BINARY_OP, hit);
+            PyLongObject *lhs = (PyLongObject *)left;
+            PyLongObject *rhs = (PyLongObject *)right;
+            if (GETLOCAL(oparg) == left && Py_REFCNT(left) == 2 &&
+                _PyLong_BothAreCompact(lhs, rhs) &&
+                _PyLong_SetCompactValueInPlace(lhs,
+                    (stwodigits)_PyLong_CompactValue(lhs) +
+                    (stwodigits)_PyLong_CompactValue(rhs)))
+            {
+                _Py_DECREF_NO_DEALLOC(left);
+                _Py_DECREF_SPECIALIZED(right, (destructor)PyObject_Free);
+            }
+            else {
+                PyObject *res = _PyLong_Add(lhs, rhs);
+                _Py_DECREF_SPECIALIZED(right, (destructor)PyObject_Free);
+                _Py_DECREF_SPECIALIZED(left, (destructor)PyObject_Free);
+                ERROR_IF(res == NULL, error);
+                SETLOCAL(oparg, res);
+            }
+        }
+
+        op(_BINARY_OP_INPLACE_SUBTRACT_INT, (unused/1, left, right --)) {
+            TIER_TWO_ONLY
+            STAT_INC(BINARY_OP, hit);
+            PyLongObject *lhs = (PyLongObject *)left;
+            PyLongObject *rhs = (PyLongObject *)right;
+            if (GETLOCAL(oparg) == left && Py_REFCNT(left) == 2 &&
+                _PyLong_BothAreCompact(lhs, rhs) &&
+                _PyLong_SetCompactValueInPlace(lhs,
+                    (stwodigits)_PyLong_CompactValue(lhs) -
+                    (stwodigits)_PyLong_CompactValue(rhs)))
+            {
+                _Py_DECREF_NO_DEALLOC(left);
+                _Py_DECREF_SPECIALIZED(right, (destructor)PyObject_Free);
+            }
+            else {
+                PyObject *res = _PyLong_Subtract(lhs, rhs);
+                _Py_DECREF_SPECIALIZED(right, (destructor)PyObject_Free);
+                _Py_DECREF_SPECIALIZED(left, (destructor)PyObject_Free);
+                ERROR_IF(res == NULL, error);
+                SETLOCAL(oparg, res);
+            }
+        }
+
         op(_GUARD_BOTH_FLOAT, (left, right -- left, right)) {
             DEOPT_IF(!PyFloat_CheckExact(left));
             DEOPT_IF(!PyFloat_CheckExact(right));
         }
 
+        op(_GUARD_NOS_FLOAT, (left, unused -- left, unused)) {
+            DEOPT_IF(!PyFloat_CheckExact(left));
+        }
+
+        op(_GUARD_TOS_FLOAT, (value -- value)) {
+            DEOPT_IF(!PyFloat_CheckExact(value));
+        }
+
         op(_BINARY_OP_MULTIPLY_FLOAT, (unused/1, left, right -- res)) {
             STAT_INC(BINARY_OP, hit);
             double dres =
@@ -469,6 +532,36 @@ dummy_func(
         macro(BINARY_OP_SUBTRACT_FLOAT) =
             _GUARD_BOTH_FLOAT + _BINARY_OP_SUBTRACT_FLOAT;
 
+        // The optimizer replaces `BINARY_OP_*_FLOAT; STORE_FAST` with these
+        // when the local being stored to holds `left`, as in `total += x`.
+        // The accumulator is then updated in place rather than reboxed.
+        op(_BINARY_OP_INPLACE_MULTIPLY_FLOAT, (unused/1, left, right --)) {
+            TIER_TWO_ONLY
+            STAT_INC(BINARY_OP, hit);
+            double dres =
+                ((PyFloatObject *)left)->ob_fval *
+                ((PyFloatObject *)right)->ob_fval;
+            STORE_LOCAL_AND_REUSE_FLOAT(oparg, left, right, dres);
+        }
+
+        op(_BINARY_OP_INPLACE_ADD_FLOAT, (unused/1, left, right --)) {
+            TIER_TWO_ONLY
+            STAT_INC(BINARY_OP, hit);
+            double dres =
+                ((PyFloatObject *)left)->ob_fval +
+                ((PyFloatObject *)right)->ob_fval;
+            STORE_LOCAL_AND_REUSE_FLOAT(oparg, left, right, dres);
+        }
+
+        op(_BINARY_OP_INPLACE_SUBTRACT_FLOAT, (unused/1, left, right --)) {
+            TIER_TWO_ONLY
+            STAT_INC(BINARY_OP, hit);
+            double dres =
+                ((PyFloatObject *)left)->ob_fval -
+                ((PyFloatObject *)right)->ob_fval;
+            STORE_LOCAL_AND_REUSE_FLOAT(oparg, left, right, dres);
+        }
+
         op(_GUARD_BOTH_UNICODE, (left, right -- left, right)) {
             DEOPT_IF(!PyUnicode_CheckExact(left));
             DEOPT_IF(!PyUnicode_CheckExact(right));
@@ -2218,13 +2311,78 @@ dummy_func(
             b = res ? Py_True : Py_False;
         }
 
-        inst(CONTAINS_OP, (left, right -- b)) {
+        family(CONTAINS_OP, INLINE_CACHE_ENTRIES_CONTAINS_OP) = {
+            CONTAINS_OP_DICT,
+            CONTAINS_OP_SET,
+            CONTAINS_OP_STR,
+            CONTAINS_OP_TUPLE,
+            CONTAINS_OP_LIST,
+        };
+
+        inst(CONTAINS_OP, (unused/1, left, right -- b)) {
+            #if ENABLE_SPECIALIZATION
+            _PyContainsOpCache *cache = (_PyContainsOpCache *)next_instr;
+            if (ADAPTIVE_COUNTER_IS_ZERO(cache->counter)) {
+                next_instr--;
+                _Py_Specialize_ContainsOp(left, right, next_instr);
+                DISPATCH_SAME_OPARG();
+            }
+            STAT_INC(CONTAINS_OP, deferred);
+            DECREMENT_ADAPTIVE_COUNTER(cache->counter);
+            #endif  /* ENABLE_SPECIALIZATION */
             int res = PySequence_Contains(right, left);
             DECREF_INPUTS();
             ERROR_IF(res < 0, error);
             b = (res ^ oparg) ? Py_True : Py_False;
         }
 
+        inst(CONTAINS_OP_DICT, (unused/1, left, right -- b)) {
+            DEOPT_IF(!PyDict_CheckExact(right));
+            STAT_INC(CONTAINS_OP, hit);
+            int res = PyDict_Contains(right, left);
+            DECREF_INPUTS();
+            ERROR_IF(res < 0, error);
+            b = (res ^ oparg) ? Py_True : Py_False;
+        }
+
+        inst(CONTAINS_OP_SET, (unused/1, left, right -- b)) {
+            DEOPT_IF(!(PySet_CheckExact(right) || PyFrozenSet_CheckExact(right)));
+            STAT_INC(CONTAINS_OP, hit);
+            // Note: both set and frozenset use the same seq_contains method!
+            int res = _PySet_Contains((PySetObject *)right, left);
+            DECREF_INPUTS();
+            ERROR_IF(res < 0, error);
+            b = (res ^ oparg) ? Py_True : Py_False;
+        }
+
+        inst(CONTAINS_OP_STR, (unused/1, left, right -- b)) {
+            DEOPT_IF(!PyUnicode_CheckExact(left));
+            DEOPT_IF(!PyUnicode_CheckExact(right));
+            STAT_INC(CONTAINS_OP, hit);
+            int res = PyUnicode_Contains(right, left);
+            DECREF_INPUTS();
+            ERROR_IF(res < 0, error);
+            b = (res ^ oparg) ? Py_True : Py_False;
+        }
+
+        inst(CONTAINS_OP_TUPLE, (unused/1, left, right -- b)) {
+            DEOPT_IF(!PyTuple_CheckExact(right));
+            STAT_INC(CONTAINS_OP, hit);
+            int res = _PyTuple_Contains((PyTupleObject *)right, left);
+            DECREF_INPUTS();
+            ERROR_IF(res < 0, error);
+            b = (res ^ oparg) ? Py_True : Py_False;
+        }
+
+        inst(CONTAINS_OP_LIST, (unused/1, left, right -- b)) {
+            DEOPT_IF(!PyList_CheckExact(right));
+            STAT_INC(CONTAINS_OP, hit);
+            int res = _PyList_Contains((PyListObject *)right, left);
+            DECREF_INPUTS();
+            ERROR_IF(res < 0, error);
+            b = (res ^ oparg) ? Py_True : Py_False;
+        }
+
         inst(CHECK_EG_MATCH, (exc_value, match_type -- rest, match)) {
             if (_PyEval_CheckExceptStarTypeValid(tstate, match_type) < 0) {
                 DECREF_INPUTS();
@@ -3560,16 +3718,33 @@ dummy_func(
                     tstate, PY_MONITORING_EVENT_CALL,
                     frame, next_instr - 1, function, arg);
             ERROR_IF(err, error);
+            _PyCallCache *cache = (_PyCallCache *)next_instr;
+            INCREMENT_ADAPTIVE_COUNTER(cache->counter);
             GO_TO_INSTRUCTION(CALL_KW);
         }
 
-        inst(CALL_KW, (callable, self_or_null, args[oparg], kwnames -- res)) {
+        // Cache layout: counter/1, func_version/2
+        family(CALL_KW, INLINE_CACHE_ENTRIES_CALL_KW) = {
+            CALL_KW_PY_EXACT_ARGS,
+        };
+
+        inst(CALL_KW, (unused/1, unused/2, callable, self_or_null, args[oparg], kwnames -- res)) {
             // oparg counts all of the args, but *not* self:
             int total_args = oparg;
             if (self_or_null != NULL) {
                 args--;
                 total_args++;
             }
+            #if ENABLE_SPECIALIZATION
+            _PyCallCache *cache = (_PyCallCache *)next_instr;
+            if (ADAPTIVE_COUNTER_IS_ZERO(cache->counter)) {
+                next_instr--;
+                _Py_Specialize_CallKw(callable, next_instr, total_args, kwnames);
+                DISPATCH_SAME_OPARG();
+            }
+            STAT_INC(CALL_KW, deferred);
+            DECREMENT_ADAPTIVE_COUNTER(cache->counter);
+            #endif  /* ENABLE_SPECIALIZATION */
             if (self_or_null == NULL && Py_TYPE(callable) == &PyMethod_Type) {
                 args--;
                 total_args++;
@@ -3600,8 +3775,9 @@ dummy_func(
                 if (new_frame == NULL) {
                     goto error;
                 }
-                assert(next_instr - frame->instr_ptr == 1);
-                frame->return_offset = 1;
+                SKIP_OVER(INLINE_CACHE_ENTRIES_CALL_KW);
+                assert(1 + INLINE_CACHE_ENTRIES_CALL_KW == next_instr - frame->instr_ptr);
+                frame->return_offset = 1 + INLINE_CACHE_ENTRIES_CALL_KW;
                 DISPATCH_INLINED(new_frame);
             }
             /* Callable is not a normal Python function */
@@ -3636,14 +3812,68 @@ dummy_func(
             CHECK_EVAL_BREAKER();
         }
 
+        // Python function called with keyword arguments that name its
+        // remaining parameters in order, so that all arguments can be
+        // copied to the new frame without matching names.
+        inst(CALL_KW_PY_EXACT_ARGS, (unused/1, func_version/2, callable, self_or_null, args[oparg], kwnames -- unused)) {
+            DEOPT_IF(tstate->interp->eval_frame);
+            int argcount = oparg;
+            if (self_or_null != NULL) {
+                args--;
+                argcount++;
+            }
+            DEOPT_IF(!PyFunction_Check(callable));
+            PyFunctionObject *func = (PyFunctionObject *)callable;
+            DEOPT_IF(func->func_version != func_version);
+            PyCodeObject *code = (PyCodeObject *)func->func_code;
+            DEOPT_IF(code->co_argcount + code->co_kwonlyargcount != argcount);
+            int nkwargs = (int)PyTuple_GET_SIZE(kwnames);
+            int positional_args = argcount - nkwargs;
+            DEOPT_IF(positional_args < code->co_posonlyargcount);
+            DEOPT_IF(positional_args > code->co_argcount);
+            for (int i = 0; i < nkwargs; i++) {
+                PyObject *name = PyTuple_GET_ITEM(code->co_localsplusnames, positional_args + i);
+                DEOPT_IF(PyTuple_GET_ITEM(kwnames, i) != name);
+            }
+            DEOPT_IF(!_PyThreadState_HasStackSpace(tstate, code->co_framesize));
+            STAT_INC(CALL_KW, hit);
+            _PyInterpreterFrame *new_frame = _PyFrame_PushUnchecked(tstate, func, argcount);
+            for (int i = 0; i < argcount; i++) {
+                new_frame->localsplus[i] = args[i];
+            }
+            Py_DECREF(kwnames);
+            // Manipulate stack and cache directly since we leave using DISPATCH_INLINED().
+            STACK_SHRINK(oparg + 3);
+            SKIP_OVER(INLINE_CACHE_ENTRIES_CALL_KW);
+            assert(1 + INLINE_CACHE_ENTRIES_CALL_KW == next_instr - frame->instr_ptr);
+            frame->return_offset = 1 + INLINE_CACHE_ENTRIES_CALL_KW;
+            DISPATCH_INLINED(new_frame);
+        }
+
         inst(INSTRUMENTED_CALL_FUNCTION_EX, ( -- )) {
+            _PyCallFunctionExCache *cache = (_PyCallFunctionExCache *)next_instr;
+            INCREMENT_ADAPTIVE_COUNTER(cache->counter);
             GO_TO_INSTRUCTION(CALL_FUNCTION_EX);
         }
 
-        inst(CALL_FUNCTION_EX, (func, unused, callargs, kwargs if (oparg & 1) -- result)) {
+        family(CALL_FUNCTION_EX, INLINE_CACHE_ENTRIES_CALL_FUNCTION_EX) = {
+            CALL_FUNCTION_EX_PY,
+        };
+
+        inst(CALL_FUNCTION_EX, (unused/1, func, unused, callargs, kwargs if (oparg & 1) -- result)) {
             // DICT_MERGE is called before this opcode if there are kwargs.
             // It converts all dict subtypes in kwargs into regular dicts.
             assert(kwargs == NULL || PyDict_CheckExact(kwargs));
+            #if ENABLE_SPECIALIZATION
+            _PyCallFunctionExCache *cache = (_PyCallFunctionExCache *)next_instr;
+            if (ADAPTIVE_COUNTER_IS_ZERO(cache->counter)) {
+                next_instr--;
+                _Py_Specialize_CallFunctionEx(func, next_instr);
+                DISPATCH_SAME_OPARG();
+            }
+            STAT_INC(CALL_FUNCTION_EX, deferred);
+            DECREMENT_ADAPTIVE_COUNTER(cache->counter);
+            #endif  /* ENABLE_SPECIALIZATION */
             if (!PyTuple_CheckExact(callargs)) {
                 if (check_args_iterable(tstate, func, callargs) < 0) {
                     goto error;
@@ -3697,8 +3927,9 @@ dummy_func(
                     if (new_frame == NULL) {
                         goto error;
                     }
-                    assert(next_instr - frame->instr_ptr == 1);
-                    frame->return_offset = 1;
+                    SKIP_OVER(INLINE_CACHE_ENTRIES_CALL_FUNCTION_EX);
+                    assert(1 + INLINE_CACHE_ENTRIES_CALL_FUNCTION_EX == next_instr - frame->instr_ptr);
+                    frame->return_offset = 1 + INLINE_CACHE_ENTRIES_CALL_FUNCTION_EX;
                     DISPATCH_INLINED(new_frame);
                 }
                 result = PyObject_Call(func, callargs, kwargs);
@@ -3709,6 +3940,50 @@ dummy_func(
             CHECK_EVAL_BREAKER();
         }
 
+        // Forwarding *args (and usually empty **kwargs) to a Python function.
+        // When the arguments match the signature exactly, they are copied to
+        // the new frame without building an argument array first.
+        inst(CALL_FUNCTION_EX_PY, (unused/1, func, unused, callargs, kwargs if (oparg & 1) -- unused)) {
+            DEOPT_IF(tstate->interp->eval_frame);
+            DEOPT_IF(Py_TYPE(func) != &PyFunction_Type);
+            PyFunctionObject *func_obj = (PyFunctionObject *)func;
+            DEOPT_IF(func_obj->vectorcall != _PyFunction_Vectorcall);
+            DEOPT_IF(!PyTuple_CheckExact(callargs));
+            assert(kwargs == NULL || PyDict_CheckExact(kwargs));
+            STAT_INC(CALL_FUNCTION_EX, hit);
+            PyCodeObject *code = (PyCodeObject *)func_obj->func_code;
+            Py_ssize_t nargs = PyTuple_GET_SIZE(callargs);
+            _PyInterpreterFrame *new_frame;
+            if ((kwargs == NULL || PyDict_GET_SIZE(kwargs) == 0) &&
+                nargs == code->co_argcount &&
+                code->co_kwonlyargcount == 0 &&
+                (code->co_flags & (CO_VARARGS | CO_VARKEYWORDS)) == 0 &&
+                (code->co_flags & CO_OPTIMIZED) &&
+                _PyThreadState_HasStackSpace(tstate, code->co_framesize))
+            {
+                new_frame = _PyFrame_PushUnchecked(tstate, func_obj, (int)nargs);
+                for (Py_ssize_t i = 0; i < nargs; i++) {
+                    new_frame->localsplus[i] = Py_NewRef(PyTuple_GET_ITEM(callargs, i));
+                }
+                Py_DECREF(callargs);
+                Py_XDECREF(kwargs);
+            }
+            else {
+                PyObject *locals = code->co_flags & CO_OPTIMIZED ? NULL : Py_NewRef(PyFunction_GET_GLOBALS(func));
+                new_frame = _PyEvalFramePushAndInit_Ex(tstate, func_obj, locals,
+                                                       nargs, callargs, kwargs);
+            }
+            // Manipulate stack and cache directly since we leave using DISPATCH_INLINED().
+            STACK_SHRINK(oparg + 3);
+            if (new_frame == NULL) {
+                goto error;
+            }
+            SKIP_OVER(INLINE_CACHE_ENTRIES_CALL_FUNCTION_EX);
+            assert(1 + INLINE_CACHE_ENTRIES_CALL_FUNCTION_EX == next_instr - frame->instr_ptr);
+            frame->return_offset = 1 + INLINE_CACHE_ENTRIES_CALL_FUNCTION_EX;
+            DISPATCH_INLINED(new_frame);
+        }
+
         inst(MAKE_FUNCTION, (codeobj -- func)) {
 
             PyFunctionObject *func_obj = (PyFunctionObject *)
@@ -3979,9 +4254,46 @@ dummy_func(
         op(_EXIT_TRACE, (--)) {
             TIER_TWO_ONLY
             _PyFrame_SetStackPointer(frame, stack_pointer);
-            Py_DECREF(self);
             OPT_HIST(trace_uop_execution_counter, trace_run_length_hist);
-            return frame;
+            goto exit_trace;
+        }
+
+        // The object must be immortal, so no reference is taken.
+        op(_LOAD_CONST_INLINE_BORROW, (ptr/4 -- value)) {
+            TIER_TWO_ONLY
+            value = ptr;
+        }
+
+        // Replaces a pure computation on two stack items whose result
+        // was folded by the optimizer; the result must be immortal.
+        op(_POP_TWO_LOAD_CONST_INLINE_BORROW, (ptr/4, pop1, pop2 -- value)) {
+            TIER_TWO_ONLY
+            Py_DECREF(pop2);
+            Py_DECREF(pop1);
+            value = ptr;
+        }
+
+        // Replace the frame push and pop of a call inlined by the optimizer,
+        // once the result of the call is on top of the stack.  The arguments
+        // include self_or_null, which may be NULL.
+        op(_POP_INLINED_CALL_UNDER_TOP, (callable, args[oparg], res -- res)) {
+            TIER_TWO_ONLY
+            Py_DECREF(callable);
+            for (int i = 0; i < oparg; i++) {
+                Py_XDECREF(args[i]);
+            }
+        }
+
+        // Same, for a call whose result is a constant of the callee.  The
+        // callable keeps the constant alive until it has a new reference,
+        // and no stack slot above the call is needed to hold it.
+        op(_POP_INLINED_CALL_LOAD_CONST_INLINE, (ptr/4, callable, args[oparg] -- value)) {
+            TIER_TWO_ONLY
+            value = Py_NewRef(ptr);
+            Py_DECREF(callable);
+            for (int i = 0; i < oparg; i++) {
+                Py_XDECREF(args[i]);
+            }
         }
 
         op(_INSERT, (unused[oparg], top -- top, unused[oparg])) {
@@ -11,6 +11,7 @@
 #include "pycore_function.h"
 #include "pycore_instruments.h"
 #include "pycore_intrinsics.h"
+#include "pycore_list.h"          // _PyList_Contains()
 #include "pycore_long.h"          // _PyLong_GetZero()
 #include "pycore_moduleobject.h"  // PyModuleObject
 #include "pycore_object.h"        // _PyObject_GC_TRACK()
@@ -734,6 +735,9 @@ _PyEval_EvalFrameDefault(PyThreadState *tstate, _PyInterpreterFrame *frame, int
 
     _Py_CODEUNIT *next_instr;
     PyObject **stack_pointer;
+#ifdef Py_TOS_CACHE
+    PyObject *tos_cache = NULL;
+#endif
 
 
 start_frame:
@@ -74,14 +74,42 @@
     } while(0)
 #endif
 
+/* Top-of-stack caching.
+ * When Py_TOS_CACHE is defined (configure --enable-experimental-tos-cache),
+ * the value at stack_pointer[-1] is also kept in the local variable
+ * tos_cache across instruction boundaries, so that an instruction consuming
+ * the result of the previous one can take it from a register instead of
+ * reloading it from the frame.  The cache is write-through: the stack in
+ * memory is always up to date, as the GC, frame objects and exception
+ * handling all read it.
+ * Generated instructions read their top input with TOS_CACHE() and finish
+ * with DISPATCH_TOS(value) when they know the new top of the stack; every
+ * other way of reaching an instruction goes through DISPATCH_GOTO() or
+ * GO_TO_INSTRUCTION(), which reload the cache. */
+#ifdef Py_TOS_CACHE
+#define TOS_CACHE()  tos_cache
+#define TOS_SET(v)   (tos_cache = (v))
+#define TOS_RELOAD() (tos_cache = stack_pointer[-1])
+#else
+#define TOS_CACHE()  (stack_pointer[-1])
+#define TOS_SET(v)   ((void)0)
+#define TOS_RELOAD() ((void)0)
+#endif
+
 #if USE_COMPUTED_GOTOS
 #  define TARGET(op) TARGET_##op: INSTRUCTION_START(op);
-#  define DISPATCH_GOTO() goto *opcode_targets[opcode]
+#  define GOTO_OPCODE() goto *opcode_targets[opcode]
 #else
 #  define TARGET(op) case op: TARGET_##op: INSTRUCTION_START(op);
-#  define DISPATCH_GOTO() goto dispatch_opcode
+#  define GOTO_OPCODE() goto dispatch_opcode
 #endif
 
+#define DISPATCH_GOTO() \
+    do { \
+        TOS_RELOAD(); \
+        GOTO_OPCODE(); \
+    } while (0)
+
 /* PRE_DISPATCH_GOTO() does lltrace if enabled. Normally a no-op */
 #ifdef LLTRACE
 #define PRE_DISPATCH_GOTO() if (lltrace) { \
@@ -99,6 +127,15 @@
         DISPATCH_GOTO(); \
     }
 
+/* Like DISPATCH(), but the new top of the stack is known to be value. */
+#define DISPATCH_TOS(value) \
+    { \
+        NEXTOPARG(); \
+        PRE_DISPATCH_GOTO(); \
+        TOS_SET(value); \
+        GOTO_OPCODE(); \
+    }
+
 #define DISPATCH_SAME_OPARG() \
     { \
         opcode = next_instr->op.code; \
@@ -248,7 +285,11 @@ GETITEM(PyObject *v, Py_ssize_t i) {
                                      GETLOCAL(i) = value; \
                                      Py_XDECREF(tmp); } while (0)
 
-#define GO_TO_INSTRUCTION(op) goto PREDICT_ID(op)
+#define GO_TO_INSTRUCTION(op) \
+    do { \
+        TOS_RELOAD(); \
+        goto PREDICT_ID(op); \
+    } while (0)
 
 #ifdef Py_STATS
 #define UPDATE_MISS_STATS(INSTNAME)                              \
@@ -332,6 +373,22 @@ do { \
     } \
 } while (0)
 
+// Store the result of `left op right` in local i, which is known to hold
+// `left`.  If nothing else refers to `left`, overwrite it in place.
+#define STORE_LOCAL_AND_REUSE_FLOAT(i, left, right, dval) \
+do { \
+    if (GETLOCAL(i) == (left) && Py_REFCNT(left) == 2) { \
+        ((PyFloatObject *)left)->ob_fval = (dval); \
+        _Py_DECREF_NO_DEALLOC(left); \
+        _Py_DECREF_SPECIALIZED(right, _PyFloat_ExactDealloc); \
+    } \
+    else { \
+        PyObject *result_; \
+        DECREF_INPUTS_AND_REUSE_FLOAT(left, right, dval, result_); \
+        SETLOCAL(i, result_); \
+    } \
+} while (0)
+
 // If a trace function sets a new f_lineno and
 // *then* raises, we use the destination when searching
 // for an exception handler, displaying the traceback, and so on
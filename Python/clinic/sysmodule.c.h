@@ -1097,6 +1097,36 @@ sys__clear_type_cache(PyObject *module, PyObject *Py_UNUSED(ignored))
     return sys__clear_type_cache_impl(module);
 }
 
+PyDoc_STRVAR(sys__trim_memory__doc__,
+"_trim_memory($module, /)\n"
+"--\n"
+"\n"
+"Return the memory of the free pymalloc pools to the operating system.\n"
+"\n"
+"Return the number of bytes released.");
+
+#define SYS__TRIM_MEMORY_METHODDEF    \
+    {"_trim_memory", (PyCFunction)sys__trim_memory, METH_NOARGS, sys__trim_memory__doc__},
+
+static Py_ssize_t
+sys__trim_memory_impl(PyObject *module);
+
+static PyObject *
+sys__trim_memory(PyObject *module, PyObject *Py_UNUSED(ignored))
+{
+    PyObject *return_value = NULL;
+    Py_ssize_t _return_value;
+
+    _return_value = sys__trim_memory_impl(module);
+    if ((_return_value == -1) && PyErr_Occurred()) {
+        goto exit;
+    }
+    return_value = PyLong_FromSsize_t(_return_value);
+
+exit:
+    return return_value;
+}
+
 PyDoc_STRVAR(sys_is_finalizing__doc__,
 "is_finalizing($module, /)\n"
 "--\n"
@@ -1452,4 +1482,4 @@ exit:
 #ifndef SYS_GETANDROIDAPILEVEL_METHODDEF
     #define SYS_GETANDROIDAPILEVEL_METHODDEF
 #endif /* !defined(SYS_GETANDROIDAPILEVEL_METHODDEF) */
-/*[clinic end generated code: output=f36d45c829250775 input=a9049054013a1b77]*/
+/*[clinic end generated code: output=bde0223d77b5f5e6 input=a9049054013a1b77]*/
@@ -8,14 +8,17 @@
 #include "pycore_dict.h"
 #include "pycore_emscripten_signal.h"
 #include "pycore_intrinsics.h"
+#include "pycore_list.h"
 #include "pycore_long.h"
 #include "pycore_object.h"
 #include "pycore_opcode_metadata.h"
 #include "pycore_opcode_utils.h"
+#include "pycore_optimizer.h"     // _PyOptimizer_SideExit()
 #include "pycore_pyerrors.h"
 #include "pycore_range.h"
 #include "pycore_setobject.h"     // _PySet_Update()
 #include "pycore_sliceobject.h"
+#include "pycore_tuple.h"
 #include "pycore_uops.h"
 
 #define TIER_TWO 2
@@ -143,6 +146,17 @@ _PyUopExecute(_PyExecutorObject *executor, _PyInterpreterFrame *frame, PyObject
     OPT_HIST(trace_uop_execution_counter, trace_run_length_hist);
     frame->return_offset = 0;  // Dispatch to frame->instr_ptr
     _PyFrame_SetStackPointer(frame, stack_pointer);
-    Py_DECREF(self);
-    return frame;
+
+exit_trace:
+    // Continue in the side exit executor if the exit is hot, else in tier 1.
+    {
+        _PyExecutorObject *exit;
+        int linked = _PyOptimizer_SideExit(self, pc - 1, frame, &exit);
+        Py_DECREF(self);
+        if (linked <= 0) {
+            return linked < 0 ? NULL : frame;
+        }
+        DPRINTF(2, "Side exit at %d: continuing in %p\n", pc - 1, exit);
+        return exit->execute(exit, frame, stack_pointer);
+    }
 }
@@ -241,6 +241,20 @@
             break;
         }
 
+        case _GUARD_NOS_INT: {
+            PyObject *left;
+            left = stack_pointer[-2];
+            DEOPT_IF(!PyLong_CheckExact(left), _GUARD_NOS_INT);
+            break;
+        }
+
+        case _GUARD_TOS_INT: {
+            PyObject *value;
+            value = stack_pointer[-1];
+            DEOPT_IF(!PyLong_CheckExact(value), _GUARD_TOS_INT);
+            break;
+        }
+
         case _BINARY_OP_MULTIPLY_INT: {
             PyObject *right;
             PyObject *left;
@@ -289,6 +303,64 @@
             break;
         }
 
+        case _BINARY_OP_INPLACE_ADD_INT: {
+            PyObject *right;
+            PyObject *left;
+            right = stack_pointer[-1];
+            left = stack_pointer[-2];
+            TIER_TWO_ONLY
+            STAT_INC(BINARY_OP, hit);
+            PyLongObject *lhs = (PyLongObject *)left;
+            PyLongObject *rhs = (PyLongObject *)right;
+            if (GETLOCAL(oparg) == left && Py_REFCNT(left) == 2 &&
+                _PyLong_BothAreCompact(lhs, rhs) &&
+                _PyLong_SetCompactValueInPlace(lhs,
+                    (stwodigits)_PyLong_CompactValue(lhs) +
+                    (stwodigits)_PyLong_CompactValue(rhs)))
+            {
+                _Py_DECREF_NO_DEALLOC(left);
+                _Py_DECREF_SPECIALIZED(right, (destructor)PyObject_Free);
+            }
+            else {
+                PyObject *res = _PyLong_Add(lhs, rhs);
+                _Py_DECREF_SPECIALIZED(right, (destructor)PyObject_Free);
+                _Py_DECREF_SPECIALIZED(left, (destructor)PyObject_Free);
+                if (res == NULL) goto pop_2_error;
+                SETLOCAL(oparg, res);
+            }
+            STACK_SHRINK(2);
+            break;
+        }
+
+        case _BINARY_OP_INPLACE_SUBTRACT_INT: {
+            PyObject *right;
+            PyObject *left;
+            right = stack_pointer[-1];
+            left = stack_pointer[-2];
+            TIER_TWO_ONLY
+            STAT_INC(BINARY_OP, hit);
+            PyLongObject *lhs = (PyLongObject *)left;
+            PyLongObject *rhs = (PyLongObject *)right;
+            if (GETLOCAL(oparg) == left && Py_REFCNT(left) == 2 &&
+                _PyLong_BothAreCompact(lhs, rhs) &&
+                _PyLong_SetCompactValueInPlace(lhs,
+                    (stwodigits)_PyLong_CompactValue(lhs) -
+                    (stwodigits)_PyLong_CompactValue(rhs)))
+            {
+                _Py_DECREF_NO_DEALLOC(left);
+                _Py_DECREF_SPECIALIZED(right, (destructor)PyObject_Free);
+            }
+            else {
+                PyObject *res = _PyLong_Subtract(lhs, rhs);
+                _Py_DECREF_SPECIALIZED(right, (destructor)PyObject_Free);
+                _Py_DECREF_SPECIALIZED(left, (destructor)PyObject_Free);
+                if (res == NULL) goto pop_2_error;
+                SETLOCAL(oparg, res);
+            }
+            STACK_SHRINK(2);
+            break;
+        }
+
         case _GUARD_BOTH_FLOAT: {
             PyObject *right;
             PyObject *left;
@@ -299,6 +371,20 @@
             break;
         }
 
+        case _GUARD_NOS_FLOAT: {
+            PyObject *left;
+            left = stack_pointer[-2];
+            DEOPT_IF(!PyFloat_CheckExact(left), _GUARD_NOS_FLOAT);
+            break;
+        }
+
+        case _GUARD_TOS_FLOAT: {
+            PyObject *value;
+            value = stack_pointer[-1];
+            DEOPT_IF(!PyFloat_CheckExact(value), _GUARD_TOS_FLOAT);
+            break;
+        }
+
         case _BINARY_OP_MULTIPLY_FLOAT: {
             PyObject *right;
             PyObject *left;
@@ -347,6 +433,51 @@
             break;
         }
 
+        case _BINARY_OP_INPLACE_MULTIPLY_FLOAT: {
+            PyObject *right;
+            PyObject *left;
+            right = stack_pointer[-1];
+            left = stack_pointer[-2];
+            TIER_TWO_ONLY
+            STAT_INC(BINARY_OP, hit);
+            double dres =
+                ((PyFloatObject *)left)->ob_fval *
+                ((PyFloatObject *)right)->ob_fval;
+            STORE_LOCAL_AND_REUSE_FLOAT(oparg, left, right, dres);
+            STACK_SHRINK(2);
+            break;
+        }
+
+        case _BINARY_OP_INPLACE_ADD_FLOAT: {
+            PyObject *right;
+            PyObject *left;
+            right = stack_pointer[-1];
+            left = stack_pointer[-2];
+            TIER_TWO_ONLY
+            STAT_INC(BINARY_OP, hit);
+            double dres =
+                ((PyFloatObject *)left)->ob_fval +
+                ((PyFloatObject *)right)->ob_fval;
+            STORE_LOCAL_AND_REUSE_FLOAT(oparg, left, right, dres);
+            STACK_SHRINK(2);
+            break;
+        }
+
+        case _BINARY_OP_INPLACE_SUBTRACT_FLOAT: {
+            PyObject *right;
+            PyObject *left;
+            right = stack_pointer[-1];
+            left = stack_pointer[-2];
+            TIER_TWO_ONLY
+            STAT_INC(BINARY_OP, hit);
+            double dres =
+                ((PyFloatObject *)left)->ob_fval -
+                ((PyFloatObject *)right)->ob_fval;
+            STORE_LOCAL_AND_REUSE_FLOAT(oparg, left, right, dres);
+            STACK_SHRINK(2);
+            break;
+        }
+
         case _GUARD_BOTH_UNICODE: {
             PyObject *right;
             PyObject *left;
@@ -2004,6 +2135,16 @@
             PyObject *b;
             right = stack_pointer[-1];
             left = stack_pointer[-2];
+            #if ENABLE_SPECIALIZATION
+            _PyContainsOpCache *cache = (_PyContainsOpCache *)next_instr;
+            if (ADAPTIVE_COUNTER_IS_ZERO(cache->counter)) {
+                next_instr--;
+                _Py_Specialize_ContainsOp(left, right, next_instr);
+                DISPATCH_SAME_OPARG();
+            }
+            STAT_INC(CONTAINS_OP, deferred);
+            DECREMENT_ADAPTIVE_COUNTER(cache->counter);
+            #endif  /* ENABLE_SPECIALIZATION */
             int res = PySequence_Contains(right, left);
             Py_DECREF(left);
             Py_DECREF(right);
@@ -2014,6 +2155,98 @@
             break;
         }
 
+        case CONTAINS_OP_DICT: {
+            PyObject *right;
+            PyObject *left;
+            PyObject *b;
+            right = stack_pointer[-1];
+            left = stack_pointer[-2];
+            DEOPT_IF(!PyDict_CheckExact(right), CONTAINS_OP);
+            STAT_INC(CONTAINS_OP, hit);
+            int res = PyDict_Contains(right, left);
+            Py_DECREF(left);
+            Py_DECREF(right);
+            if (res < 0) goto pop_2_error;
+            b = (res ^ oparg) ? Py_True : Py_False;
+            STACK_SHRINK(1);
+            stack_pointer[-1] = b;
+            break;
+        }
+
+        case CONTAINS_OP_SET: {
+            PyObject *right;
+            PyObject *left;
+            PyObject *b;
+            right = stack_pointer[-1];
+            left = stack_pointer[-2];
+            DEOPT_IF(!(PySet_CheckExact(right) || PyFrozenSet_CheckExact(right)), CONTAINS_OP);
+            STAT_INC(CONTAINS_OP, hit);
+            // Note: both set and frozenset use the same seq_contains method!
+            int res = _PySet_Contains((PySetObject *)right, left);
+            Py_DECREF(left);
+            Py_DECREF(right);
+            if (res < 0) goto pop_2_error;
+            b = (res ^ oparg) ? Py_True : Py_False;
+            STACK_SHRINK(1);
+            stack_pointer[-1] = b;
+            break;
+        }
+
+        case CONTAINS_OP_STR: {
+            PyObject *right;
+            PyObject *left;
+            PyObject *b;
+            right = stack_pointer[-1];
+            left = stack_pointer[-2];
+            DEOPT_IF(!PyUnicode_CheckExact(left), CONTAINS_OP);
+            DEOPT_IF(!PyUnicode_CheckExact(right), CONTAINS_OP);
+            STAT_INC(CONTAINS_OP, hit);
+            int res = PyUnicode_Contains(right, left);
+            Py_DECREF(left);
+            Py_DECREF(right);
+            if (res < 0) goto pop_2_error;
+            b = (res ^ oparg) ? Py_True : Py_False;
+            STACK_SHRINK(1);
+            stack_pointer[-1] = b;
+            break;
+        }
+
+        case CONTAINS_OP_TUPLE: {
+            PyObject *right;
+            PyObject *left;
+            PyObject *b;
+            right = stack_pointer[-1];
+            left = stack_pointer[-2];
+            DEOPT_IF(!PyTuple_CheckExact(right), CONTAINS_OP);
+            STAT_INC(CONTAINS_OP, hit);
+            int res = _PyTuple_Contains((PyTupleObject *)right, left);
+            Py_DECREF(left);
+            Py_DECREF(right);
+            if (res < 0) goto pop_2_error;
+            b = (res ^ oparg) ? Py_True : Py_False;
+            STACK_SHRINK(1);
+            stack_pointer[-1] = b;
+            break;
+        }
+
+        case CONTAINS_OP_LIST: {
+            PyObject *right;
+            PyObject *left;
+            PyObject *b;
+            right = stack_pointer[-1];
+            left = stack_pointer[-2];
+            DEOPT_IF(!PyList_CheckExact(right), CONTAINS_OP);
+            STAT_INC(CONTAINS_OP, hit);
+            int res = _PyList_Contains((PyListObject *)right, left);
+            Py_DECREF(left);
+            Py_DECREF(right);
+            if (res < 0) goto pop_2_error;
+            b = (res ^ oparg) ? Py_True : Py_False;
+            STACK_SHRINK(1);
+            stack_pointer[-1] = b;
+            break;
+        }
+
         case CHECK_EG_MATCH: {
             PyObject *match_type;
             PyObject *exc_value;
@@ -3286,9 +3519,70 @@
         case _EXIT_TRACE: {
             TIER_TWO_ONLY
             _PyFrame_SetStackPointer(frame, stack_pointer);
-            Py_DECREF(self);
             OPT_HIST(trace_uop_execution_counter, trace_run_length_hist);
-            return frame;
+            goto exit_trace;
+            break;
+        }
+
+        case _LOAD_CONST_INLINE_BORROW: {
+            PyObject *value;
+            PyObject *ptr = (PyObject *)operand;
+            TIER_TWO_ONLY
+            value = ptr;
+            STACK_GROW(1);
+            stack_pointer[-1] = value;
+            break;
+        }
+
+        case _POP_TWO_LOAD_CONST_INLINE_BORROW: {
+            PyObject *pop2;
+            PyObject *pop1;
+            PyObject *value;
+            pop2 = stack_pointer[-1];
+            pop1 = stack_pointer[-2];
+            PyObject *ptr = (PyObject *)operand;
+            TIER_TWO_ONLY
+            Py_DECREF(pop2);
+            Py_DECREF(pop1);
+            value = ptr;
+            STACK_SHRINK(1);
+            stack_pointer[-1] = value;
+            break;
+        }
+
+        case _POP_INLINED_CALL_UNDER_TOP: {
+            PyObject *res;
+            PyObject **args;
+            PyObject *callable;
+            res = stack_pointer[-1];
+            args = stack_pointer - 1 - oparg;
+            callable = stack_pointer[-2 - oparg];
+            TIER_TWO_ONLY
+            Py_DECREF(callable);
+            for (int i = 0; i < oparg; i++) {
+                Py_XDECREF(args[i]);
+            }
+            STACK_SHRINK(oparg);
+            STACK_SHRINK(1);
+            stack_pointer[-1] = res;
+            break;
+        }
+
+        case _POP_INLINED_CALL_LOAD_CONST_INLINE: {
+            PyObject **args;
+            PyObject *callable;
+            PyObject *value;
+            args = stack_pointer - oparg;
+            callable = stack_pointer[-1 - oparg];
+            PyObject *ptr = (PyObject *)operand;
+            TIER_TWO_ONLY
+            value = Py_NewRef(ptr);
+            Py_DECREF(callable);
+            for (int i = 0; i < oparg; i++) {
+                Py_XDECREF(args[i]);
+            }
+            STACK_SHRINK(oparg);
+            stack_pointer[-1] = value;
             break;
         }
 
@@ -77,7 +77,7 @@
             Py_INCREF(value);
             STACK_GROW(1);
             stack_pointer[-1] = value;
-            DISPATCH();
+            DISPATCH_TOS(value);
         }
 
         TARGET(LOAD_FAST) {
@@ -87,7 +87,7 @@
             Py_INCREF(value);
             STACK_GROW(1);
             stack_pointer[-1] = value;
-            DISPATCH();
+            DISPATCH_TOS(value);
         }
 
         TARGET(LOAD_FAST_AND_CLEAR) {
@@ -97,7 +97,7 @@
             GETLOCAL(oparg) = NULL;
             STACK_GROW(1);
             stack_pointer[-1] = value;
-            DISPATCH();
+            DISPATCH_TOS(value);
         }
 
         TARGET(LOAD_FAST_LOAD_FAST) {
@@ -112,7 +112,7 @@
             STACK_GROW(2);
             stack_pointer[-2] = value1;
             stack_pointer[-1] = value2;
-            DISPATCH();
+            DISPATCH_TOS(value2);
         }
 
         TARGET(LOAD_CONST) {
@@ -121,12 +121,12 @@
             Py_INCREF(value);
             STACK_GROW(1);
             stack_pointer[-1] = value;
-            DISPATCH();
+            DISPATCH_TOS(value);
         }
 
         TARGET(STORE_FAST) {
             PyObject *value;
-            value = stack_pointer[-1];
+            value = TOS_CACHE();
             SETLOCAL(oparg, value);
             STACK_SHRINK(1);
             DISPATCH();
@@ -135,20 +135,20 @@
         TARGET(STORE_FAST_LOAD_FAST) {
             PyObject *value1;
             PyObject *value2;
-            value1 = stack_pointer[-1];
+            value1 = TOS_CACHE();
             uint32_t oparg1 = oparg >> 4;
             uint32_t oparg2 = oparg & 15;
             SETLOCAL(oparg1, value1);
             value2 = GETLOCAL(oparg2);
             Py_INCREF(value2);
             stack_pointer[-1] = value2;
-            DISPATCH();
+            DISPATCH_TOS(value2);
         }
 
         TARGET(STORE_FAST_STORE_FAST) {
             PyObject *value1;
             PyObject *value2;
-            value1 = stack_pointer[-1];
+            value1 = TOS_CACHE();
             value2 = stack_pointer[-2];
             uint32_t oparg1 = oparg >> 4;
             uint32_t oparg2 = oparg & 15;
@@ -160,7 +160,7 @@
 
         TARGET(POP_TOP) {
             PyObject *value;
-            value = stack_pointer[-1];
+            value = TOS_CACHE();
             Py_DECREF(value);
             STACK_SHRINK(1);
             DISPATCH();
@@ -171,13 +171,13 @@
             res = NULL;
             STACK_GROW(1);
             stack_pointer[-1] = res;
-            DISPATCH();
+            DISPATCH_TOS(res);
         }
 
         TARGET(END_FOR) {
             PyObject *value;
             // POP_TOP
-            value = stack_pointer[-1];
+            value = TOS_CACHE();
             {
                 Py_DECREF(value);
             }
@@ -193,7 +193,7 @@
         TARGET(INSTRUMENTED_END_FOR) {
             PyObject *value;
             PyObject *receiver;
-            value = stack_pointer[-1];
+            value = TOS_CACHE();
             receiver = stack_pointer[-2];
             /* Need to create a fake StopIteration error here,
              * to conform to PEP 380 */
@@ -213,18 +213,18 @@
         TARGET(END_SEND) {
             PyObject *value;
             PyObject *receiver;
-            value = stack_pointer[-1];
+            value = TOS_CACHE();
             receiver = stack_pointer[-2];
             Py_DECREF(receiver);
             STACK_SHRINK(1);
             stack_pointer[-1] = value;
-            DISPATCH();
+            DISPATCH_TOS(value);
         }
 
         TARGET(INSTRUMENTED_END_SEND) {
             PyObject *value;
             PyObject *receiver;
-            value = stack_pointer[-1];
+            value = TOS_CACHE();
             receiver = stack_pointer[-2];
             if (PyGen_Check(receiver) || PyCoro_CheckExact(receiver)) {
                 PyErr_SetObject(PyExc_StopIteration, value);
@@ -236,28 +236,28 @@
             Py_DECREF(receiver);
             STACK_SHRINK(1);
             stack_pointer[-1] = value;
-            DISPATCH();
+            DISPATCH_TOS(value);
         }
 
         TARGET(UNARY_NEGATIVE) {
             PyObject *value;
             PyObject *res;
-            value = stack_pointer[-1];
+            value = TOS_CACHE();
             res = PyNumber_Negative(value);
             Py_DECREF(value);
             if (res == NULL) goto pop_1_error;
             stack_pointer[-1] = res;
-            DISPATCH();
+            DISPATCH_TOS(res);
         }
 
         TARGET(UNARY_NOT) {
             PyObject *value;
             PyObject *res;
-            value = stack_pointer[-1];
+            value = TOS_CACHE();
             assert(PyBool_Check(value));
             res = Py_IsFalse(value) ? Py_True : Py_False;
             stack_pointer[-1] = res;
-            DISPATCH();
+            DISPATCH_TOS(res);
         }
 
         TARGET(TO_BOOL) {
@@ -265,7 +265,7 @@
             static_assert(INLINE_CACHE_ENTRIES_TO_BOOL == 3, "incorrect cache size");
             PyObject *value;
             PyObject *res;
-            value = stack_pointer[-1];
+            value = TOS_CACHE();
             #if ENABLE_SPECIALIZATION
             _PyToBoolCache *cache = (_PyToBoolCache *)next_instr;
             if (ADAPTIVE_COUNTER_IS_ZERO(cache->counter)) {
@@ -282,12 +282,12 @@
             res = err ? Py_True : Py_False;
             stack_pointer[-1] = res;
             next_instr += 3;
-            DISPATCH();
+            DISPATCH_TOS(res);
         }
 
         TARGET(TO_BOOL_BOOL) {
             PyObject *value;
-            value = stack_pointer[-1];
+            value = TOS_CACHE();
             DEOPT_IF(!PyBool_Check(value), TO_BOOL);
             STAT_INC(TO_BOOL, hit);
             next_instr += 3;
@@ -297,7 +297,7 @@
         TARGET(TO_BOOL_INT) {
             PyObject *value;
             PyObject *res;
-            value = stack_pointer[-1];
+            value = TOS_CACHE();
             DEOPT_IF(!PyLong_CheckExact(value), TO_BOOL);
             STAT_INC(TO_BOOL, hit);
             if (_PyLong_IsZero((PyLongObject *)value)) {
@@ -310,39 +310,39 @@
             }
             stack_pointer[-1] = res;
             next_instr += 3;
-            DISPATCH();
+            DISPATCH_TOS(res);
         }
 
         TARGET(TO_BOOL_LIST) {
             PyObject *value;
             PyObject *res;
-            value = stack_pointer[-1];
+            value = TOS_CACHE();
             DEOPT_IF(!PyList_CheckExact(value), TO_BOOL);
             STAT_INC(TO_BOOL, hit);
             res = Py_SIZE(value) ? Py_True : Py_False;
             Py_DECREF(value);
             stack_pointer[-1] = res;
             next_instr += 3;
-            DISPATCH();
+            DISPATCH_TOS(res);
         }
 
         TARGET(TO_BOOL_NONE) {
             PyObject *value;
             PyObject *res;
-            value = stack_pointer[-1];
+            value = TOS_CACHE();
             // This one is a bit weird, because we expect *some* failures:
             DEOPT_IF(!Py_IsNone(value), TO_BOOL);
             STAT_INC(TO_BOOL, hit);
             res = Py_False;
             stack_pointer[-1] = res;
             next_instr += 3;
-            DISPATCH();
+            DISPATCH_TOS(res);
         }
 
         TARGET(TO_BOOL_STR) {
             PyObject *value;
             PyObject *res;
-            value = stack_pointer[-1];
+            value = TOS_CACHE();
             DEOPT_IF(!PyUnicode_CheckExact(value), TO_BOOL);
             STAT_INC(TO_BOOL, hit);
             if (value == &_Py_STR(empty)) {
@@ -356,13 +356,13 @@
             }
             stack_pointer[-1] = res;
             next_instr += 3;
-            DISPATCH();
+            DISPATCH_TOS(res);
         }
 
         TARGET(TO_BOOL_ALWAYS_TRUE) {
             PyObject *value;
             PyObject *res;
-            value = stack_pointer[-1];
+            value = TOS_CACHE();
             uint32_t version = read_u32(&next_instr[1].cache);
             // This one is a bit weird, because we expect *some* failures:
             assert(version);
@@ -372,18 +372,18 @@
             res = Py_True;
             stack_pointer[-1] = res;
             next_instr += 3;
-            DISPATCH();
+            DISPATCH_TOS(res);
         }
 
         TARGET(UNARY_INVERT) {
             PyObject *value;
             PyObject *res;
-            value = stack_pointer[-1];
+            value = TOS_CACHE();
             res = PyNumber_Invert(value);
             Py_DECREF(value);
             if (res == NULL) goto pop_1_error;
             stack_pointer[-1] = res;
-            DISPATCH();
+            DISPATCH_TOS(res);
         }
 
         TARGET(BINARY_OP_MULTIPLY_INT) {
@@ -391,7 +391,7 @@
             PyObject *left;
             PyObject *res;
             // _GUARD_BOTH_INT
-            right = stack_pointer[-1];
+            right = TOS_CACHE();
             left = stack_pointer[-2];
             {
                 DEOPT_IF(!PyLong_CheckExact(left), BINARY_OP);
@@ -408,7 +408,7 @@
             STACK_SHRINK(1);
             stack_pointer[-1] = res;
             next_instr += 1;
-            DISPATCH();
+            DISPATCH_TOS(res);
         }
 
         TARGET(BINARY_OP_ADD_INT) {
@@ -416,7 +416,7 @@
             PyObject *left;
             PyObject *res;
             // _GUARD_BOTH_INT
-            right = stack_pointer[-1];
+            right = TOS_CACHE();
             left = stack_pointer[-2];
             {
                 DEOPT_IF(!PyLong_CheckExact(left), BINARY_OP);
@@ -433,7 +433,7 @@
             STACK_SHRINK(1);
             stack_pointer[-1] = res;
             next_instr += 1;
-            DISPATCH();
+            DISPATCH_TOS(res);
         }
 
         TARGET(BINARY_OP_SUBTRACT_INT) {
@@ -441,7 +441,7 @@
             PyObject *left;
             PyObject *res;
             // _GUARD_BOTH_INT
-            right = stack_pointer[-1];
+            right = TOS_CACHE();
             left = stack_pointer[-2];
             {
                 DEOPT_IF(!PyLong_CheckExact(left), BINARY_OP);
@@ -458,7 +458,7 @@
             STACK_SHRINK(1);
             stack_pointer[-1] = res;
             next_instr += 1;
-            DISPATCH();
+            DISPATCH_TOS(res);
         }
 
         TARGET(BINARY_OP_MULTIPLY_FLOAT) {
@@ -466,7 +466,7 @@
             PyObject *left;
             PyObject *res;
             // _GUARD_BOTH_FLOAT
-            right = stack_pointer[-1];
+            right = TOS_CACHE();
             left = stack_pointer[-2];
             {
                 DEOPT_IF(!PyFloat_CheckExact(left), BINARY_OP);
@@ -483,7 +483,7 @@
             STACK_SHRINK(1);
             stack_pointer[-1] = res;
             next_instr += 1;
-            DISPATCH();
+            DISPATCH_TOS(res);
         }
 
         TARGET(BINARY_OP_ADD_FLOAT) {
@@ -491,7 +491,7 @@
             PyObject *left;
             PyObject *res;
             // _GUARD_BOTH_FLOAT
-            right = stack_pointer[-1];
+            right = TOS_CACHE();
             left = stack_pointer[-2];
             {
                 DEOPT_IF(!PyFloat_CheckExact(left), BINARY_OP);
@@ -508,7 +508,7 @@
             STACK_SHRINK(1);
             stack_pointer[-1] = res;
             next_instr += 1;
-            DISPATCH();
+            DISPATCH_TOS(res);
         }
 
         TARGET(BINARY_OP_SUBTRACT_FLOAT) {
@@ -516,7 +516,7 @@
             PyObject *left;
             PyObject *res;
             // _GUARD_BOTH_FLOAT
-            right = stack_pointer[-1];
+            right = TOS_CACHE();
             left = stack_pointer[-2];
             {
                 DEOPT_IF(!PyFloat_CheckExact(left), BINARY_OP);
@@ -533,7 +533,7 @@
             STACK_SHRINK(1);
             stack_pointer[-1] = res;
             next_instr += 1;
-            DISPATCH();
+            DISPATCH_TOS(res);
         }
 
         TARGET(BINARY_OP_ADD_UNICODE) {
@@ -541,7 +541,7 @@
             PyObject *left;
             PyObject *res;
             // _GUARD_BOTH_UNICODE
-            right = stack_pointer[-1];
+            right = TOS_CACHE();
             left = stack_pointer[-2];
             {
                 DEOPT_IF(!PyUnicode_CheckExact(left), BINARY_OP);
@@ -558,14 +558,14 @@
             STACK_SHRINK(1);
             stack_pointer[-1] = res;
             next_instr += 1;
-            DISPATCH();
+            DISPATCH_TOS(res);
         }
 
         TARGET(BINARY_OP_INPLACE_ADD_UNICODE) {
             PyObject *right;
             PyObject *left;
             // _GUARD_BOTH_UNICODE
-            right = stack_pointer[-1];
+            right = TOS_CACHE();
             left = stack_pointer[-2];
             {
                 DEOPT_IF(!PyUnicode_CheckExact(left), BINARY_OP);
@@ -607,7 +607,7 @@
             PyObject *sub;
             PyObject *container;
             PyObject *res;
-            sub = stack_pointer[-1];
+            sub = TOS_CACHE();
             container = stack_pointer[-2];
             #if ENABLE_SPECIALIZATION
             _PyBinarySubscrCache *cache = (_PyBinarySubscrCache *)next_instr;
@@ -626,7 +626,7 @@
             STACK_SHRINK(1);
             stack_pointer[-1] = res;
             next_instr += 1;
-            DISPATCH();
+            DISPATCH_TOS(res);
         }
 
         TARGET(BINARY_SLICE) {
@@ -634,7 +634,7 @@
             PyObject *start;
             PyObject *container;
             PyObject *res;
-            stop = stack_pointer[-1];
+            stop = TOS_CACHE();
             start = stack_pointer[-2];
             container = stack_pointer[-3];
             PyObject *slice = _PyBuildSlice_ConsumeRefs(start, stop);
@@ -651,7 +651,7 @@
             if (res == NULL) goto pop_3_error;
             STACK_SHRINK(2);
             stack_pointer[-1] = res;
-            DISPATCH();
+            DISPATCH_TOS(res);
         }
 
         TARGET(STORE_SLICE) {
@@ -659,7 +659,7 @@
             PyObject *start;
             PyObject *container;
             PyObject *v;
-            stop = stack_pointer[-1];
+            stop = TOS_CACHE();
             start = stack_pointer[-2];
             container = stack_pointer[-3];
             v = stack_pointer[-4];
@@ -683,7 +683,7 @@
             PyObject *sub;
             PyObject *list;
             PyObject *res;
-            sub = stack_pointer[-1];
+            sub = TOS_CACHE();
             list = stack_pointer[-2];
             DEOPT_IF(!PyLong_CheckExact(sub), BINARY_SUBSCR);
             DEOPT_IF(!PyList_CheckExact(list), BINARY_SUBSCR);
@@ -701,14 +701,14 @@
             STACK_SHRINK(1);
             stack_pointer[-1] = res;
             next_instr += 1;
-            DISPATCH();
+            DISPATCH_TOS(res);
         }
 
         TARGET(BINARY_SUBSCR_STR_INT) {
             PyObject *sub;
             PyObject *str;
             PyObject *res;
-            sub = stack_pointer[-1];
+            sub = TOS_CACHE();
             str = stack_pointer[-2];
             DEOPT_IF(!PyLong_CheckExact(sub), BINARY_SUBSCR);
             DEOPT_IF(!PyUnicode_CheckExact(str), BINARY_SUBSCR);
@@ -725,14 +725,14 @@
             STACK_SHRINK(1);
             stack_pointer[-1] = res;
             next_instr += 1;
-            DISPATCH();
+            DISPATCH_TOS(res);
         }
 
         TARGET(BINARY_SUBSCR_TUPLE_INT) {
             PyObject *sub;
             PyObject *tuple;
             PyObject *res;
-            sub = stack_pointer[-1];
+            sub = TOS_CACHE();
             tuple = stack_pointer[-2];
             DEOPT_IF(!PyLong_CheckExact(sub), BINARY_SUBSCR);
             DEOPT_IF(!PyTuple_CheckExact(tuple), BINARY_SUBSCR);
@@ -750,14 +750,14 @@
             STACK_SHRINK(1);
             stack_pointer[-1] = res;
             next_instr += 1;
-            DISPATCH();
+            DISPATCH_TOS(res);
         }
 
         TARGET(BINARY_SUBSCR_DICT) {
             PyObject *sub;
             PyObject *dict;
             PyObject *res;
-            sub = stack_pointer[-1];
+            sub = TOS_CACHE();
             dict = stack_pointer[-2];
             DEOPT_IF(!PyDict_CheckExact(dict), BINARY_SUBSCR);
             STAT_INC(BINARY_SUBSCR, hit);
@@ -776,13 +776,13 @@
             STACK_SHRINK(1);
             stack_pointer[-1] = res;
             next_instr += 1;
-            DISPATCH();
+            DISPATCH_TOS(res);
         }
 
         TARGET(BINARY_SUBSCR_GETITEM) {
             PyObject *sub;
             PyObject *container;
-            sub = stack_pointer[-1];
+            sub = TOS_CACHE();
             container = stack_pointer[-2];
             DEOPT_IF(tstate->interp->eval_frame, BINARY_SUBSCR);
             PyTypeObject *tp = Py_TYPE(container);
@@ -812,7 +812,7 @@
         TARGET(LIST_APPEND) {
             PyObject *v;
             PyObject *list;
-            v = stack_pointer[-1];
+            v = TOS_CACHE();
             list = stack_pointer[-2 - (oparg-1)];
             if (_PyList_AppendTakeRef((PyListObject *)list, v) < 0) goto pop_1_error;
             STACK_SHRINK(1);
@@ -822,7 +822,7 @@
         TARGET(SET_ADD) {
             PyObject *v;
             PyObject *set;
-            v = stack_pointer[-1];
+            v = TOS_CACHE();
             set = stack_pointer[-2 - (oparg-1)];
             int err = PySet_Add(set, v);
             Py_DECREF(v);
@@ -837,7 +837,7 @@
             PyObject *sub;
             PyObject *container;
             PyObject *v;
-            sub = stack_pointer[-1];
+            sub = TOS_CACHE();
             container = stack_pointer[-2];
             v = stack_pointer[-3];
             #if ENABLE_SPECIALIZATION
@@ -865,7 +865,7 @@
             PyObject *sub;
             PyObject *list;
             PyObject *value;
-            sub = stack_pointer[-1];
+            sub = TOS_CACHE();
             list = stack_pointer[-2];
             value = stack_pointer[-3];
             DEOPT_IF(!PyLong_CheckExact(sub), STORE_SUBSCR);
@@ -893,7 +893,7 @@
             PyObject *sub;
             PyObject *dict;
             PyObject *value;
-            sub = stack_pointer[-1];
+            sub = TOS_CACHE();
             dict = stack_pointer[-2];
             value = stack_pointer[-3];
             DEOPT_IF(!PyDict_CheckExact(dict), STORE_SUBSCR);
@@ -909,7 +909,7 @@
         TARGET(DELETE_SUBSCR) {
             PyObject *sub;
             PyObject *container;
-            sub = stack_pointer[-1];
+            sub = TOS_CACHE();
             container = stack_pointer[-2];
             /* del container[sub] */
             int err = PyObject_DelItem(container, sub);
@@ -923,20 +923,20 @@
         TARGET(CALL_INTRINSIC_1) {
             PyObject *value;
             PyObject *res;
-            value = stack_pointer[-1];
+            value = TOS_CACHE();
             assert(oparg <= MAX_INTRINSIC_1);
             res = _PyIntrinsics_UnaryFunctions[oparg].func(tstate, value);
             Py_DECREF(value);
             if (res == NULL) goto pop_1_error;
             stack_pointer[-1] = res;
-            DISPATCH();
+            DISPATCH_TOS(res);
         }
 
         TARGET(CALL_INTRINSIC_2) {
             PyObject *value1;
             PyObject *value2;
             PyObject *res;
-            value1 = stack_pointer[-1];
+            value1 = TOS_CACHE();
             value2 = stack_pointer[-2];
             assert(oparg <= MAX_INTRINSIC_2);
             res = _PyIntrinsics_BinaryFunctions[oparg].func(tstate, value2, value1);
@@ -945,7 +945,7 @@
             if (res == NULL) goto pop_2_error;
             STACK_SHRINK(1);
             stack_pointer[-1] = res;
-            DISPATCH();
+            DISPATCH_TOS(res);
         }
 
         TARGET(RAISE_VARARGS) {
@@ -976,7 +976,7 @@
 
         TARGET(INTERPRETER_EXIT) {
             PyObject *retval;
-            retval = stack_pointer[-1];
+            retval = TOS_CACHE();
             assert(frame == &entry_frame);
             assert(_PyFrame_IsIncomplete(frame));
             /* Restore previous frame and return. */
@@ -988,7 +988,7 @@
 
         TARGET(RETURN_VALUE) {
             PyObject *retval;
-            retval = stack_pointer[-1];
+            retval = TOS_CACHE();
             STACK_SHRINK(1);
             assert(EMPTY());
             #if TIER_ONE
@@ -1014,7 +1014,7 @@
 
         TARGET(INSTRUMENTED_RETURN_VALUE) {
             PyObject *retval;
-            retval = stack_pointer[-1];
+            retval = TOS_CACHE();
             int err = _Py_call_instrumentation_arg(
                     tstate, PY_MONITORING_EVENT_PY_RETURN,
                     frame, next_instr-1, retval);
@@ -1090,7 +1090,7 @@
         TARGET(GET_AITER) {
             PyObject *obj;
             PyObject *iter;
-            obj = stack_pointer[-1];
+            obj = TOS_CACHE();
             unaryfunc getter = NULL;
             PyTypeObject *type = Py_TYPE(obj);
 
@@ -1122,13 +1122,13 @@
                 if (true) goto pop_1_error;
             }
             stack_pointer[-1] = iter;
-            DISPATCH();
+            DISPATCH_TOS(iter);
         }
 
         TARGET(GET_ANEXT) {
             PyObject *aiter;
             PyObject *awaitable;
-            aiter = stack_pointer[-1];
+            aiter = TOS_CACHE();
             unaryfunc getter = NULL;
             PyObject *next_iter = NULL;
             PyTypeObject *type = Py_TYPE(aiter);
@@ -1173,13 +1173,13 @@
             }
             STACK_GROW(1);
             stack_pointer[-1] = awaitable;
-            DISPATCH();
+            DISPATCH_TOS(awaitable);
         }
 
         TARGET(GET_AWAITABLE) {
             PyObject *iterable;
             PyObject *iter;
-            iterable = stack_pointer[-1];
+            iterable = TOS_CACHE();
             iter = _PyCoro_GetAwaitableIter(iterable);
 
             if (iter == NULL) {
@@ -1204,7 +1204,7 @@
 
             if (iter == NULL) goto pop_1_error;
             stack_pointer[-1] = iter;
-            DISPATCH();
+            DISPATCH_TOS(iter);
         }
 
         TARGET(SEND) {
@@ -1213,7 +1213,7 @@
             PyObject *v;
             PyObject *receiver;
             PyObject *retval;
-            v = stack_pointer[-1];
+            v = TOS_CACHE();
             receiver = stack_pointer[-2];
             #if ENABLE_SPECIALIZATION
             _PySendCache *cache = (_PySendCache *)next_instr;
@@ -1264,13 +1264,13 @@
             Py_DECREF(v);
             stack_pointer[-1] = retval;
             next_instr += 1;
-            DISPATCH();
+            DISPATCH_TOS(retval);
         }
 
         TARGET(SEND_GEN) {
             PyObject *v;
             PyObject *receiver;
-            v = stack_pointer[-1];
+            v = TOS_CACHE();
             receiver = stack_pointer[-2];
             DEOPT_IF(tstate->interp->eval_frame, SEND);
             PyGenObject *gen = (PyGenObject *)receiver;
@@ -1291,7 +1291,7 @@
 
         TARGET(INSTRUMENTED_YIELD_VALUE) {
             PyObject *retval;
-            retval = stack_pointer[-1];
+            retval = TOS_CACHE();
             assert(frame != &entry_frame);
             assert(oparg >= 0); /* make the generator identify this as HAS_ARG */
             frame->instr_ptr = next_instr;
@@ -1317,7 +1317,7 @@
 
         TARGET(YIELD_VALUE) {
             PyObject *retval;
-            retval = stack_pointer[-1];
+            retval = TOS_CACHE();
             // NOTE: It's important that YIELD_VALUE never raises an exception!
             // The compiler treats any exception raised here as a failed close()
             // or throw() call.
@@ -1342,7 +1342,7 @@
 
         TARGET(POP_EXCEPT) {
             PyObject *exc_value;
-            exc_value = stack_pointer[-1];
+            exc_value = TOS_CACHE();
             _PyErr_StackItem *exc_info = tstate->exc_info;
             Py_XSETREF(exc_info->exc_value, exc_value);
             STACK_SHRINK(1);
@@ -1352,7 +1352,7 @@
         TARGET(RERAISE) {
             PyObject *exc;
             PyObject **values;
-            exc = stack_pointer[-1];
+            exc = TOS_CACHE();
             values = stack_pointer - 1 - oparg;
             assert(oparg >= 0 && oparg <= 2);
             if (oparg) {
@@ -1377,7 +1377,7 @@
         TARGET(END_ASYNC_FOR) {
             PyObject *exc;
             PyObject *awaitable;
-            exc = stack_pointer[-1];
+            exc = TOS_CACHE();
             awaitable = stack_pointer[-2];
             assert(exc && PyExceptionInstance_Check(exc));
             if (PyErr_GivenExceptionMatches(exc, PyExc_StopAsyncIteration)) {
@@ -1400,7 +1400,7 @@
             PyObject *sub_iter;
             PyObject *none;
             PyObject *value;
-            exc_value = stack_pointer[-1];
+            exc_value = TOS_CACHE();
             last_sent_val = stack_pointer[-2];
             sub_iter = stack_pointer[-3];
             assert(throwflag);
@@ -1420,7 +1420,7 @@
             STACK_SHRINK(1);
             stack_pointer[-2] = none;
             stack_pointer[-1] = value;
-            DISPATCH();
+            DISPATCH_TOS(value);
         }
 
         TARGET(LOAD_ASSERTION_ERROR) {
@@ -1428,7 +1428,7 @@
             value = Py_NewRef(PyExc_AssertionError);
             STACK_GROW(1);
             stack_pointer[-1] = value;
-            DISPATCH();
+            DISPATCH_TOS(value);
         }
 
         TARGET(LOAD_BUILD_CLASS) {
@@ -1441,12 +1441,12 @@
             }
             STACK_GROW(1);
             stack_pointer[-1] = bc;
-            DISPATCH();
+            DISPATCH_TOS(bc);
         }
 
         TARGET(STORE_NAME) {
             PyObject *v;
-            v = stack_pointer[-1];
+            v = TOS_CACHE();
             PyObject *name = GETITEM(FRAME_CO_NAMES, oparg);
             PyObject *ns = LOCALS();
             int err;
@@ -1490,7 +1490,7 @@
             PREDICTED(UNPACK_SEQUENCE);
             static_assert(INLINE_CACHE_ENTRIES_UNPACK_SEQUENCE == 1, "incorrect cache size");
             PyObject *seq;
-            seq = stack_pointer[-1];
+            seq = TOS_CACHE();
             #if ENABLE_SPECIALIZATION
             _PyUnpackSequenceCache *cache = (_PyUnpackSequenceCache *)next_instr;
             if (ADAPTIVE_COUNTER_IS_ZERO(cache->counter)) {
@@ -1514,7 +1514,7 @@
         TARGET(UNPACK_SEQUENCE_TWO_TUPLE) {
             PyObject *seq;
             PyObject **values;
-            seq = stack_pointer[-1];
+            seq = TOS_CACHE();
             values = stack_pointer - 1;
             DEOPT_IF(!PyTuple_CheckExact(seq), UNPACK_SEQUENCE);
             DEOPT_IF(PyTuple_GET_SIZE(seq) != 2, UNPACK_SEQUENCE);
@@ -1532,7 +1532,7 @@
         TARGET(UNPACK_SEQUENCE_TUPLE) {
             PyObject *seq;
             PyObject **values;
-            seq = stack_pointer[-1];
+            seq = TOS_CACHE();
             values = stack_pointer - 1;
             DEOPT_IF(!PyTuple_CheckExact(seq), UNPACK_SEQUENCE);
             DEOPT_IF(PyTuple_GET_SIZE(seq) != oparg, UNPACK_SEQUENCE);
@@ -1551,7 +1551,7 @@
         TARGET(UNPACK_SEQUENCE_LIST) {
             PyObject *seq;
             PyObject **values;
-            seq = stack_pointer[-1];
+            seq = TOS_CACHE();
             values = stack_pointer - 1;
             DEOPT_IF(!PyList_CheckExact(seq), UNPACK_SEQUENCE);
             DEOPT_IF(PyList_GET_SIZE(seq) != oparg, UNPACK_SEQUENCE);
@@ -1569,7 +1569,7 @@
 
         TARGET(UNPACK_EX) {
             PyObject *seq;
-            seq = stack_pointer[-1];
+            seq = TOS_CACHE();
             int totalargs = 1 + (oparg & 0xFF) + (oparg >> 8);
             PyObject **top = stack_pointer + totalargs - 1;
             int res = _PyEval_UnpackIterable(tstate, seq, oparg & 0xFF, oparg >> 8, top);
@@ -1584,7 +1584,7 @@
             static_assert(INLINE_CACHE_ENTRIES_STORE_ATTR == 4, "incorrect cache size");
             PyObject *owner;
             PyObject *v;
-            owner = stack_pointer[-1];
+            owner = TOS_CACHE();
             v = stack_pointer[-2];
             #if ENABLE_SPECIALIZATION
             _PyAttrCache *cache = (_PyAttrCache *)next_instr;
@@ -1609,7 +1609,7 @@
 
         TARGET(DELETE_ATTR) {
             PyObject *owner;
-            owner = stack_pointer[-1];
+            owner = TOS_CACHE();
             PyObject *name = GETITEM(FRAME_CO_NAMES, oparg);
             int err = PyObject_DelAttr(owner, name);
             Py_DECREF(owner);
@@ -1620,7 +1620,7 @@
 
         TARGET(STORE_GLOBAL) {
             PyObject *v;
-            v = stack_pointer[-1];
+            v = TOS_CACHE();
             PyObject *name = GETITEM(FRAME_CO_NAMES, oparg);
             int err = PyDict_SetItem(GLOBALS(), name, v);
             Py_DECREF(v);
@@ -1655,13 +1655,13 @@
             Py_INCREF(locals);
             STACK_GROW(1);
             stack_pointer[-1] = locals;
-            DISPATCH();
+            DISPATCH_TOS(locals);
         }
 
         TARGET(LOAD_FROM_DICT_OR_GLOBALS) {
             PyObject *mod_or_class_dict;
             PyObject *v;
-            mod_or_class_dict = stack_pointer[-1];
+            mod_or_class_dict = TOS_CACHE();
             PyObject *name = GETITEM(FRAME_CO_NAMES, oparg);
             if (PyMapping_GetOptionalItem(mod_or_class_dict, name, &v) < 0) {
                 goto error;
@@ -1688,7 +1688,7 @@
             }
             Py_DECREF(mod_or_class_dict);
             stack_pointer[-1] = v;
-            DISPATCH();
+            DISPATCH_TOS(v);
         }
 
         TARGET(LOAD_NAME) {
@@ -1725,7 +1725,7 @@
             }
             STACK_GROW(1);
             stack_pointer[-1] = v;
-            DISPATCH();
+            DISPATCH_TOS(v);
         }
 
         TARGET(LOAD_GLOBAL) {
@@ -1891,7 +1891,7 @@
         TARGET(LOAD_FROM_DICT_OR_DEREF) {
             PyObject *class_dict;
             PyObject *value;
-            class_dict = stack_pointer[-1];
+            class_dict = TOS_CACHE();
             PyObject *name;
             assert(class_dict);
             assert(oparg >= 0 && oparg < _PyFrame_GetCode(frame)->co_nlocalsplus);
@@ -1911,7 +1911,7 @@
                 Py_INCREF(value);
             }
             stack_pointer[-1] = value;
-            DISPATCH();
+            DISPATCH_TOS(value);
         }
 
         TARGET(LOAD_DEREF) {
@@ -1925,12 +1925,12 @@
             Py_INCREF(value);
             STACK_GROW(1);
             stack_pointer[-1] = value;
-            DISPATCH();
+            DISPATCH_TOS(value);
         }
 
         TARGET(STORE_DEREF) {
             PyObject *v;
-            v = stack_pointer[-1];
+            v = TOS_CACHE();
             PyObject *cell = GETLOCAL(oparg);
             PyObject *oldobj = PyCell_GET(cell);
             PyCell_SET(cell, v);
@@ -1965,7 +1965,7 @@
             STACK_SHRINK(oparg);
             STACK_GROW(1);
             stack_pointer[-1] = str;
-            DISPATCH();
+            DISPATCH_TOS(str);
         }
 
         TARGET(BUILD_TUPLE) {
@@ -1977,7 +1977,7 @@
             STACK_SHRINK(oparg);
             STACK_GROW(1);
             stack_pointer[-1] = tup;
-            DISPATCH();
+            DISPATCH_TOS(tup);
         }
 
         TARGET(BUILD_LIST) {
@@ -1989,13 +1989,13 @@
             STACK_SHRINK(oparg);
             STACK_GROW(1);
             stack_pointer[-1] = list;
-            DISPATCH();
+            DISPATCH_TOS(list);
         }
 
         TARGET(LIST_EXTEND) {
             PyObject *iterable;
             PyObject *list;
-            iterable = stack_pointer[-1];
+            iterable = TOS_CACHE();
             list = stack_pointer[-2 - (oparg-1)];
             PyObject *none_val = _PyList_Extend((PyListObject *)list, iterable);
             if (none_val == NULL) {
@@ -2019,7 +2019,7 @@
         TARGET(SET_UPDATE) {
             PyObject *iterable;
             PyObject *set;
-            iterable = stack_pointer[-1];
+            iterable = TOS_CACHE();
             set = stack_pointer[-2 - (oparg-1)];
             int err = _PySet_Update(set, iterable);
             Py_DECREF(iterable);
@@ -2049,7 +2049,7 @@
             STACK_SHRINK(oparg);
             STACK_GROW(1);
             stack_pointer[-1] = set;
-            DISPATCH();
+            DISPATCH_TOS(set);
         }
 
         TARGET(BUILD_MAP) {
@@ -2067,7 +2067,7 @@
             STACK_SHRINK(oparg*2);
             STACK_GROW(1);
             stack_pointer[-1] = map;
-            DISPATCH();
+            DISPATCH_TOS(map);
         }
 
         TARGET(SETUP_ANNOTATIONS) {
@@ -2115,7 +2115,7 @@
             PyObject *keys;
             PyObject **values;
             PyObject *map;
-            keys = stack_pointer[-1];
+            keys = TOS_CACHE();
             values = stack_pointer - 1 - oparg;
             if (!PyTuple_CheckExact(keys) ||
                 PyTuple_GET_SIZE(keys) != (Py_ssize_t)oparg) {
@@ -2133,13 +2133,13 @@
             if (map == NULL) { STACK_SHRINK(oparg); goto pop_1_error; }
             STACK_SHRINK(oparg);
             stack_pointer[-1] = map;
-            DISPATCH();
+            DISPATCH_TOS(map);
         }
 
         TARGET(DICT_UPDATE) {
             PyObject *update;
             PyObject *dict;
-            update = stack_pointer[-1];
+            update = TOS_CACHE();
             dict = stack_pointer[-2 - (oparg - 1)];
             if (PyDict_Update(dict, update) < 0) {
                 if (_PyErr_ExceptionMatches(tstate, PyExc_AttributeError)) {
@@ -2159,7 +2159,7 @@
             PyObject *update;
             PyObject *dict;
             PyObject *callable;
-            update = stack_pointer[-1];
+            update = TOS_CACHE();
             dict = stack_pointer[-2 - (oparg - 1)];
             callable = stack_pointer[-5 - (oparg - 1)];
             if (_PyDict_MergeEx(dict, update, 2) < 0) {
@@ -2176,7 +2176,7 @@
             PyObject *value;
             PyObject *key;
             PyObject *dict;
-            value = stack_pointer[-1];
+            value = TOS_CACHE();
             key = stack_pointer[-2];
             dict = stack_pointer[-3 - (oparg - 1)];
             assert(PyDict_CheckExact(dict));
@@ -2203,7 +2203,7 @@
             PyObject *global_super;
             PyObject *attr;
             PyObject *null = NULL;
-            self = stack_pointer[-1];
+            self = TOS_CACHE();
             class = stack_pointer[-2];
             global_super = stack_pointer[-3];
             PyObject *name = GETITEM(FRAME_CO_NAMES, oparg >> 2);
@@ -2268,7 +2268,7 @@
             PyObject *class;
             PyObject *global_super;
             PyObject *attr;
-            self = stack_pointer[-1];
+            self = TOS_CACHE();
             class = stack_pointer[-2];
             global_super = stack_pointer[-3];
             assert(!(oparg & 1));
@@ -2284,7 +2284,7 @@
             STACK_SHRINK(2);
             stack_pointer[-1] = attr;
             next_instr += 1;
-            DISPATCH();
+            DISPATCH_TOS(attr);
         }
 
         TARGET(LOAD_SUPER_ATTR_METHOD) {
@@ -2293,7 +2293,7 @@
             PyObject *global_super;
             PyObject *attr;
             PyObject *self_or_null;
-            self = stack_pointer[-1];
+            self = TOS_CACHE();
             class = stack_pointer[-2];
             global_super = stack_pointer[-3];
             assert(oparg & 1);
@@ -2321,7 +2321,7 @@
             stack_pointer[-2] = attr;
             stack_pointer[-1] = self_or_null;
             next_instr += 1;
-            DISPATCH();
+            DISPATCH_TOS(self_or_null);
         }
 
         TARGET(LOAD_ATTR) {
@@ -2330,7 +2330,7 @@
             PyObject *owner;
             PyObject *attr;
             PyObject *self_or_null = NULL;
-            owner = stack_pointer[-1];
+            owner = TOS_CACHE();
             #if ENABLE_SPECIALIZATION
             _PyAttrCache *cache = (_PyAttrCache *)next_instr;
             if (ADAPTIVE_COUNTER_IS_ZERO(cache->counter)) {
@@ -2386,7 +2386,7 @@
             PyObject *attr;
             PyObject *null = NULL;
             // _GUARD_TYPE_VERSION
-            owner = stack_pointer[-1];
+            owner = TOS_CACHE();
             {
                 uint32_t type_version = read_u32(&next_instr[1].cache);
                 PyTypeObject *tp = Py_TYPE(owner);
@@ -2423,7 +2423,7 @@
             PyObject *attr;
             PyObject *null = NULL;
             // _CHECK_ATTR_MODULE
-            owner = stack_pointer[-1];
+            owner = TOS_CACHE();
             {
                 uint32_t type_version = read_u32(&next_instr[1].cache);
                 DEOPT_IF(!PyModule_CheckExact(owner), LOAD_ATTR);
@@ -2457,7 +2457,7 @@
             PyObject *attr;
             PyObject *null = NULL;
             // _GUARD_TYPE_VERSION
-            owner = stack_pointer[-1];
+            owner = TOS_CACHE();
             {
                 uint32_t type_version = read_u32(&next_instr[1].cache);
                 PyTypeObject *tp = Py_TYPE(owner);
@@ -2508,7 +2508,7 @@
             PyObject *attr;
             PyObject *null = NULL;
             // _GUARD_TYPE_VERSION
-            owner = stack_pointer[-1];
+            owner = TOS_CACHE();
             {
                 uint32_t type_version = read_u32(&next_instr[1].cache);
                 PyTypeObject *tp = Py_TYPE(owner);
@@ -2538,7 +2538,7 @@
             PyObject *attr;
             PyObject *null = NULL;
             // _CHECK_ATTR_CLASS
-            owner = stack_pointer[-1];
+            owner = TOS_CACHE();
             {
                 uint32_t type_version = read_u32(&next_instr[1].cache);
                 DEOPT_IF(!PyType_Check(owner), LOAD_ATTR);
@@ -2563,7 +2563,7 @@
 
         TARGET(LOAD_ATTR_PROPERTY) {
             PyObject *owner;
-            owner = stack_pointer[-1];
+            owner = TOS_CACHE();
             uint32_t type_version = read_u32(&next_instr[1].cache);
             uint32_t func_version = read_u32(&next_instr[3].cache);
             PyObject *fget = read_obj(&next_instr[5].cache);
@@ -2594,7 +2594,7 @@
 
         TARGET(LOAD_ATTR_GETATTRIBUTE_OVERRIDDEN) {
             PyObject *owner;
-            owner = stack_pointer[-1];
+            owner = TOS_CACHE();
             uint32_t type_version = read_u32(&next_instr[1].cache);
             uint32_t func_version = read_u32(&next_instr[3].cache);
             PyObject *getattribute = read_obj(&next_instr[5].cache);
@@ -2629,7 +2629,7 @@
             PyObject *owner;
             PyObject *value;
             // _GUARD_TYPE_VERSION
-            owner = stack_pointer[-1];
+            owner = TOS_CACHE();
             {
                 uint32_t type_version = read_u32(&next_instr[1].cache);
                 PyTypeObject *tp = Py_TYPE(owner);
@@ -2667,7 +2667,7 @@
         TARGET(STORE_ATTR_WITH_HINT) {
             PyObject *owner;
             PyObject *value;
-            owner = stack_pointer[-1];
+            owner = TOS_CACHE();
             value = stack_pointer[-2];
             uint32_t type_version = read_u32(&next_instr[1].cache);
             uint16_t hint = read_u16(&next_instr[3].cache);
@@ -2718,7 +2718,7 @@
             PyObject *owner;
             PyObject *value;
             // _GUARD_TYPE_VERSION
-            owner = stack_pointer[-1];
+            owner = TOS_CACHE();
             {
                 uint32_t type_version = read_u32(&next_instr[1].cache);
                 PyTypeObject *tp = Py_TYPE(owner);
@@ -2747,7 +2747,7 @@
             PyObject *right;
             PyObject *left;
             PyObject *res;
-            right = stack_pointer[-1];
+            right = TOS_CACHE();
             left = stack_pointer[-2];
             #if ENABLE_SPECIALIZATION
             _PyCompareOpCache *cache = (_PyCompareOpCache *)next_instr;
@@ -2773,14 +2773,14 @@
             STACK_SHRINK(1);
             stack_pointer[-1] = res;
             next_instr += 1;
-            DISPATCH();
+            DISPATCH_TOS(res);
         }
 
         TARGET(COMPARE_OP_FLOAT) {
             PyObject *right;
             PyObject *left;
             PyObject *res;
-            right = stack_pointer[-1];
+            right = TOS_CACHE();
             left = stack_pointer[-2];
             DEOPT_IF(!PyFloat_CheckExact(left), COMPARE_OP);
             DEOPT_IF(!PyFloat_CheckExact(right), COMPARE_OP);
@@ -2796,14 +2796,14 @@
             STACK_SHRINK(1);
             stack_pointer[-1] = res;
             next_instr += 1;
-            DISPATCH();
+            DISPATCH_TOS(res);
         }
 
         TARGET(COMPARE_OP_INT) {
             PyObject *right;
             PyObject *left;
             PyObject *res;
-            right = stack_pointer[-1];
+            right = TOS_CACHE();
             left = stack_pointer[-2];
             DEOPT_IF(!PyLong_CheckExact(left), COMPARE_OP);
             DEOPT_IF(!PyLong_CheckExact(right), COMPARE_OP);
@@ -2823,14 +2823,14 @@
             STACK_SHRINK(1);
             stack_pointer[-1] = res;
             next_instr += 1;
-            DISPATCH();
+            DISPATCH_TOS(res);
         }
 
         TARGET(COMPARE_OP_STR) {
             PyObject *right;
             PyObject *left;
             PyObject *res;
-            right = stack_pointer[-1];
+            right = TOS_CACHE();
             left = stack_pointer[-2];
             DEOPT_IF(!PyUnicode_CheckExact(left), COMPARE_OP);
             DEOPT_IF(!PyUnicode_CheckExact(right), COMPARE_OP);
@@ -2847,14 +2847,14 @@
             STACK_SHRINK(1);
             stack_pointer[-1] = res;
             next_instr += 1;
-            DISPATCH();
+            DISPATCH_TOS(res);
         }
 
         TARGET(IS_OP) {
             PyObject *right;
             PyObject *left;
             PyObject *b;
-            right = stack_pointer[-1];
+            right = TOS_CACHE();
             left = stack_pointer[-2];
             int res = Py_Is(left, right) ^ oparg;
             Py_DECREF(left);
@@ -2862,15 +2862,27 @@
             b = res ? Py_True : Py_False;
             STACK_SHRINK(1);
             stack_pointer[-1] = b;
-            DISPATCH();
+            DISPATCH_TOS(b);
         }
 
         TARGET(CONTAINS_OP) {
+            PREDICTED(CONTAINS_OP);
+            static_assert(INLINE_CACHE_ENTRIES_CONTAINS_OP == 1, "incorrect cache size");
             PyObject *right;
             PyObject *left;
             PyObject *b;
-            right = stack_pointer[-1];
+            right = TOS_CACHE();
             left = stack_pointer[-2];
+            #if ENABLE_SPECIALIZATION
+            _PyContainsOpCache *cache = (_PyContainsOpCache *)next_instr;
+            if (ADAPTIVE_COUNTER_IS_ZERO(cache->counter)) {
+                next_instr--;
+                _Py_Specialize_ContainsOp(left, right, next_instr);
+                DISPATCH_SAME_OPARG();
+            }
+            STAT_INC(CONTAINS_OP, deferred);
+            DECREMENT_ADAPTIVE_COUNTER(cache->counter);
+            #endif  /* ENABLE_SPECIALIZATION */
             int res = PySequence_Contains(right, left);
             Py_DECREF(left);
             Py_DECREF(right);
@@ -2878,7 +2890,105 @@
             b = (res ^ oparg) ? Py_True : Py_False;
             STACK_SHRINK(1);
             stack_pointer[-1] = b;
-            DISPATCH();
+            next_instr += 1;
+            DISPATCH_TOS(b);
+        }
+
+        TARGET(CONTAINS_OP_DICT) {
+            PyObject *right;
+            PyObject *left;
+            PyObject *b;
+            right = TOS_CACHE();
+            left = stack_pointer[-2];
+            DEOPT_IF(!PyDict_CheckExact(right), CONTAINS_OP);
+            STAT_INC(CONTAINS_OP, hit);
+            int res = PyDict_Contains(right, left);
+            Py_DECREF(left);
+            Py_DECREF(right);
+            if (res < 0) goto pop_2_error;
+            b = (res ^ oparg) ? Py_True : Py_False;
+            STACK_SHRINK(1);
+            stack_pointer[-1] = b;
+            next_instr += 1;
+            DISPATCH_TOS(b);
+        }
+
+        TARGET(CONTAINS_OP_SET) {
+            PyObject *right;
+            PyObject *left;
+            PyObject *b;
+            right = TOS_CACHE();
+            left = stack_pointer[-2];
+            DEOPT_IF(!(PySet_CheckExact(right) || PyFrozenSet_CheckExact(right)), CONTAINS_OP);
+            STAT_INC(CONTAINS_OP, hit);
+            // Note: both set and frozenset use the same seq_contains method!
+            int res = _PySet_Contains((PySetObject *)right, left);
+            Py_DECREF(left);
+            Py_DECREF(right);
+            if (res < 0) goto pop_2_error;
+            b = (res ^ oparg) ? Py_True : Py_False;
+            STACK_SHRINK(1);
+            stack_pointer[-1] = b;
+            next_instr += 1;
+            DISPATCH_TOS(b);
+        }
+
+        TARGET(CONTAINS_OP_STR) {
+            PyObject *right;
+            PyObject *left;
+            PyObject *b;
+            right = TOS_CACHE();
+            left = stack_pointer[-2];
+            DEOPT_IF(!PyUnicode_CheckExact(left), CONTAINS_OP);
+            DEOPT_IF(!PyUnicode_CheckExact(right), CONTAINS_OP);
+            STAT_INC(CONTAINS_OP, hit);
+            int res = PyUnicode_Contains(right, left);
+            Py_DECREF(left);
+            Py_DECREF(right);
+            if (res < 0) goto pop_2_error;
+            b = (res ^ oparg) ? Py_True : Py_False;
+            STACK_SHRINK(1);
+            stack_pointer[-1] = b;
+            next_instr += 1;
+            DISPATCH_TOS(b);
+        }
+
+        TARGET(CONTAINS_OP_TUPLE) {
+            PyObject *right;
+            PyObject *left;
+            PyObject *b;
+            right = TOS_CACHE();
+            left = stack_pointer[-2];
+            DEOPT_IF(!PyTuple_CheckExact(right), CONTAINS_OP);
+            STAT_INC(CONTAINS_OP, hit);
+            int res = _PyTuple_Contains((PyTupleObject *)right, left);
+            Py_DECREF(left);
+            Py_DECREF(right);
+            if (res < 0) goto pop_2_error;
+            b = (res ^ oparg) ? Py_True : Py_False;
+            STACK_SHRINK(1);
+            stack_pointer[-1] = b;
+            next_instr += 1;
+            DISPATCH_TOS(b);
+        }
+
+        TARGET(CONTAINS_OP_LIST) {
+            PyObject *right;
+            PyObject *left;
+            PyObject *b;
+            right = TOS_CACHE();
+            left = stack_pointer[-2];
+            DEOPT_IF(!PyList_CheckExact(right), CONTAINS_OP);
+            STAT_INC(CONTAINS_OP, hit);
+            int res = _PyList_Contains((PyListObject *)right, left);
+            Py_DECREF(left);
+            Py_DECREF(right);
+            if (res < 0) goto pop_2_error;
+            b = (res ^ oparg) ? Py_True : Py_False;
+            STACK_SHRINK(1);
+            stack_pointer[-1] = b;
+            next_instr += 1;
+            DISPATCH_TOS(b);
         }
 
         TARGET(CHECK_EG_MATCH) {
@@ -2886,7 +2996,7 @@
             PyObject *exc_value;
             PyObject *rest;
             PyObject *match;
-            match_type = stack_pointer[-1];
+            match_type = TOS_CACHE();
             exc_value = stack_pointer[-2];
             if (_PyEval_CheckExceptStarTypeValid(tstate, match_type) < 0) {
                 Py_DECREF(exc_value);
@@ -2910,14 +3020,14 @@
             }
             stack_pointer[-2] = rest;
             stack_pointer[-1] = match;
-            DISPATCH();
+            DISPATCH_TOS(match);
         }
 
         TARGET(CHECK_EXC_MATCH) {
             PyObject *right;
             PyObject *left;
             PyObject *b;
-            right = stack_pointer[-1];
+            right = TOS_CACHE();
             left = stack_pointer[-2];
             assert(PyExceptionInstance_Check(left));
             if (_PyEval_CheckExceptTypeValid(tstate, right) < 0) {
@@ -2929,14 +3039,14 @@
             Py_DECREF(right);
             b = res ? Py_True : Py_False;
             stack_pointer[-1] = b;
-            DISPATCH();
+            DISPATCH_TOS(b);
         }
 
         TARGET(IMPORT_NAME) {
             PyObject *fromlist;
             PyObject *level;
             PyObject *res;
-            fromlist = stack_pointer[-1];
+            fromlist = TOS_CACHE();
             level = stack_pointer[-2];
             PyObject *name = GETITEM(FRAME_CO_NAMES, oparg);
             res = import_name(tstate, frame, name, fromlist, level);
@@ -2945,19 +3055,19 @@
             if (res == NULL) goto pop_2_error;
             STACK_SHRINK(1);
             stack_pointer[-1] = res;
-            DISPATCH();
+            DISPATCH_TOS(res);
         }
 
         TARGET(IMPORT_FROM) {
             PyObject *from;
             PyObject *res;
-            from = stack_pointer[-1];
+            from = TOS_CACHE();
             PyObject *name = GETITEM(FRAME_CO_NAMES, oparg);
             res = import_from(tstate, from, name);
             if (res == NULL) goto error;
             STACK_GROW(1);
             stack_pointer[-1] = res;
-            DISPATCH();
+            DISPATCH_TOS(res);
         }
 
         TARGET(JUMP_FORWARD) {
@@ -3010,7 +3120,7 @@
 
         TARGET(POP_JUMP_IF_FALSE) {
             PyObject *cond;
-            cond = stack_pointer[-1];
+            cond = TOS_CACHE();
             assert(PyBool_Check(cond));
             int flag = Py_IsFalse(cond);
             #if ENABLE_SPECIALIZATION
@@ -3024,7 +3134,7 @@
 
         TARGET(POP_JUMP_IF_TRUE) {
             PyObject *cond;
-            cond = stack_pointer[-1];
+            cond = TOS_CACHE();
             assert(PyBool_Check(cond));
             int flag = Py_IsTrue(cond);
             #if ENABLE_SPECIALIZATION
@@ -3041,7 +3151,7 @@
             PyObject *b;
             PyObject *cond;
             // _IS_NONE
-            value = stack_pointer[-1];
+            value = TOS_CACHE();
             {
                 if (Py_IsNone(value)) {
                     b = Py_True;
@@ -3071,7 +3181,7 @@
             PyObject *b;
             PyObject *cond;
             // _IS_NONE
-            value = stack_pointer[-1];
+            value = TOS_CACHE();
             {
                 if (Py_IsNone(value)) {
                     b = Py_True;
@@ -3109,7 +3219,7 @@
         TARGET(GET_LEN) {
             PyObject *obj;
             PyObject *len_o;
-            obj = stack_pointer[-1];
+            obj = TOS_CACHE();
             // PUSH(len(TOS))
             Py_ssize_t len_i = PyObject_Length(obj);
             if (len_i < 0) goto error;
@@ -3117,7 +3227,7 @@
             if (len_o == NULL) goto error;
             STACK_GROW(1);
             stack_pointer[-1] = len_o;
-            DISPATCH();
+            DISPATCH_TOS(len_o);
         }
 
         TARGET(MATCH_CLASS) {
@@ -3125,7 +3235,7 @@
             PyObject *type;
             PyObject *subject;
             PyObject *attrs;
-            names = stack_pointer[-1];
+            names = TOS_CACHE();
             type = stack_pointer[-2];
             subject = stack_pointer[-3];
             // Pop TOS and TOS1. Set TOS to a tuple of attributes on success, or
@@ -3144,61 +3254,61 @@
             }
             STACK_SHRINK(2);
             stack_pointer[-1] = attrs;
-            DISPATCH();
+            DISPATCH_TOS(attrs);
         }
 
         TARGET(MATCH_MAPPING) {
             PyObject *subject;
             PyObject *res;
-            subject = stack_pointer[-1];
+            subject = TOS_CACHE();
             int match = Py_TYPE(subject)->tp_flags & Py_TPFLAGS_MAPPING;
             res = match ? Py_True : Py_False;
             STACK_GROW(1);
             stack_pointer[-1] = res;
-            DISPATCH();
+            DISPATCH_TOS(res);
         }
 
         TARGET(MATCH_SEQUENCE) {
             PyObject *subject;
             PyObject *res;
-            subject = stack_pointer[-1];
+            subject = TOS_CACHE();
             int match = Py_TYPE(subject)->tp_flags & Py_TPFLAGS_SEQUENCE;
             res = match ? Py_True : Py_False;
             STACK_GROW(1);
             stack_pointer[-1] = res;
-            DISPATCH();
+            DISPATCH_TOS(res);
         }
 
         TARGET(MATCH_KEYS) {
             PyObject *keys;
             PyObject *subject;
             PyObject *values_or_none;
-            keys = stack_pointer[-1];
+            keys = TOS_CACHE();
             subject = stack_pointer[-2];
             // On successful match, PUSH(values). Otherwise, PUSH(None).
             values_or_none = _PyEval_MatchKeys(tstate, subject, keys);
             if (values_or_none == NULL) goto error;
             STACK_GROW(1);
             stack_pointer[-1] = values_or_none;
-            DISPATCH();
+            DISPATCH_TOS(values_or_none);
         }
 
         TARGET(GET_ITER) {
             PyObject *iterable;
             PyObject *iter;
-            iterable = stack_pointer[-1];
+            iterable = TOS_CACHE();
             /* before: [obj]; after [getiter(obj)] */
             iter = PyObject_GetIter(iterable);
             Py_DECREF(iterable);
             if (iter == NULL) goto pop_1_error;
             stack_pointer[-1] = iter;
-            DISPATCH();
+            DISPATCH_TOS(iter);
         }
 
         TARGET(GET_YIELD_FROM_ITER) {
             PyObject *iterable;
             PyObject *iter;
-            iterable = stack_pointer[-1];
+            iterable = TOS_CACHE();
             /* before: [obj]; after [getiter(obj)] */
             if (PyCoro_CheckExact(iterable)) {
                 /* `iterable` is a coroutine */
@@ -3224,7 +3334,7 @@
                 Py_DECREF(iterable);
             }
             stack_pointer[-1] = iter;
-            DISPATCH();
+            DISPATCH_TOS(iter);
         }
 
         TARGET(FOR_ITER) {
@@ -3232,7 +3342,7 @@
             static_assert(INLINE_CACHE_ENTRIES_FOR_ITER == 1, "incorrect cache size");
             PyObject *iter;
             PyObject *next;
-            iter = stack_pointer[-1];
+            iter = TOS_CACHE();
             #if ENABLE_SPECIALIZATION
             _PyForIterCache *cache = (_PyForIterCache *)next_instr;
             if (ADAPTIVE_COUNTER_IS_ZERO(cache->counter)) {
@@ -3267,7 +3377,7 @@
             STACK_GROW(1);
             stack_pointer[-1] = next;
             next_instr += 1;
-            DISPATCH();
+            DISPATCH_TOS(next);
         }
 
         TARGET(INSTRUMENTED_FOR_ITER) {
@@ -3303,7 +3413,7 @@
             PyObject *iter;
             PyObject *next;
             // _ITER_CHECK_LIST
-            iter = stack_pointer[-1];
+            iter = TOS_CACHE();
             {
                 DEOPT_IF(Py_TYPE(iter) != &PyListIter_Type, FOR_ITER);
             }
@@ -3338,14 +3448,14 @@
             STACK_GROW(1);
             stack_pointer[-1] = next;
             next_instr += 1;
-            DISPATCH();
+            DISPATCH_TOS(next);
         }
 
         TARGET(FOR_ITER_TUPLE) {
             PyObject *iter;
             PyObject *next;
             // _ITER_CHECK_TUPLE
-            iter = stack_pointer[-1];
+            iter = TOS_CACHE();
             {
                 DEOPT_IF(Py_TYPE(iter) != &PyTupleIter_Type, FOR_ITER);
             }
@@ -3380,14 +3490,14 @@
             STACK_GROW(1);
             stack_pointer[-1] = next;
             next_instr += 1;
-            DISPATCH();
+            DISPATCH_TOS(next);
         }
 
         TARGET(FOR_ITER_RANGE) {
             PyObject *iter;
             PyObject *next;
             // _ITER_CHECK_RANGE
-            iter = stack_pointer[-1];
+            iter = TOS_CACHE();
             {
                 _PyRangeIterObject *r = (_PyRangeIterObject *)iter;
                 DEOPT_IF(Py_TYPE(r) != &PyRangeIter_Type, FOR_ITER);
@@ -3420,12 +3530,12 @@
             STACK_GROW(1);
             stack_pointer[-1] = next;
             next_instr += 1;
-            DISPATCH();
+            DISPATCH_TOS(next);
         }
 
         TARGET(FOR_ITER_GEN) {
             PyObject *iter;
-            iter = stack_pointer[-1];
+            iter = TOS_CACHE();
             DEOPT_IF(tstate->interp->eval_frame, FOR_ITER);
             PyGenObject *gen = (PyGenObject *)iter;
             DEOPT_IF(Py_TYPE(gen) != &PyGen_Type, FOR_ITER);
@@ -3448,7 +3558,7 @@
             PyObject *mgr;
             PyObject *exit;
             PyObject *res;
-            mgr = stack_pointer[-1];
+            mgr = TOS_CACHE();
             PyObject *enter = _PyObject_LookupSpecial(mgr, &_Py_ID(__aenter__));
             if (enter == NULL) {
                 if (!_PyErr_Occurred(tstate)) {
@@ -3481,14 +3591,14 @@
             STACK_GROW(1);
             stack_pointer[-2] = exit;
             stack_pointer[-1] = res;
-            DISPATCH();
+            DISPATCH_TOS(res);
         }
 
         TARGET(BEFORE_WITH) {
             PyObject *mgr;
             PyObject *exit;
             PyObject *res;
-            mgr = stack_pointer[-1];
+            mgr = TOS_CACHE();
             /* pop the context manager, push its __exit__ and the
              * value returned from calling its __enter__
              */
@@ -3524,7 +3634,7 @@
             STACK_GROW(1);
             stack_pointer[-2] = exit;
             stack_pointer[-1] = res;
-            DISPATCH();
+            DISPATCH_TOS(res);
         }
 
         TARGET(WITH_EXCEPT_START) {
@@ -3532,7 +3642,7 @@
             PyObject *lasti;
             PyObject *exit_func;
             PyObject *res;
-            val = stack_pointer[-1];
+            val = TOS_CACHE();
             lasti = stack_pointer[-3];
             exit_func = stack_pointer[-4];
             /* At the top of the stack are 4 values:
@@ -3562,13 +3672,13 @@
             if (res == NULL) goto error;
             STACK_GROW(1);
             stack_pointer[-1] = res;
-            DISPATCH();
+            DISPATCH_TOS(res);
         }
 
         TARGET(PUSH_EXC_INFO) {
             PyObject *new_exc;
             PyObject *prev_exc;
-            new_exc = stack_pointer[-1];
+            new_exc = TOS_CACHE();
             _PyErr_StackItem *exc_info = tstate->exc_info;
             if (exc_info->exc_value != NULL) {
                 prev_exc = exc_info->exc_value;
@@ -3581,7 +3691,7 @@
             STACK_GROW(1);
             stack_pointer[-2] = prev_exc;
             stack_pointer[-1] = new_exc;
-            DISPATCH();
+            DISPATCH_TOS(new_exc);
         }
 
         TARGET(LOAD_ATTR_METHOD_WITH_VALUES) {
@@ -3589,7 +3699,7 @@
             PyObject *attr;
             PyObject *self;
             // _GUARD_TYPE_VERSION
-            owner = stack_pointer[-1];
+            owner = TOS_CACHE();
             {
                 uint32_t type_version = read_u32(&next_instr[1].cache);
                 PyTypeObject *tp = Py_TYPE(owner);
@@ -3624,7 +3734,7 @@
             stack_pointer[-2] = attr;
             stack_pointer[-1] = self;
             next_instr += 9;
-            DISPATCH();
+            DISPATCH_TOS(self);
         }
 
         TARGET(LOAD_ATTR_METHOD_NO_DICT) {
@@ -3632,7 +3742,7 @@
             PyObject *attr;
             PyObject *self;
             // _GUARD_TYPE_VERSION
-            owner = stack_pointer[-1];
+            owner = TOS_CACHE();
             {
                 uint32_t type_version = read_u32(&next_instr[1].cache);
                 PyTypeObject *tp = Py_TYPE(owner);
@@ -3654,14 +3764,14 @@
             stack_pointer[-2] = attr;
             stack_pointer[-1] = self;
             next_instr += 9;
-            DISPATCH();
+            DISPATCH_TOS(self);
         }
 
         TARGET(LOAD_ATTR_NONDESCRIPTOR_WITH_VALUES) {
             PyObject *owner;
             PyObject *attr;
             // _GUARD_TYPE_VERSION
-            owner = stack_pointer[-1];
+            owner = TOS_CACHE();
             {
                 uint32_t type_version = read_u32(&next_instr[1].cache);
                 PyTypeObject *tp = Py_TYPE(owner);
@@ -3692,14 +3802,14 @@
             }
             stack_pointer[-1] = attr;
             next_instr += 9;
-            DISPATCH();
+            DISPATCH_TOS(attr);
         }
 
         TARGET(LOAD_ATTR_NONDESCRIPTOR_NO_DICT) {
             PyObject *owner;
             PyObject *attr;
             // _GUARD_TYPE_VERSION
-            owner = stack_pointer[-1];
+            owner = TOS_CACHE();
             {
                 uint32_t type_version = read_u32(&next_instr[1].cache);
                 PyTypeObject *tp = Py_TYPE(owner);
@@ -3718,7 +3828,7 @@
             }
             stack_pointer[-1] = attr;
             next_instr += 9;
-            DISPATCH();
+            DISPATCH_TOS(attr);
         }
 
         TARGET(LOAD_ATTR_METHOD_LAZY_DICT) {
@@ -3726,7 +3836,7 @@
             PyObject *attr;
             PyObject *self;
             // _GUARD_TYPE_VERSION
-            owner = stack_pointer[-1];
+            owner = TOS_CACHE();
             {
                 uint32_t type_version = read_u32(&next_instr[1].cache);
                 PyTypeObject *tp = Py_TYPE(owner);
@@ -3755,7 +3865,7 @@
             stack_pointer[-2] = attr;
             stack_pointer[-1] = self;
             next_instr += 9;
-            DISPATCH();
+            DISPATCH_TOS(self);
         }
 
         TARGET(INSTRUMENTED_CALL) {
@@ -3865,7 +3975,7 @@
             stack_pointer[-1] = res;
             next_instr += 3;
             CHECK_EVAL_BREAKER();
-            DISPATCH();
+            DISPATCH_TOS(res);
         }
 
         TARGET(CALL_BOUND_METHOD_EXACT_ARGS) {
@@ -4102,7 +4212,7 @@
             STACK_SHRINK(1);
             stack_pointer[-1] = res;
             next_instr += 3;
-            DISPATCH();
+            DISPATCH_TOS(res);
         }
 
         TARGET(CALL_STR_1) {
@@ -4127,7 +4237,7 @@
             stack_pointer[-1] = res;
             next_instr += 3;
             CHECK_EVAL_BREAKER();
-            DISPATCH();
+            DISPATCH_TOS(res);
         }
 
         TARGET(CALL_TUPLE_1) {
@@ -4152,7 +4262,7 @@
             stack_pointer[-1] = res;
             next_instr += 3;
             CHECK_EVAL_BREAKER();
-            DISPATCH();
+            DISPATCH_TOS(res);
         }
 
         TARGET(CALL_ALLOC_AND_ENTER_INIT) {
@@ -4215,7 +4325,7 @@
 
         TARGET(EXIT_INIT_CHECK) {
             PyObject *should_be_none;
-            should_be_none = stack_pointer[-1];
+            should_be_none = TOS_CACHE();
             assert(STACK_LEVEL() == 2);
             if (should_be_none != Py_None) {
                 PyErr_Format(PyExc_TypeError,
@@ -4256,7 +4366,7 @@
             stack_pointer[-1] = res;
             next_instr += 3;
             CHECK_EVAL_BREAKER();
-            DISPATCH();
+            DISPATCH_TOS(res);
         }
 
         TARGET(CALL_BUILTIN_O) {
@@ -4296,7 +4406,7 @@
             stack_pointer[-1] = res;
             next_instr += 3;
             CHECK_EVAL_BREAKER();
-            DISPATCH();
+            DISPATCH_TOS(res);
         }
 
         TARGET(CALL_BUILTIN_FAST) {
@@ -4340,7 +4450,7 @@
             stack_pointer[-1] = res;
             next_instr += 3;
             CHECK_EVAL_BREAKER();
-            DISPATCH();
+            DISPATCH_TOS(res);
         }
 
         TARGET(CALL_BUILTIN_FAST_WITH_KEYWORDS) {
@@ -4378,7 +4488,7 @@
             stack_pointer[-1] = res;
             next_instr += 3;
             CHECK_EVAL_BREAKER();
-            DISPATCH();
+            DISPATCH_TOS(res);
         }
 
         TARGET(CALL_LEN) {
@@ -4414,7 +4524,7 @@
             STACK_SHRINK(1);
             stack_pointer[-1] = res;
             next_instr += 3;
-            DISPATCH();
+            DISPATCH_TOS(res);
         }
 
         TARGET(CALL_ISINSTANCE) {
@@ -4452,7 +4562,7 @@
             STACK_SHRINK(1);
             stack_pointer[-1] = res;
             next_instr += 3;
-            DISPATCH();
+            DISPATCH_TOS(res);
         }
 
         TARGET(CALL_LIST_APPEND) {
@@ -4520,7 +4630,7 @@
             stack_pointer[-1] = res;
             next_instr += 3;
             CHECK_EVAL_BREAKER();
-            DISPATCH();
+            DISPATCH_TOS(res);
         }
 
         TARGET(CALL_METHOD_DESCRIPTOR_FAST_WITH_KEYWORDS) {
@@ -4561,7 +4671,7 @@
             stack_pointer[-1] = res;
             next_instr += 3;
             CHECK_EVAL_BREAKER();
-            DISPATCH();
+            DISPATCH_TOS(res);
         }
 
         TARGET(CALL_METHOD_DESCRIPTOR_NOARGS) {
@@ -4603,7 +4713,7 @@
             stack_pointer[-1] = res;
             next_instr += 3;
             CHECK_EVAL_BREAKER();
-            DISPATCH();
+            DISPATCH_TOS(res);
         }
 
         TARGET(CALL_METHOD_DESCRIPTOR_FAST) {
@@ -4643,7 +4753,7 @@
             stack_pointer[-1] = res;
             next_instr += 3;
             CHECK_EVAL_BREAKER();
-            DISPATCH();
+            DISPATCH_TOS(res);
         }
 
         TARGET(INSTRUMENTED_CALL_KW) {
@@ -4656,17 +4766,20 @@
                     tstate, PY_MONITORING_EVENT_CALL,
                     frame, next_instr - 1, function, arg);
             if (err) goto error;
+            _PyCallCache *cache = (_PyCallCache *)next_instr;
+            INCREMENT_ADAPTIVE_COUNTER(cache->counter);
             GO_TO_INSTRUCTION(CALL_KW);
         }
 
         TARGET(CALL_KW) {
             PREDICTED(CALL_KW);
+            static_assert(INLINE_CACHE_ENTRIES_CALL_KW == 3, "incorrect cache size");
             PyObject *kwnames;
             PyObject **args;
             PyObject *self_or_null;
             PyObject *callable;
             PyObject *res;
-            kwnames = stack_pointer[-1];
+            kwnames = TOS_CACHE();
             args = stack_pointer - 1 - oparg;
             self_or_null = stack_pointer[-2 - oparg];
             callable = stack_pointer[-3 - oparg];
@@ -4676,6 +4789,16 @@
                 args--;
                 total_args++;
             }
+            #if ENABLE_SPECIALIZATION
+            _PyCallCache *cache = (_PyCallCache *)next_instr;
+            if (ADAPTIVE_COUNTER_IS_ZERO(cache->counter)) {
+                next_instr--;
+                _Py_Specialize_CallKw(callable, next_instr, total_args, kwnames);
+                DISPATCH_SAME_OPARG();
+            }
+            STAT_INC(CALL_KW, deferred);
+            DECREMENT_ADAPTIVE_COUNTER(cache->counter);
+            #endif  /* ENABLE_SPECIALIZATION */
             if (self_or_null == NULL && Py_TYPE(callable) == &PyMethod_Type) {
                 args--;
                 total_args++;
@@ -4706,8 +4829,9 @@
                 if (new_frame == NULL) {
                     goto error;
                 }
-                assert(next_instr - frame->instr_ptr == 1);
-                frame->return_offset = 1;
+                SKIP_OVER(INLINE_CACHE_ENTRIES_CALL_KW);
+                assert(1 + INLINE_CACHE_ENTRIES_CALL_KW == next_instr - frame->instr_ptr);
+                frame->return_offset = 1 + INLINE_CACHE_ENTRIES_CALL_KW;
                 DISPATCH_INLINED(new_frame);
             }
             /* Callable is not a normal Python function */
@@ -4742,16 +4866,64 @@
             STACK_SHRINK(oparg);
             STACK_SHRINK(2);
             stack_pointer[-1] = res;
+            next_instr += 3;
             CHECK_EVAL_BREAKER();
-            DISPATCH();
+            DISPATCH_TOS(res);
+        }
+
+        TARGET(CALL_KW_PY_EXACT_ARGS) {
+            PyObject *kwnames;
+            PyObject **args;
+            PyObject *self_or_null;
+            PyObject *callable;
+            kwnames = TOS_CACHE();
+            args = stack_pointer - 1 - oparg;
+            self_or_null = stack_pointer[-2 - oparg];
+            callable = stack_pointer[-3 - oparg];
+            uint32_t func_version = read_u32(&next_instr[1].cache);
+            DEOPT_IF(tstate->interp->eval_frame, CALL_KW);
+            int argcount = oparg;
+            if (self_or_null != NULL) {
+                args--;
+                argcount++;
+            }
+            DEOPT_IF(!PyFunction_Check(callable), CALL_KW);
+            PyFunctionObject *func = (PyFunctionObject *)callable;
+            DEOPT_IF(func->func_version != func_version, CALL_KW);
+            PyCodeObject *code = (PyCodeObject *)func->func_code;
+            DEOPT_IF(code->co_argcount + code->co_kwonlyargcount != argcount, CALL_KW);
+            int nkwargs = (int)PyTuple_GET_SIZE(kwnames);
+            int positional_args = argcount - nkwargs;
+            DEOPT_IF(positional_args < code->co_posonlyargcount, CALL_KW);
+            DEOPT_IF(positional_args > code->co_argcount, CALL_KW);
+            for (int i = 0; i < nkwargs; i++) {
+                PyObject *name = PyTuple_GET_ITEM(code->co_localsplusnames, positional_args + i);
+                DEOPT_IF(PyTuple_GET_ITEM(kwnames, i) != name, CALL_KW);
+            }
+            DEOPT_IF(!_PyThreadState_HasStackSpace(tstate, code->co_framesize), CALL_KW);
+            STAT_INC(CALL_KW, hit);
+            _PyInterpreterFrame *new_frame = _PyFrame_PushUnchecked(tstate, func, argcount);
+            for (int i = 0; i < argcount; i++) {
+                new_frame->localsplus[i] = args[i];
+            }
+            Py_DECREF(kwnames);
+            // Manipulate stack and cache directly since we leave using DISPATCH_INLINED().
+            STACK_SHRINK(oparg + 3);
+            SKIP_OVER(INLINE_CACHE_ENTRIES_CALL_KW);
+            assert(1 + INLINE_CACHE_ENTRIES_CALL_KW == next_instr - frame->instr_ptr);
+            frame->return_offset = 1 + INLINE_CACHE_ENTRIES_CALL_KW;
+            DISPATCH_INLINED(new_frame);
         }
 
         TARGET(INSTRUMENTED_CALL_FUNCTION_EX) {
+            _PyCallFunctionExCache *cache = (_PyCallFunctionExCache *)next_instr;
+            INCREMENT_ADAPTIVE_COUNTER(cache->counter);
             GO_TO_INSTRUCTION(CALL_FUNCTION_EX);
         }
 
         TARGET(CALL_FUNCTION_EX) {
             PREDICTED(CALL_FUNCTION_EX);
+            static_assert(INLINE_CACHE_ENTRIES_CALL_FUNCTION_EX == 1, "incorrect cache size");
             PyObject *kwargs = NULL;
             PyObject *callargs;
             PyObject *func;
@@ -4762,6 +4934,16 @@
             // DICT_MERGE is called before this opcode if there are kwargs.
             // It converts all dict subtypes in kwargs into regular dicts.
             assert(kwargs == NULL || PyDict_CheckExact(kwargs));
+            #if ENABLE_SPECIALIZATION
+            _PyCallFunctionExCache *cache = (_PyCallFunctionExCache *)next_instr;
+            if (ADAPTIVE_COUNTER_IS_ZERO(cache->counter)) {
+                next_instr--;
+                _Py_Specialize_CallFunctionEx(func, next_instr);
+                DISPATCH_SAME_OPARG();
+            }
+            STAT_INC(CALL_FUNCTION_EX, deferred);
+            DECREMENT_ADAPTIVE_COUNTER(cache->counter);
+            #endif  /* ENABLE_SPECIALIZATION */
             if (!PyTuple_CheckExact(callargs)) {
                 if (check_args_iterable(tstate, func, callargs) < 0) {
                     goto error;
@@ -4815,8 +4997,9 @@
                     if (new_frame == NULL) {
                         goto error;
                     }
-                    assert(next_instr - frame->instr_ptr == 1);
-                    frame->return_offset = 1;
+                    SKIP_OVER(INLINE_CACHE_ENTRIES_CALL_FUNCTION_EX);
+                    assert(1 + INLINE_CACHE_ENTRIES_CALL_FUNCTION_EX == next_instr - frame->instr_ptr);
+                    frame->return_offset = 1 + INLINE_CACHE_ENTRIES_CALL_FUNCTION_EX;
                     DISPATCH_INLINED(new_frame);
                 }
                 result = PyObject_Call(func, callargs, kwargs);
@@ -4829,14 +5012,62 @@
             STACK_SHRINK(((oparg & 1) ? 1 : 0));
             STACK_SHRINK(2);
             stack_pointer[-1] = result;
+            next_instr += 1;
             CHECK_EVAL_BREAKER();
-            DISPATCH();
+            DISPATCH_TOS(result);
+        }
+
+        TARGET(CALL_FUNCTION_EX_PY) {
+            PyObject *kwargs = NULL;
+            PyObject *callargs;
+            PyObject *func;
+            if (oparg & 1) { kwargs = stack_pointer[-(oparg & 1 ? 1 : 0)]; }
+            callargs = stack_pointer[-1 - (oparg & 1 ? 1 : 0)];
+            func = stack_pointer[-3 - (oparg & 1 ? 1 : 0)];
+            DEOPT_IF(tstate->interp->eval_frame, CALL_FUNCTION_EX);
+            DEOPT_IF(Py_TYPE(func) != &PyFunction_Type, CALL_FUNCTION_EX);
+            PyFunctionObject *func_obj = (PyFunctionObject *)func;
+            DEOPT_IF(func_obj->vectorcall != _PyFunction_Vectorcall, CALL_FUNCTION_EX);
+            DEOPT_IF(!PyTuple_CheckExact(callargs), CALL_FUNCTION_EX);
+            assert(kwargs == NULL || PyDict_CheckExact(kwargs));
+            STAT_INC(CALL_FUNCTION_EX, hit);
+            PyCodeObject *code = (PyCodeObject *)func_obj->func_code;
+            Py_ssize_t nargs = PyTuple_GET_SIZE(callargs);
+            _PyInterpreterFrame *new_frame;
+            if ((kwargs == NULL || PyDict_GET_SIZE(kwargs) == 0) &&
+                nargs == code->co_argcount &&
+                code->co_kwonlyargcount == 0 &&
+                (code->co_flags & (CO_VARARGS | CO_VARKEYWORDS)) == 0 &&
+                (code->co_flags & CO_OPTIMIZED) &&
+                _PyThreadState_HasStackSpace(tstate, code->co_framesize))
+            {
+                new_frame = _PyFrame_PushUnchecked(tstate, func_obj, (int)nargs);
+                for (Py_ssize_t i = 0; i < nargs; i++) {
+                    new_frame->localsplus[i] = Py_NewRef(PyTuple_GET_ITEM(callargs, i));
+                }
+                Py_DECREF(callargs);
+                Py_XDECREF(kwargs);
+            }
+            else {
+                PyObject *locals = code->co_flags & CO_OPTIMIZED ? NULL : Py_NewRef(PyFunction_GET_GLOBALS(func));
+                new_frame = _PyEvalFramePushAndInit_Ex(tstate, func_obj, locals,
+                                                       nargs, callargs, kwargs);
+            }
+            // Manipulate stack and cache directly since we leave using DISPATCH_INLINED().
+            STACK_SHRINK(oparg + 3);
+            if (new_frame == NULL) {
+                goto error;
+            }
+            SKIP_OVER(INLINE_CACHE_ENTRIES_CALL_FUNCTION_EX);
+            assert(1 + INLINE_CACHE_ENTRIES_CALL_FUNCTION_EX == next_instr - frame->instr_ptr);
+            frame->return_offset = 1 + INLINE_CACHE_ENTRIES_CALL_FUNCTION_EX;
+            DISPATCH_INLINED(new_frame);
         }
 
         TARGET(MAKE_FUNCTION) {
             PyObject *codeobj;
             PyObject *func;
-            codeobj = stack_pointer[-1];
+            codeobj = TOS_CACHE();
 
             PyFunctionObject *func_obj = (PyFunctionObject *)
                 PyFunction_New(codeobj, GLOBALS());
@@ -4850,13 +5081,13 @@
                 func_obj, ((PyCodeObject *)codeobj)->co_version);
             func = (PyObject *)func_obj;
             stack_pointer[-1] = func;
-            DISPATCH();
+            DISPATCH_TOS(func);
         }
 
         TARGET(SET_FUNCTION_ATTRIBUTE) {
             PyObject *func;
             PyObject *attr;
-            func = stack_pointer[-1];
+            func = TOS_CACHE();
             attr = stack_pointer[-2];
             assert(PyFunction_Check(func));
             PyFunctionObject *func_obj = (PyFunctionObject *)func;
@@ -4884,7 +5115,7 @@
             }
             STACK_SHRINK(1);
             stack_pointer[-1] = func;
-            DISPATCH();
+            DISPATCH_TOS(func);
         }
 
         TARGET(RETURN_GENERATOR) {
@@ -4928,13 +5159,13 @@
             STACK_SHRINK(((oparg == 3) ? 1 : 0));
             STACK_SHRINK(1);
             stack_pointer[-1] = slice;
-            DISPATCH();
+            DISPATCH_TOS(slice);
         }
 
         TARGET(CONVERT_VALUE) {
             PyObject *value;
             PyObject *result;
-            value = stack_pointer[-1];
+            value = TOS_CACHE();
             convertion_func_ptr  conv_fn;
             assert(oparg >= FVC_STR && oparg <= FVC_ASCII);
             conv_fn = CONVERSION_FUNCTIONS[oparg];
@@ -4942,13 +5173,13 @@
             Py_DECREF(value);
             if (result == NULL) goto pop_1_error;
             stack_pointer[-1] = result;
-            DISPATCH();
+            DISPATCH_TOS(result);
         }
 
         TARGET(FORMAT_SIMPLE) {
             PyObject *value;
             PyObject *res;
-            value = stack_pointer[-1];
+            value = TOS_CACHE();
             /* If value is a unicode object, then we know the result
              * of format(value) is value itself. */
             if (!PyUnicode_CheckExact(value)) {
@@ -4960,14 +5191,14 @@
                 res = value;
             }
             stack_pointer[-1] = res;
-            DISPATCH();
+            DISPATCH_TOS(res);
         }
 
         TARGET(FORMAT_WITH_SPEC) {
             PyObject *fmt_spec;
             PyObject *value;
             PyObject *res;
-            fmt_spec = stack_pointer[-1];
+            fmt_spec = TOS_CACHE();
             value = stack_pointer[-2];
             res = PyObject_Format(value, fmt_spec);
             Py_DECREF(value);
@@ -4975,7 +5206,7 @@
             if (res == NULL) goto pop_2_error;
             STACK_SHRINK(1);
             stack_pointer[-1] = res;
-            DISPATCH();
+            DISPATCH_TOS(res);
         }
 
         TARGET(COPY) {
@@ -4986,7 +5217,7 @@
             top = Py_NewRef(bottom);
             STACK_GROW(1);
             stack_pointer[-1] = top;
-            DISPATCH();
+            DISPATCH_TOS(top);
         }
 
         TARGET(BINARY_OP) {
@@ -4995,7 +5226,7 @@
             PyObject *rhs;
             PyObject *lhs;
             PyObject *res;
-            rhs = stack_pointer[-1];
+            rhs = TOS_CACHE();
             lhs = stack_pointer[-2];
             #if ENABLE_SPECIALIZATION
             _PyBinaryOpCache *cache = (_PyBinaryOpCache *)next_instr;
@@ -5017,18 +5248,18 @@
             STACK_SHRINK(1);
             stack_pointer[-1] = res;
             next_instr += 1;
-            DISPATCH();
+            DISPATCH_TOS(res);
         }
 
         TARGET(SWAP) {
             PyObject *top;
             PyObject *bottom;
-            top = stack_pointer[-1];
+            top = TOS_CACHE();
             bottom = stack_pointer[-2 - (oparg-2)];
             assert(oparg >= 2);
             stack_pointer[-2 - (oparg-2)] = top;
             stack_pointer[-1] = bottom;
-            DISPATCH();
+            DISPATCH_TOS(bottom);
         }
 
         TARGET(INSTRUMENTED_INSTRUCTION) {
@@ -93,6 +93,8 @@ static const PyConfigSpec PYCONFIG_SPEC[] = {
     SPEC(safe_path, UINT),
     SPEC(int_max_str_digits, INT),
     SPEC(cpu_count, INT),
+    SPEC(sort_threads, INT),
+    SPEC(optimizer_profile, WSTR_OPT),
     SPEC(pathconfig_warnings, UINT),
     SPEC(program_name, WSTR),
     SPEC(pythonpath_env, WSTR_OPT),
@@ -227,6 +229,8 @@ The following implementation-specific options are available:\n\
     trampoline. When this option is activated, the Linux \"perf\" profiler will be \n\
     able to report Python calls. This option is only available on some platforms and will \n\
     do nothing if is not supported on the current system. The default value is \"off\".\n\
+-X perf_jit: like -X perf, but write the symbols in the \"jitdump\" format (for\n\
+    \"perf inject --jit\") instead of a perf map file.\n\
 \n\
 -X frozen_modules=[on|off]: whether or not frozen modules should be used.\n\
    The default is \"on\" (or \"off\" if you are running a local build).\n\
@@ -237,7 +241,13 @@ The following implementation-specific options are available:\n\
 \n\
 -X cpu_count=[n|default]: Override the return value of os.cpu_count(),\n\
     os.process_cpu_count(), and multiprocessing.cpu_count(). This can help users who need\n\
-    to limit resources in a container."
+    to limit resources in a container.\n\
+\n\
+-X sort_threads=n: let list.sort() use up to n threads to sort very large\n\
+    lists of Latin-1 strings. The default is 1.\n\
+\n\
+-X optprofile=PATH: load the profile of specialized instructions, branches\n\
+    and hot loops from PATH at startup and save it back there at exit."
 
 #ifdef Py_STATS
 "\n\
@@ -282,6 +292,10 @@ static const char usage_envvars[] =
 "   debugger. It can be set to the callable of your debugger of choice.\n"
 "PYTHON_CPU_COUNT: Overrides the return value of os.process_cpu_count(),\n"
 "   os.cpu_count(), and multiprocessing.cpu_count() if set to a positive integer.\n"
+"PYTHON_SORT_THREADS: maximum number of threads used by list.sort()\n"
+"   (-X sort_threads=n).\n"
+"PYTHONOPTPROFILE: file used to persist the optimizer profile\n"
+"   (-X optprofile=PATH).\n"
 "PYTHONDEVMODE: enable the development mode.\n"
 "PYTHONPYCACHEPREFIX: root directory for bytecode cache (pyc) files.\n"
 "PYTHONWARNDEFAULTENCODING: enable opt-in EncodingWarning for 'encoding=None'.\n"
@@ -752,6 +766,7 @@ config_check_consistency(const PyConfig *config)
     assert(config->int_max_str_digits >= 0);
     // cpu_count can be -1 if the user doesn't override it.
     assert(config->cpu_count != 0);
+    assert(config->sort_threads >= 1);
     // config->use_frozen_modules is initialized later
     // by _PyConfig_InitImportConfig().
 #ifdef Py_STATS
@@ -801,6 +816,7 @@ PyConfig_Clear(PyConfig *config)
     CLEAR(config->run_module);
     CLEAR(config->run_filename);
     CLEAR(config->check_hash_pycs_mode);
+    CLEAR(config->optimizer_profile);
 #ifdef Py_DEBUG
     CLEAR(config->run_presite);
 #endif
@@ -856,6 +872,7 @@ _PyConfig_InitCompatConfig(PyConfig *config)
     config->_is_python_build = 0;
     config->code_debug_ranges = 1;
     config->cpu_count = -1;
+    config->sort_threads = -1;
 }
 
 
@@ -911,6 +928,7 @@ PyConfig_InitIsolatedConfig(PyConfig *config)
     config->tracemalloc = 0;
     config->perf_profiling = 0;
     config->int_max_str_digits = _PY_LONG_DEFAULT_MAX_STR_DIGITS;
+    config->sort_threads = 1;
     config->safe_path = 1;
     config->pathconfig_warnings = 0;
 #ifdef MS_WINDOWS
@@ -1680,6 +1698,34 @@ config_init_cpu_count(PyConfig *config)
                          "n must be greater than 0");
 }
 
+static PyStatus
+config_init_sort_threads(PyConfig *config)
+{
+    int threads;
+    const char *env = config_get_env(config, "PYTHON_SORT_THREADS");
+    if (env) {
+        if (_Py_str_to_int(env, &threads) < 0 || threads < 1) {
+            return _PyStatus_ERR("PYTHON_SORT_THREADS: invalid value; "
+                                 "must be greater than 0");
+        }
+        config->sort_threads = threads;
+    }
+
+    const wchar_t *xoption = config_get_xoption(config, L"sort_threads");
+    if (xoption) {
+        const wchar_t *sep = wcschr(xoption, L'=');
+        if (!sep || config_wstr_to_int(sep + 1, &threads) < 0 || threads < 1) {
+            return _PyStatus_ERR("-X sort_threads=n option: n is missing or "
+                                 "an invalid number, n must be greater than 0");
+        }
+        config->sort_threads = threads;
+    }
+    if (config->sort_threads < 0) {
+        config->sort_threads = 1;
+    }
+    return _PyStatus_OK();
+}
+
 static PyStatus
 config_init_perf_profiling(PyConfig *config)
 {
@@ -1697,6 +1743,19 @@ config_init_perf_profiling(PyConfig *config)
     if (xoption) {
         config->perf_profiling = 1;
     }
+    env = config_get_env(config, "PYTHONPERFJITSUPPORT");
+    if (env) {
+        if (_Py_str_to_int(env, &active) != 0) {
+            active = 0;
+        }
+        if (active) {
+            config->perf_profiling = 2;
+        }
+    }
+    xoption = config_get_xoption(config, L"perf_jit");
+    if (xoption) {
+        config->perf_profiling = 2;
+    }
     return _PyStatus_OK();
 
 }
@@ -1820,6 +1879,34 @@ config_init_pycache_prefix(PyConfig *config)
 }
 
 
+static PyStatus
+config_init_optimizer_profile(PyConfig *config)
+{
+    assert(config->optimizer_profile == NULL);
+
+    const wchar_t *xoption = config_get_xoption(config, L"optprofile");
+    if (xoption) {
+        const wchar_t *sep = wcschr(xoption, L'=');
+        if (sep && wcslen(sep) > 1) {
+            config->optimizer_profile = _PyMem_RawWcsdup(sep + 1);
+            if (config->optimizer_profile == NULL) {
+                return _PyStatus_NO_MEMORY();
+            }
+        }
+        else {
+            // PYTHONOPTPROFILE env var ignored
+            // if "-X optprofile=" option is used
+            config->optimizer_profile = NULL;
+        }
+        return _PyStatus_OK();
+    }
+
+    return CONFIG_GET_ENV_DUP(config, &config->optimizer_profile,
+                              L"PYTHONOPTPROFILE",
+                              "PYTHONOPTPROFILE");
+}
+
+
 #ifdef Py_DEBUG
 static PyStatus
 config_init_run_presite(PyConfig *config)
@@ -1899,6 +1986,13 @@ config_read_complex_options(PyConfig *config)
         }
     }
 
+    if (config->sort_threads < 0) {
+        status = config_init_sort_threads(config);
+        if (_PyStatus_EXCEPTION(status)) {
+            return status;
+        }
+    }
+
     if (config->pycache_prefix == NULL) {
         status = config_init_pycache_prefix(config);
         if (_PyStatus_EXCEPTION(status)) {
@@ -1906,6 +2000,13 @@ config_read_complex_options(PyConfig *config)
         }
     }
 
+    if (config->optimizer_profile == NULL) {
+        status = config_init_optimizer_profile(config);
+        if (_PyStatus_EXCEPTION(status)) {
+            return status;
+        }
+    }
+
 #ifdef Py_DEBUG
     if (config->run_presite == NULL) {
         status = config_init_run_presite(config);
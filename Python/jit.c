@@ -0,0 +1,262 @@
+/* Copy-and-patch JIT compiler for tier 2 executors.
+ *
+ * At build time, Tools/jit/build.py compiles Tools/jit/template.c once for
+ * every uop into a "stencil": a blob of machine code (plus read-only data)
+ * with "holes" that are filled in here, at runtime, with the uop's oparg and
+ * operand, the executor, and the addresses of the following stencils.  The
+ * stencils live in the generated jit_stencils.h.
+ *
+ * Compiling a trace is then just a matter of copying the stencil of every
+ * uop into one executable mapping and patching its holes.  Every stencil
+ * ends in a tail call to the next one, so the trace runs without returning
+ * to a dispatch loop.
+ */
+
+#include "Python.h"
+
+#ifdef _Py_JIT
+
+#include "opcode.h"
+
+// Every external symbol referenced by a stencil must be declared here, so
+// keep the includes in sync with Tools/jit/template.c.
+#include "pycore_bitutils.h"
+#include "pycore_call.h"
+#include "pycore_ceval.h"
+#include "pycore_dict.h"
+#include "pycore_emscripten_signal.h"
+#include "pycore_intrinsics.h"
+#include "pycore_jit.h"
+#include "pycore_list.h"
+#include "pycore_long.h"
+#include "pycore_object.h"
+#include "pycore_opcode_metadata.h"
+#include "pycore_opcode_utils.h"
+#include "pycore_optimizer.h"
+#include "pycore_pyerrors.h"
+#include "pycore_range.h"
+#include "pycore_setobject.h"     // _PySet_Update()
+#include "pycore_sliceobject.h"
+#include "pycore_tuple.h"
+#include "pycore_uops.h"
+
+#include <sys/mman.h>             // mmap()
+#include <unistd.h>               // sysconf()
+
+typedef enum {
+    HOLE_abs_64,    // 64-bit absolute address
+    HOLE_rel_32,    // 32-bit displacement, relative to the hole
+} HoleKind;
+
+typedef enum {
+    HOLE_CODE,          // The start of this uop's code
+    HOLE_CONTINUE,      // The start of the next uop's code
+    HOLE_DATA,          // The start of this uop's data
+    HOLE_EXECUTOR,      // The executor being compiled
+    HOLE_INDEX,         // The uop's index in the trace
+    HOLE_JUMP_TARGET,   // The start of the code of the uop jumped to
+    HOLE_OPARG,         // The uop's oparg
+    HOLE_OPERAND,       // The uop's operand
+    HOLE_ZERO,          // Nothing (the hole is filled with a symbol)
+} HoleValue;
+
+#define HOLE_VALUE_COUNT (HOLE_ZERO + 1)
+
+typedef struct {
+    const size_t offset;
+    const HoleKind kind;
+    const HoleValue value;
+    const void *symbol;
+    const uint64_t addend;
+} Hole;
+
+typedef struct {
+    const size_t body_size;
+    const unsigned char * const body;
+    const size_t holes_size;
+    const Hole * const holes;
+} Stencil;
+
+typedef struct {
+    const Stencil code;
+    const Stencil data;
+} StencilGroup;
+
+#include "jit_stencils.h"
+
+static size_t
+page_size(void)
+{
+    static size_t size = 0;
+    if (size == 0) {
+        size = (size_t)sysconf(_SC_PAGESIZE);
+    }
+    return size;
+}
+
+static void
+patch(unsigned char *base, const Stencil *stencil, uint64_t patches[])
+{
+    memcpy(base, stencil->body, stencil->body_size);
+    for (size_t i = 0; i < stencil->holes_size; i++) {
+        const Hole *hole = &stencil->holes[i];
+        unsigned char *location = base + hole->offset;
+        uint64_t value = patches[hole->value] + (uintptr_t)hole->symbol +
+                         hole->addend;
+        switch (hole->kind) {
+            case HOLE_abs_64:
+                memcpy(location, &value, sizeof(value));
+                break;
+            case HOLE_rel_32: {
+                int64_t relative = (int64_t)(value - (uintptr_t)location);
+                assert(INT32_MIN <= relative && relative <= INT32_MAX);
+                int32_t value32 = (int32_t)relative;
+                memcpy(location, &value32, sizeof(value32));
+                break;
+            }
+            default:
+                Py_UNREACHABLE();
+        }
+    }
+}
+
+#ifndef NDEBUG
+static int
+has_hole(const Stencil *stencil, HoleValue value)
+{
+    for (size_t i = 0; i < stencil->holes_size; i++) {
+        if (stencil->holes[i].value == value) {
+            return 1;
+        }
+    }
+    return 0;
+}
+#endif
+
+// Return the index of the uop that a jump uop may continue at, or -1 if the
+// uop never jumps (its oparg is then an operand, not an index):
+static int
+jump_target(const _PyUOpInstruction *instruction)
+{
+    switch (instruction->opcode) {
+        case _JUMP_TO_TOP:
+            return 0;
+        case _POP_JUMP_IF_FALSE:
+        case _POP_JUMP_IF_TRUE:
+            return instruction->oparg;
+        default:
+            return -1;
+    }
+}
+
+int
+_PyJIT_Compile(_PyUOpExecutorObject *executor)
+{
+    Py_ssize_t length = Py_SIZE(executor);
+    // Lay out all of the code first, followed by all of the data:
+    size_t *code_offsets = PyMem_New(size_t, length + 1);
+    size_t *data_offsets = PyMem_New(size_t, length);
+    if (code_offsets == NULL || data_offsets == NULL) {
+        PyMem_Free(code_offsets);
+        PyMem_Free(data_offsets);
+        PyErr_NoMemory();
+        return -1;
+    }
+    size_t code_size = 0;
+    size_t data_size = 0;
+    for (Py_ssize_t i = 0; i < length; i++) {
+        const StencilGroup *group = &stencil_groups[executor->trace[i].opcode];
+        // Every uop that can appear in a trace has a stencil:
+        assert(group->code.body_size);
+        code_offsets[i] = code_size;
+        data_offsets[i] = data_size;
+        code_size += group->code.body_size;
+        data_size += group->data.body_size;
+    }
+    code_offsets[length] = code_size;
+    size_t size = code_size + data_size;
+    size = (size + page_size() - 1) & ~(page_size() - 1);
+    unsigned char *memory = mmap(NULL, size, PROT_READ | PROT_WRITE,
+                                 MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED) {
+        PyMem_Free(code_offsets);
+        PyMem_Free(data_offsets);
+        PyErr_NoMemory();
+        return -1;
+    }
+    for (Py_ssize_t i = 0; i < length; i++) {
+        _PyUOpInstruction *instruction = &executor->trace[i];
+        const StencilGroup *group = &stencil_groups[instruction->opcode];
+        unsigned char *code = memory + code_offsets[i];
+        unsigned char *data = memory + code_size + data_offsets[i];
+        int target = jump_target(instruction);
+        assert(target < length);
+        assert(target >= 0 || (!has_hole(&group->code, HOLE_JUMP_TARGET) &&
+                               !has_hole(&group->data, HOLE_JUMP_TARGET)));
+        uint64_t patches[HOLE_VALUE_COUNT] = {
+            [HOLE_CODE] = (uintptr_t)code,
+            // The last uop (_EXIT_TRACE or _JUMP_TO_TOP) never continues:
+            [HOLE_CONTINUE] = (uintptr_t)(memory + code_offsets[i + 1]),
+            [HOLE_DATA] = (uintptr_t)data,
+            [HOLE_EXECUTOR] = (uintptr_t)executor,
+            [HOLE_INDEX] = i,
+            // Only the jump uops have a _JIT_JUMP_TARGET hole to patch:
+            [HOLE_JUMP_TARGET] =
+                target < 0 ? 0 : (uintptr_t)(memory + code_offsets[target]),
+            [HOLE_OPARG] = instruction->oparg,
+            [HOLE_OPERAND] = instruction->operand,
+            [HOLE_ZERO] = 0,
+        };
+        patch(code, &group->code, patches);
+        patch(data, &group->data, patches);
+    }
+    PyMem_Free(code_offsets);
+    PyMem_Free(data_offsets);
+    if (mprotect(memory, size, PROT_READ | PROT_EXEC)) {
+        PyErr_SetFromErrno(PyExc_OSError);
+        munmap(memory, size);
+        return -1;
+    }
+    __builtin___clear_cache((char *)memory, (char *)memory + code_size);
+    executor->jit_code = memory;
+    executor->jit_size = size;
+    executor->base.execute = _PyJIT_Execute;
+    return 0;
+}
+
+void
+_PyJIT_Free(_PyUOpExecutorObject *executor)
+{
+    if (executor->jit_code != NULL) {
+        munmap(executor->jit_code, executor->jit_size);
+        executor->jit_code = NULL;
+        executor->jit_size = 0;
+    }
+}
+
+typedef _PyInterpreterFrame *(*jit_func)(
+    _PyInterpreterFrame *frame, PyObject **stack_pointer,
+    PyThreadState *tstate);
+
+_PyInterpreterFrame *
+_PyJIT_Execute(_PyExecutorObject *executor, _PyInterpreterFrame *frame,
+               PyObject **stack_pointer)
+{
+    // Mirror the prologue of _PyUopExecute():
+    PyThreadState *tstate = _PyThreadState_GET();
+    _PyUOpExecutorObject *self = (_PyUOpExecutorObject *)executor;
+    if (_Py_atomic_load_uintptr_relaxed(&tstate->interp->ceval.eval_breaker) &
+        _PY_EVAL_EVENTS_MASK)
+    {
+        if (_Py_HandlePending(tstate) != 0) {
+            frame->return_offset = 0;
+            _PyFrame_SetStackPointer(frame, stack_pointer);
+            Py_DECREF(self);
+            return NULL;
+        }
+    }
+    OPT_STAT_INC(traces_executed);
+    return ((jit_func)self->jit_code)(frame, stack_pointer, tstate);
+}
+
+#endif  // _Py_JIT
@@ -167,7 +167,9 @@ static void *opcode_targets[256] = {
     &&TARGET_CALL_BUILTIN_FAST,
     &&TARGET_CALL_BUILTIN_FAST_WITH_KEYWORDS,
     &&TARGET_CALL_BUILTIN_O,
+    &&TARGET_CALL_FUNCTION_EX_PY,
     &&TARGET_CALL_ISINSTANCE,
+    &&TARGET_CALL_KW_PY_EXACT_ARGS,
     &&TARGET_CALL_LEN,
     &&TARGET_CALL_LIST_APPEND,
     &&TARGET_CALL_METHOD_DESCRIPTOR_FAST,
@@ -182,6 +184,11 @@ static void *opcode_targets[256] = {
     &&TARGET_COMPARE_OP_FLOAT,
     &&TARGET_COMPARE_OP_INT,
     &&TARGET_COMPARE_OP_STR,
+    &&TARGET_CONTAINS_OP_DICT,
+    &&TARGET_CONTAINS_OP_LIST,
+    &&TARGET_CONTAINS_OP_SET,
+    &&TARGET_CONTAINS_OP_STR,
+    &&TARGET_CONTAINS_OP_TUPLE,
     &&TARGET_FOR_ITER_GEN,
     &&TARGET_FOR_ITER_LIST,
     &&TARGET_FOR_ITER_RANGE,
@@ -228,13 +235,6 @@ static void *opcode_targets[256] = {
     &&_unknown_opcode,
     &&_unknown_opcode,
     &&_unknown_opcode,
-    &&_unknown_opcode,
-    &&_unknown_opcode,
-    &&_unknown_opcode,
-    &&_unknown_opcode,
-    &&_unknown_opcode,
-    &&_unknown_opcode,
-    &&_unknown_opcode,
     &&TARGET_INSTRUMENTED_RESUME,
     &&TARGET_INSTRUMENTED_END_FOR,
     &&TARGET_INSTRUMENTED_END_SEND,
@@ -2,6 +2,8 @@
 #include "opcode.h"
 #include "pycore_interp.h"
 #include "pycore_bitutils.h"        // _Py_popcount32()
+#include "pycore_hashtable.h"     // _Py_hashtable_t
+#include "pycore_jit.h"           // _PyJIT_Compile()
 #include "pycore_opcode_metadata.h" // _PyOpcode_OpName()
 #include "pycore_opcode_utils.h"  // MAX_REAL_OPCODE
 #include "pycore_optimizer.h"     // _Py_uop_analyze_and_optimize()
@@ -184,6 +186,7 @@ _PyOptimizer_BackEdge(_PyInterpreterFrame *frame, _Py_CODEUNIT *src, _Py_CODEUNI
     }
     insert_executor(code, src, index, executor);
     Py_DECREF(executor);
+    _PyOptimizer_RecordProfile(code);
     return 1;
 }
 
@@ -322,6 +325,15 @@ PyUnstable_Optimizer_NewCounter(void)
 static void
 uop_dealloc(_PyUOpExecutorObject *self) {
     _Py_ExecutorClear((_PyExecutorObject *)self);
+    if (self->exits != NULL) {
+        for (Py_ssize_t i = 0; i < Py_SIZE(self); i++) {
+            Py_XDECREF(self->exits[i].executor);
+        }
+        PyMem_Free(self->exits);
+    }
+#ifdef _Py_JIT
+    _PyJIT_Free(self);
+#endif
     PyObject_Free(self);
 }
 
@@ -370,6 +382,29 @@ uop_item(_PyUOpExecutorObject *self, Py_ssize_t index)
     return _PyTuple_FromArraySteal(args, 3);
 }
 
+static PyObject *
+get_side_exit(_PyUOpExecutorObject *self, PyObject *arg)
+{
+    Py_ssize_t index = PyLong_AsSsize_t(arg);
+    if (index == -1 && PyErr_Occurred()) {
+        return NULL;
+    }
+    if (index < 0 || index >= Py_SIZE(self)) {
+        PyErr_SetNone(PyExc_IndexError);
+        return NULL;
+    }
+    if (self->exits == NULL || self->exits[index].executor == NULL) {
+        Py_RETURN_NONE;
+    }
+    return Py_NewRef(self->exits[index].executor);
+}
+
+static PyMethodDef uop_executor_methods[] = {
+    { "is_valid", is_valid, METH_NOARGS, NULL },
+    { "get_side_exit", (PyCFunction)get_side_exit, METH_O, NULL },
+    { NULL, NULL },
+};
+
 PySequenceMethods uop_as_sequence = {
     .sq_length = (lenfunc)uop_len,
     .sq_item = (ssizeargfunc)uop_item,
@@ -383,7 +418,7 @@ static PyTypeObject UOpExecutor_Type = {
     .tp_flags = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_DISALLOW_INSTANTIATION,
     .tp_dealloc = (destructor)uop_dealloc,
     .tp_as_sequence = &uop_as_sequence,
-    .tp_methods = executor_methods,
+    .tp_methods = uop_executor_methods,
 };
 
 static int
@@ -414,16 +449,36 @@ move_stubs(
 
 #define TRACE_STACK_SIZE 5
 
+/* The code objects a trace goes through.  Each one is entered by a uop in
+ * the trace, except the first. */
+typedef struct {
+    int count;
+    void *objects[_Py_UOP_MAX_TRACE_LENGTH + 1];
+} trace_dependencies;
+
+static void
+add_trace_dependency(trace_dependencies *dependencies, void *obj)
+{
+    for (int i = 0; i < dependencies->count; i++) {
+        if (dependencies->objects[i] == obj) {
+            return;
+        }
+    }
+    assert(dependencies->count < (int)Py_ARRAY_LENGTH(dependencies->objects));
+    dependencies->objects[dependencies->count++] = obj;
+}
+
 static int
 translate_bytecode_to_trace(
     PyCodeObject *code,
     _Py_CODEUNIT *instr,
     _PyUOpInstruction *trace,
     int buffer_size,
-    _PyBloomFilter *dependencies)
+    trace_dependencies *dependencies,
+    bool deopt_first)
 {
     PyCodeObject *initial_code = code;
-    _Py_BloomFilter_Add(dependencies, initial_code);
+    add_trace_dependency(dependencies, initial_code);
     _Py_CODEUNIT *initial_instr = instr;
     int trace_length = 0;
     int max_length = buffer_size;
@@ -541,6 +596,14 @@ translate_bytecode_to_trace(
             oparg = (oparg & 0xffffff00) | executor->vm_data.oparg;
         }
 
+        if (deopt_first) {
+            // We are tracing from a side exit where this instruction failed
+            // a guard, so trace its unspecialized form instead.
+            opcode = _PyOpcode_Deopt[opcode];
+            DPRINTF(2, "  * Side exit -> %s\n", _PyOpcode_OpName[opcode]);
+            deopt_first = false;
+        }
+
         switch (opcode) {
 
             case POP_JUMP_IF_NONE:
@@ -757,7 +820,7 @@ translate_bytecode_to_trace(
                                 // Increment IP to the return address
                                 instr += _PyOpcode_Caches[_PyOpcode_Deopt[opcode]] + 1;
                                 TRACE_STACK_PUSH();
-                                _Py_BloomFilter_Add(dependencies, new_code);
+                                add_trace_dependency(dependencies, new_code);
                                 code = new_code;
                                 instr = _PyCode_CODE(code);
                                 DPRINTF(2,
@@ -907,17 +970,16 @@ remove_unneeded_uops(_PyUOpInstruction *trace, int trace_length)
 }
 
 static int
-uop_optimize(
-    _PyOptimizerObject *self,
+make_executor(
     PyCodeObject *code,
     _Py_CODEUNIT *instr,
     _PyExecutorObject **exec_ptr,
-    int curr_stackentries)
+    int curr_stackentries,
+    bool deopt_first)
 {
-    _PyBloomFilter dependencies;
-    _Py_BloomFilter_Init(&dependencies);
+    trace_dependencies dependencies = {.count = 0};
     _PyUOpInstruction trace[_Py_UOP_MAX_TRACE_LENGTH];
-    int trace_length = translate_bytecode_to_trace(code, instr, trace, _Py_UOP_MAX_TRACE_LENGTH, &dependencies);
+    int trace_length = translate_bytecode_to_trace(code, instr, trace, _Py_UOP_MAX_TRACE_LENGTH, &dependencies, deopt_first);
     if (trace_length <= 0) {
         // Error or nothing translated
         return trace_length;
@@ -925,7 +987,7 @@ uop_optimize(
     OPT_HIST(trace_length, trace_length_hist);
     OPT_STAT_INC(traces_created);
     char *uop_optimize = Py_GETENV("PYTHONUOPSOPTIMIZE");
-    if (uop_optimize != NULL && *uop_optimize > '0') {
+    if (uop_optimize == NULL || *uop_optimize > '0') {
         trace_length = _Py_uop_analyze_and_optimize(code, trace, trace_length, curr_stackentries);
     }
     trace_length = remove_unneeded_uops(trace, trace_length);
@@ -935,12 +997,39 @@ uop_optimize(
     }
     OPT_HIST(trace_length, optimized_trace_length_hist);
     executor->base.execute = _PyUopExecute;
+    executor->exits = NULL;
     memcpy(executor->trace, trace, trace_length * sizeof(_PyUOpInstruction));
-    _Py_ExecutorInit((_PyExecutorObject *)executor, &dependencies);
+    _PyBloomFilter empty;
+    _Py_BloomFilter_Init(&empty);
+    _Py_ExecutorInit((_PyExecutorObject *)executor, &empty);
+    for (int i = 0; i < dependencies.count; i++) {
+        _Py_Executor_DependsOn((_PyExecutorObject *)executor,
+                               dependencies.objects[i]);
+    }
+#ifdef _Py_JIT
+    executor->jit_code = NULL;
+    executor->jit_size = 0;
+    if (_PyJIT_Compile(executor)) {
+        Py_DECREF(executor);
+        return -1;
+    }
+#endif
+    _PyPerfTrampoline_RegisterExecutor(executor, code, instr);
     *exec_ptr = (_PyExecutorObject *)executor;
     return 1;
 }
 
+static int
+uop_optimize(
+    _PyOptimizerObject *self,
+    PyCodeObject *code,
+    _Py_CODEUNIT *instr,
+    _PyExecutorObject **exec_ptr,
+    int curr_stackentries)
+{
+    return make_executor(code, instr, exec_ptr, curr_stackentries, false);
+}
+
 static void
 uop_opt_dealloc(PyObject *self) {
     PyObject_Free(self);
@@ -973,10 +1062,183 @@ PyUnstable_Optimizer_NewUOpOptimizer(void)
 }
 
 
+/* Side exits.
+ *
+ * Whenever a uop executor leaves its trace early, either because a guard
+ * failed (DEOPT_IF) or at an _EXIT_TRACE (a stub for an unlikely branch, the
+ * end of a trace that got too long, ...), it calls _PyOptimizer_SideExit()
+ * with the index of the uop it exited at.  Each such exit has a temperature.
+ * Once an exit is hot we trace from where tier 1 would resume, and link the
+ * new executor to the exit, so that from then on the executor continues
+ * directly in the "side exit executor" instead of dropping back to tier 1.
+ *
+ * Side exit executors are ordinary uop executors, so their own exits can get
+ * side exit executors too, and (since a side exit executor never loops back
+ * to its own start) the links form a tree.  Exits that land on a backward
+ * jump that has an executor are left alone: tier 1 enters that executor
+ * immediately anyway.
+ */
+
+#define MAX_SIDE_EXIT_BACKOFF 12
+
+int
+_PyOptimizer_SideExit(_PyUOpExecutorObject *executor, int index,
+                      _PyInterpreterFrame *frame, _PyExecutorObject **exit_ptr)
+{
+    assert(0 <= index && index < Py_SIZE(executor));
+    *exit_ptr = NULL;
+    if (executor->exits == NULL) {
+        executor->exits = PyMem_Calloc(Py_SIZE(executor), sizeof(_PyExitData));
+        if (executor->exits == NULL) {
+            // Side exits are an optimization; don't raise.
+            return 0;
+        }
+    }
+    _PyExitData *exit = &executor->exits[index];
+    if (exit->executor != NULL) {
+        if (exit->executor->vm_data.valid) {
+            *exit_ptr = (_PyExecutorObject *)Py_NewRef(exit->executor);
+            return 1;
+        }
+        // Invalidated; trace again once the exit is hot again.
+        Py_CLEAR(exit->executor);
+        exit->temperature = 0;
+    }
+    PyInterpreterState *interp = _PyInterpreterState_GET();
+    if (Py_TYPE(interp->optimizer) != &UOpOptimizer_Type) {
+        // The uop optimizer has been replaced; don't create new executors.
+        return 0;
+    }
+    if (++exit->temperature < (_Py_SIDE_EXIT_THRESHOLD << exit->backoff)) {
+        return 0;
+    }
+    exit->temperature = 0;
+    PyCodeObject *code = _PyFrame_GetCode(frame);
+    _Py_CODEUNIT *target = frame->instr_ptr;
+    int curr_stackentries = frame->stacktop - code->co_nlocalsplus;
+    _PyExecutorObject *side = NULL;
+    int err = 0;
+    if (target->op.code != ENTER_EXECUTOR) {
+        OPT_STAT_INC(attempts);
+        bool deopt = executor->trace[index].opcode != _EXIT_TRACE;
+        err = make_executor(code, target, &side, curr_stackentries, deopt);
+    }
+    if (err <= 0) {
+        assert(side == NULL);
+        if (exit->backoff < MAX_SIDE_EXIT_BACKOFF) {
+            exit->backoff++;
+        }
+        return err;
+    }
+    exit->executor = side;
+    *exit_ptr = (_PyExecutorObject *)Py_NewRef(side);
+    return 1;
+}
+
+
 /*****************************************
  *        Executor management
  ****************************************/
 
+/* Executors record the objects they depend on with _Py_Executor_DependsOn(),
+ * and _Py_Executors_InvalidateDependency() invalidates the executors that
+ * depend on a given object.  Every dependency is an edge in a graph of
+ * executors and objects, on two lists: the list of the executor's
+ * dependencies, and the list of the executors that depend on the object,
+ * which interp->executor_dependents maps the object to.  So invalidating the
+ * executors that depend on an object only touches those executors, and
+ * freeing an executor only touches its own dependencies.
+ *
+ * Optimizers may also pass a bloom filter of dependencies to
+ * _Py_ExecutorInit().  The objects themselves are then unknown, so
+ * invalidation has to check the bloom filter of every such executor.
+ */
+
+typedef struct _PyExecutorDependency {
+    void *obj;
+    _PyExecutorObject *executor;
+    // The next dependency of the same executor
+    struct _PyExecutorDependency *next;
+    // The neighbours in the list of dependencies on the same object
+    struct _PyExecutorDependency *next_dependent;
+    struct _PyExecutorDependency *prev_dependent;
+} _PyExecutorDependency;
+
+static int
+add_dependency(PyInterpreterState *interp, _PyExecutorObject *executor,
+               void *obj)
+{
+    for (_PyExecutorDependency *dep = executor->vm_data.dependencies;
+         dep != NULL; dep = dep->next)
+    {
+        if (dep->obj == obj) {
+            return 0;
+        }
+    }
+    if (interp->executor_dependents == NULL) {
+        interp->executor_dependents = _Py_hashtable_new(
+            _Py_hashtable_hash_ptr, _Py_hashtable_compare_direct);
+        if (interp->executor_dependents == NULL) {
+            return -1;
+        }
+    }
+    _PyExecutorDependency *dep = PyMem_RawMalloc(sizeof(_PyExecutorDependency));
+    if (dep == NULL) {
+        return -1;
+    }
+    dep->obj = obj;
+    dep->executor = executor;
+    dep->prev_dependent = NULL;
+    _Py_hashtable_entry_t *entry =
+        _Py_hashtable_get_entry(interp->executor_dependents, obj);
+    if (entry != NULL) {
+        _PyExecutorDependency *head = entry->value;
+        head->prev_dependent = dep;
+        dep->next_dependent = head;
+        entry->value = dep;
+    }
+    else {
+        dep->next_dependent = NULL;
+        if (_Py_hashtable_set(interp->executor_dependents, obj, dep) < 0) {
+            PyMem_RawFree(dep);
+            return -1;
+        }
+    }
+    dep->next = executor->vm_data.dependencies;
+    executor->vm_data.dependencies = dep;
+    return 0;
+}
+
+static void
+remove_dependencies(PyInterpreterState *interp, _PyExecutorObject *executor)
+{
+    _PyExecutorDependency *dep = executor->vm_data.dependencies;
+    executor->vm_data.dependencies = NULL;
+    while (dep != NULL) {
+        _PyExecutorDependency *next = dep->next;
+        if (dep->next_dependent != NULL) {
+            dep->next_dependent->prev_dependent = dep->prev_dependent;
+        }
+        if (dep->prev_dependent != NULL) {
+            dep->prev_dependent->next_dependent = dep->next_dependent;
+        }
+        else {
+            // dep is the head of the list for dep->obj
+            _Py_hashtable_entry_t *entry =
+                _Py_hashtable_get_entry(interp->executor_dependents, dep->obj);
+            assert(entry != NULL && entry->value == dep);
+            if (dep->next_dependent != NULL) {
+                entry->value = dep->next_dependent;
+            }
+            else {
+                _Py_hashtable_steal(interp->executor_dependents, dep->obj);
+            }
+        }
+        PyMem_RawFree(dep);
+        dep = next;
+    }
+}
+
 /* We use a bloomfilter with k = 6, m = 256
  * The choice of k and the following constants
  * could do with a more rigourous analysis,
@@ -1062,12 +1324,26 @@ bloom_filter_may_contain(_PyBloomFilter *bloom, _PyBloomFilter *hashes)
     return true;
 }
 
+static bool
+bloom_filter_is_empty(_PyBloomFilter *bloom)
+{
+    for (int i = 0; i < BLOOM_FILTER_WORDS; i++) {
+        if (bloom->bits[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
 static void
 link_executor(_PyExecutorObject *executor)
 {
     PyInterpreterState *interp = _PyInterpreterState_GET();
     _PyExecutorLinkListNode *links = &executor->vm_data.links;
     _PyExecutorObject *head = interp->executor_list_head;
+    if (!bloom_filter_is_empty(&executor->vm_data.bloom)) {
+        interp->executor_bloom_count++;
+    }
     if (head == NULL) {
         interp->executor_list_head = executor;
         links->previous = NULL;
@@ -1093,6 +1369,7 @@ unlink_executor(_PyExecutorObject *executor)
     if (!executor->vm_data.linked) {
         return;
     }
+    PyInterpreterState *interp = PyInterpreterState_Get();
     _PyExecutorLinkListNode *links = &executor->vm_data.links;
     _PyExecutorObject *next = links->next;
     _PyExecutorObject *prev = links->previous;
@@ -1104,10 +1381,14 @@ unlink_executor(_PyExecutorObject *executor)
     }
     else {
         // prev == NULL implies that executor is the list head
-        PyInterpreterState *interp = PyInterpreterState_Get();
         assert(interp->executor_list_head == executor);
         interp->executor_list_head = next;
     }
+    if (!bloom_filter_is_empty(&executor->vm_data.bloom)) {
+        interp->executor_bloom_count--;
+        assert(interp->executor_bloom_count >= 0);
+    }
+    remove_dependencies(interp, executor);
     executor->vm_data.linked = false;
 }
 
@@ -1119,6 +1400,7 @@ _Py_ExecutorInit(_PyExecutorObject *executor, _PyBloomFilter *dependency_set)
     for (int i = 0; i < BLOOM_FILTER_WORDS; i++) {
         executor->vm_data.bloom.bits[i] = dependency_set->bits[i];
     }
+    executor->vm_data.dependencies = NULL;
     link_executor(executor);
 }
 
@@ -1132,8 +1414,19 @@ _Py_ExecutorClear(_PyExecutorObject *executor)
 void
 _Py_Executor_DependsOn(_PyExecutorObject *executor, void *obj)
 {
-    assert(executor->vm_data.valid = true);
-    _Py_BloomFilter_Add(&executor->vm_data.bloom, obj);
+    if (!executor->vm_data.linked) {
+        // Invalidated executors don't need to track dependencies.
+        return;
+    }
+    PyInterpreterState *interp = _PyInterpreterState_GET();
+    if (add_dependency(interp, executor, obj) < 0) {
+        // Out of memory: fall back to the bloom filter, which is always
+        // correct, just slower to check.
+        if (bloom_filter_is_empty(&executor->vm_data.bloom)) {
+            interp->executor_bloom_count++;
+        }
+        _Py_BloomFilter_Add(&executor->vm_data.bloom, obj);
+    }
 }
 
 /* Invalidate all executors that depend on `obj`
@@ -1142,11 +1435,27 @@ _Py_Executor_DependsOn(_PyExecutorObject *executor, void *obj)
 void
 _Py_Executors_InvalidateDependency(PyInterpreterState *interp, void *obj)
 {
+    if (interp->executor_dependents != NULL) {
+        _Py_hashtable_entry_t *entry;
+        // Unlinking the executor removes its dependencies, including the
+        // one at the head of the list for obj.
+        while ((entry = _Py_hashtable_get_entry(interp->executor_dependents,
+                                                obj)) != NULL)
+        {
+            _PyExecutorDependency *dep = entry->value;
+            _PyExecutorObject *exec = dep->executor;
+            assert(exec->vm_data.valid);
+            exec->vm_data.valid = false;
+            unlink_executor(exec);
+        }
+    }
+    if (interp->executor_bloom_count == 0) {
+        return;
+    }
     _PyBloomFilter obj_filter;
     _Py_BloomFilter_Init(&obj_filter);
     _Py_BloomFilter_Add(&obj_filter, obj);
     /* Walk the list of executors */
-    /* TO DO -- Use a tree to avoid traversing as many objects */
     for (_PyExecutorObject *exec = interp->executor_list_head; exec != NULL;) {
         assert(exec->vm_data.valid);
         _PyExecutorObject *next = exec->vm_data.links.next;
@@ -1170,7 +1479,20 @@ _Py_Executors_InvalidateAll(PyInterpreterState *interp)
         exec->vm_data.links.previous = NULL;
         exec->vm_data.valid = false;
         exec->vm_data.linked = false;
+        // Each dependency is freed once, from its executor's list.
+        _PyExecutorDependency *dep = exec->vm_data.dependencies;
+        exec->vm_data.dependencies = NULL;
+        while (dep != NULL) {
+            _PyExecutorDependency *next_dep = dep->next;
+            PyMem_RawFree(dep);
+            dep = next_dep;
+        }
         exec = next;
     }
     interp->executor_list_head = NULL;
+    interp->executor_bloom_count = 0;
+    if (interp->executor_dependents != NULL) {
+        _Py_hashtable_destroy(interp->executor_dependents);
+        interp->executor_dependents = NULL;
+    }
 }
@@ -1,17 +1,870 @@
 #include "Python.h"
 #include "opcode.h"
+#include "pycore_function.h"     // _PyFunction_LookupByVersion()
 #include "pycore_interp.h"
 #include "pycore_opcode_metadata.h"
 #include "pycore_opcode_utils.h"
 #include "pycore_pystate.h"       // _PyInterpreterState_GET()
 #include "pycore_uops.h"
 #include "pycore_long.h"
+#include "pycore_object.h"       // _PyNone_Type
 #include "cpython/optimizer.h"
 #include <stdbool.h>
 #include <stdint.h>
 #include <stddef.h>
 #include "pycore_optimizer.h"
 
+/* Abstract interpretation of uop traces.
+ *
+ * The main part of the trace is interpreted once, from top to bottom,
+ * over an abstract frame whose locals and stack hold symbols instead of
+ * objects.  A symbol records what is known about the object in a slot:
+ * its exact type and, if it is a constant, its (borrowed) value.  Slots
+ * that hold the same object share a symbol, so a guard that succeeds on
+ * a value loaded from a local also teaches us about that local.
+ *
+ * A trace is straight-line code: branches only lead to the exit stubs,
+ * and _JUMP_TO_TOP starts over with nothing known.  So a single forward
+ * pass is sound.  The pass stops at the first frame push that remains
+ * after inlining (see inline_calls() below).
+ *
+ * What we learn is used to
+ *   - replace guards whose outcome is already known,
+ *   - fold int arithmetic on constants when the result is immortal,
+ *   - drop pure pushes that are immediately popped again.
+ *
+ * Exact types never change, but type versions and inline values do.
+ * Those facts are only trusted until the next uop that may run arbitrary
+ * code (e.g. by calling a function or freeing an object with a __del__).
+ * Every such uop bumps ctx->epoch, invalidating all facts from before.
+ */
+
+#ifdef Py_DEBUG
+#define DPRINTF(level, ...) \
+    if (lltrace >= (level)) { printf(__VA_ARGS__); }
+#else
+#define DPRINTF(level, ...)
+#endif
+
+/* Each uop creates at most a few new symbols on average;
+ * if we run out we simply stop analyzing the rest of the trace. */
+#define SYMBOLS_PER_UOP 4
+
+typedef struct {
+    PyTypeObject *typ;       // Exact type, or NULL if unknown
+    PyObject *const_val;     // Borrowed constant value, or NULL
+    uint32_t type_version;   // Valid while version_epoch == ctx->epoch
+    int version_epoch;
+    int values_epoch;        // Inline values valid while == ctx->epoch
+} _Py_UOpsSymbol;
+
+typedef struct {
+    PyCodeObject *co;
+    int epoch;
+    int n_syms;
+    int max_syms;
+    bool out_of_space;
+    _Py_UOpsSymbol *syms;    // max_syms + 1 entries, the last is scratch
+    int n_localsplus;
+    _Py_UOpsSymbol **localsplus;  // Locals followed by the stack
+    _Py_UOpsSymbol **stack_base;
+    _Py_UOpsSymbol **stack_limit;
+} _Py_UOpsAbstractInterpContext;
+
+static _Py_UOpsSymbol *
+sym_new_unknown(_Py_UOpsAbstractInterpContext *ctx)
+{
+    _Py_UOpsSymbol *sym;
+    if (ctx->n_syms < ctx->max_syms) {
+        sym = &ctx->syms[ctx->n_syms++];
+    }
+    else {
+        // The caller stops analyzing after this uop.
+        ctx->out_of_space = true;
+        sym = &ctx->syms[ctx->max_syms];
+    }
+    sym->typ = NULL;
+    sym->const_val = NULL;
+    sym->type_version = 0;
+    sym->version_epoch = 0;
+    sym->values_epoch = 0;
+    return sym;
+}
+
+static _Py_UOpsSymbol *
+sym_new_type(_Py_UOpsAbstractInterpContext *ctx, PyTypeObject *typ)
+{
+    _Py_UOpsSymbol *sym = sym_new_unknown(ctx);
+    sym->typ = typ;
+    return sym;
+}
+
+static _Py_UOpsSymbol *
+sym_new_const(_Py_UOpsAbstractInterpContext *ctx, PyObject *const_val)
+{
+    _Py_UOpsSymbol *sym = sym_new_type(ctx, Py_TYPE(const_val));
+    sym->const_val = const_val;
+    return sym;
+}
+
+static inline bool
+sym_matches_type(_Py_UOpsSymbol *sym, PyTypeObject *typ)
+{
+    return sym->typ == typ;
+}
+
+/* Record the result of a passed guard.  If the symbol is already known
+ * to have a different type the guard always fails, and whatever follows
+ * is unreachable; keep the old type so constants stay consistent. */
+static inline void
+sym_set_type(_Py_UOpsSymbol *sym, PyTypeObject *typ)
+{
+    if (sym->typ == NULL) {
+        sym->typ = typ;
+    }
+}
+
+/* Return true if decref'ing an object of this symbol can not run
+ * arbitrary code, either because the object is kept alive by a
+ * constant, or because its type has a trivial deallocator. */
+static bool
+sym_is_safe_to_decref(_Py_UOpsSymbol *sym)
+{
+    if (sym->const_val != NULL) {
+        return true;
+    }
+    PyTypeObject *typ = sym->typ;
+    return (typ == &PyLong_Type || typ == &PyFloat_Type ||
+            typ == &PyUnicode_Type || typ == &PyBool_Type ||
+            typ == &_PyNone_Type);
+}
+
+/* Return true if some slot below `stack_pointer` still holds `sym`. */
+static bool
+sym_is_referenced(_Py_UOpsAbstractInterpContext *ctx, _Py_UOpsSymbol *sym,
+                  _Py_UOpsSymbol **stack_pointer)
+{
+    for (_Py_UOpsSymbol **p = ctx->localsplus; p < stack_pointer; p++) {
+        if (*p == sym) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/* Forget all facts that arbitrary code could invalidate. */
+static inline void
+escape(_Py_UOpsAbstractInterpContext *ctx)
+{
+    ctx->epoch++;
+}
+
+/* Account for a reference to `sym` being dropped. */
+static void
+sym_decref(_Py_UOpsAbstractInterpContext *ctx, _Py_UOpsSymbol *sym,
+           _Py_UOpsSymbol **stack_pointer)
+{
+    if (!sym_is_safe_to_decref(sym) &&
+        !sym_is_referenced(ctx, sym, stack_pointer))
+    {
+        escape(ctx);
+    }
+}
+
+static const char *
+uop_name(int index)
+{
+    if (index <= MAX_REAL_OPCODE) {
+        return _PyOpcode_OpName[index];
+    }
+    return _PyOpcode_uop_name[index];
+}
+
+/* Return true if the uop may run arbitrary code.  The uops with their own
+ * case in uop_abstract_interpret() account for that themselves. */
+static bool
+op_may_escape(int opcode)
+{
+    switch (opcode) {
+        // Specially handled
+        case LOAD_FAST:
+        case LOAD_FAST_CHECK:
+        case LOAD_FAST_AND_CLEAR:
+        case LOAD_CONST:
+        case STORE_FAST:
+        case STORE_FAST_MAYBE_NULL:
+        case DELETE_FAST:
+        case COPY:
+        case SWAP:
+        case POP_TOP:
+        case _GUARD_BOTH_INT:
+        case _GUARD_NOS_INT:
+        case _GUARD_TOS_INT:
+        case _GUARD_BOTH_FLOAT:
+        case _GUARD_NOS_FLOAT:
+        case _GUARD_TOS_FLOAT:
+        case _GUARD_BOTH_UNICODE:
+        case _GUARD_TYPE_VERSION:
+        case _CHECK_MANAGED_OBJECT_HAS_VALUES:
+        case _BINARY_OP_MULTIPLY_INT:
+        case _BINARY_OP_ADD_INT:
+        case _BINARY_OP_SUBTRACT_INT:
+        case _BINARY_OP_MULTIPLY_FLOAT:
+        case _BINARY_OP_ADD_FLOAT:
+        case _BINARY_OP_SUBTRACT_FLOAT:
+        case _BINARY_OP_ADD_UNICODE:
+        case _LOAD_ATTR_INSTANCE_VALUE:
+        case _ITER_NEXT_RANGE:
+        case _LOAD_CONST_INLINE_BORROW:
+        case _POP_TWO_LOAD_CONST_INLINE_BORROW:
+        case _POP_INLINED_CALL_UNDER_TOP:
+        case _POP_INLINED_CALL_LOAD_CONST_INLINE:
+        // Generic, but only guards or decrefs of objects of known type
+        case NOP:
+        case RESUME_CHECK:
+        case PUSH_NULL:
+        case TO_BOOL_BOOL:
+        case TO_BOOL_INT:
+        case TO_BOOL_NONE:
+        case TO_BOOL_STR:
+        case COMPARE_OP_FLOAT:
+        case COMPARE_OP_INT:
+        case COMPARE_OP_STR:
+        case _GUARD_GLOBALS_VERSION:
+        case _GUARD_BUILTINS_VERSION:
+        case _LOAD_GLOBAL_MODULE:
+        case _LOAD_GLOBAL_BUILTINS:
+        case _GUARD_DORV_VALUES:
+        case _GUARD_KEYS_VERSION:
+        case _CHECK_PEP_523:
+        case _CHECK_FUNCTION_EXACT_ARGS:
+        case _CHECK_STACK_SPACE:
+        case _ITER_CHECK_LIST:
+        case _IS_ITER_EXHAUSTED_LIST:
+        case _ITER_NEXT_LIST:
+        case _ITER_CHECK_TUPLE:
+        case _IS_ITER_EXHAUSTED_TUPLE:
+        case _ITER_NEXT_TUPLE:
+        case _ITER_CHECK_RANGE:
+        case _IS_ITER_EXHAUSTED_RANGE:
+        case _POP_JUMP_IF_FALSE:
+        case _POP_JUMP_IF_TRUE:
+        case _SET_IP:
+        case _SAVE_RETURN_OFFSET:
+            return false;
+        default:
+            return true;
+    }
+}
+
+/* Return the index of the closest uop before `pc` that does something,
+ * or -1 if there isn't one. */
+static int
+previous_real_op(_PyUOpInstruction *trace, int pc)
+{
+    while (--pc >= 0) {
+        int opcode = trace[pc].opcode;
+        if (opcode != NOP && opcode != _SET_IP) {
+            return pc;
+        }
+    }
+    return -1;
+}
+
+/* Return the uop that stores the result of `opcode` straight into a local
+ * holding its left operand, updating it in place if possible, or 0. */
+static int
+inplace_store_op(int opcode)
+{
+    switch (opcode) {
+        case _BINARY_OP_MULTIPLY_FLOAT:
+            return _BINARY_OP_INPLACE_MULTIPLY_FLOAT;
+        case _BINARY_OP_ADD_FLOAT:
+            return _BINARY_OP_INPLACE_ADD_FLOAT;
+        case _BINARY_OP_SUBTRACT_FLOAT:
+            return _BINARY_OP_INPLACE_SUBTRACT_FLOAT;
+        case _BINARY_OP_ADD_INT:
+            return _BINARY_OP_INPLACE_ADD_INT;
+        case _BINARY_OP_SUBTRACT_INT:
+            return _BINARY_OP_INPLACE_SUBTRACT_INT;
+        default:
+            return 0;
+    }
+}
+
+static int
+uop_abstract_interpret(
+    _Py_UOpsAbstractInterpContext *ctx,
+    _PyUOpInstruction *trace,
+    int trace_len,
+    int curr_stacklen
+)
+{
+#ifdef Py_DEBUG
+    char *uop_debug = Py_GETENV("PYTHONUOPSDEBUG");
+    int lltrace = 0;
+    if (uop_debug != NULL && *uop_debug >= '0') {
+        lltrace = *uop_debug - '0';
+    }
+#endif
+
+#define STACK_LEVEL()     ((int)(stack_pointer - ctx->stack_base))
+#define STACK_SHRINK(n) \
+    do { \
+        if (stack_pointer - (n) < ctx->stack_base) { \
+            goto out_of_bounds; \
+        } \
+        stack_pointer -= (n); \
+    } while (0)
+#define STACK_GROW(n) \
+    do { \
+        if (stack_pointer + (n) > ctx->stack_limit) { \
+            goto out_of_bounds; \
+        } \
+        stack_pointer += (n); \
+    } while (0)
+#define PEEK(n)           (stack_pointer[-(n)])
+#define GETLOCAL(n)       (ctx->localsplus[(n)])
+#define REPLACE_OP(INST, OP, ARG, OPERAND) \
+    DPRINTF(2, "  replacing %s with %s\n", \
+            uop_name((INST)->opcode), uop_name(OP)); \
+    (INST)->opcode = (OP); \
+    (INST)->oparg = (ARG); \
+    (INST)->operand = (OPERAND);
+
+    PyCodeObject *co = ctx->co;
+    _Py_UOpsSymbol **stack_pointer = ctx->stack_base + curr_stacklen;
+    for (_Py_UOpsSymbol **p = ctx->localsplus; p < stack_pointer; p++) {
+        *p = sym_new_unknown(ctx);
+    }
+
+    // The last arithmetic uop, and its left operand (see STORE_FAST):
+    int arith_pc = -1;
+    _Py_UOpsSymbol *arith_left = NULL;
+
+    int pc = 0;
+    for (; pc < trace_len; pc++) {
+        _PyUOpInstruction *inst = &trace[pc];
+        int opcode = inst->opcode;
+        int oparg = inst->oparg;
+
+        switch (opcode) {
+
+            case LOAD_FAST:
+            case LOAD_FAST_CHECK: {
+                STACK_GROW(1);
+                PEEK(1) = GETLOCAL(oparg);
+                break;
+            }
+
+            case LOAD_FAST_AND_CLEAR: {
+                STACK_GROW(1);
+                PEEK(1) = GETLOCAL(oparg);
+                GETLOCAL(oparg) = sym_new_unknown(ctx);
+                break;
+            }
+
+            case LOAD_CONST: {
+                STACK_GROW(1);
+                PEEK(1) = sym_new_const(ctx, PyTuple_GET_ITEM(co->co_consts, oparg));
+                break;
+            }
+
+            case STORE_FAST:
+            case STORE_FAST_MAYBE_NULL: {
+                _Py_UOpsSymbol *old = GETLOCAL(oparg);
+                // `x = x + y`: let the arithmetic store into x itself, so a
+                // float or int accumulator isn't reboxed every time.
+                if (opcode == STORE_FAST && old == arith_left &&
+                    previous_real_op(trace, pc) == arith_pc &&
+                    inplace_store_op(trace[arith_pc].opcode))
+                {
+                    _PyUOpInstruction *arith = &trace[arith_pc];
+                    REPLACE_OP(arith, inplace_store_op(arith->opcode),
+                               oparg, arith->operand);
+                    REPLACE_OP(inst, NOP, 0, 0);
+                }
+                GETLOCAL(oparg) = PEEK(1);
+                STACK_SHRINK(1);
+                sym_decref(ctx, old, stack_pointer);
+                break;
+            }
+
+            case DELETE_FAST: {
+                _Py_UOpsSymbol *old = GETLOCAL(oparg);
+                GETLOCAL(oparg) = sym_new_unknown(ctx);
+                sym_decref(ctx, old, stack_pointer);
+                break;
+            }
+
+            case COPY: {
+                _Py_UOpsSymbol *bottom = PEEK(oparg);
+                STACK_GROW(1);
+                PEEK(1) = bottom;
+                break;
+            }
+
+            case SWAP: {
+                _Py_UOpsSymbol *top = PEEK(1);
+                PEEK(1) = PEEK(oparg);
+                PEEK(oparg) = top;
+                break;
+            }
+
+            case POP_TOP: {
+                _Py_UOpsSymbol *value = PEEK(1);
+                STACK_SHRINK(1);
+                sym_decref(ctx, value, stack_pointer);
+                break;
+            }
+
+            case _PUSH_FRAME:
+            case _POP_FRAME: {
+                DPRINTF(2, "  stopping at frame change\n");
+                goto done;
+            }
+
+            case _GUARD_BOTH_INT:
+            case _GUARD_BOTH_FLOAT:
+            case _GUARD_BOTH_UNICODE: {
+                _Py_UOpsSymbol *left = PEEK(2);
+                _Py_UOpsSymbol *right = PEEK(1);
+                PyTypeObject *typ;
+                int nos_guard = 0, tos_guard = 0;
+                switch (opcode) {
+                    case _GUARD_BOTH_INT:
+                        typ = &PyLong_Type;
+                        nos_guard = _GUARD_NOS_INT;
+                        tos_guard = _GUARD_TOS_INT;
+                        break;
+                    case _GUARD_BOTH_FLOAT:
+                        typ = &PyFloat_Type;
+                        nos_guard = _GUARD_NOS_FLOAT;
+                        tos_guard = _GUARD_TOS_FLOAT;
+                        break;
+                    default:
+                        typ = &PyUnicode_Type;
+                        break;
+                }
+                bool left_ok = sym_matches_type(left, typ);
+                bool right_ok = sym_matches_type(right, typ);
+                if (left_ok && right_ok) {
+                    REPLACE_OP(inst, NOP, 0, 0);
+                }
+                else if (left_ok && tos_guard) {
+                    REPLACE_OP(inst, tos_guard, 0, 0);
+                }
+                else if (right_ok && nos_guard) {
+                    REPLACE_OP(inst, nos_guard, 0, 0);
+                }
+                sym_set_type(left, typ);
+                sym_set_type(right, typ);
+                break;
+            }
+
+            case _GUARD_NOS_INT:
+            case _GUARD_NOS_FLOAT:
+            case _GUARD_TOS_INT:
+            case _GUARD_TOS_FLOAT: {
+                bool nos = (opcode == _GUARD_NOS_INT || opcode == _GUARD_NOS_FLOAT);
+                PyTypeObject *typ = (opcode == _GUARD_NOS_INT || opcode == _GUARD_TOS_INT) ?
+                    &PyLong_Type : &PyFloat_Type;
+                _Py_UOpsSymbol *value = nos ? PEEK(2) : PEEK(1);
+                if (sym_matches_type(value, typ)) {
+                    REPLACE_OP(inst, NOP, 0, 0);
+                }
+                sym_set_type(value, typ);
+                break;
+            }
+
+            case _GUARD_TYPE_VERSION: {
+                _Py_UOpsSymbol *owner = PEEK(1);
+                uint32_t type_version = (uint32_t)inst->operand;
+                if (owner->version_epoch == ctx->epoch &&
+                    owner->type_version == type_version)
+                {
+                    REPLACE_OP(inst, NOP, 0, 0);
+                }
+                owner->type_version = type_version;
+                owner->version_epoch = ctx->epoch;
+                break;
+            }
+
+            case _CHECK_MANAGED_OBJECT_HAS_VALUES: {
+                _Py_UOpsSymbol *owner = PEEK(1);
+                if (owner->values_epoch == ctx->epoch) {
+                    REPLACE_OP(inst, NOP, 0, 0);
+                }
+                owner->values_epoch = ctx->epoch;
+                break;
+            }
+
+            case _BINARY_OP_MULTIPLY_INT:
+            case _BINARY_OP_ADD_INT:
+            case _BINARY_OP_SUBTRACT_INT: {
+                _Py_UOpsSymbol *left = PEEK(2);
+                _Py_UOpsSymbol *right = PEEK(1);
+                arith_pc = pc;
+                arith_left = left;
+                STACK_SHRINK(1);
+                PyObject *res = NULL;
+                if (left->const_val != NULL && PyLong_CheckExact(left->const_val) &&
+                    right->const_val != NULL && PyLong_CheckExact(right->const_val))
+                {
+                    PyLongObject *lhs = (PyLongObject *)left->const_val;
+                    PyLongObject *rhs = (PyLongObject *)right->const_val;
+                    switch (opcode) {
+                        case _BINARY_OP_MULTIPLY_INT:
+                            res = _PyLong_Multiply(lhs, rhs);
+                            break;
+                        case _BINARY_OP_ADD_INT:
+                            res = _PyLong_Add(lhs, rhs);
+                            break;
+                        default:
+                            res = _PyLong_Subtract(lhs, rhs);
+                            break;
+                    }
+                    if (res == NULL) {
+                        PyErr_Clear();
+                    }
+                    else if (!_Py_IsImmortal(res)) {
+                        // The executor can't own a reference to it.
+                        Py_CLEAR(res);
+                    }
+                }
+                if (res != NULL) {
+                    REPLACE_OP(inst, _POP_TWO_LOAD_CONST_INLINE_BORROW,
+                               0, (uint64_t)(uintptr_t)res);
+                    PEEK(1) = sym_new_const(ctx, res);
+                }
+                else {
+                    PEEK(1) = sym_new_type(ctx, &PyLong_Type);
+                }
+                break;
+            }
+
+            case _BINARY_OP_MULTIPLY_FLOAT:
+            case _BINARY_OP_ADD_FLOAT:
+            case _BINARY_OP_SUBTRACT_FLOAT: {
+                arith_pc = pc;
+                arith_left = PEEK(2);
+                STACK_SHRINK(1);
+                PEEK(1) = sym_new_type(ctx, &PyFloat_Type);
+                break;
+            }
+
+            case _BINARY_OP_ADD_UNICODE: {
+                STACK_SHRINK(1);
+                PEEK(1) = sym_new_type(ctx, &PyUnicode_Type);
+                break;
+            }
+
+            case _LOAD_ATTR_INSTANCE_VALUE: {
+                _Py_UOpsSymbol *owner = PEEK(1);
+                PEEK(1) = sym_new_unknown(ctx);
+                if (oparg & 1) {
+                    STACK_GROW(1);
+                    PEEK(1) = sym_new_unknown(ctx);
+                }
+                sym_decref(ctx, owner, stack_pointer);
+                break;
+            }
+
+            case _ITER_NEXT_RANGE: {
+                STACK_GROW(1);
+                PEEK(1) = sym_new_type(ctx, &PyLong_Type);
+                break;
+            }
+
+            case _LOAD_CONST_INLINE_BORROW: {
+                STACK_GROW(1);
+                PEEK(1) = sym_new_const(ctx, (PyObject *)inst->operand);
+                break;
+            }
+
+            case _POP_TWO_LOAD_CONST_INLINE_BORROW: {
+                _Py_UOpsSymbol *pop1 = PEEK(2);
+                _Py_UOpsSymbol *pop2 = PEEK(1);
+                STACK_SHRINK(1);
+                PEEK(1) = sym_new_const(ctx, (PyObject *)inst->operand);
+                sym_decref(ctx, pop2, stack_pointer);
+                sym_decref(ctx, pop1, stack_pointer);
+                break;
+            }
+
+            case _POP_INLINED_CALL_UNDER_TOP: {
+                _Py_UOpsSymbol *res = PEEK(1);
+                STACK_SHRINK(oparg + 2);
+                // The callable and the arguments are now just above the stack:
+                for (int i = 0; i <= oparg; i++) {
+                    if (stack_pointer[i] != res) {
+                        sym_decref(ctx, stack_pointer[i], stack_pointer);
+                    }
+                }
+                STACK_GROW(1);
+                PEEK(1) = res;
+                break;
+            }
+
+            case _POP_INLINED_CALL_LOAD_CONST_INLINE: {
+                STACK_SHRINK(oparg + 1);
+                for (int i = 0; i <= oparg; i++) {
+                    sym_decref(ctx, stack_pointer[i], stack_pointer);
+                }
+                STACK_GROW(1);
+                PEEK(1) = sym_new_const(ctx, (PyObject *)inst->operand);
+                break;
+            }
+
+#include "abstract_interp_cases.c.h"
+
+            default:
+            {
+                DPRINTF(1, "Unknown uop %s\n", uop_name(opcode));
+                // A bug in this pass, but not one worth aborting for.
+                assert(0);
+                goto error;
+            }
+        }
+
+        if (op_may_escape(opcode)) {
+            escape(ctx);
+        }
+        if (ctx->out_of_space) {
+            DPRINTF(2, "  out of symbols\n");
+            goto done;
+        }
+        if (opcode == _JUMP_TO_TOP || opcode == _EXIT_TRACE) {
+            break;
+        }
+    }
+
+done:
+    return pc;
+
+out_of_bounds:
+    // This would be a bug in the trace or in the stack effects.
+    DPRINTF(1, "Abstract stack out of bounds at %s\n",
+            uop_name(trace[pc].opcode));
+    assert(0);
+error:
+    // Symbols and uops may have been changed already: the caller restores
+    // the trace.
+    return -1;
+
+#undef STACK_LEVEL
+#undef STACK_SHRINK
+#undef STACK_GROW
+#undef PEEK
+#undef GETLOCAL
+#undef REPLACE_OP
+}
+
+static inline bool
+op_is_pure_push(int opcode)
+{
+    return (opcode == LOAD_FAST ||
+            opcode == LOAD_CONST ||
+            opcode == COPY ||
+            opcode == _LOAD_CONST_INLINE_BORROW);
+}
+
+/* Remove pure pushes that are immediately popped again,
+ * typically the operands of a folded operation. */
+static void
+remove_dead_pushes(_PyUOpInstruction *trace, int trace_len)
+{
+    for (int pc = 0; pc < trace_len; pc++) {
+        int opcode = trace[pc].opcode;
+        if (opcode == POP_TOP) {
+            int prev = previous_real_op(trace, pc);
+            if (prev >= 0 && op_is_pure_push(trace[prev].opcode)) {
+                trace[prev].opcode = NOP;
+                trace[pc].opcode = NOP;
+            }
+        }
+        else if (opcode == _POP_TWO_LOAD_CONST_INLINE_BORROW) {
+            int prev = previous_real_op(trace, pc);
+            int prev2 = prev >= 0 ? previous_real_op(trace, prev) : -1;
+            if (prev2 >= 0 &&
+                op_is_pure_push(trace[prev].opcode) &&
+                op_is_pure_push(trace[prev2].opcode))
+            {
+                trace[prev2].opcode = NOP;
+                trace[prev].opcode = NOP;
+                trace[pc].opcode = _LOAD_CONST_INLINE_BORROW;
+            }
+        }
+        else if (opcode == _JUMP_TO_TOP || opcode == _EXIT_TRACE) {
+            break;
+        }
+    }
+}
+
+/* Frameless inlining of calls to tiny Python functions.
+ *
+ * The projector follows CALL_PY_EXACT_ARGS (and CALL_BOUND_METHOD_EXACT_ARGS)
+ * into the callee, so the callee's uops sit between _PUSH_FRAME and
+ * _POP_FRAME.  If the callee is just `return CONST`, `return arg` or
+ * `return arg.attr` (where `arg` is the last argument, typically self), its
+ * frame can never be observed: the body can't raise, call anything, or
+ * leave the trace once it has started.  Such calls are replaced by uops
+ * that compute the result straight from the caller's stack, followed by
+ * _POP_INLINED_CALL_UNDER_TOP to drop the callable and the arguments, or
+ * by _POP_INLINED_CALL_LOAD_CONST_INLINE that does both for `return CONST`.
+ *
+ * The version guard of the call stays, so the callee is still the code that
+ * was inlined.  The attribute guards of `return arg.attr` run on `arg` while
+ * it is still on top of the caller's stack, before anything is pushed, so a
+ * failing guard simply re-executes the CALL in tier 1.
+ */
+
+// Longest body considered: LOAD_FAST, two guards and the attribute load.
+#define MAX_INLINED_BODY 4
+
+static bool
+op_is_inlinable_guard(int opcode)
+{
+    return (opcode == _GUARD_TYPE_VERSION ||
+            opcode == _CHECK_MANAGED_OBJECT_HAS_VALUES);
+}
+
+static bool
+op_is_inlinable_attr_load(_PyUOpInstruction *inst)
+{
+    return ((inst->opcode == _LOAD_ATTR_INSTANCE_VALUE ||
+             inst->opcode == _LOAD_ATTR_SLOT) &&
+            (inst->oparg & 1) == 0);
+}
+
+/* Try to inline the call guarded by the _CHECK_FUNCTION_EXACT_ARGS at `pc`.
+ * Return the index of the last uop handled. */
+static int
+inline_call(_PyUOpInstruction *trace, int trace_len, int pc)
+{
+#ifdef Py_DEBUG
+    char *uop_debug = Py_GETENV("PYTHONUOPSDEBUG");
+    int lltrace = 0;
+    if (uop_debug != NULL && *uop_debug >= '0') {
+        lltrace = *uop_debug - '0';
+    }
+#endif
+    _PyUOpInstruction *check = &trace[pc];
+    assert(check->opcode == _CHECK_FUNCTION_EXACT_ARGS);
+    if (pc + 4 >= trace_len ||
+        trace[pc + 1].opcode != _CHECK_STACK_SPACE ||
+        trace[pc + 2].opcode != _INIT_CALL_PY_EXACT_ARGS ||
+        trace[pc + 3].opcode != _SAVE_RETURN_OFFSET ||
+        trace[pc + 4].opcode != _PUSH_FRAME)
+    {
+        return pc;
+    }
+    // Find the callee the same way the projector did.
+    uint32_t func_version = (uint32_t)check->operand;
+    PyFunctionObject *func = _PyFunction_LookupByVersion(func_version);
+    if (func == NULL) {
+        return pc;
+    }
+    PyCodeObject *callee = (PyCodeObject *)func->func_code;
+    if (callee->co_version != func_version) {
+        return pc;
+    }
+    // Collect the callee's body, without the bookkeeping that only
+    // matters for a real frame.
+    _PyUOpInstruction *body[MAX_INLINED_BODY];
+    int body_len = 0;
+    int end = pc + 5;
+    for (;; end++) {
+        if (end >= trace_len) {
+            return pc;
+        }
+        int opcode = trace[end].opcode;
+        if (opcode == _POP_FRAME) {
+            break;
+        }
+        if (opcode == _SET_IP || opcode == NOP || opcode == RESUME_CHECK) {
+            continue;
+        }
+        if (body_len == MAX_INLINED_BODY || opcode == _PUSH_FRAME ||
+            opcode == _JUMP_TO_TOP || opcode == _EXIT_TRACE)
+        {
+            return pc;
+        }
+        body[body_len++] = &trace[end];
+    }
+    if (body_len == 0) {
+        return pc;
+    }
+    // The guard ensures that the callee's arguments are the top `argcount`
+    // stack items, so local i is at depth argcount - i.  There are
+    // oparg + 1 stack items above the callable (including self_or_null).
+    int argcount = callee->co_argcount;
+    int nargs = check->oparg + 1;
+    _PyUOpInstruction new_body[MAX_INLINED_BODY + 1];
+    int new_len = 0;
+    _PyUOpInstruction *first = body[0];
+    if (body_len == 1 && first->opcode == LOAD_CONST) {
+        // return CONST
+        PyObject *value = PyTuple_GET_ITEM(callee->co_consts, first->oparg);
+        new_body[new_len++] = (_PyUOpInstruction){
+            _POP_INLINED_CALL_LOAD_CONST_INLINE, nargs,
+            (uint64_t)(uintptr_t)value};
+    }
+    else if (body_len == 1 && first->opcode == LOAD_FAST &&
+             (int)first->oparg < argcount)
+    {
+        // return arg
+        int depth = argcount - first->oparg;
+        if (depth > 1) {
+            new_body[new_len++] = (_PyUOpInstruction){SWAP, depth, 0};
+        }
+        new_body[new_len++] = (_PyUOpInstruction){
+            _POP_INLINED_CALL_UNDER_TOP, nargs - 1, 0};
+    }
+    else if (body_len >= 2 && first->opcode == LOAD_FAST &&
+             (int)first->oparg == argcount - 1 &&
+             op_is_inlinable_attr_load(body[body_len - 1]))
+    {
+        // return arg.attr, consuming the caller's reference to arg
+        for (int i = 1; i < body_len - 1; i++) {
+            if (!op_is_inlinable_guard(body[i]->opcode)) {
+                return pc;
+            }
+            new_body[new_len++] = *body[i];
+        }
+        new_body[new_len++] = *body[body_len - 1];
+        new_body[new_len++] = (_PyUOpInstruction){
+            _POP_INLINED_CALL_UNDER_TOP, nargs - 1, 0};
+    }
+    else {
+        return pc;
+    }
+    DPRINTF(2, "  inlining call to %s (%s:%d)\n",
+            PyUnicode_AsUTF8(callee->co_qualname),
+            PyUnicode_AsUTF8(callee->co_filename),
+            callee->co_firstlineno);
+    // Keep the version guard; overwrite everything up to the _POP_FRAME.
+    assert(new_len <= end - pc);
+    for (int i = pc + 1; i <= end; i++) {
+        trace[i].opcode = NOP;
+    }
+    memcpy(&trace[pc + 1], new_body, new_len * sizeof(_PyUOpInstruction));
+    return end;
+}
+
+static void
+inline_calls(_PyUOpInstruction *trace, int trace_len)
+{
+    for (int pc = 0; pc < trace_len; pc++) {
+        int opcode = trace[pc].opcode;
+        if (opcode == _CHECK_FUNCTION_EXACT_ARGS) {
+            pc = inline_call(trace, trace_len, pc);
+        }
+        else if (opcode == _JUMP_TO_TOP || opcode == _EXIT_TRACE) {
+            break;
+        }
+    }
+}
 
 int
 _Py_uop_analyze_and_optimize(
@@ -21,5 +874,37 @@ _Py_uop_analyze_and_optimize(
     int curr_stacklen
 )
 {
+    _Py_UOpsAbstractInterpContext ctx;
+    ctx.co = co;
+    ctx.epoch = 1;
+    ctx.n_syms = 0;
+    ctx.out_of_space = false;
+    ctx.n_localsplus = co->co_nlocalsplus;
+    int n_slots = co->co_nlocalsplus + co->co_stacksize;
+    ctx.max_syms = n_slots + SYMBOLS_PER_UOP * trace_len;
+    ctx.syms = PyMem_New(_Py_UOpsSymbol, ctx.max_syms + 1);
+    ctx.localsplus = PyMem_New(_Py_UOpsSymbol *, n_slots);
+    _PyUOpInstruction *original = PyMem_New(_PyUOpInstruction, trace_len);
+    if (ctx.syms == NULL || ctx.localsplus == NULL || original == NULL) {
+        // Not worth raising MemoryError; just skip the optimization.
+        goto finish;
+    }
+    ctx.stack_base = ctx.localsplus + co->co_nlocalsplus;
+    ctx.stack_limit = ctx.localsplus + n_slots;
+
+    memcpy(original, trace, trace_len * sizeof(_PyUOpInstruction));
+    inline_calls(trace, trace_len);
+    if (uop_abstract_interpret(&ctx, trace, trace_len, curr_stacklen) < 0) {
+        // Leave the trace unoptimized.
+        memcpy(trace, original, trace_len * sizeof(_PyUOpInstruction));
+    }
+    else {
+        remove_dead_pushes(trace, trace_len);
+    }
+
+finish:
+    PyMem_Free(ctx.syms);
+    PyMem_Free(ctx.localsplus);
+    PyMem_Free(original);
     return trace_len;
 }
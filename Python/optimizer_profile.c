@@ -0,0 +1,515 @@
+/* Persistent optimizer profiles (experimental).
+ *
+ * Every process starts cold: _PyCode_Quicken() resets all inline caches, and
+ * JUMP_BACKWARD must count up to the optimizer's threshold before a loop is
+ * traced.  For short-lived processes running the same code again and again,
+ * that warm-up can be most of their life.
+ *
+ * With -X optprofile=PATH (or PYTHONOPTPROFILE=PATH), the main interpreter
+ * remembers, for every code object it quickens:
+ *   - 's': the instructions that were specialized,
+ *   - 'b': the taken/not-taken history of the conditional branches that ran,
+ *     which the trace projector uses to pick the likely path,
+ *   - 'j': the JUMP_BACKWARD instructions that got executors (hot loops),
+ *     with the tier 2 optimizer (-X uops).
+ * A code object is recorded when it is deallocated, when it gets an executor
+ * and at exit.  What was recorded for the same code object by an earlier
+ * process is kept unless this one has something newer for the instruction.
+ * The profile is written to PATH at exit.  When a code object with a
+ * matching key is created later on, its specializable instructions
+ * specialize on their first execution rather than after the usual warm-up,
+ * its branch history is restored, and its hot loops are optimized on their
+ * first back edge.
+ *
+ * Specialized instructions are not restored directly, since their caches
+ * hold versions that are only meaningful within one process.  Code objects
+ * are keyed by a hash of their bytecode, name, file name and first line,
+ * which doesn't depend on the process (unlike hash(code)).
+ */
+
+#include "Python.h"
+#include "opcode.h"
+#include "pycore_code.h"          // _PyCode_CODE()
+#include "pycore_fileutils.h"     // _Py_wfopen()
+#include "pycore_hashtable.h"     // _Py_hashtable_t
+#include "pycore_interp.h"
+#include "pycore_opcode_metadata.h" // _PyOpcode_Deopt
+#include "pycore_optimizer.h"
+#include "pycore_pystate.h"       // _PyThreadState_GET()
+#include "cpython/optimizer.h"    // _PyExecutorObject
+
+#ifdef MS_WINDOWS
+#  include <windows.h>            // MoveFileExW()
+#else
+#  include <unistd.h>             // getpid()
+#endif
+
+#define PROFILE_HEADER "CPython optimizer profile"
+#define PROFILE_FORMAT_VERSION 1
+
+// Above the uop optimizer's backedge threshold, so the next back edge
+// optimizes the loop, and far enough from wrapping around.
+#define PRIMED_BACKEDGE_COUNTER (1 << 15)
+
+typedef struct {
+    uint32_t offset;    // In code units
+    char kind;          // 'j', 'b' or 's' (see above)
+    uint16_t value;     // The branch history for 'b'
+} ProfileRecord;
+
+typedef struct {
+    uint64_t key;
+    Py_ssize_t nrecords;
+    ProfileRecord records[1];
+} ProfileEntry;
+
+// The branch history set by _PyCode_Quicken(): the branch never ran.
+#define INITIAL_BRANCH_HISTORY 0x5555
+
+typedef struct _PyOptimizerProfile {
+    wchar_t *path;
+    // ProfileEntry * -> ProfileEntry * (the key and the value are the same)
+    _Py_hashtable_t *entries;
+    // The live code objects quickened since the profile was loaded, which
+    // are recorded when they are deallocated or at exit.
+    // PyCodeObject * -> PyCodeObject * (borrowed references)
+    _Py_hashtable_t *code_objects;
+} _PyOptimizerProfile;
+
+
+static Py_uhash_t
+entry_hash(const void *key)
+{
+    return (Py_uhash_t)((const ProfileEntry *)key)->key;
+}
+
+static int
+entry_compare(const void *key1, const void *key2)
+{
+    return ((const ProfileEntry *)key1)->key == ((const ProfileEntry *)key2)->key;
+}
+
+static ProfileEntry *
+entry_new(uint64_t key, Py_ssize_t nrecords)
+{
+    ProfileEntry *entry = PyMem_RawMalloc(
+        sizeof(ProfileEntry) + Py_MAX(nrecords - 1, 0) * sizeof(ProfileRecord));
+    if (entry != NULL) {
+        entry->key = key;
+        entry->nrecords = nrecords;
+    }
+    return entry;
+}
+
+/* Add `entry`, replacing any entry with the same key. */
+static int
+add_entry(_PyOptimizerProfile *profile, ProfileEntry *entry)
+{
+    ProfileEntry *old = _Py_hashtable_steal(profile->entries, entry);
+    PyMem_RawFree(old);
+    if (_Py_hashtable_set(profile->entries, entry, entry) < 0) {
+        PyMem_RawFree(entry);
+        return -1;
+    }
+    return 0;
+}
+
+
+/* Code object keys (64-bit FNV-1a) */
+
+#define FNV_OFFSET_BASIS 0xcbf29ce484222325ULL
+#define FNV_PRIME 0x100000001b3ULL
+
+static uint64_t
+fnv1a(uint64_t hash, const void *data, size_t size)
+{
+    const unsigned char *p = data;
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ p[i]) * FNV_PRIME;
+    }
+    return hash;
+}
+
+static uint64_t
+fnv1a_str(uint64_t hash, PyObject *str)
+{
+    assert(PyUnicode_Check(str));
+    int kind = PyUnicode_KIND(str);
+    hash = fnv1a(hash, &kind, sizeof(kind));
+    return fnv1a(hash, PyUnicode_DATA(str), PyUnicode_GET_LENGTH(str) * kind);
+}
+
+/* Return the unspecialized, uninstrumented opcode at index i, and its oparg
+ * in *oparg. */
+static int
+base_instruction(PyCodeObject *code, int i, int *oparg)
+{
+    _Py_CODEUNIT *instr = &_PyCode_CODE(code)[i];
+    *oparg = instr->op.arg;
+    if (instr->op.code == ENTER_EXECUTOR) {
+        _PyExecutorObject *exec = code->co_executors->executors[*oparg];
+        *oparg = exec->vm_data.oparg;
+        return _PyOpcode_Deopt[exec->vm_data.opcode];
+    }
+    return _Py_GetBaseOpcode(code, i);
+}
+
+static uint64_t
+code_key(PyCodeObject *code)
+{
+    uint64_t hash = FNV_OFFSET_BASIS;
+    hash = fnv1a_str(hash, code->co_qualname);
+    hash = fnv1a_str(hash, code->co_filename);
+    hash = fnv1a(hash, &code->co_firstlineno, sizeof(code->co_firstlineno));
+    for (int i = 0; i < Py_SIZE(code); i++) {
+        int oparg;
+        int opcode = base_instruction(code, i, &oparg);
+        unsigned char bytes[2] = {(unsigned char)opcode, (unsigned char)oparg};
+        hash = fnv1a(hash, bytes, sizeof(bytes));
+        i += _PyOpcode_Caches[opcode];
+    }
+    return hash;
+}
+
+
+/* Recording and applying */
+
+static inline bool
+is_conditional_branch(int opcode)
+{
+    return (opcode == POP_JUMP_IF_FALSE || opcode == POP_JUMP_IF_TRUE ||
+            opcode == POP_JUMP_IF_NONE || opcode == POP_JUMP_IF_NOT_NONE);
+}
+
+/* Record the state of `code`, keeping what an older entry for the same code
+ * object knew about the instructions that have nothing to record now. */
+static void
+record_code(_PyOptimizerProfile *profile, PyCodeObject *code)
+{
+    uint64_t key = code_key(code);
+    ProfileEntry probe = {.key = key};
+    ProfileEntry *old = _Py_hashtable_get(profile->entries, &probe);
+    // Count first, so the entry doesn't waste space on large code objects.
+    Py_ssize_t nrecords = 0;
+    for (int pass = 0; pass < 2; pass++) {
+        ProfileEntry *entry = NULL;
+        if (pass == 1) {
+            if (nrecords == 0) {
+                return;
+            }
+            entry = entry_new(key, nrecords);
+            if (entry == NULL) {
+                return;
+            }
+        }
+        Py_ssize_t n = 0;
+        Py_ssize_t k = 0;  // The next record of old
+        _Py_CODEUNIT *instructions = _PyCode_CODE(code);
+        for (int i = 0; i < Py_SIZE(code); i++) {
+            int actual = instructions[i].op.code;
+            int oparg;
+            int opcode = base_instruction(code, i, &oparg);
+            int caches = _PyOpcode_Caches[opcode];
+            ProfileRecord record = {(uint32_t)i, 0, 0};
+            if (actual == ENTER_EXECUTOR && opcode == JUMP_BACKWARD) {
+                record.kind = 'j';
+            }
+            else if (is_conditional_branch(opcode)) {
+                if (instructions[i + 1].cache != INITIAL_BRANCH_HISTORY) {
+                    record.kind = 'b';
+                    record.value = instructions[i + 1].cache;
+                }
+            }
+            else if (caches && actual != opcode &&
+                     actual < MIN_INSTRUMENTED_OPCODE)
+            {
+                record.kind = 's';
+            }
+            while (old != NULL && k < old->nrecords &&
+                   old->records[k].offset < (uint32_t)i)
+            {
+                k++;
+            }
+            if (record.kind == 0 && old != NULL && k < old->nrecords &&
+                old->records[k].offset == (uint32_t)i)
+            {
+                record = old->records[k];
+            }
+            if (record.kind) {
+                if (entry != NULL) {
+                    entry->records[n] = record;
+                }
+                n++;
+            }
+            i += caches;
+        }
+        nrecords = n;
+        if (entry != NULL) {
+            // Not worth raising MemoryError over; the profile is a hint.
+            (void)add_entry(profile, entry);
+        }
+    }
+}
+
+void
+_PyOptimizer_RecordProfile(PyCodeObject *code)
+{
+    PyInterpreterState *interp = _PyInterpreterState_GET();
+    _PyOptimizerProfile *profile = interp->optimizer_profile;
+    if (profile == NULL) {
+        return;
+    }
+    record_code(profile, code);
+}
+
+void
+_PyOptimizer_ForgetCode(PyCodeObject *code)
+{
+    PyInterpreterState *interp = _PyInterpreterState_GET();
+    _PyOptimizerProfile *profile = interp->optimizer_profile;
+    if (profile == NULL ||
+        _Py_hashtable_steal(profile->code_objects, code) == NULL)
+    {
+        return;
+    }
+    record_code(profile, code);
+}
+
+void
+_PyOptimizer_ApplyProfile(PyCodeObject *code)
+{
+    // Code objects are also created (and quickened) before the first
+    // thread state exists.
+    PyThreadState *tstate = _PyThreadState_GET();
+    if (tstate == NULL || tstate->interp->optimizer_profile == NULL) {
+        return;
+    }
+    _PyOptimizerProfile *profile = tstate->interp->optimizer_profile;
+    // Not worth raising MemoryError over: the code object just won't be
+    // recorded.
+    (void)_Py_hashtable_set(profile->code_objects, code, code);
+    ProfileEntry probe = {.key = code_key(code)};
+    ProfileEntry *entry = _Py_hashtable_get(profile->entries, &probe);
+    if (entry == NULL) {
+        return;
+    }
+    _Py_CODEUNIT *instructions = _PyCode_CODE(code);
+    for (Py_ssize_t j = 0; j < entry->nrecords; j++) {
+        ProfileRecord *record = &entry->records[j];
+        if (record->offset >= (uint32_t)Py_SIZE(code)) {
+            continue;
+        }
+        // The key matches, but check the instruction anyway, in case the
+        // file was edited or the hash collided.
+        int opcode = instructions[record->offset].op.code;
+        if (_PyOpcode_Deopt[opcode] != opcode ||
+            _PyOpcode_Caches[opcode] == 0 ||
+            record->offset + _PyOpcode_Caches[opcode] >= (uint32_t)Py_SIZE(code))
+        {
+            continue;
+        }
+        uint16_t *counter = &instructions[record->offset + 1].cache;
+        switch (record->kind) {
+            case 'j':
+                if (opcode == JUMP_BACKWARD) {
+                    *counter = PRIMED_BACKEDGE_COUNTER;
+                }
+                break;
+            case 'b':
+                if (is_conditional_branch(opcode)) {
+                    *counter = record->value;
+                }
+                break;
+            case 's':
+                if (opcode != JUMP_BACKWARD && !is_conditional_branch(opcode)) {
+                    *counter = adaptive_counter_bits(0, ADAPTIVE_WARMUP_BACKOFF);
+                }
+                break;
+        }
+    }
+}
+
+
+/* Reading and writing */
+
+static void
+load_profile(_PyOptimizerProfile *profile)
+{
+    FILE *f = _Py_wfopen(profile->path, L"r");
+    if (f == NULL) {
+        // No profile yet
+        return;
+    }
+    unsigned int format, version;
+    if (fscanf(f, PROFILE_HEADER " %u %x", &format, &version) != 2 ||
+        format != PROFILE_FORMAT_VERSION || version != PY_VERSION_HEX)
+    {
+        // Unknown format or a different Python: start over.
+        fclose(f);
+        return;
+    }
+    unsigned long long key;
+    Py_ssize_t nrecords;
+    while (fscanf(f, " %llx %zd", &key, &nrecords) == 2) {
+        if (nrecords < 0 || nrecords > INT_MAX) {
+            break;
+        }
+        ProfileEntry *entry = entry_new(key, nrecords);
+        if (entry == NULL) {
+            break;
+        }
+        Py_ssize_t j = 0;
+        for (; j < nrecords; j++) {
+            ProfileRecord *record = &entry->records[j];
+            unsigned int offset, value;
+            char kind;
+            if (fscanf(f, " %u %c %u", &offset, &kind, &value) != 3 ||
+                (kind != 'j' && kind != 'b' && kind != 's') ||
+                value > UINT16_MAX)
+            {
+                break;
+            }
+            *record = (ProfileRecord){offset, kind, (uint16_t)value};
+        }
+        if (j < nrecords || add_entry(profile, entry) < 0) {
+            if (j < nrecords) {
+                PyMem_RawFree(entry);
+            }
+            break;
+        }
+    }
+    fclose(f);
+}
+
+static int
+write_entry(_Py_hashtable_t *Py_UNUSED(entries), const void *key,
+            const void *Py_UNUSED(value), void *arg)
+{
+    FILE *f = (FILE *)arg;
+    const ProfileEntry *entry = key;
+    fprintf(f, "%016llx %zd", (unsigned long long)entry->key, entry->nrecords);
+    for (Py_ssize_t j = 0; j < entry->nrecords; j++) {
+        const ProfileRecord *record = &entry->records[j];
+        fprintf(f, " %u %c %u", (unsigned int)record->offset, record->kind,
+                (unsigned int)record->value);
+    }
+    fputc('\n', f);
+    return 0;
+}
+
+static void
+remove_file(const wchar_t *path)
+{
+#ifdef MS_WINDOWS
+    (void)_wremove(path);
+#else
+    char *cpath = _Py_EncodeLocaleRaw(path, NULL);
+    if (cpath != NULL) {
+        (void)remove(cpath);
+        PyMem_RawFree(cpath);
+    }
+#endif
+}
+
+/* Write the profile to a temporary file, then move it into place, so that
+ * concurrent processes never see a partially written profile. */
+static void
+save_profile(_PyOptimizerProfile *profile)
+{
+    size_t len = wcslen(profile->path);
+    size_t tmp_size = len + 32;
+    wchar_t *tmp = PyMem_RawMalloc(tmp_size * sizeof(wchar_t));
+    if (tmp == NULL) {
+        return;
+    }
+#ifdef MS_WINDOWS
+    unsigned long pid = GetCurrentProcessId();
+#else
+    unsigned long pid = (unsigned long)getpid();
+#endif
+    swprintf(tmp, tmp_size, L"%ls.%lu.tmp", profile->path, pid);
+    FILE *f = _Py_wfopen(tmp, L"w");
+    if (f == NULL) {
+        PyMem_RawFree(tmp);
+        return;
+    }
+    fprintf(f, PROFILE_HEADER " %d %x\n", PROFILE_FORMAT_VERSION, PY_VERSION_HEX);
+    _Py_hashtable_foreach(profile->entries, write_entry, f);
+    int failed = ferror(f);
+    failed |= fclose(f);
+#ifdef MS_WINDOWS
+    failed = failed || !MoveFileExW(tmp, profile->path, MOVEFILE_REPLACE_EXISTING);
+#else
+    if (!failed) {
+        char *ctmp = _Py_EncodeLocaleRaw(tmp, NULL);
+        char *cpath = _Py_EncodeLocaleRaw(profile->path, NULL);
+        failed = ctmp == NULL || cpath == NULL || rename(ctmp, cpath) != 0;
+        PyMem_RawFree(ctmp);
+        PyMem_RawFree(cpath);
+    }
+#endif
+    if (failed) {
+        remove_file(tmp);
+    }
+    PyMem_RawFree(tmp);
+}
+
+static int
+record_live_code(_Py_hashtable_t *Py_UNUSED(code_objects), const void *key,
+                 const void *Py_UNUSED(value), void *arg)
+{
+    record_code((_PyOptimizerProfile *)arg, (PyCodeObject *)key);
+    return 0;
+}
+
+static void
+free_profile(_PyOptimizerProfile *profile)
+{
+    if (profile->entries != NULL) {
+        _Py_hashtable_destroy(profile->entries);
+    }
+    if (profile->code_objects != NULL) {
+        _Py_hashtable_destroy(profile->code_objects);
+    }
+    PyMem_RawFree(profile->path);
+    PyMem_RawFree(profile);
+}
+
+int
+_PyOptimizer_InitProfile(PyInterpreterState *interp, const wchar_t *path)
+{
+    assert(interp->optimizer_profile == NULL);
+    _PyOptimizerProfile *profile = PyMem_RawCalloc(1, sizeof(*profile));
+    if (profile == NULL) {
+        return -1;
+    }
+    profile->path = _PyMem_RawWcsdup(path);
+    _Py_hashtable_allocator_t alloc = {PyMem_RawMalloc, PyMem_RawFree};
+    profile->entries = _Py_hashtable_new_full(
+        entry_hash, entry_compare, NULL, PyMem_RawFree, &alloc);
+    profile->code_objects = _Py_hashtable_new_full(
+        _Py_hashtable_hash_ptr, _Py_hashtable_compare_direct,
+        NULL, NULL, &alloc);
+    if (profile->path == NULL || profile->entries == NULL ||
+        profile->code_objects == NULL)
+    {
+        free_profile(profile);
+        return -1;
+    }
+    load_profile(profile);
+    interp->optimizer_profile = profile;
+    return 0;
+}
+
+void
+_PyOptimizer_FiniProfile(PyInterpreterState *interp)
+{
+    _PyOptimizerProfile *profile = interp->optimizer_profile;
+    if (profile == NULL) {
+        return;
+    }
+    _Py_hashtable_foreach(profile->code_objects, record_live_code, profile);
+    interp->optimizer_profile = NULL;
+    save_profile(profile);
+    free_profile(profile);
+}
@@ -0,0 +1,245 @@
+/*
+
+Perf jitdump support
+====================
+
+The "perf" backend of the perf trampoline (see perf_trampoline.c) writes
+symbols to /tmp/perf-PID.map.  That is enough for "perf report", but the map
+only names address ranges: perf has no copy of the code, so annotating or
+disassembling a hot trampoline or JIT-compiled executor doesn't work, and the
+map file is not tied to the mappings that were live when a sample was taken.
+
+The "perf_jit" backend (-X perf_jit, PYTHONPERFJITSUPPORT=1 or
+sys.activate_stack_trampoline("perf_jit")) writes the same symbols in the
+jitdump format instead, to /tmp/jit-PID.dump.  Every JIT_CODE_LOAD record
+carries a copy of the code.  Use it with:
+
+    $ perf record -k 1 -g python -X perf_jit script.py
+    $ perf inject --jit -i perf.data -o perf.jit.data
+    $ perf report -i perf.jit.data
+
+perf only looks for a jitdump file it has seen mapped executable by the
+profiled process, which is why the file is mmap()ed below.  Timestamps must
+come from the clock perf was told to use with "-k 1" (CLOCK_MONOTONIC).
+
+The format is described in tools/perf/Documentation/jitdump-specification.txt
+in the Linux kernel sources.
+
+*/
+
+#include "Python.h"
+#include "pycore_ceval.h"         // _PyPerf_Callbacks
+
+#ifdef PY_HAVE_PERF_TRAMPOLINE
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/mman.h>             // mmap()
+#include <sys/types.h>
+#include <time.h>                 // clock_gettime()
+#include <unistd.h>               // sysconf()
+
+#ifdef HAVE_SYS_SYSCALL_H
+#  include <sys/syscall.h>        // SYS_gettid
+#endif
+
+#define JITDUMP_MAGIC 0x4A695444  // "JiTD"
+#define JITDUMP_VERSION 1
+
+// ELF machine types (from <elf.h>)
+#if defined(__x86_64__)
+#  define JITDUMP_ELF_MACHINE 62   // EM_X86_64
+#elif defined(__aarch64__)
+#  define JITDUMP_ELF_MACHINE 183  // EM_AARCH64
+#else
+#  define JITDUMP_ELF_MACHINE 0    // EM_NONE
+#endif
+
+enum {
+    JIT_CODE_LOAD = 0,
+    JIT_CODE_CLOSE = 3,
+};
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t size;          // Size of this header
+    uint32_t elf_mach;
+    uint32_t pad1;
+    uint32_t pid;
+    uint64_t timestamp;
+    uint64_t flags;
+} JitDumpHeader;
+
+typedef struct {
+    uint32_t id;
+    uint32_t total_size;    // Including this prefix, the name and the code
+    uint64_t timestamp;
+} JitDumpRecordPrefix;
+
+typedef struct {
+    JitDumpRecordPrefix prefix;
+    uint32_t pid;
+    uint32_t tid;
+    uint64_t vma;
+    uint64_t code_addr;
+    uint64_t code_size;
+    uint64_t code_index;
+    // Followed by the NUL-terminated name and the code
+} JitCodeLoadRecord;
+
+typedef struct {
+    FILE *file;
+    pid_t pid;              // The process that created the file
+    void *marker;           // The mapping of the file's first page
+    size_t marker_size;
+    uint64_t code_index;    // Unique id of every JIT_CODE_LOAD record
+} JitDumpState;
+
+
+static uint64_t
+jitdump_timestamp(void)
+{
+    struct timespec ts;
+    if (clock_gettime(CLOCK_MONOTONIC, &ts) != 0) {
+        return 0;
+    }
+    return (uint64_t)ts.tv_sec * 1000000000 + (uint64_t)ts.tv_nsec;
+}
+
+static uint32_t
+jitdump_tid(void)
+{
+#if defined(HAVE_SYS_SYSCALL_H) && defined(SYS_gettid)
+    return (uint32_t)syscall(SYS_gettid);
+#else
+    return (uint32_t)getpid();
+#endif
+}
+
+static void *
+perf_jit_init_state(void)
+{
+    JitDumpState *state = PyMem_RawCalloc(1, sizeof(JitDumpState));
+    if (state == NULL) {
+        return NULL;
+    }
+    char filename[100];
+    pid_t pid = getpid();
+    snprintf(filename, sizeof(filename), "/tmp/jit-%d.dump", (int)pid);
+    int fd = open(filename, O_CREAT | O_TRUNC | O_RDWR | O_CLOEXEC, 0600);
+    if (fd == -1) {
+        PyMem_RawFree(state);
+        return NULL;
+    }
+    state->marker_size = (size_t)sysconf(_SC_PAGESIZE);
+    state->marker = mmap(NULL, state->marker_size, PROT_READ | PROT_EXEC,
+                         MAP_PRIVATE, fd, 0);
+    if (state->marker == MAP_FAILED) {
+        close(fd);
+        PyMem_RawFree(state);
+        return NULL;
+    }
+    state->file = fdopen(fd, "w+");
+    if (state->file == NULL) {
+        munmap(state->marker, state->marker_size);
+        close(fd);
+        PyMem_RawFree(state);
+        return NULL;
+    }
+    state->pid = pid;
+    JitDumpHeader header = {
+        .magic = JITDUMP_MAGIC,
+        .version = JITDUMP_VERSION,
+        .size = sizeof(JitDumpHeader),
+        .elf_mach = JITDUMP_ELF_MACHINE,
+        .pid = (uint32_t)pid,
+        .timestamp = jitdump_timestamp(),
+    };
+    fwrite(&header, sizeof(header), 1, state->file);
+    fflush(state->file);
+    return state;
+}
+
+static void
+perf_jit_write_named_entry(void *state, const void *code_addr,
+                           unsigned int code_size, const char *name)
+{
+    JitDumpState *jitdump = (JitDumpState *)state;
+    if (jitdump == NULL) {
+        return;
+    }
+    size_t name_size = strlen(name) + 1;
+    JitCodeLoadRecord record = {
+        .prefix = {
+            .id = JIT_CODE_LOAD,
+            .total_size = (uint32_t)(sizeof(record) + name_size + code_size),
+            .timestamp = jitdump_timestamp(),
+        },
+        .pid = (uint32_t)getpid(),
+        .tid = jitdump_tid(),
+        .vma = (uintptr_t)code_addr,
+        .code_addr = (uintptr_t)code_addr,
+        .code_size = code_size,
+        .code_index = jitdump->code_index++,
+    };
+    fwrite(&record, sizeof(record), 1, jitdump->file);
+    fwrite(name, name_size, 1, jitdump->file);
+    fwrite(code_addr, code_size, 1, jitdump->file);
+    fflush(jitdump->file);
+}
+
+static void
+perf_jit_write_entry(void *state, const void *code_addr,
+                     unsigned int code_size, PyCodeObject *co)
+{
+    // Same symbol names as the perf map backend
+    const char *entry = "";
+    if (co->co_qualname != NULL) {
+        entry = PyUnicode_AsUTF8(co->co_qualname);
+    }
+    const char *filename = "";
+    if (co->co_filename != NULL) {
+        filename = PyUnicode_AsUTF8(co->co_filename);
+    }
+    size_t size = snprintf(NULL, 0, "py::%s:%s", entry, filename) + 1;
+    char *name = (char *)PyMem_RawMalloc(size);
+    if (name == NULL) {
+        return;
+    }
+    snprintf(name, size, "py::%s:%s", entry, filename);
+    perf_jit_write_named_entry(state, code_addr, code_size, name);
+    PyMem_RawFree(name);
+}
+
+static int
+perf_jit_free_state(void *state)
+{
+    JitDumpState *jitdump = (JitDumpState *)state;
+    if (jitdump == NULL) {
+        return 0;
+    }
+    // After a fork, the child must leave its parent's file alone.
+    if (jitdump->pid == getpid()) {
+        JitDumpRecordPrefix close_record = {
+            .id = JIT_CODE_CLOSE,
+            .total_size = sizeof(close_record),
+            .timestamp = jitdump_timestamp(),
+        };
+        fwrite(&close_record, sizeof(close_record), 1, jitdump->file);
+    }
+    fclose(jitdump->file);
+    munmap(jitdump->marker, jitdump->marker_size);
+    PyMem_RawFree(jitdump);
+    return 0;
+}
+
+_PyPerf_Callbacks _Py_perfmap_jit_callbacks = {
+    &perf_jit_init_state,
+    &perf_jit_write_entry,
+    &perf_jit_free_state,
+    &perf_jit_write_named_entry,
+};
+
+#endif  // PY_HAVE_PERF_TRAMPOLINE
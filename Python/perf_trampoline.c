@@ -133,7 +133,9 @@ any DWARF information available for them).
 #include "pycore_ceval.h"         // _PyPerf_Callbacks
 #include "pycore_frame.h"
 #include "pycore_interp.h"
+#include "pycore_optimizer.h"     // _PyPerfTrampoline_RegisterExecutor()
 #include "pycore_pyerrors.h"      // _PyErr_WriteUnraisableMsg()
+#include "pycore_uops.h"          // _PyUOpExecutorObject
 
 
 #ifdef PY_HAVE_PERF_TRAMPOLINE
@@ -191,6 +193,7 @@ typedef struct trampoline_api_st trampoline_api_t;
 #define perf_status _PyRuntime.ceval.perf.status
 #define extra_code_index _PyRuntime.ceval.perf.extra_code_index
 #define perf_code_arena _PyRuntime.ceval.perf.code_arena
+#define perf_code_arena_generation _PyRuntime.ceval.perf.code_arena_generation
 #define trampoline_api _PyRuntime.ceval.perf.trampoline_api
 #define perf_map_file _PyRuntime.ceval.perf.map_file
 
@@ -217,10 +220,18 @@ perf_map_write_entry(void *state, const void *code_addr,
     PyMem_RawFree(perf_map_entry);
 }
 
+static void
+perf_map_write_named_entry(void *state, const void *code_addr,
+                           unsigned int code_size, const char *name)
+{
+    PyUnstable_WritePerfMapEntry(code_addr, code_size, name);
+}
+
 _PyPerf_Callbacks _Py_perfmap_callbacks = {
     NULL,
     &perf_map_write_entry,
     NULL,
+    &perf_map_write_named_entry,
 };
 
 static int
@@ -298,6 +309,7 @@ free_code_arenas(void)
     code_arena_t *cur = perf_code_arena;
     code_arena_t *prev;
     perf_code_arena = NULL;  // invalid static pointer
+    perf_code_arena_generation++;
     while (cur) {
         munmap(cur->start_addr, cur->size);
         prev = cur->prev;
@@ -306,6 +318,15 @@ free_code_arenas(void)
     }
 }
 
+static void
+free_trampoline_state(void)
+{
+    if (trampoline_api.state != NULL && trampoline_api.free_state != NULL) {
+        trampoline_api.free_state(trampoline_api.state);
+    }
+    trampoline_api.state = NULL;
+}
+
 static inline py_trampoline
 code_arena_new_code(code_arena_t *code_arena)
 {
@@ -359,8 +380,84 @@ py_trampoline_evaluator(PyThreadState *ts, _PyInterpreterFrame *frame,
     // Something failed, fall back to the default evaluator.
     return _PyEval_EvalFrameDefault(ts, frame, throw);
 }
+
+/* Tier 2 executors.
+ *
+ * Without the JIT, every executor runs in _PyUopExecute(), so we give each
+ * one its own copy of the trampoline, just like code objects get one for
+ * _PyEval_EvalFrameDefault().  The trampoline takes the executor's
+ * arguments in place of the evaluator's (they are passed in the same
+ * registers) and calls _PyUopExecute().  With the JIT, the executor's
+ * machine code gets the symbol instead.
+ */
+typedef _PyInterpreterFrame *(*executor_trampoline)(
+    _PyExecutorObject *, _PyInterpreterFrame *, PyObject **,
+    _PyInterpreterFrame *(*)(_PyExecutorObject *, _PyInterpreterFrame *,
+                             PyObject **));
+
+static _PyInterpreterFrame *
+py_trampoline_executor(_PyExecutorObject *self, _PyInterpreterFrame *frame,
+                       PyObject **stack_pointer)
+{
+    _PyUOpExecutorObject *executor = (_PyUOpExecutorObject *)self;
+    // The trampoline is gone if the arenas were freed since:
+    if (executor->perf_generation == perf_code_arena_generation) {
+        executor_trampoline f = (executor_trampoline)executor->perf_trampoline;
+        return f(self, frame, stack_pointer, _PyUopExecute);
+    }
+    return _PyUopExecute(self, frame, stack_pointer);
+}
 #endif  // PY_HAVE_PERF_TRAMPOLINE
 
+void
+_PyPerfTrampoline_RegisterExecutor(_PyUOpExecutorObject *executor,
+                                   PyCodeObject *code, _Py_CODEUNIT *instr)
+{
+#ifdef PY_HAVE_PERF_TRAMPOLINE
+    executor->perf_trampoline = NULL;
+    if (perf_status != PERF_STATUS_OK || !_PyIsPerfTrampolineActive() ||
+        trampoline_api.write_named_state == NULL)
+    {
+        return;
+    }
+    int lineno = PyCode_Addr2Line(
+        code, (int)((instr - _PyCode_CODE(code)) * sizeof(_Py_CODEUNIT)));
+    PyObject *name = PyUnicode_FromFormat(
+        "py::uop::%U:%U:%d", code->co_qualname, code->co_filename, lineno);
+    if (name == NULL) {
+        PyErr_Clear();
+        return;
+    }
+    const char *entry = PyUnicode_AsUTF8(name);
+    if (entry == NULL) {
+        PyErr_Clear();
+        Py_DECREF(name);
+        return;
+    }
+#ifdef _Py_JIT
+    if (executor->jit_code != NULL) {
+        trampoline_api.write_named_state(trampoline_api.state,
+                                         executor->jit_code,
+                                         (unsigned int)executor->jit_size,
+                                         entry);
+        Py_DECREF(name);
+        return;
+    }
+#endif
+    if (executor->base.execute == _PyUopExecute) {
+        void *trampoline = compile_trampoline();
+        if (trampoline != NULL) {
+            trampoline_api.write_named_state(trampoline_api.state, trampoline,
+                                             perf_code_arena->code_size, entry);
+            executor->perf_trampoline = trampoline;
+            executor->perf_generation = perf_code_arena_generation;
+            executor->base.execute = py_trampoline_executor;
+        }
+    }
+    Py_DECREF(name);
+#endif
+}
+
 int
 _PyIsPerfTrampolineActive(void)
 {
@@ -381,6 +478,7 @@ _PyPerfTrampoline_GetCallbacks(_PyPerf_Callbacks *callbacks)
     callbacks->init_state = trampoline_api.init_state;
     callbacks->write_state = trampoline_api.write_state;
     callbacks->free_state = trampoline_api.free_state;
+    callbacks->write_named_state = trampoline_api.write_named_state;
 #endif
     return;
 }
@@ -393,12 +491,16 @@ _PyPerfTrampoline_SetCallbacks(_PyPerf_Callbacks *callbacks)
     }
 #ifdef PY_HAVE_PERF_TRAMPOLINE
     if (trampoline_api.state) {
+        // The state belongs to the current backend: free it with the current
+        // callbacks before they are replaced, e.g. to close the jitdump file
+        // when switching from perf_jit to perf.
+        free_trampoline_state();
         _PyPerfTrampoline_Fini();
     }
     trampoline_api.init_state = callbacks->init_state;
     trampoline_api.write_state = callbacks->write_state;
     trampoline_api.free_state = callbacks->free_state;
-    trampoline_api.state = NULL;
+    trampoline_api.write_named_state = callbacks->write_named_state;
     perf_status = PERF_STATUS_OK;
 #endif
     return 0;
@@ -428,6 +530,9 @@ _PyPerfTrampoline_Init(int activate)
         if (extra_code_index == -1) {
             return -1;
         }
+        if (trampoline_api.state == NULL && trampoline_api.init_state != NULL) {
+            trampoline_api.state = trampoline_api.init_state();
+        }
         perf_status = PERF_STATUS_OK;
     }
 #endif
@@ -443,6 +548,7 @@ _PyPerfTrampoline_Fini(void)
         tstate->interp->eval_frame = NULL;
     }
     free_code_arenas();
+    free_trampoline_state();
     extra_code_index = -1;
 #endif
     return 0;
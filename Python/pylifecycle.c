@@ -17,6 +17,7 @@
 #include "pycore_list.h"          // _PyList_Fini()
 #include "pycore_long.h"          // _PyLong_InitTypes()
 #include "pycore_object.h"        // _PyDebug_PrintTotalRefs()
+#include "pycore_optimizer.h"     // _PyOptimizer_InitProfile()
 #include "pycore_pathconfig.h"    // _PyPathConfig_UpdateGlobal()
 #include "pycore_pyerrors.h"      // _PyErr_Occurred()
 #include "pycore_pylifecycle.h"   // _PyErr_Print()
@@ -1171,7 +1172,11 @@ init_interp_main(PyThreadState *tstate)
 
 #ifdef PY_HAVE_PERF_TRAMPOLINE
         if (config->perf_profiling) {
-            if (_PyPerfTrampoline_SetCallbacks(&_Py_perfmap_callbacks) < 0 ||
+            _PyPerf_Callbacks *callbacks = &_Py_perfmap_callbacks;
+            if (config->perf_profiling == 2) {
+                callbacks = &_Py_perfmap_jit_callbacks;
+            }
+            if (_PyPerfTrampoline_SetCallbacks(callbacks) < 0 ||
                     _PyPerfTrampoline_Init(config->perf_profiling) < 0) {
                 return _PyStatus_ERR("can't initialize the perf trampoline");
             }
@@ -1244,6 +1249,13 @@ init_interp_main(PyThreadState *tstate)
         }
     }
 
+    // Experimental persistent optimizer profile
+    if (is_main_interp && config->optimizer_profile != NULL) {
+        if (_PyOptimizer_InitProfile(interp, config->optimizer_profile) < 0) {
+            return _PyStatus_NO_MEMORY();
+        }
+    }
+
     if (!is_main_interp) {
         // The main interpreter is handled in Py_Main(), for now.
         if (config->sys_path_0 != NULL) {
@@ -1849,6 +1861,9 @@ Py_FinalizeEx(void)
     _PyAtExit_Call(tstate->interp);
     PyUnstable_PerfMapState_Fini();
 
+    // Save the optimizer profile while the code objects are still alive.
+    _PyOptimizer_FiniProfile(tstate->interp);
+
     /* Copy the core config, PyInterpreterState_Delete() free
        the core config memory */
 #ifdef Py_REF_DEBUG
@@ -714,6 +714,8 @@ init_interpreter(PyInterpreterState *interp,
     interp->optimizer_resume_threshold = _PyOptimizer_Default.backedge_threshold;
     interp->next_func_version = 1;
     interp->executor_list_head = NULL;
+    interp->executor_dependents = NULL;
+    interp->executor_bloom_count = 0;
     if (interp != &runtime->_main_interpreter) {
         /* Fix the self-referential, statically initialized fields. */
         interp->dtoa = (struct _dtoa_state)_dtoa_state_INIT(interp);
@@ -881,6 +883,7 @@ interpreter_clear(PyInterpreterState *interp, PyThreadState *tstate)
     interp->optimizer = &_PyOptimizer_Default;
     interp->optimizer_backedge_threshold = _PyOptimizer_Default.backedge_threshold;
     interp->optimizer_resume_threshold = _PyOptimizer_Default.backedge_threshold;
+    _Py_Executors_InvalidateAll(interp);
 
     /* It is possible that any of the objects below have a finalizer
        that runs Python code or otherwise relies on a thread state
@@ -10,6 +10,7 @@
 #include "pycore_moduleobject.h"
 #include "pycore_object.h"
 #include "pycore_opcode_metadata.h" // _PyOpcode_Caches
+#include "pycore_optimizer.h"     // _PyOptimizer_ApplyProfile()
 #include "pycore_pylifecycle.h"   // _PyOS_URandomNonblock()
 #include "pycore_runtime.h"       // _Py_ID()
 
@@ -405,6 +406,7 @@ _PyCode_Quicken(PyCodeObject *code)
             i += caches;
         }
     }
+    _PyOptimizer_ApplyProfile(code);
     #endif /* ENABLE_SPECIALIZATION */
 }
 
@@ -523,6 +525,8 @@ _PyCode_Quicken(PyCodeObject *code)
 #define SPEC_FAIL_CALL_METHOD_WRAPPER 28
 #define SPEC_FAIL_CALL_OPERATOR_WRAPPER 29
 #define SPEC_FAIL_CALL_INIT_NOT_SIMPLE 30
+#define SPEC_FAIL_CALL_KW_NAMES 31
+#define SPEC_FAIL_CALL_NOT_FUNCTION 32
 
 /* COMPARE_OP */
 #define SPEC_FAIL_COMPARE_OP_DIFFERENT_TYPES 12
@@ -537,6 +541,12 @@ _PyCode_Quicken(PyCodeObject *code)
 #define SPEC_FAIL_COMPARE_OP_FLOAT_LONG 21
 #define SPEC_FAIL_COMPARE_OP_LONG_FLOAT 22
 
+/* CONTAINS_OP */
+#define SPEC_FAIL_CONTAINS_OP_STR_NOT_STR 9
+#define SPEC_FAIL_CONTAINS_OP_SUBCLASS 10
+#define SPEC_FAIL_CONTAINS_OP_ITERATOR 11
+#define SPEC_FAIL_CONTAINS_OP_USER_CLASS 12
+
 /* FOR_ITER and SEND */
 #define SPEC_FAIL_ITER_GENERATOR 10
 #define SPEC_FAIL_ITER_COROUTINE 11
@@ -1994,6 +2004,123 @@ _Py_Specialize_Call(PyObject *callable, _Py_CODEUNIT *instr, int nargs)
     }
 }
 
+static int
+specialize_py_call_kw(PyFunctionObject *func, _Py_CODEUNIT *instr, int nargs,
+                      PyObject *kwnames)
+{
+    _PyCallCache *cache = (_PyCallCache *)(instr + 1);
+    PyCodeObject *code = (PyCodeObject *)func->func_code;
+    /* Don't specialize if PEP 523 is active */
+    if (_PyInterpreterState_GET()->eval_frame) {
+        SPECIALIZATION_FAIL(CALL_KW, SPEC_FAIL_CALL_PEP_523);
+        return -1;
+    }
+    if (code->co_flags & (CO_VARKEYWORDS | CO_VARARGS)) {
+        SPECIALIZATION_FAIL(CALL_KW, SPEC_FAIL_CODE_COMPLEX_PARAMETERS);
+        return -1;
+    }
+    if ((code->co_flags & CO_OPTIMIZED) == 0) {
+        SPECIALIZATION_FAIL(CALL_KW, SPEC_FAIL_CODE_NOT_OPTIMIZED);
+        return -1;
+    }
+    if (code->co_argcount + code->co_kwonlyargcount != nargs) {
+        SPECIALIZATION_FAIL(CALL_KW, SPEC_FAIL_WRONG_NUMBER_ARGUMENTS);
+        return -1;
+    }
+    /* The keywords must name the remaining parameters, in order */
+    int nkwargs = (int)PyTuple_GET_SIZE(kwnames);
+    int positional_args = nargs - nkwargs;
+    if (positional_args < code->co_posonlyargcount ||
+        positional_args > code->co_argcount)
+    {
+        SPECIALIZATION_FAIL(CALL_KW, SPEC_FAIL_CALL_KW_NAMES);
+        return -1;
+    }
+    for (int i = 0; i < nkwargs; i++) {
+        PyObject *name = PyTuple_GET_ITEM(kwnames, i);
+        if (name != PyTuple_GET_ITEM(code->co_localsplusnames, positional_args + i)) {
+            SPECIALIZATION_FAIL(CALL_KW, SPEC_FAIL_CALL_KW_NAMES);
+            return -1;
+        }
+    }
+    int version = _PyFunction_GetVersionForCurrentState(func);
+    if (version == 0) {
+        SPECIALIZATION_FAIL(CALL_KW, SPEC_FAIL_OUT_OF_VERSIONS);
+        return -1;
+    }
+    write_u32(cache->func_version, version);
+    instr->op.code = CALL_KW_PY_EXACT_ARGS;
+    return 0;
+}
+
+void
+_Py_Specialize_CallKw(PyObject *callable, _Py_CODEUNIT *instr, int nargs,
+                      PyObject *kwnames)
+{
+    assert(ENABLE_SPECIALIZATION);
+    assert(_PyOpcode_Caches[CALL_KW] == INLINE_CACHE_ENTRIES_CALL_KW);
+    assert(_Py_OPCODE(*instr) != INSTRUMENTED_CALL_KW);
+    assert(PyTuple_CheckExact(kwnames));
+    _PyCallCache *cache = (_PyCallCache *)(instr + 1);
+    int fail;
+    if (PyFunction_Check(callable)) {
+        fail = specialize_py_call_kw((PyFunctionObject *)callable, instr,
+                                     nargs, kwnames);
+    }
+    else {
+        SPECIALIZATION_FAIL(CALL_KW, SPEC_FAIL_CALL_NOT_FUNCTION);
+        fail = -1;
+    }
+    if (fail) {
+        STAT_INC(CALL_KW, failure);
+        assert(!PyErr_Occurred());
+        instr->op.code = CALL_KW;
+        cache->counter = adaptive_counter_backoff(cache->counter);
+    }
+    else {
+        STAT_INC(CALL_KW, success);
+        assert(!PyErr_Occurred());
+        cache->counter = adaptive_counter_cooldown();
+    }
+}
+
+void
+_Py_Specialize_CallFunctionEx(PyObject *func, _Py_CODEUNIT *instr)
+{
+    assert(ENABLE_SPECIALIZATION);
+    assert(_PyOpcode_Caches[CALL_FUNCTION_EX] == INLINE_CACHE_ENTRIES_CALL_FUNCTION_EX);
+    assert(_Py_OPCODE(*instr) != INSTRUMENTED_CALL_FUNCTION_EX);
+    _PyCallFunctionExCache *cache = (_PyCallFunctionExCache *)(instr + 1);
+    /* Whether the arguments fit the signature is checked on every call,
+     * so that a forwarding wrapper can specialize whatever it wraps. */
+    if (_PyInterpreterState_GET()->eval_frame) {
+        SPECIALIZATION_FAIL(CALL_FUNCTION_EX, SPEC_FAIL_CALL_PEP_523);
+        goto fail;
+    }
+    if (Py_IS_TYPE(func, &PyFunction_Type) &&
+        ((PyFunctionObject *)func)->vectorcall == _PyFunction_Vectorcall)
+    {
+        PyCodeObject *code = (PyCodeObject *)PyFunction_GET_CODE(func);
+        if ((code->co_flags & CO_OPTIMIZED) == 0) {
+            SPECIALIZATION_FAIL(CALL_FUNCTION_EX, SPEC_FAIL_CODE_NOT_OPTIMIZED);
+            goto fail;
+        }
+        instr->op.code = CALL_FUNCTION_EX_PY;
+        goto success;
+    }
+    SPECIALIZATION_FAIL(CALL_FUNCTION_EX, SPEC_FAIL_CALL_NOT_FUNCTION);
+fail:
+    STAT_INC(CALL_FUNCTION_EX, failure);
+    assert(!PyErr_Occurred());
+    instr->op.code = CALL_FUNCTION_EX;
+    cache->counter = adaptive_counter_backoff(cache->counter);
+    return;
+success:
+    STAT_INC(CALL_FUNCTION_EX, success);
+    assert(!PyErr_Occurred());
+    cache->counter = adaptive_counter_cooldown();
+}
+
 #ifdef Py_STATS
 static int
 binary_op_fail_kind(int oparg, PyObject *lhs, PyObject *rhs)
@@ -2220,6 +2347,67 @@ _Py_Specialize_CompareOp(PyObject *lhs, PyObject *rhs, _Py_CODEUNIT *instr,
     cache->counter = adaptive_counter_cooldown();
 }
 
+#ifdef Py_STATS
+static int
+contains_op_fail_kind(PyObject *value)
+{
+    if (PyDict_Check(value) || PySet_Check(value) || PyFrozenSet_Check(value) ||
+        PyUnicode_Check(value) || PyTuple_Check(value) || PyList_Check(value))
+    {
+        return SPEC_FAIL_CONTAINS_OP_SUBCLASS;
+    }
+    PySequenceMethods *sqm = Py_TYPE(value)->tp_as_sequence;
+    if (sqm == NULL || sqm->sq_contains == NULL) {
+        return SPEC_FAIL_CONTAINS_OP_ITERATOR;
+    }
+    if (Py_TYPE(value)->tp_flags & Py_TPFLAGS_HEAPTYPE) {
+        return SPEC_FAIL_CONTAINS_OP_USER_CLASS;
+    }
+    return SPEC_FAIL_OTHER;
+}
+#endif   // Py_STATS
+
+void
+_Py_Specialize_ContainsOp(PyObject *key, PyObject *value, _Py_CODEUNIT *instr)
+{
+    assert(ENABLE_SPECIALIZATION);
+    assert(_PyOpcode_Caches[CONTAINS_OP] == INLINE_CACHE_ENTRIES_CONTAINS_OP);
+    _PyContainsOpCache *cache = (_PyContainsOpCache *)(instr + 1);
+    if (PyDict_CheckExact(value)) {
+        instr->op.code = CONTAINS_OP_DICT;
+        goto success;
+    }
+    if (PySet_CheckExact(value) || PyFrozenSet_CheckExact(value)) {
+        instr->op.code = CONTAINS_OP_SET;
+        goto success;
+    }
+    if (PyUnicode_CheckExact(value)) {
+        if (!PyUnicode_CheckExact(key)) {
+            SPECIALIZATION_FAIL(CONTAINS_OP, SPEC_FAIL_CONTAINS_OP_STR_NOT_STR);
+            goto failure;
+        }
+        instr->op.code = CONTAINS_OP_STR;
+        goto success;
+    }
+    if (PyTuple_CheckExact(value)) {
+        instr->op.code = CONTAINS_OP_TUPLE;
+        goto success;
+    }
+    if (PyList_CheckExact(value)) {
+        instr->op.code = CONTAINS_OP_LIST;
+        goto success;
+    }
+    SPECIALIZATION_FAIL(CONTAINS_OP, contains_op_fail_kind(value));
+failure:
+    STAT_INC(CONTAINS_OP, failure);
+    instr->op.code = CONTAINS_OP;
+    cache->counter = adaptive_counter_backoff(cache->counter);
+    return;
+success:
+    STAT_INC(CONTAINS_OP, success);
+    cache->counter = adaptive_counter_cooldown();
+}
+
 #ifdef Py_STATS
 static int
 unpack_sequence_fail_kind(PyObject *seq)
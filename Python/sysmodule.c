@@ -2100,6 +2100,21 @@ sys__clear_type_cache_impl(PyObject *module)
     Py_RETURN_NONE;
 }
 
+/*[clinic input]
+sys._trim_memory -> Py_ssize_t
+
+Return the memory of the free pymalloc pools to the operating system.
+
+Return the number of bytes released.
+[clinic start generated code]*/
+
+static Py_ssize_t
+sys__trim_memory_impl(PyObject *module)
+/*[clinic end generated code: output=3126d241cfc76942 input=6e9493c3417608f8]*/
+{
+    return _PyObject_TrimFreePools();
+}
+
 /* Note that, for now, we do not have a per-interpreter equivalent
   for sys.is_finalizing(). */
 
@@ -2208,11 +2223,18 @@ sys_activate_stack_trampoline_impl(PyObject *module, const char *backend)
 /*[clinic end generated code: output=5783cdeb51874b43 input=a12df928758a82b4]*/
 {
 #ifdef PY_HAVE_PERF_TRAMPOLINE
+    _PyPerf_Callbacks *callbacks = NULL;
     if (strcmp(backend, "perf") == 0) {
+        callbacks = &_Py_perfmap_callbacks;
+    }
+    else if (strcmp(backend, "perf_jit") == 0) {
+        callbacks = &_Py_perfmap_jit_callbacks;
+    }
+    if (callbacks != NULL) {
         _PyPerf_Callbacks cur_cb;
         _PyPerfTrampoline_GetCallbacks(&cur_cb);
-        if (cur_cb.write_state != _Py_perfmap_callbacks.write_state) {
-            if (_PyPerfTrampoline_SetCallbacks(&_Py_perfmap_callbacks) < 0 ) {
+        if (cur_cb.write_state != callbacks->write_state) {
+            if (_PyPerfTrampoline_SetCallbacks(callbacks) < 0 ) {
                 PyErr_SetString(PyExc_ValueError, "can't activate perf trampoline");
                 return NULL;
             }
@@ -2396,6 +2418,7 @@ static PyMethodDef sys_methods[] = {
     {"breakpointhook", _PyCFunction_CAST(sys_breakpointhook),
      METH_FASTCALL | METH_KEYWORDS, breakpointhook_doc},
     SYS__CLEAR_TYPE_CACHE_METHODDEF
+    SYS__TRIM_MEMORY_METHODDEF
     SYS__CURRENT_FRAMES_METHODDEF
     SYS__CURRENT_EXCEPTIONS_METHODDEF
     SYS_DISPLAYHOOK_METHODDEF
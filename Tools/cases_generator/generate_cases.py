@@ -80,11 +80,38 @@
     "LOAD_CONST",
     "STORE_FAST",
     "STORE_FAST_MAYBE_NULL",
+    "DELETE_FAST",
     "COPY",
+    "SWAP",
+    "POP_TOP",
+    # Frames
+    "_PUSH_FRAME",
+    "_POP_FRAME",
+    # Guards
+    "_GUARD_BOTH_INT",
+    "_GUARD_NOS_INT",
+    "_GUARD_TOS_INT",
+    "_GUARD_BOTH_FLOAT",
+    "_GUARD_NOS_FLOAT",
+    "_GUARD_TOS_FLOAT",
+    "_GUARD_BOTH_UNICODE",
+    "_GUARD_TYPE_VERSION",
+    "_CHECK_MANAGED_OBJECT_HAS_VALUES",
     # Arithmetic
     "_BINARY_OP_MULTIPLY_INT",
     "_BINARY_OP_ADD_INT",
     "_BINARY_OP_SUBTRACT_INT",
+    "_BINARY_OP_MULTIPLY_FLOAT",
+    "_BINARY_OP_ADD_FLOAT",
+    "_BINARY_OP_SUBTRACT_FLOAT",
+    "_BINARY_OP_ADD_UNICODE",
+    # Other
+    "_LOAD_ATTR_INSTANCE_VALUE",
+    "_ITER_NEXT_RANGE",
+    "_LOAD_CONST_INLINE_BORROW",
+    "_POP_TWO_LOAD_CONST_INLINE_BORROW",
+    "_POP_INLINED_CALL_UNDER_TOP",
+    "_POP_INLINED_CALL_LOAD_CONST_INLINE",
 }
 
 arg_parser = argparse.ArgumentParser(
@@ -369,7 +369,7 @@ def write_macro_instr(mac: MacroInstruction, out: Formatter) -> None:
             out.emit(f"PREDICTED({mac.name});")
         out.static_assert_family_size(mac.name, mac.family, mac.cache_offset)
         try:
-            next_instr_is_set = write_components(
+            next_instr_is_set, top = write_components(
                 parts, out, TIER_ONE, mac.cache_offset, mac.family
             )
         except AssertionError as err:
@@ -379,7 +379,10 @@ def write_macro_instr(mac: MacroInstruction, out: Formatter) -> None:
                 out.emit(f"next_instr += {mac.cache_offset};")
             if parts[-1].instr.check_eval_breaker:
                 out.emit("CHECK_EVAL_BREAKER();")
-            out.emit("DISPATCH();")
+            if top is not None:
+                out.emit(f"DISPATCH_TOS({top});")
+            else:
+                out.emit("DISPATCH();")
 
 
 def write_components(
@@ -388,7 +391,12 @@ def write_components(
     tier: Tiers,
     cache_offset: int,
     family: Family | None,
-) -> bool:
+) -> tuple[bool, str | None]:
+    """Write the peeks, bodies and pokes of a sequence of uops.
+
+    Return whether next_instr was set, and (for tier one) the name of the
+    variable last stored at stack_pointer[-1], if there is one.
+    """
     managers = get_managers(parts)
 
     all_vars: dict[str, StackEffect] = {}
@@ -410,6 +418,7 @@ def write_components(
         out.declare(eff, None)
 
     next_instr_is_set = False
+    top: str | None = None
     for mgr in managers:
         if len(parts) > 1:
             out.emit(f"// {mgr.instr.name}")
@@ -421,10 +430,11 @@ def write_components(
                     copy_src_effect = copy.src.as_stack_effect()
                 out.assign(copy.dst.effect, copy_src_effect)
         for peek in mgr.peeks:
-            out.assign(
-                peek.effect,
-                peek.as_stack_effect(),
-            )
+            src = peek.as_stack_effect()
+            if tier == TIER_ONE and mgr is managers[0] and is_top(peek):
+                # The top of the stack on entry may be cached.
+                src = StackEffect("TOS_CACHE()", src.type, src.cond, src.size)
+            out.assign(peek.effect, src)
         # Initialize array outputs
         for poke in mgr.pokes:
             if poke.effect.size and poke.effect.name not in mgr.instr.unmoved_names:
@@ -468,8 +478,33 @@ def write_components(
             # past the stack top.
             out.stack_adjust(mgr.final_offset.deep, mgr.final_offset.high)
             write_all_pokes(mgr.final_offset, managers, out)
+            if tier == TIER_ONE:
+                top = find_top_poke(managers)
+
+    return next_instr_is_set, top
+
 
-    return next_instr_is_set
+def is_top(item: StackItem) -> bool:
+    """Is this a plain scalar at stack_pointer[-1]?"""
+    return (
+        not item.effect.size
+        and item.effect.cond in ("", "1")
+        and item.effect.type in ("", "PyObject *")
+        and item.as_variable(lax=True) == "stack_pointer[-1]"
+    )
+
+
+def find_top_poke(managers: list[EffectManager]) -> str | None:
+    """Find the variable written to stack_pointer[-1] by the final pokes."""
+    for mgr in managers:
+        for poke in mgr.pokes:
+            if (
+                poke.effect.name != UNUSED
+                and poke.effect.name not in mgr.instr.unmoved_names
+                and is_top(poke)
+            ):
+                return poke.effect.name
+    return None
 
 
 def assert_no_pokes(managers: list[EffectManager]) -> None:
@@ -520,10 +555,14 @@ def _write_components_for_abstract_interp(
         if mgr is managers[-1]:
             out.stack_adjust(mgr.final_offset.deep, mgr.final_offset.high)
             mgr.adjust_inverse(mgr.final_offset)
-        # NULL out the output stack effects
+        # Nothing is known about the output stack effects
         for poke in mgr.pokes:
-            if not poke.effect.size and poke.effect.name not in mgr.instr.unmoved_names:
-                out.emit(
-                    f"PARTITIONNODE_OVERWRITE((_Py_PARTITIONNODE_t *)"
-                    f"PARTITIONNODE_NULLROOT, PEEK(-({poke.offset.as_index()})), true);"
-                )
+            if poke.effect.name in mgr.instr.unmoved_names:
+                continue
+            dst = poke.as_stack_effect(lax=True)
+            if poke.effect.size:
+                out.emit(f"for (int _i = {poke.effect.size}; --_i >= 0;) {{")
+                out.emit(f"    ({dst.name})[_i] = sym_new_unknown(ctx);")
+                out.emit("}")
+            else:
+                out.assign(dst, StackEffect("sym_new_unknown(ctx)", "", poke.effect.cond))
@@ -1225,10 +1225,18 @@ def _dummy_key(self):
 
     def __iter__(self):
         dummy_ptr = self._dummy_key()
+        # A compact table only holds the keys, and is flagged by the
+        # second highest bit of finger (SET_COMPACT_FLAG)
+        finger = self.field('finger')
+        compact = int(finger) & (1 << (8 * finger.type.sizeof - 2))
         table = self.field('table')
+        if compact:
+            table = table.cast(PyObjectPtr.get_gdb_type().pointer())
         for i in safe_range(self.field('mask') + 1):
-            setentry = table[i]
-            key = setentry['key']
+            if compact:
+                key = table[i]
+            else:
+                key = table[i]['key']
             if key != 0 and key != dummy_ptr:
                 yield PyObjectPtr.from_pyobject_ptr(key)
 
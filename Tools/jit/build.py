@@ -0,0 +1,419 @@
+"""Build the stencils of the copy-and-patch JIT.
+
+Compiles Tools/jit/template.c once for every uop in executor_cases.c.h,
+reads the machine code and relocations back out of the resulting ELF
+object files, and writes them to jit_stencils.h, which is #included in
+Python/jit.c.  Only the C compiler that builds CPython is needed; LLVM is
+not required, neither here nor at runtime.
+
+Currently only x86-64 ELF targets are supported.
+"""
+
+import argparse
+import concurrent.futures
+import dataclasses
+import os
+import posixpath
+import re
+import shlex
+import shutil
+import struct
+import subprocess
+import sys
+import tempfile
+
+HERE = os.path.dirname(__file__)
+ROOT = os.path.join(HERE, "../..")
+THIS = os.path.relpath(__file__, ROOT).replace(os.path.sep, posixpath.sep)
+
+DEFAULT_TEMPLATE = os.path.relpath(os.path.join(HERE, "template.c"))
+DEFAULT_CASES = os.path.relpath(os.path.join(ROOT, "Python/executor_cases.c.h"))
+DEFAULT_OUTPUT = os.path.relpath(os.path.join(ROOT, "Python/jit_stencils.h"))
+
+# Every stencil must be position-independent in the "patchable" sense: all
+# addresses are loaded as 64-bit immediates, which we can overwrite.
+# Py_BUILD_CORE_MODULE makes _PyThreadState_GET() call a function instead of
+# reading a thread-local variable, which can't be relocated this way.
+CFLAGS = [
+    "-O3",
+    "-DPy_BUILD_CORE",
+    "-DPy_BUILD_CORE_MODULE",
+    "-fno-pic",
+    "-mcmodel=large",
+    "-ffunction-sections",
+    "-fno-asynchronous-unwind-tables",
+    "-fno-jump-tables",
+    "-fno-stack-protector",
+    "-fno-reorder-blocks-and-partition",
+    "-fcf-protection=none",
+    "-fno-plt",
+    "-malign-data=abi",
+    "-fno-lto",
+    "-g0",
+]
+
+# The symbols that mark holes in template.c, and the HoleValue they map to:
+HOLE_SYMBOLS = {
+    "_JIT_CONTINUE": "HOLE_CONTINUE",
+    "_JIT_JUMP_TARGET": "HOLE_JUMP_TARGET",
+    "_JIT_EXECUTOR": "HOLE_EXECUTOR",
+    "_JIT_INDEX": "HOLE_INDEX",
+    "_JIT_OPARG": "HOLE_OPARG",
+    "_JIT_OPERAND": "HOLE_OPERAND",
+}
+ENTRY_SYMBOL = "_JIT_ENTRY"
+
+# ELF constants (see elf.h):
+EM_X86_64 = 62
+SHT_SYMTAB = 2
+SHT_RELA = 4
+SHT_NOBITS = 8
+SHF_WRITE = 0x1
+SHF_ALLOC = 0x2
+SHF_EXECINSTR = 0x4
+STT_SECTION = 3
+SHN_UNDEF = 0
+R_X86_64_64 = 1
+R_X86_64_PC32 = 2
+R_X86_64_PLT32 = 4
+
+ALIGNMENT = 16
+
+
+class StencilError(Exception):
+    pass
+
+
+@dataclasses.dataclass
+class Section:
+    name: str
+    type: int
+    flags: int
+    offset: int
+    size: int
+    link: int
+    info: int
+    align: int
+    data: bytes
+
+
+@dataclasses.dataclass
+class Symbol:
+    name: str
+    info: int
+    shndx: int
+    value: int
+
+
+@dataclasses.dataclass
+class Hole:
+    offset: int
+    kind: str
+    value: str
+    symbol: str | None
+    addend: int
+
+
+@dataclasses.dataclass
+class Stencil:
+    body: bytearray = dataclasses.field(default_factory=bytearray)
+    holes: list[Hole] = dataclasses.field(default_factory=list)
+
+
+@dataclasses.dataclass
+class StencilGroup:
+    code: Stencil
+    data: Stencil
+
+
+def read_elf(path: str) -> tuple[list[Section], list[Symbol]]:
+    with open(path, "rb") as f:
+        image = f.read()
+    if image[:4] != b"\x7fELF" or image[4] != 2 or image[5] != 1:
+        raise StencilError(f"{path}: not a little-endian ELF64 object")
+    (machine,) = struct.unpack_from("<H", image, 18)
+    if machine != EM_X86_64:
+        raise StencilError(f"{path}: unsupported machine {machine}")
+    shoff, = struct.unpack_from("<Q", image, 40)
+    shentsize, shnum, shstrndx = struct.unpack_from("<HHH", image, 58)
+    headers = [
+        struct.unpack_from("<IIQQQQIIQQ", image, shoff + i * shentsize)
+        for i in range(shnum)
+    ]
+    _, _, _, _, names_offset, names_size, *_ = headers[shstrndx]
+    names = image[names_offset : names_offset + names_size]
+    sections = []
+    for name, type, flags, _, offset, size, link, info, align, _ in headers:
+        data = b"" if type == SHT_NOBITS else image[offset : offset + size]
+        sections.append(
+            Section(
+                cstring(names, name), type, flags, offset, size, link, info,
+                align, data,
+            )
+        )
+    symbols = []
+    for section in sections:
+        if section.type != SHT_SYMTAB:
+            continue
+        strings = sections[section.link].data
+        for offset in range(0, section.size, 24):
+            name, info, _, shndx, value, _ = struct.unpack_from(
+                "<IBBHQQ", section.data, offset
+            )
+            symbols.append(Symbol(cstring(strings, name), info, shndx, value))
+    return sections, symbols
+
+
+def cstring(table: bytes, offset: int) -> str:
+    return table[offset : table.index(b"\0", offset)].decode()
+
+
+def build_stencil_group(path: str, opname: str) -> StencilGroup:
+    sections, symbols = read_elf(path)
+    group = StencilGroup(Stencil(), Stencil())
+    # Lay out every allocated section in either the code or the data stencil,
+    # putting the entry point first:
+    placement: dict[int, tuple[str, int]] = {}
+    entry = next(s for s in symbols if s.name == ENTRY_SYMBOL)
+    order = sorted(range(len(sections)), key=lambda i: i != entry.shndx)
+    for i in order:
+        section = sections[i]
+        if not section.flags & SHF_ALLOC or not section.size:
+            continue
+        if section.flags & SHF_WRITE and not section.name.startswith(
+            ".data.rel.ro"
+        ):
+            raise StencilError(f"{opname}: writable section {section.name}")
+        if section.align > ALIGNMENT:
+            raise StencilError(f"{opname}: overaligned section {section.name}")
+        kind = "code" if section.flags & SHF_EXECINSTR else "data"
+        stencil = getattr(group, kind)
+        pad(stencil.body, max(section.align, 1), kind)
+        placement[i] = (kind, len(stencil.body))
+        stencil.body.extend(section.data or bytes(section.size))
+    if placement.get(entry.shndx) != ("code", 0) or entry.value:
+        raise StencilError(f"{opname}: {ENTRY_SYMBOL} is not at offset 0")
+    for section in sections:
+        if section.type != SHT_RELA or section.info not in placement:
+            continue
+        kind, base = placement[section.info]
+        stencil = getattr(group, kind)
+        for offset in range(0, section.size, 24):
+            r_offset, r_info, r_addend = struct.unpack_from(
+                "<QQq", section.data, offset
+            )
+            symbol = symbols[r_info >> 32]
+            stencil.holes.append(
+                make_hole(
+                    opname, placement, symbol, r_info & 0xFFFFFFFF,
+                    base + r_offset, r_addend,
+                )
+            )
+    pad(group.code.body, ALIGNMENT, "code")
+    pad(group.data.body, ALIGNMENT, "data")
+    return group
+
+
+def pad(body: bytearray, align: int, kind: str) -> None:
+    # Pad code with int3, so stray jumps trap:
+    body.extend((b"\xCC" if kind == "code" else b"\0") * (-len(body) % align))
+
+
+def make_hole(
+    opname: str,
+    placement: dict[int, tuple[str, int]],
+    symbol: Symbol,
+    type: int,
+    offset: int,
+    addend: int,
+) -> Hole:
+    if type == R_X86_64_64:
+        kind = "HOLE_abs_64"
+    elif type in (R_X86_64_PC32, R_X86_64_PLT32):
+        kind = "HOLE_rel_32"
+    else:
+        raise StencilError(f"{opname}: unsupported relocation type {type}")
+    if symbol.shndx in placement:
+        # A reference to our own code or data:
+        where, base = placement[symbol.shndx]
+        value = "HOLE_CODE" if where == "code" else "HOLE_DATA"
+        if symbol.info & 0xF != STT_SECTION:
+            addend += symbol.value
+        return Hole(offset, kind, value, None, base + addend)
+    if symbol.shndx != SHN_UNDEF:
+        raise StencilError(f"{opname}: unplaced symbol {symbol.name}")
+    if symbol.name in HOLE_SYMBOLS:
+        return Hole(offset, kind, HOLE_SYMBOLS[symbol.name], None, addend)
+    if kind != "HOLE_abs_64":
+        raise StencilError(f"{opname}: relative reference to {symbol.name}")
+    return Hole(offset, kind, "HOLE_ZERO", symbol.name, addend)
+
+
+def check_tail_calls(objdump: str, path: str, opname: str) -> None:
+    """Make sure that continuing to the next stencil doesn't grow the stack.
+
+    Every use of the register loaded with _JIT_CONTINUE or _JIT_JUMP_TARGET
+    must be an indirect jump; an indirect call would mean that the compiler
+    failed to turn the continuation into a tail call.
+    """
+    disassembly = subprocess.run(
+        [objdump, "-dr", "--no-show-raw-insn", path],
+        check=True, capture_output=True, text=True,
+    ).stdout.splitlines()
+    for i, line in enumerate(disassembly):
+        if not re.search(r"R_X86_64_64\s+_JIT_(CONTINUE|JUMP_TARGET)\b", line):
+            continue
+        match = re.search(r",(%\w+)$", disassembly[i - 1].strip())
+        if match is None:
+            raise StencilError(f"{opname}: can't find continuation register")
+        register = re.escape(match.group(1))
+        for later in disassembly[i + 1 :]:
+            if re.search(rf"\*{register}\b", later):
+                if not re.search(r"\bjmp\b", later):
+                    raise StencilError(f"{opname}: continuation is not a tail call")
+                break
+
+
+def compile_stencil(
+    cc: list[str], cflags: list[str], template: str, objdump: str | None,
+    workdir: str, opname: str,
+) -> StencilGroup:
+    path = os.path.join(workdir, f"{opname}.o")
+    subprocess.run(
+        [*cc, *cflags, *CFLAGS, f"-D_JIT_OPCODE={opname}", "-c", "-o", path, template],
+        check=True,
+    )
+    if objdump is not None:
+        check_tail_calls(objdump, path, opname)
+    return build_stencil_group(path, opname)
+
+
+def find_opnames(cases: str) -> list[str]:
+    with open(cases) as f:
+        return re.findall(r"^        case (\w+): \{", f.read(), re.MULTILINE)
+
+
+def c_bytes(body: bytes) -> list[str]:
+    lines = []
+    for i in range(0, len(body), 12):
+        chunk = body[i : i + 12]
+        lines.append("    " + " ".join(f"0x{b:02x}," for b in chunk))
+    return lines
+
+
+def dump(groups: dict[str, StencilGroup]) -> list[str]:
+    lines = [
+        f"// This file is generated by {THIS}",
+        "// Do not edit!",
+        "",
+    ]
+    symbols = sorted(
+        {
+            hole.symbol
+            for group in groups.values()
+            for stencil in (group.code, group.data)
+            for hole in stencil.holes
+            if hole.symbol is not None
+        }
+    )
+    for opname, group in groups.items():
+        for kind in ("code", "data"):
+            stencil = getattr(group, kind)
+            if stencil.body:
+                lines.append(f"static const unsigned char {opname}_{kind}_body[{len(stencil.body)}] = {{")
+                lines.extend(c_bytes(stencil.body))
+                lines.append("};")
+            if stencil.holes:
+                lines.append(f"static const Hole {opname}_{kind}_holes[{len(stencil.holes)}] = {{")
+                for hole in stencil.holes:
+                    symbol = f"&{hole.symbol}" if hole.symbol else "NULL"
+                    lines.append(
+                        f"    {{0x{hole.offset:x}, {hole.kind}, {hole.value}, "
+                        f"{symbol}, 0x{hole.addend & 0xFFFFFFFFFFFFFFFF:x}}},"
+                    )
+                lines.append("};")
+        lines.append("")
+
+    def init(opname: str, kind: str, stencil: Stencil) -> str:
+        body = f"{opname}_{kind}_body" if stencil.body else "NULL"
+        holes = f"{opname}_{kind}_holes" if stencil.holes else "NULL"
+        return (
+            f"{{{len(stencil.body)}, {body}, {len(stencil.holes)}, {holes}}}"
+        )
+
+    lines.append("static const StencilGroup stencil_groups[512] = {")
+    for opname, group in groups.items():
+        lines.append(f"    [{opname}] = {{")
+        lines.append(f"        .code = {init(opname, 'code', group.code)},")
+        lines.append(f"        .data = {init(opname, 'data', group.data)},")
+        lines.append("    },")
+    lines.append("};")
+    lines.append("")
+    lines.append(f"// {len(symbols)} external symbols are referenced:")
+    for symbol in symbols:
+        lines.append(f"//   {symbol}")
+    return lines
+
+
+arg_parser = argparse.ArgumentParser(
+    description="Build the stencils of the copy-and-patch JIT.",
+    formatter_class=argparse.ArgumentDefaultsHelpFormatter,
+)
+arg_parser.add_argument(
+    "-o", "--output", type=str, help="Generated stencil file",
+    default=DEFAULT_OUTPUT,
+)
+arg_parser.add_argument(
+    "-t", "--template", type=str, help="Template file", default=DEFAULT_TEMPLATE,
+)
+arg_parser.add_argument(
+    "-c", "--cases", type=str, help="Tier 2 instruction cases",
+    default=DEFAULT_CASES,
+)
+arg_parser.add_argument(
+    "--cc", type=str, help="C compiler", default=os.environ.get("CC", "cc"),
+)
+arg_parser.add_argument(
+    "--objdump", type=str, help="objdump, used to verify tail calls",
+    default="objdump",
+)
+arg_parser.add_argument(
+    "cflags", nargs=argparse.REMAINDER,
+    help="Extra compiler flags (include paths, ...), after --",
+)
+
+
+def main() -> None:
+    args = arg_parser.parse_args()
+    cflags = args.cflags
+    if cflags[:1] == ["--"]:
+        cflags = cflags[1:]
+    cc = shlex.split(args.cc)
+    objdump = shutil.which(args.objdump)
+    if objdump is None:
+        print(f"{args.objdump} not found; not verifying tail calls", file=sys.stderr)
+    opnames = find_opnames(args.cases)
+    with tempfile.TemporaryDirectory() as workdir:
+        with concurrent.futures.ThreadPoolExecutor(os.cpu_count()) as pool:
+            futures = [
+                pool.submit(
+                    compile_stencil, cc, cflags, args.template, objdump,
+                    workdir, opname,
+                )
+                for opname in opnames
+            ]
+            groups = {
+                opname: future.result()
+                for opname, future in zip(opnames, futures)
+            }
+    with open(args.output, "w") as f:
+        for line in dump(groups):
+            f.write(line + "\n")
+    print(f"Wrote {len(groups)} stencils to {args.output}", file=sys.stderr)
+
+
+if __name__ == "__main__":
+    try:
+        main()
+    except StencilError as e:
+        sys.exit(f"{THIS}: {e}")
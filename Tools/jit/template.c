@@ -0,0 +1,144 @@
+/* Template for the stencils of the copy-and-patch JIT.
+ *
+ * Tools/jit/build.py compiles this file once for every uop, with
+ * _JIT_OPCODE defined to that uop.  The external symbols starting with
+ * _JIT_ are never defined: their addresses are "holes" that
+ * Python/jit.c fills in when it copies the machine code of a stencil
+ * into an executor.
+ *
+ * Keep the includes in sync with Python/executor.c and Python/jit.c.
+ */
+
+#include "Python.h"
+
+#include "opcode.h"
+
+#include "pycore_bitutils.h"
+#include "pycore_call.h"
+#include "pycore_ceval.h"
+#include "pycore_dict.h"
+#include "pycore_emscripten_signal.h"
+#include "pycore_intrinsics.h"
+#include "pycore_list.h"
+#include "pycore_long.h"
+#include "pycore_object.h"
+#include "pycore_opcode_metadata.h"
+#include "pycore_opcode_utils.h"
+#include "pycore_optimizer.h"     // _PyOptimizer_SideExit()
+#include "pycore_pyerrors.h"
+#include "pycore_range.h"
+#include "pycore_setobject.h"     // _PySet_Update()
+#include "pycore_sliceobject.h"
+#include "pycore_tuple.h"
+#include "pycore_uops.h"
+
+#define TIER_TWO 2
+#include "ceval_macros.h"
+
+#undef DEOPT_IF
+#define DEOPT_IF(COND, INSTNAME) \
+    if ((COND)) {                \
+        goto deoptimize;         \
+    }
+
+// Every stencil recomputes ip_offset from the current frame on entry.
+#undef LOAD_IP
+#define LOAD_IP(UNUSED) ((void)0)
+
+// No stats in jitted code; see Python/executor.c.
+#undef STAT_INC
+#define STAT_INC(opname, name) ((void)0)
+#undef STAT_DEC
+#define STAT_DEC(opname, name) ((void)0)
+#undef CALL_STAT_INC
+#define CALL_STAT_INC(name) ((void)0)
+#undef OPT_STAT_INC
+#define OPT_STAT_INC(name) ((void)0)
+#undef OPT_HIST
+#define OPT_HIST(length, name) ((void)0)
+
+#undef ENABLE_SPECIALIZATION
+#define ENABLE_SPECIALIZATION 0
+
+// Holes, patched when the stencil is copied.  The values are declared weak
+// so that the compiler can't assume that their addresses are non-NULL:
+extern _PyInterpreterFrame *_JIT_CONTINUE(
+    _PyInterpreterFrame *frame, PyObject **stack_pointer,
+    PyThreadState *tstate);
+extern _PyInterpreterFrame *_JIT_JUMP_TARGET(
+    _PyInterpreterFrame *frame, PyObject **stack_pointer,
+    PyThreadState *tstate);
+extern _PyUOpExecutorObject _JIT_EXECUTOR;
+extern char _JIT_INDEX[] __attribute__((weak));
+extern char _JIT_OPARG[] __attribute__((weak));
+extern char _JIT_OPERAND[] __attribute__((weak));
+
+_PyInterpreterFrame *
+_JIT_ENTRY(_PyInterpreterFrame *frame, PyObject **stack_pointer,
+           PyThreadState *tstate)
+{
+    // Locals that the instruction implementations expect to exist:
+    _PyUOpExecutorObject *self = &_JIT_EXECUTOR;
+    _Py_CODEUNIT *ip_offset =
+        (_Py_CODEUNIT *)_PyFrame_GetCode(frame)->co_code_adaptive;
+    int opcode = _JIT_OPCODE;
+    int oparg = (int)(uintptr_t)_JIT_OPARG;
+    uint64_t operand = (uintptr_t)_JIT_OPERAND;
+    int pc = -1;
+    (void)ip_offset;
+    (void)opcode;
+    (void)operand;
+
+    // The actual instruction definitions (only one will be used):
+    switch (opcode) {
+
+#include "executor_cases.c.h"
+
+        default:
+            Py_UNREACHABLE();
+    }
+    if (pc >= 0) {
+        // _POP_JUMP_IF_FALSE, _POP_JUMP_IF_TRUE or _JUMP_TO_TOP was taken.
+        return _JIT_JUMP_TARGET(frame, stack_pointer, tstate);
+    }
+    return _JIT_CONTINUE(frame, stack_pointer, tstate);
+
+    // Labels that the instruction implementations expect to exist:
+unbound_local_error:
+    _PyEval_FormatExcCheckArg(tstate, PyExc_UnboundLocalError,
+        UNBOUNDLOCAL_ERROR_MSG,
+        PyTuple_GetItem(_PyFrame_GetCode(frame)->co_localsplusnames, oparg)
+    );
+    goto error;
+pop_4_error:
+    STACK_SHRINK(1);
+pop_3_error:
+    STACK_SHRINK(1);
+pop_2_error:
+    STACK_SHRINK(1);
+pop_1_error:
+    STACK_SHRINK(1);
+error:
+    // On ERROR_IF we return NULL as the frame.
+    // The caller recovers the frame from tstate->current_frame.
+    frame->return_offset = 0;  // Don't leave this random
+    _PyFrame_SetStackPointer(frame, stack_pointer);
+    Py_DECREF(self);
+    return NULL;
+deoptimize:
+    // On DEOPT_IF we just repeat the last instruction.
+    // This presumes nothing was popped from the stack (nor pushed).
+    frame->return_offset = 0;  // Dispatch to frame->instr_ptr
+    _PyFrame_SetStackPointer(frame, stack_pointer);
+exit_trace:
+    {
+        _PyExecutorObject *exit;
+        int linked = _PyOptimizer_SideExit(self, (int)(uintptr_t)_JIT_INDEX,
+                                           frame, &exit);
+        Py_DECREF(self);
+        if (linked <= 0) {
+            return linked < 0 ? NULL : frame;
+        }
+        return exit->execute(exit, frame, stack_pointer);
+    }
+}
@@ -0,0 +1,40 @@
+#!/usr/bin/env python3
+#
+# Time int multiplication, squaring and exponentiation across the sizes
+# where longobject.c switches between the Karatsuba, Toom-3 and NTT
+# multiplication tiers.  Run with different builds (or after changing the
+# *_CUTOFF constants) to compare them.
+
+import sys
+from random import getrandbits, seed
+from timeit import repeat
+
+BITS_PER_DIGIT = sys.int_info.bits_per_digit
+
+# digit counts, bracketing TOOM3_CUTOFF and NTT_CUTOFF
+SIZES = [100, 200, 300, 500, 1000, 2000, 3000, 5000, 10000, 30000, 100000]
+
+
+def bench(func, n):
+    number = max(1, int(3e6 / n ** 1.5))
+    best = min(repeat(func, number=number, repeat=5))
+    return best / number * 1e6
+
+
+def main():
+    seed(42)
+    print(f"{'digits':>8} {'a*b (us)':>12} {'a*a (us)':>12} "
+          f"{'a**3 (us)':>12} {'c*a (us)':>12}")
+    for n in SIZES:
+        a = getrandbits(n * BITS_PER_DIGIT) | 1
+        b = getrandbits(n * BITS_PER_DIGIT) | 1
+        # lopsided: a third the size of a
+        c = getrandbits(n * BITS_PER_DIGIT // 3) | 1
+        print(f"{n:8} {bench(lambda: a * b, n):12.1f} "
+              f"{bench(lambda: a * a, n):12.1f} "
+              f"{bench(lambda: a ** 3, n):12.1f} "
+              f"{bench(lambda: c * a, n):12.1f}")
+
+
+if __name__ == '__main__':
+    main()